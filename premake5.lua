@@ -4,12 +4,49 @@ workspace "SML"
        "release" 
     }
 
+    -- SIMD backend the library is built for, see sml/include/backend.h. Every backend builds the
+    -- full test suite, the scalar one is the reference the others are compared against.
+    platforms {
+        "avx",
+        "sse",
+        "scalar",
+        "avx512"
+    }
+
     flags {
 		"MultiProcessorCompile"
 	}
 
-    binaries = "%{sln.location}/bin/%{cfg.buildcfg}/%{cfg.system}/%{cfg.architecture}"
-    intermediate = "%{sln.location}/bin-int/%{cfg.buildcfg}/%{cfg.system}/%{cfg.architecture}"
+    binaries = "%{sln.location}/bin/%{cfg.buildcfg}/%{cfg.system}/%{cfg.platform}"
+    intermediate = "%{sln.location}/bin-int/%{cfg.buildcfg}/%{cfg.system}/%{cfg.platform}"
+
+    filter "platforms:avx"
+        vectorextensions "AVX"
+
+    filter "platforms:sse"
+        vectorextensions "SSE4.1"
+
+    filter "platforms:scalar"
+        defines {
+            "SML_FORCE_SCALAR"
+        }
+
+    filter "platforms:avx512"
+        vectorextensions "AVX2"
+
+    filter { "platforms:avx512", "system:windows" }
+        buildoptions {
+            "/arch:AVX512"
+        }
+
+    filter { "platforms:avx512", "system:not windows" }
+        buildoptions {
+            "-mavx512f",
+            "-mavx512vl",
+            "-mfma"
+        }
+
+    filter {}
 
     IncludeDir = {}
     IncludeDir["SML"] = "sml/include"
@@ -62,8 +99,6 @@ project "SMLTest"
 	targetdir (binaries)
 	objdir (intermediate)
 	
-	vectorextensions "AVX"
-
     files {
         "smltest/include/**.h",
         "smltest/include/**.hpp",
@@ -77,10 +112,48 @@ project "SMLTest"
         "smltest/include"
     }
 
+    -- The tests use the instantiations of the compiled library instead of their own
+    defines {
+        "SML_EXTERN_TEMPLATES"
+    }
+
     links {
-        "googletest"
+        "googletest",
+        "sml"
     }
 
+    -- The differential tests link every backend into one binary, each from its own translation
+    -- unit built for that backend's instruction set (the backends are only run when the CPU has it)
+    filter { "files:smltest/src/differential/SseBackend.cpp", "system:not windows" }
+        buildoptions {
+            "-msse4.1"
+        }
+
+    filter { "files:smltest/src/differential/AvxBackend.cpp", "system:windows" }
+        buildoptions {
+            "/arch:AVX"
+        }
+
+    filter { "files:smltest/src/differential/AvxBackend.cpp", "system:not windows" }
+        buildoptions {
+            "-mavx"
+        }
+
+    filter { "files:smltest/src/differential/Avx512Backend.cpp", "system:windows" }
+        buildoptions {
+            "/arch:AVX512"
+        }
+
+    filter { "files:smltest/src/differential/Avx512Backend.cpp", "system:not windows" }
+        buildoptions {
+            "-mavx2",
+            "-mfma",
+            "-mavx512f",
+            "-mavx512vl"
+        }
+
+    filter {}
+
     filter "system:windows"
         toolset "msc-ClangCL"
 
@@ -104,3 +177,42 @@ project "SMLTest"
             "NDEBUG" 
         }
         optimize "On"
+
+project "SMLBench"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir (binaries)
+	objdir (intermediate)
+
+    files {
+        "smlbench/include/**.h",
+        "smlbench/src/**.cpp" 
+    }
+
+    includedirs {
+        "%{IncludeDir.SML}",
+        "smlbench/include"
+    }
+
+    filter "system:windows"
+        toolset "msc-ClangCL"
+
+    filter "system:linux"
+        toolset "clang"
+
+    filter {}
+
+    filter "configurations:Debug"
+        defines { 
+            "DEBUG" 
+        }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { 
+            "NDEBUG" 
+        }
+        optimize "Speed"
@@ -0,0 +1,135 @@
+#ifndef sml_backend_h__
+#define sml_backend_h__
+
+/* backend.h -- compile time SIMD backend selection of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <type_traits>
+
+// The backend is picked from the instruction sets the compiler targets, the highest one wins:
+//   SML_BACKEND_SCALAR  plain C++, the reference every other backend is tested against
+//   SML_BACKEND_SSE     SSE4.1, 128 bit f32 and 32 bit integer paths
+//   SML_BACKEND_AVX     AVX, adds the f64 paths and the 8 / 4 lane array kernels (AVX2 and FMA
+//                       are used on top when the compiler targets them)
+//   SML_BACKEND_AVX512  AVX-512F, adds the 16 lane array kernels
+// Define SML_FORCE_SCALAR to build the scalar reference regardless of the target, or define
+// SML_BACKEND to one of the values above to cap the backend below what the target supports.
+#define SML_BACKEND_SCALAR 0
+#define SML_BACKEND_SSE 1
+#define SML_BACKEND_AVX 2
+#define SML_BACKEND_AVX512 3
+
+#if defined(__AVX512F__)
+    #define SML_BACKEND_TARGET SML_BACKEND_AVX512
+#elif defined(__AVX__)
+    #define SML_BACKEND_TARGET SML_BACKEND_AVX
+#elif defined(__SSE4_1__)
+    #define SML_BACKEND_TARGET SML_BACKEND_SSE
+#else
+    #define SML_BACKEND_TARGET SML_BACKEND_SCALAR
+#endif
+
+#if defined(SML_FORCE_SCALAR)
+    #undef SML_BACKEND
+    #define SML_BACKEND SML_BACKEND_SCALAR
+#elif !defined(SML_BACKEND)
+    #define SML_BACKEND SML_BACKEND_TARGET
+#elif SML_BACKEND > SML_BACKEND_TARGET
+    #error "SML_BACKEND selects an instruction set the compiler doesn't target"
+#endif
+
+#define SML_SSE (SML_BACKEND >= SML_BACKEND_SSE)
+#define SML_AVX (SML_BACKEND >= SML_BACKEND_AVX)
+#define SML_AVX512 (SML_BACKEND >= SML_BACKEND_AVX512)
+
+#if SML_AVX && defined(__AVX2__)
+    #define SML_AVX2 1
+#else
+    #define SML_AVX2 0
+#endif
+
+#if SML_AVX && defined(__FMA__)
+    #define SML_FMA 1
+#else
+    #define SML_FMA 0
+#endif
+
+// Every backend lives in its own inline namespace, so translation units built with different
+// backends can be linked into one binary (the differential tests do) without the inline
+// functions of one backend replacing those of another
+#if SML_BACKEND == SML_BACKEND_AVX512
+    #define SML_BACKEND_NAMESPACE avx512
+    #define SML_BACKEND_NAME "avx512"
+#elif SML_BACKEND == SML_BACKEND_AVX
+    #define SML_BACKEND_NAMESPACE avx
+    #define SML_BACKEND_NAME "avx"
+#elif SML_BACKEND == SML_BACKEND_SSE
+    #define SML_BACKEND_NAMESPACE sse
+    #define SML_BACKEND_NAME "sse"
+#else
+    #define SML_BACKEND_NAMESPACE scalar
+    #define SML_BACKEND_NAME "scalar"
+#endif
+
+// The scalar backend doesn't touch the intrinsic headers at all, so it also builds for targets
+// without x86 SIMD
+#if SML_SSE
+    #include <immintrin.h>
+#endif
+
+#define SML_NAMESPACE_BEGIN namespace sml { inline namespace SML_BACKEND_NAMESPACE {
+#define SML_NAMESPACE_END } }
+
+// Define SML_EXTERN_TEMPLATES when linking the compiled sml library (sml/src), the f32 / f64 / s32
+// classes are then instantiated once in the library instead of in every translation unit. The
+// library has to be built for the same backend, a mismatch shows up as unresolved symbols.
+#if defined(SML_EXTERN_TEMPLATES)
+    #define SML_EXTERN_TEMPLATE(...) extern template __VA_ARGS__;
+#else
+    #define SML_EXTERN_TEMPLATE(...)
+#endif
+
+SML_NAMESPACE_BEGIN
+    static constexpr int backend = SML_BACKEND;
+    static constexpr const char* backendname = SML_BACKEND_NAME;
+
+    // Types that take the 128 bit SSE f32 paths
+    template<typename T>
+    struct simdf32 : std::integral_constant<bool, SML_SSE && std::is_same<T, float>::value>
+    {
+    };
+
+    // Types that take the f64 paths, most of them are 256 bit AVX
+    template<typename T>
+    struct simdf64 : std::integral_constant<bool, SML_AVX && std::is_same<T, double>::value>
+    {
+    };
+
+    // Types that take the SSE4.1 / AVX2 32 bit integer paths
+    template<typename T>
+    struct simdi32 : std::integral_constant<bool, SML_SSE && (std::is_same<T, int>::value || std::is_same<T, unsigned int>::value)>
+    {
+    };
+
+    // Types that have a wide<T> specialization and take the 8 / 4 lane array kernels
+    template<typename T>
+    struct simdwide : std::integral_constant<bool, SML_AVX && (std::is_same<T, float>::value || std::is_same<T, double>::value)>
+    {
+    };
+SML_NAMESPACE_END
+
+#endif // sml_backend_h__
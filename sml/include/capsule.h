@@ -0,0 +1,102 @@
+#ifndef sml_capsule_h__
+#define sml_capsule_h__
+
+/* capsule.h -- capsule of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "common.h"
+#include "smltypes.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "closest.h"
+
+SML_NAMESPACE_BEGIN
+    // Points within radius of the segment a, b
+    template<typename T>
+    class capsule
+    {
+        public:
+            constexpr capsule() noexcept
+                : a(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), b(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), radius(static_cast<T>(0))
+            {
+            }
+
+            constexpr capsule(const vec3<T>& a, const vec3<T>& b, T radius) noexcept
+                : a(a), b(b), radius(radius)
+            {
+            }
+
+            // Operators
+            inline constexpr bool operator == (const capsule& other) const noexcept
+            {
+                return a == other.a && b == other.b && radius == other.radius;
+            }
+
+            inline constexpr bool operator != (const capsule& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            SML_NO_DISCARD inline bool contains(const vec3<T>& point) const noexcept
+            {
+                return distancesquaredsegment(point, a, b) <= radius * radius;
+            }
+
+            // Negative inside the capsule
+            SML_NO_DISCARD inline T signeddistance(const vec3<T>& point) const noexcept
+            {
+                return distancesegment(point, a, b) - radius;
+            }
+
+            // Closest point on the surface, a point on the axis maps to itself
+            SML_NO_DISCARD inline vec3<T> closestpoint(const vec3<T>& point) const noexcept
+            {
+                vec3<T> axis = closestpointsegment(point, a, b);
+                vec3<T> offset = point - axis;
+                T length = offset.length();
+
+                return length > static_cast<T>(0) ? axis + offset * (radius / length) : axis;
+            }
+
+            // The radius scales with the largest axis scale of the matrix, so non-uniform scaling
+            // gives the smallest capsule that contains the transformed one
+            SML_NO_DISCARD inline constexpr capsule transformed(const mat4<T>& matrix) const noexcept
+            {
+                T x = matrix.m00 * matrix.m00 + matrix.m01 * matrix.m01 + matrix.m02 * matrix.m02;
+                T y = matrix.m10 * matrix.m10 + matrix.m11 * matrix.m11 + matrix.m12 * matrix.m12;
+                T z = matrix.m20 * matrix.m20 + matrix.m21 * matrix.m21 + matrix.m22 * matrix.m22;
+
+                return capsule(matrix.transformPoint(a), matrix.transformPoint(b), radius * sml::sqrt(sml::max(x, sml::max(y, z))));
+            }
+
+            // Variables
+            vec3<T> a;
+            vec3<T> b;
+            T radius;
+    };
+
+    // Predefined types
+    typedef capsule<f32> fcapsule;
+    typedef capsule<f64> dcapsule;
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class capsule<f32>)
+    SML_EXTERN_TEMPLATE(class capsule<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_capsule_h__
@@ -0,0 +1,488 @@
+#ifndef sml_closest_h__
+#define sml_closest_h__
+
+/* closest.h -- closest point queries of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <limits>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec3.h"
+
+// Closest points and distances between a point and a segment, triangle or axis aligned box, and
+// between two segments. Every distance comes in a squared form, which skips the square root and
+// is what comparisons need.
+//
+// The point to segment and point to triangle queries are written without branches, every Voronoi
+// region of the triangle (Ericson, "Real-Time Collision Detection" 5.1.5) is evaluated and the
+// right one selected. The same code then runs on 8 (f32) or 4 (f64) primitives at a time in the
+// array forms, which find the closest of many segments or triangles to one point.
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        template<typename O>
+        struct closestvector
+        {
+            typedef typename O::type R;
+
+            R x, y, z;
+
+            inline closestvector operator-(const closestvector& o) const noexcept
+            {
+                return { O::sub(x, o.x), O::sub(y, o.y), O::sub(z, o.z) };
+            }
+
+            inline R dot(const closestvector& o) const noexcept
+            {
+                return O::madd(x, o.x, O::madd(y, o.y, O::mul(z, o.z)));
+            }
+        };
+
+        // Parameter t in [0, 1] of the point on ab closest to p
+        template<typename O>
+        static inline typename O::type closestsegmentparameter(const closestvector<O>& p, const closestvector<O>& a, const closestvector<O>& b) noexcept
+        {
+            typedef typename O::type R;
+
+            closestvector<O> ab = b - a;
+            R zero = O::zero(), one = O::set1(1);
+            R length = ab.dot(ab);
+
+            // A degenerate segment is a point, t = 0
+            R t = O::div(ab.dot(p - a), O::select(O::gt(length, zero), length, one));
+
+            return O::min(O::max(t, zero), one);
+        }
+
+        // Weights v and w of the point a + v (b - a) + w (c - a) on triangle abc closest to p
+        template<typename O>
+        static inline void closesttriangleweights(const closestvector<O>& p, const closestvector<O>& a, const closestvector<O>& b, const closestvector<O>& c, typename O::type& v, typename O::type& w) noexcept
+        {
+            typedef typename O::type R;
+
+            closestvector<O> ab = b - a, ac = c - a;
+            closestvector<O> ap = p - a, bp = p - b, cp = p - c;
+
+            R d1 = ab.dot(ap), d2 = ac.dot(ap);
+            R d3 = ab.dot(bp), d4 = ac.dot(bp);
+            R d5 = ab.dot(cp), d6 = ac.dot(cp);
+
+            R va = O::sub(O::mul(d3, d6), O::mul(d5, d4));
+            R vb = O::sub(O::mul(d5, d2), O::mul(d1, d6));
+            R vc = O::sub(O::mul(d1, d4), O::mul(d3, d2));
+
+            R zero = O::zero(), one = O::set1(1);
+
+            // Interior, then the regions from lowest to highest priority so the first one that
+            // Ericson's branching version would take wins. Divisions of the regions not taken may
+            // produce infinities or NaNs, the selects discard them.
+            R denominator = O::add(va, O::add(vb, vc));
+            v = O::div(vb, denominator);
+            w = O::div(vc, denominator);
+
+            R e43 = O::sub(d4, d3), e56 = O::sub(d5, d6);
+            auto bc = O::band(O::le(va, zero), O::band(O::ge(e43, zero), O::ge(e56, zero)));
+            R tbc = O::div(e43, O::add(e43, e56));
+            v = O::select(bc, O::sub(one, tbc), v);
+            w = O::select(bc, tbc, w);
+
+            auto edgeac = O::band(O::le(vb, zero), O::band(O::ge(d2, zero), O::le(d6, zero)));
+            v = O::select(edgeac, zero, v);
+            w = O::select(edgeac, O::div(d2, O::sub(d2, d6)), w);
+
+            auto edgeab = O::band(O::le(vc, zero), O::band(O::ge(d1, zero), O::le(d3, zero)));
+            v = O::select(edgeab, O::div(d1, O::sub(d1, d3)), v);
+            w = O::select(edgeab, zero, w);
+
+            auto vertexc = O::band(O::ge(d6, zero), O::le(d5, d6));
+            v = O::select(vertexc, zero, v);
+            w = O::select(vertexc, one, w);
+
+            auto vertexb = O::band(O::ge(d3, zero), O::le(d4, d3));
+            v = O::select(vertexb, one, v);
+            w = O::select(vertexb, zero, w);
+
+            auto vertexa = O::band(O::le(d1, zero), O::le(d2, zero));
+            v = O::select(vertexa, zero, v);
+            w = O::select(vertexa, zero, w);
+        }
+
+        template<typename O, typename T>
+        static inline closestvector<O> closestload(const vec3<T>& v) noexcept
+        {
+            return { O::set1(v.x), O::set1(v.y), O::set1(v.z) };
+        }
+
+        // Lane i gets *v[i]
+        template<typename O, typename T>
+        static inline closestvector<O> closestload(const vec3<T>* const (&v)[O::lanes]) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                return closestload<O>(*v[0]);
+            }
+            else
+            {
+                const T* p[O::lanes];
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    p[l] = v[l]->v;
+                }
+
+                closestvector<O> r;
+                typename O::type unused;
+                O::load4(p, r.x, r.y, r.z, unused);
+
+                return r;
+            }
+        }
+
+        // Squared distances from p to the primitives first .. first + lanes - 1, vertex(i, k)
+        // returns vertex k of primitive i
+        template<typename O, size_t K, typename T, typename F>
+        static inline typename O::type closestlanes(const closestvector<O>& p, size_t first, const F& vertex) noexcept
+        {
+            typedef typename O::type R;
+
+            closestvector<O> c[K];
+            for (size_t k = 0; k < K; k++)
+            {
+                const vec3<T>* v[O::lanes];
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    v[l] = &vertex(first + l, k);
+                }
+
+                c[k] = closestload<O>(v);
+            }
+
+            closestvector<O> q;
+            if constexpr (K == 2)
+            {
+                R t = closestsegmentparameter(p, c[0], c[1]);
+
+                q.x = O::madd(t, O::sub(c[1].x, c[0].x), c[0].x);
+                q.y = O::madd(t, O::sub(c[1].y, c[0].y), c[0].y);
+                q.z = O::madd(t, O::sub(c[1].z, c[0].z), c[0].z);
+            }
+            else
+            {
+                R v, w;
+                closesttriangleweights(p, c[0], c[1], c[2], v, w);
+
+                q.x = O::madd(v, O::sub(c[1].x, c[0].x), O::madd(w, O::sub(c[2].x, c[0].x), c[0].x));
+                q.y = O::madd(v, O::sub(c[1].y, c[0].y), O::madd(w, O::sub(c[2].y, c[0].y), c[0].y));
+                q.z = O::madd(v, O::sub(c[1].z, c[0].z), O::madd(w, O::sub(c[2].z, c[0].z), c[0].z));
+            }
+
+            closestvector<O> d = p - q;
+            return d.dot(d);
+        }
+
+        template<typename O, size_t K, typename T, typename F>
+        static inline void closestblock(const closestvector<O>& p, size_t i, const F& vertex, size_t& best, T& bestdistsq) noexcept
+        {
+            typename O::type dsq = closestlanes<O, K, T>(p, i, vertex);
+            s32 bits = O::movemask(O::lt(dsq, O::set1(bestdistsq)));
+
+            if (bits == 0)
+                return;
+
+            T d[O::lanes];
+            O::store(d, dsq);
+
+            for (size_t l = 0; l < O::lanes; l++)
+            {
+                if ((bits & (1 << l)) && d[l] < bestdistsq)
+                {
+                    bestdistsq = d[l];
+                    best = i + l;
+                }
+            }
+        }
+
+        // Index of the primitive closest to p, count if there are none
+        template<size_t K, typename T, typename F>
+        static inline size_t closestarray(const vec3<T>& p, size_t count, const F& vertex, T& bestdistsq) noexcept
+        {
+            size_t best = count;
+            bestdistsq = std::numeric_limits<T>::infinity();
+
+            size_t i = 0;
+
+#if SML_AVX
+            if constexpr (simdwide<T>::value)
+            {
+                typedef wide<T> O;
+                closestvector<O> wp = closestload<O>(p);
+
+                for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+                {
+                    closestblock<O, K>(wp, i, vertex, best, bestdistsq);
+                }
+            }
+#endif
+
+            closestvector<narrow<T>> np = closestload<narrow<T>>(p);
+
+            for (; i < count; i++)
+            {
+                closestblock<narrow<T>, K>(np, i, vertex, best, bestdistsq);
+            }
+
+            return best;
+        }
+    } // namespace detail
+
+    // Point on segment ab closest to p
+    template<typename T>
+    SML_NO_DISCARD inline vec3<T> closestpointsegment(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b) noexcept
+    {
+        typedef narrow<T> O;
+        T t = detail::closestsegmentparameter(detail::closestload<O>(p), detail::closestload<O>(a), detail::closestload<O>(b));
+
+        return a + (b - a) * t;
+    }
+
+    // Point on triangle abc closest to p
+    template<typename T>
+    SML_NO_DISCARD inline vec3<T> closestpointtriangle(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b, const vec3<T>& c) noexcept
+    {
+        typedef narrow<T> O;
+        T v, w;
+        detail::closesttriangleweights(detail::closestload<O>(p), detail::closestload<O>(a), detail::closestload<O>(b), detail::closestload<O>(c), v, w);
+
+        return a + (b - a) * v + (c - a) * w;
+    }
+
+    // Point in the box [min, max] closest to p, p itself when it is inside
+    template<typename T>
+    SML_NO_DISCARD inline vec3<T> closestpointaabb(const vec3<T>& p, const vec3<T>& min, const vec3<T>& max) noexcept
+    {
+        return vec3<T>(sml::clamp(p.x, min.x, max.x), sml::clamp(p.y, min.y, max.y), sml::clamp(p.z, min.z, max.z));
+    }
+
+    // Closest points between segments p0 p1 and q0 q1, written to onp and onq, returns their
+    // distance squared. Parallel segments pick one of the closest pairs.
+    template<typename T>
+    inline T closestpointssegments(const vec3<T>& p0, const vec3<T>& p1, const vec3<T>& q0, const vec3<T>& q1, vec3<T>& onp, vec3<T>& onq) noexcept
+    {
+        const T epsilon = std::numeric_limits<T>::epsilon();
+        const T zero = static_cast<T>(0), one = static_cast<T>(1);
+
+        vec3<T> d1 = p1 - p0, d2 = q1 - q0, r = p0 - q0;
+        T a = d1.dot(d1), e = d2.dot(d2), f = d2.dot(r);
+        T s, t;
+
+        if (a <= epsilon && e <= epsilon)
+        {
+            s = t = zero;
+        }
+        else if (a <= epsilon)
+        {
+            s = zero;
+            t = sml::clamp(f / e, zero, one);
+        }
+        else
+        {
+            T c = d1.dot(r);
+
+            if (e <= epsilon)
+            {
+                t = zero;
+                s = sml::clamp(-c / a, zero, one);
+            }
+            else
+            {
+                T b = d1.dot(d2);
+                T denominator = a * e - b * b;
+
+                // Closest point on the infinite lines, clamped to p0 p1, any s works for parallel lines
+                s = denominator > zero ? sml::clamp((b * f - c * e) / denominator, zero, one) : zero;
+                t = (b * s + f) / e;
+
+                // t outside q0 q1, clamp it and recompute s for the clamped t
+                if (t < zero)
+                {
+                    t = zero;
+                    s = sml::clamp(-c / a, zero, one);
+                }
+                else if (t > one)
+                {
+                    t = one;
+                    s = sml::clamp((b - c) / a, zero, one);
+                }
+            }
+        }
+
+        onp = p0 + d1 * s;
+        onq = q0 + d2 * t;
+
+        vec3<T> d = onp - onq;
+        return d.dot(d);
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancesquaredsegment(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b) noexcept
+    {
+        vec3<T> d = p - closestpointsegment(p, a, b);
+        return d.dot(d);
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancesegment(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b) noexcept
+    {
+        return sml::sqrt(distancesquaredsegment(p, a, b));
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancesquaredtriangle(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b, const vec3<T>& c) noexcept
+    {
+        vec3<T> d = p - closestpointtriangle(p, a, b, c);
+        return d.dot(d);
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancetriangle(const vec3<T>& p, const vec3<T>& a, const vec3<T>& b, const vec3<T>& c) noexcept
+    {
+        return sml::sqrt(distancesquaredtriangle(p, a, b, c));
+    }
+
+    // Zero inside the box
+    template<typename T>
+    SML_NO_DISCARD inline T distancesquaredaabb(const vec3<T>& p, const vec3<T>& min, const vec3<T>& max) noexcept
+    {
+        vec3<T> d = p - closestpointaabb(p, min, max);
+        return d.dot(d);
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distanceaabb(const vec3<T>& p, const vec3<T>& min, const vec3<T>& max) noexcept
+    {
+        return sml::sqrt(distancesquaredaabb(p, min, max));
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancesquaredsegments(const vec3<T>& p0, const vec3<T>& p1, const vec3<T>& q0, const vec3<T>& q1) noexcept
+    {
+        vec3<T> onp, onq;
+        return closestpointssegments(p0, p1, q0, q1, onp, onq);
+    }
+
+    template<typename T>
+    SML_NO_DISCARD inline T distancesegments(const vec3<T>& p0, const vec3<T>& p1, const vec3<T>& q0, const vec3<T>& q1) noexcept
+    {
+        return sml::sqrt(distancesquaredsegments(p0, p1, q0, q1));
+    }
+
+    // The array forms below find the primitive closest to one point, 8 (f32) or 4 (f64) at a time
+    // on the AVX backends. They return its index, or count when there are none, and optionally
+    // write its closest point and distance squared.
+
+    // Triangles given as 3 vertices each, or as 3 indices each into vertices when indices isn't
+    // null
+    template<typename T>
+    inline size_t closesttriangle(const vec3<T>& p, const vec3<T>* vertices, const u32* indices, size_t count, vec3<T>* closest = nullptr, T* distsq = nullptr) noexcept
+    {
+        T best;
+        size_t index;
+
+        if (indices)
+        {
+            index = detail::closestarray<3>(p, count, [&](size_t i, size_t k) -> const vec3<T>& { return vertices[indices[i * 3 + k]]; }, best);
+        }
+        else
+        {
+            index = detail::closestarray<3>(p, count, [&](size_t i, size_t k) -> const vec3<T>& { return vertices[i * 3 + k]; }, best);
+        }
+
+        if (closest && index < count)
+        {
+            size_t a = indices ? indices[index * 3 + 0] : index * 3 + 0;
+            size_t b = indices ? indices[index * 3 + 1] : index * 3 + 1;
+            size_t c = indices ? indices[index * 3 + 2] : index * 3 + 2;
+
+            *closest = closestpointtriangle(p, vertices[a], vertices[b], vertices[c]);
+        }
+
+        if (distsq)
+            *distsq = best;
+
+        return index;
+    }
+
+    // Segments given as 2 endpoints each
+    template<typename T>
+    inline size_t closestsegment(const vec3<T>& p, const vec3<T>* endpoints, size_t count, vec3<T>* closest = nullptr, T* distsq = nullptr) noexcept
+    {
+        T best;
+        size_t index = detail::closestarray<2>(p, count, [&](size_t i, size_t k) -> const vec3<T>& { return endpoints[i * 2 + k]; }, best);
+
+        if (closest && index < count)
+            *closest = closestpointsegment(p, endpoints[index * 2], endpoints[index * 2 + 1]);
+
+        if (distsq)
+            *distsq = best;
+
+        return index;
+    }
+
+    // Squared distance of every point to the box [min, max]
+    template<typename T>
+    inline void distancesquaredaabb(const vec3<T>* points, size_t count, const vec3<T>& min, const vec3<T>& max, T* out) noexcept
+    {
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> O;
+            typedef typename O::type R;
+
+            const R lo[3] = { O::set1(min.x), O::set1(min.y), O::set1(min.z) };
+            const R hi[3] = { O::set1(max.x), O::set1(max.y), O::set1(max.z) };
+
+            for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+            {
+                R c[4];
+                O::load4(points[i].v, sizeof(vec3<T>) / sizeof(T), c[0], c[1], c[2], c[3]);
+
+                R dsq = O::zero();
+                for (size_t k = 0; k < 3; k++)
+                {
+                    // Outside on either side, zero inside
+                    R d = O::add(O::max(O::sub(lo[k], c[k]), O::zero()), O::max(O::sub(c[k], hi[k]), O::zero()));
+                    dsq = O::madd(d, d, dsq);
+                }
+
+                O::store(out + i, dsq);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            out[i] = distancesquaredaabb(points[i], min, max);
+        }
+    }
+SML_NAMESPACE_END
+
+#endif // sml_closest_h__
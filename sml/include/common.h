@@ -38,8 +38,7 @@ namespace constants
 	static inline constexpr f32 rad2deg = 1.0f / deg2rad;
 } // namespace constants
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
 	// Common math functions
 	template <typename T>
 	static inline T sin(T v)
@@ -227,6 +226,57 @@ namespace sml
 
 		return angle;
 	}
-} // namespace sml
+
+	// SIMD helpers
+	namespace detail
+	{
+		// 1 / sqrt(v) from the hardware estimate refined with one Newton-Raphson step,
+		// r' = 0.5 * r * (3 - v * r * r). rsqrtps has a relative error of at most 1.5 * 2^-12,
+		// after the step the error is below 2^-21 (rsqrt14 starts at 2^-14 and ends within a few ulp).
+#if SML_SSE
+		static inline __m128 rsqrtnr(__m128 v) noexcept
+		{
+			__m128 r = _mm_rsqrt_ps(v);
+			__m128 vrr = _mm_mul_ps(_mm_mul_ps(v, r), r);
+
+			return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), vrr));
+		}
+#endif
+
+#if SML_AVX
+		static inline __m256 rsqrtnr(__m256 v) noexcept
+		{
+			__m256 r = _mm256_rsqrt_ps(v);
+			__m256 vrr = _mm256_mul_ps(_mm256_mul_ps(v, r), r);
+
+			return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), r), _mm256_sub_ps(_mm256_set1_ps(3.0f), vrr));
+		}
+#endif
+
+#if SML_AVX512
+		static inline __m512 rsqrtnr(__m512 v) noexcept
+		{
+			__m512 r = _mm512_rsqrt14_ps(v);
+			__m512 vrr = _mm512_mul_ps(_mm512_mul_ps(v, r), r);
+
+			return _mm512_mul_ps(_mm512_mul_ps(_mm512_set1_ps(0.5f), r), _mm512_sub_ps(_mm512_set1_ps(3.0f), vrr));
+		}
+
+		// rsqrt14 plus two steps, 2^-14 -> 2^-28 -> double precision
+		static inline __m512d rsqrtnr(__m512d v) noexcept
+		{
+			__m512d r = _mm512_rsqrt14_pd(v);
+
+			for (s32 i = 0; i < 2; i++)
+			{
+				__m512d vrr = _mm512_mul_pd(_mm512_mul_pd(v, r), r);
+				r = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(0.5), r), _mm512_sub_pd(_mm512_set1_pd(3.0), vrr));
+			}
+
+			return r;
+		}
+#endif
+	} // namespace detail
+SML_NAMESPACE_END
 
 #endif // sml_common_h__
\ No newline at end of file
@@ -51,7 +51,7 @@ namespace sml
 	};
 
 	/// Current version.
-	smlVersion version = { 0, 1, 0 };
+	inline smlVersion version = { 0, 1, 0 };
 } // namespace sml
 
 #endif // sml_config_h__
\ No newline at end of file
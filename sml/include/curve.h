@@ -0,0 +1,344 @@
+#ifndef sml_curve_h__
+#define sml_curve_h__
+
+/* curve.h -- cubic curves of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <vector>
+
+#include "common.h"
+#include "smltypes.h"
+#include "simd.h"
+#include "mask.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        // Horner evaluation of the components of a cubic, components past n stay zero
+        template<typename O, size_t N>
+        static inline void curvehorner(const typename O::type (&c)[4][4], typename O::type t, typename O::type (&out)[4]) noexcept
+        {
+            for (size_t k = 0; k < 4; k++)
+            {
+                out[k] = k < N ? O::madd(O::madd(O::madd(c[3][k], t, c[2][k]), t, c[1][k]), t, c[0][k]) : O::zero();
+            }
+        }
+    } // namespace detail
+
+    // Cubic polynomial curve c0 + c1 t + c2 t^2 + c3 t^3 over vec2, vec3 or vec4, for t in [0, 1].
+    // Bezier, Hermite and Catmull-Rom segments are all converted to this power basis, so they share
+    // the evaluation, tessellation and flattening below.
+    template<template<typename> class V, typename T>
+    class alignas(simdalign<T>::value) cubiccurve
+    {
+        public:
+            static constexpr size_t dimensions = veclanes<V>::value;
+
+            constexpr cubiccurve() noexcept
+            {
+            }
+
+            constexpr cubiccurve(const V<T>& c0, const V<T>& c1, const V<T>& c2, const V<T>& c3) noexcept
+            {
+                coefficients[0] = c0;
+                coefficients[1] = c1;
+                coefficients[2] = c2;
+                coefficients[3] = c3;
+            }
+
+            // Functions
+            SML_NO_DISCARD inline constexpr V<T> evaluate(T t) const noexcept
+            {
+                return ((coefficients[3] * t + coefficients[2]) * t + coefficients[1]) * t + coefficients[0];
+            }
+
+            SML_NO_DISCARD inline constexpr V<T> derivative(T t) const noexcept
+            {
+                return (coefficients[3] * (static_cast<T>(3) * t) + coefficients[2] * static_cast<T>(2)) * t + coefficients[1];
+            }
+
+            SML_NO_DISCARD inline constexpr V<T> secondderivative(T t) const noexcept
+            {
+                return coefficients[3] * (static_cast<T>(6) * t) + coefficients[2] * static_cast<T>(2);
+            }
+
+            // The derivative as a curve (with a zero cubic term), for evaluating it at many t
+            SML_NO_DISCARD inline constexpr cubiccurve derivativecurve() const noexcept
+            {
+                return cubiccurve(coefficients[1], coefficients[2] * static_cast<T>(2), coefficients[3] * static_cast<T>(3), V<T>());
+            }
+
+            // Bezier control points of the same curve
+            inline constexpr void bezierpoints(V<T>& p0, V<T>& p1, V<T>& p2, V<T>& p3) const noexcept
+            {
+                const T third = static_cast<T>(1) / static_cast<T>(3);
+
+                p0 = coefficients[0];
+                p1 = coefficients[0] + coefficients[1] * third;
+                p2 = p1 + (coefficients[1] + coefficients[2]) * third;
+                p3 = coefficients[0] + coefficients[1] + coefficients[2] + coefficients[3];
+            }
+
+            // Evaluates the curve at t[0..count), 8 (f32) or 4 (f64) parameters at a time on the AVX
+            // backends
+            inline void evaluate(const T* t, size_t count, V<T>* out) const noexcept
+            {
+                size_t i = 0;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> O;
+                    typedef typename O::type R;
+                    constexpr size_t stride = sizeof(V<T>) / sizeof(T);
+
+                    R c[4][4];
+
+                    for (size_t j = 0; j < 4; j++)
+                    {
+                        for (size_t k = 0; k < 4; k++)
+                        {
+                            c[j][k] = O::set1(k < dimensions ? coefficients[j].v[k] : static_cast<T>(0));
+                        }
+                    }
+
+                    for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+                    {
+                        R r[4];
+                        detail::curvehorner<O, dimensions>(c, O::load(t + i), r);
+
+                        O::store4(out[i].v, stride, r[0], r[1], r[2], r[3]);
+                    }
+                }
+#endif
+
+                for (; i < count; i++)
+                {
+                    out[i] = evaluate(t[i]);
+                }
+            }
+
+            inline void derivative(const T* t, size_t count, V<T>* out) const noexcept
+            {
+                derivativecurve().evaluate(t, count, out);
+            }
+
+            // Writes count points at uniform steps from t = 0 to t = 1 by forward differencing, three
+            // additions per point. The differences are recomputed every 64 points so the rounding
+            // drift stays small in f32.
+            inline void tessellate(size_t count, V<T>* out) const noexcept
+            {
+                if (count < 2)
+                {
+                    if (count == 1)
+                        out[0] = coefficients[0];
+
+                    return;
+                }
+
+                const size_t restart = 64;
+                const T h = static_cast<T>(1) / static_cast<T>(count - 1);
+                const T hh = h * h, hhh = hh * h;
+                const V<T> d3 = coefficients[3] * (static_cast<T>(6) * hhh);
+
+                for (size_t start = 0; start < count; start += restart)
+                {
+                    T t = static_cast<T>(start) * h;
+                    V<T> p = evaluate(t);
+                    V<T> d1 = coefficients[1] * h + coefficients[2] * (static_cast<T>(2) * t * h + hh) + coefficients[3] * (static_cast<T>(3) * (t * t * h + t * hh) + hhh);
+                    V<T> d2 = coefficients[2] * (static_cast<T>(2) * hh) + coefficients[3] * (static_cast<T>(6) * (t * hh + hhh));
+
+                    for (size_t i = start, end = sml::min(start + restart, count); i < end; i++)
+                    {
+                        out[i] = p;
+                        p += d1;
+                        d1 += d2;
+                        d2 += d3;
+                    }
+                }
+
+                out[count - 1] = evaluate(static_cast<T>(1));
+            }
+
+            // Appends points along the curve from t = 0 to t = 1 so the straight segments between them
+            // stay within tolerance of it, and their parameters when asked for. The curve is split in
+            // halves until the control polygon is flat enough, at most 16 times.
+            inline void flatten(T tolerance, std::vector<V<T>>& points, std::vector<T>* parameters = nullptr) const
+            {
+                struct piece
+                {
+                    V<T> p[4];
+                    T t0, t1;
+                    u32 depth;
+                };
+
+                const u32 maxdepth = 16;
+                const T limit = static_cast<T>(16) * tolerance * tolerance;
+                const T half = static_cast<T>(0.5);
+
+                piece stack[maxdepth + 1];
+                size_t top = 0;
+
+                piece& first = stack[top++];
+                bezierpoints(first.p[0], first.p[1], first.p[2], first.p[3]);
+                first.t0 = static_cast<T>(0);
+                first.t1 = static_cast<T>(1);
+                first.depth = 0;
+
+                points.push_back(first.p[0]);
+
+                if (parameters)
+                    parameters->push_back(static_cast<T>(0));
+
+                while (top > 0)
+                {
+                    piece current = stack[--top];
+
+                    // Bound on the distance between the curve and its chord, per component
+                    V<T> u = current.p[1] * static_cast<T>(3) - current.p[0] * static_cast<T>(2) - current.p[3];
+                    V<T> v = current.p[2] * static_cast<T>(3) - current.p[0] - current.p[3] * static_cast<T>(2);
+                    T flatness = static_cast<T>(0);
+
+                    for (size_t k = 0; k < dimensions; k++)
+                    {
+                        flatness += sml::max(u.v[k] * u.v[k], v.v[k] * v.v[k]);
+                    }
+
+                    if (flatness <= limit || current.depth == maxdepth)
+                    {
+                        points.push_back(current.p[3]);
+
+                        if (parameters)
+                            parameters->push_back(current.t1);
+
+                        continue;
+                    }
+
+                    // De Casteljau split, the right half is pushed first so the left half comes out first
+                    V<T> p01 = (current.p[0] + current.p[1]) * half;
+                    V<T> p12 = (current.p[1] + current.p[2]) * half;
+                    V<T> p23 = (current.p[2] + current.p[3]) * half;
+                    V<T> p012 = (p01 + p12) * half;
+                    V<T> p123 = (p12 + p23) * half;
+                    V<T> middle = (p012 + p123) * half;
+                    T t = (current.t0 + current.t1) * half;
+
+                    piece& right = stack[top++];
+                    right.p[0] = middle;
+                    right.p[1] = p123;
+                    right.p[2] = p23;
+                    right.p[3] = current.p[3];
+                    right.t0 = t;
+                    right.t1 = current.t1;
+                    right.depth = current.depth + 1;
+
+                    piece& left = stack[top++];
+                    left.p[0] = current.p[0];
+                    left.p[1] = p01;
+                    left.p[2] = p012;
+                    left.p[3] = middle;
+                    left.t0 = current.t0;
+                    left.t1 = t;
+                    left.depth = current.depth + 1;
+                }
+            }
+
+            // Statics
+            SML_NO_DISCARD inline static constexpr cubiccurve bezier(const V<T>& p0, const V<T>& p1, const V<T>& p2, const V<T>& p3) noexcept
+            {
+                const T three = static_cast<T>(3);
+
+                return cubiccurve(p0, (p1 - p0) * three, (p0 - p1 * static_cast<T>(2) + p2) * three, p3 - p0 + (p1 - p2) * three);
+            }
+
+            // From p0 with tangent m0 to p1 with tangent m1
+            SML_NO_DISCARD inline static constexpr cubiccurve hermite(const V<T>& p0, const V<T>& m0, const V<T>& p1, const V<T>& m1) noexcept
+            {
+                const T two = static_cast<T>(2), three = static_cast<T>(3);
+
+                return cubiccurve(p0, m0, (p1 - p0) * three - m0 * two - m1, (p0 - p1) * two + m0 + m1);
+            }
+
+            // Uniform Catmull-Rom segment from p1 to p2, with p0 and p3 the neighbouring points
+            SML_NO_DISCARD inline static constexpr cubiccurve catmullrom(const V<T>& p0, const V<T>& p1, const V<T>& p2, const V<T>& p3) noexcept
+            {
+                const T half = static_cast<T>(0.5);
+
+                return hermite(p1, (p2 - p0) * half, p2, (p3 - p1) * half);
+            }
+
+            // Variables
+            V<T> coefficients[4];
+    };
+
+    // Predefined types
+    typedef cubiccurve<vec2, f32> fcurve2;
+    typedef cubiccurve<vec2, f64> dcurve2;
+    typedef cubiccurve<vec3, f32> fcurve3;
+    typedef cubiccurve<vec3, f64> dcurve3;
+    typedef cubiccurve<vec4, f32> fcurve4;
+    typedef cubiccurve<vec4, f64> dcurve4;
+
+    // Evaluates curves[i] at t[i], for many curves that each need one point
+    template<template<typename> class V, typename T>
+    inline void evaluate(const cubiccurve<V, T>* curves, const T* t, size_t count, V<T>* out) noexcept
+    {
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> O;
+            typedef typename O::type R;
+            constexpr size_t stride = sizeof(V<T>) / sizeof(T);
+
+            for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+            {
+                R c[4][4];
+
+                for (size_t j = 0; j < 4; j++)
+                {
+                    const T* p[O::lanes];
+
+                    for (size_t l = 0; l < O::lanes; l++)
+                    {
+                        p[l] = curves[i + l].coefficients[j].v;
+                    }
+
+                    O::load4(p, c[j][0], c[j][1], c[j][2], c[j][3]);
+                }
+
+                R r[4];
+                detail::curvehorner<O, veclanes<V>::value>(c, O::load(t + i), r);
+
+                O::store4(out[i].v, stride, r[0], r[1], r[2], r[3]);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            out[i] = curves[i].evaluate(t[i]);
+        }
+    }
+SML_NAMESPACE_END
+
+#endif // sml_curve_h__
@@ -0,0 +1,224 @@
+#ifndef sml_divider_h__
+#define sml_divider_h__
+
+/* divider.h -- integer division by invariant divisors of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "smltypes.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+SML_NAMESPACE_BEGIN
+    // Division of 32 bit integers by a divisor that is known ahead of time.
+    // The divisor is turned into a multiply-high and shift (Granlund & Montgomery), which
+    // unlike integer division has a SIMD form. Signed division truncates towards zero like '/'.
+    template<typename T>
+    class intdivider
+    {
+        static_assert(simdint<T>::value, "intdivider only supports s32 and u32");
+
+        public:
+            constexpr explicit intdivider(T divisor) noexcept
+            {
+                set(divisor);
+            }
+
+            constexpr void set(T divisor) noexcept
+            {
+                this->divisor = divisor;
+
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    // l = ceil(log2(d)), m = 2^32 * (2^l - d) / d + 1
+                    u32 l = 0;
+                    while (l < 32 && (1ULL << l) < divisor)
+                        l++;
+
+                    magic = static_cast<u32>((((1ULL << l) - divisor) << 32) / divisor + 1);
+                    shift1 = l < 1 ? l : 1;
+                    shift2 = l > 0 ? l - 1 : 0;
+                }
+                else
+                {
+                    // l = max(ceil(log2(|d|)), 1), m = 1 + 2^(31 + l) / |d| - 2^32
+                    u32 absolute = divisor < 0 ? 0U - static_cast<u32>(divisor) : static_cast<u32>(divisor);
+
+                    u32 l = 0;
+                    while (l < 32 && (1ULL << l) < absolute)
+                        l++;
+
+                    if (l < 1)
+                        l = 1;
+
+                    magic = static_cast<u32>(1 + (1ULL << (31 + l)) / absolute);
+                    shift1 = 0;
+                    shift2 = l - 1;
+                    sign = divisor < 0 ? -1 : 0;
+                }
+            }
+
+            SML_NO_DISCARD inline constexpr T value() const noexcept
+            {
+                return divisor;
+            }
+
+            SML_NO_DISCARD inline constexpr T divide(T n) const noexcept
+            {
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    u32 t = static_cast<u32>((static_cast<uint64_t>(magic) * n) >> 32);
+
+                    return (t + ((n - t) >> shift1)) >> shift2;
+                }
+                else
+                {
+                    s32 t = static_cast<s32>((static_cast<int64_t>(static_cast<s32>(magic)) * n) >> 32);
+
+                    // n + t wraps for n near INT_MIN, so it's done in u32 like the SIMD paths do, with
+                    // the arithmetic shift spelled out
+                    u32 sum = static_cast<u32>(n) + static_cast<u32>(t);
+                    u32 fill = 0u - (sum >> 31);
+                    u32 q = ((sum >> shift2) | (fill ^ (fill >> shift2))) + (static_cast<u32>(n) >> 31);
+                    u32 s = static_cast<u32>(sign);
+
+                    return static_cast<s32>((q ^ s) - s);
+                }
+            }
+
+#if SML_SSE
+            SML_NO_DISCARD inline __m128i divide(__m128i n) const noexcept
+            {
+                __m128i m = _mm_set1_epi32(static_cast<s32>(magic));
+
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i even = _mm_srli_epi64(_mm_mul_epu32(n, m), 32);
+                    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(n, 32), m);
+                    __m128i t = _mm_blend_epi16(even, odd, 0xCC);
+
+                    __m128i q = _mm_add_epi32(t, _mm_srl_epi32(_mm_sub_epi32(n, t), _mm_cvtsi32_si128(shift1)));
+
+                    return _mm_srl_epi32(q, _mm_cvtsi32_si128(shift2));
+                }
+                else
+                {
+                    __m128i even = _mm_srli_epi64(_mm_mul_epi32(n, m), 32);
+                    __m128i odd = _mm_mul_epi32(_mm_srli_epi64(n, 32), m);
+                    __m128i t = _mm_blend_epi16(even, odd, 0xCC);
+
+                    __m128i q = _mm_sra_epi32(_mm_add_epi32(n, t), _mm_cvtsi32_si128(shift2));
+                    q = _mm_sub_epi32(q, _mm_srai_epi32(n, 31));
+
+                    __m128i s = _mm_set1_epi32(sign);
+
+                    return _mm_sub_epi32(_mm_xor_si128(q, s), s);
+                }
+            }
+#endif
+
+#if SML_AVX2
+            SML_NO_DISCARD inline __m256i divide(__m256i n) const noexcept
+            {
+                __m256i m = _mm256_set1_epi32(static_cast<s32>(magic));
+
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(n, m), 32);
+                    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(n, 32), m);
+                    __m256i t = _mm256_blend_epi32(even, odd, 0xAA);
+
+                    __m256i q = _mm256_add_epi32(t, _mm256_srl_epi32(_mm256_sub_epi32(n, t), _mm_cvtsi32_si128(shift1)));
+
+                    return _mm256_srl_epi32(q, _mm_cvtsi32_si128(shift2));
+                }
+                else
+                {
+                    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(n, m), 32);
+                    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(n, 32), m);
+                    __m256i t = _mm256_blend_epi32(even, odd, 0xAA);
+
+                    __m256i q = _mm256_sra_epi32(_mm256_add_epi32(n, t), _mm_cvtsi32_si128(shift2));
+                    q = _mm256_sub_epi32(q, _mm256_srai_epi32(n, 31));
+
+                    __m256i s = _mm256_set1_epi32(sign);
+
+                    return _mm256_sub_epi32(_mm256_xor_si256(q, s), s);
+                }
+            }
+#endif
+
+        private:
+            T divisor = static_cast<T>(1);
+            u32 magic = 0;
+            s32 shift1 = 0;
+            s32 shift2 = 0;
+            s32 sign = 0;
+    };
+
+    // Operators
+    template<typename T>
+    constexpr T operator / (T left, const intdivider<T>& right) noexcept
+    {
+        return right.divide(left);
+    }
+
+    template<typename T>
+    vec2<T> operator / (const vec2<T>& left, const intdivider<T>& right) noexcept
+    {
+#if SML_SSE
+        vec2<T> res;
+        _mm_store_si128(reinterpret_cast<__m128i*>(res.v), right.divide(_mm_load_si128(reinterpret_cast<const __m128i*>(left.v))));
+
+        return res;
+#else
+        return vec2<T>(right.divide(left.x), right.divide(left.y));
+#endif
+    }
+
+    template<typename T>
+    vec3<T> operator / (const vec3<T>& left, const intdivider<T>& right) noexcept
+    {
+#if SML_SSE
+        vec3<T> res;
+        _mm_store_si128(reinterpret_cast<__m128i*>(res.v), right.divide(_mm_load_si128(reinterpret_cast<const __m128i*>(left.v))));
+
+        return res;
+#else
+        return vec3<T>(right.divide(left.x), right.divide(left.y), right.divide(left.z));
+#endif
+    }
+
+    template<typename T>
+    vec4<T> operator / (const vec4<T>& left, const intdivider<T>& right) noexcept
+    {
+#if SML_SSE
+        vec4<T> res;
+        _mm_store_si128(reinterpret_cast<__m128i*>(res.v), right.divide(_mm_load_si128(reinterpret_cast<const __m128i*>(left.v))));
+
+        return res;
+#else
+        return vec4<T>(right.divide(left.x), right.divide(left.y), right.divide(left.z), right.divide(left.w));
+#endif
+    }
+
+    // Predefined types
+    typedef intdivider<s32> idivider;
+    typedef intdivider<u32> udivider;
+SML_NAMESPACE_END
+
+#endif // sml_divider_h__
@@ -0,0 +1,333 @@
+#ifndef sml_dualquat_h__
+#define sml_dualquat_h__
+
+/* dualquat.h -- dual quaternion implementation of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "common.h"
+#include "smltypes.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "quat.h"
+
+SML_NAMESPACE_BEGIN
+    // Rigid transform (rotation followed by translation) as real + dual * e. A unit dual
+    // quaternion has a unit real part that is orthogonal to the dual part, the real part is the
+    // rotation and the dual part is 0.5 * translation * rotation. Scale can't be represented.
+    template<typename T>
+    class alignas(simdalign<T>::value) dualquat
+    {
+        public:
+            constexpr dualquat() noexcept
+            {
+                real.set(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
+                dual.set(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0));
+            }
+
+            constexpr dualquat(const quat<T>& real, const quat<T>& dual) noexcept
+            {
+                set(real, dual);
+            }
+
+            constexpr dualquat(const quat<T>& rotation, const vec3<T>& translation) noexcept
+            {
+                set(rotation, translation);
+            }
+
+            constexpr dualquat(const dualquat& other) noexcept
+            {
+                set(other.real, other.dual);
+            }
+
+            constexpr void set(const quat<T>& real, const quat<T>& dual) noexcept
+            {
+                this->real = real;
+                this->dual = dual;
+            }
+
+            constexpr void set(const quat<T>& rotation, const vec3<T>& translation) noexcept
+            {
+                real = rotation;
+                dual = quat<T>(translation.x, translation.y, translation.z, static_cast<T>(0)) * rotation;
+                dual *= static_cast<T>(0.5);
+            }
+
+            // Operators
+            inline constexpr bool operator == (const dualquat& other) const noexcept
+            {
+                return real.v == other.real.v && dual.v == other.dual.v;
+            }
+
+            inline constexpr bool operator != (const dualquat& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            constexpr dualquat& operator = (const dualquat& other) noexcept
+            {
+                set(other.real, other.dual);
+
+                return *this;
+            }
+
+            dualquat& operator += (const dualquat& other) noexcept
+            {
+                real += other.real;
+                dual += other.dual;
+
+                return *this;
+            }
+
+            dualquat& operator -= (const dualquat& other) noexcept
+            {
+                real -= other.real;
+                dual -= other.dual;
+
+                return *this;
+            }
+
+            // Applies other first, then this transform
+            dualquat& operator *= (const dualquat& other) noexcept
+            {
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    __m128 ar = _mm_load_ps(real.v.v);
+                    __m128 ad = _mm_load_ps(dual.v.v);
+                    __m128 br = _mm_load_ps(other.real.v.v);
+                    __m128 bd = _mm_load_ps(other.dual.v.v);
+
+                    _mm_store_ps(real.v.v, detail::quatmul(ar, br));
+                    _mm_store_ps(dual.v.v, _mm_add_ps(detail::quatmul(ar, bd), detail::quatmul(ad, br)));
+
+                    return *this;
+                }
+#endif
+
+                quat<T> r = real * other.real;
+                quat<T> d = (real * other.dual) + (dual * other.real);
+
+                set(r, d);
+
+                return *this;
+            }
+
+            dualquat& operator *= (const T other) noexcept
+            {
+                real *= other;
+                dual *= other;
+
+                return *this;
+            }
+
+            // Operations
+            // Scales to a unit real part and removes the component of the dual part along it
+            inline constexpr void normalize() noexcept
+            {
+                T lengthSq = real.lengthsquared();
+
+                if (lengthSq == static_cast<T>(0))
+                {
+                    *this = dualquat();
+                    return;
+                }
+
+                T inv = static_cast<T>(1) / sml::sqrt(lengthSq);
+                real *= inv;
+                dual *= inv;
+
+                T d = real.v.dot(dual.v);
+                dual -= quat<T>(real.x * d, real.y * d, real.z * d, real.w * d);
+            }
+
+            SML_NO_DISCARD inline constexpr dualquat normalized() const noexcept
+            {
+                dualquat res(*this);
+                res.normalize();
+
+                return res;
+            }
+
+            // Inverse of a unit dual quaternion
+            SML_NO_DISCARD inline constexpr dualquat conjugate() const noexcept
+            {
+                return dualquat(quat<T>(-real.x, -real.y, -real.z, real.w), quat<T>(-dual.x, -dual.y, -dual.z, dual.w));
+            }
+
+            SML_NO_DISCARD inline constexpr quat<T> rotation() const noexcept
+            {
+                return real;
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> translation() const noexcept
+            {
+                // 2 * dual * conjugate(real)
+                quat<T> t = dual * quat<T>(-real.x, -real.y, -real.z, real.w);
+
+                return vec3<T>(t.x + t.x, t.y + t.y, t.z + t.z);
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> transformPoint(const vec3<T>& point) const noexcept
+            {
+                return (real * point) + translation();
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> transformVector(const vec3<T>& vector) const noexcept
+            {
+                return real * vector;
+            }
+
+            SML_NO_DISCARD inline constexpr mat4<T> tomatrix4() const noexcept
+            {
+                return mat4<T>::compose(translation(), real, vec3<T>(static_cast<T>(1), static_cast<T>(1), static_cast<T>(1)));
+            }
+
+            inline constexpr void totrs(vec3<T>& translation, quat<T>& rotation) const noexcept
+            {
+                translation = this->translation();
+                rotation = real;
+            }
+
+            // Statics
+            SML_NO_DISCARD inline static constexpr dualquat identity() noexcept
+            {
+                return dualquat();
+            }
+
+            SML_NO_DISCARD inline static constexpr dualquat normalize(const dualquat& value) noexcept
+            {
+                return value.normalized();
+            }
+
+            // Rotation and translation of an affine matrix, scale and shear are dropped
+            SML_NO_DISCARD inline static constexpr dualquat frommatrix4(const mat4<T>& matrix) noexcept
+            {
+                vec3<T> translation, scale;
+                quat<T> rotation;
+
+                matrix.decompose(translation, rotation, scale);
+
+                return dualquat(rotation, translation);
+            }
+
+            SML_NO_DISCARD inline static constexpr dualquat fromtrs(const vec3<T>& translation, const quat<T>& rotation) noexcept
+            {
+                return dualquat(rotation, translation);
+            }
+
+            // Screw linear interpolation: constant speed rotation about and translation along the
+            // screw axis from a to b, taking the shortest arc
+            SML_NO_DISCARD inline static constexpr dualquat sclerp(const dualquat& a, const dualquat& b, T blend) noexcept
+            {
+                const T one = static_cast<T>(1);
+                const T half = static_cast<T>(0.5);
+
+                dualquat diff = a.conjugate() * b;
+
+                if (a.real.v.dot(b.real.v) < static_cast<T>(0))
+                {
+                    diff *= static_cast<T>(-1);
+                }
+
+                vec3<T> axis(diff.real.x, diff.real.y, diff.real.z);
+                T sinhalf = axis.length();
+
+                // Pure translation, interpolate the translation linearly
+                if (sinhalf < static_cast<T>(constants::epsilon))
+                {
+                    dualquat step(quat<T>::identity(), diff.translation() * blend);
+
+                    return (a * step).normalized();
+                }
+
+                T invsin = one / sinhalf;
+                T coshalf = sml::clamp(diff.real.w, -one, one);
+
+                // Screw parameters: angle, pitch (translation along the axis), direction and moment
+                T angle = static_cast<T>(2) * sml::atan2(sinhalf, coshalf);
+                T pitch = static_cast<T>(-2) * diff.dual.w * invsin;
+                vec3<T> direction = axis * invsin;
+                vec3<T> moment = (vec3<T>(diff.dual.x, diff.dual.y, diff.dual.z) - direction * (pitch * half * coshalf)) * invsin;
+
+                angle *= blend;
+                pitch *= blend;
+
+                T s = sml::sin(angle * half);
+                T c = sml::cos(angle * half);
+
+                vec3<T> r = direction * s;
+                vec3<T> d = moment * s + direction * (pitch * half * c);
+
+                dualquat step(quat<T>(r.x, r.y, r.z, c), quat<T>(d.x, d.y, d.z, -pitch * half * s));
+
+                return (a * step).normalized();
+            }
+
+            // Data
+            quat<T> real;
+            quat<T> dual;
+    };
+
+    // Operators
+    template<typename T>
+    constexpr dualquat<T> operator + (dualquat<T> left, const dualquat<T>& right) noexcept
+    {
+        left += right;
+
+        return left;
+    }
+
+    template<typename T>
+    constexpr dualquat<T> operator - (dualquat<T> left, const dualquat<T>& right) noexcept
+    {
+        left -= right;
+
+        return left;
+    }
+
+    template<typename T>
+    constexpr dualquat<T> operator * (dualquat<T> left, const dualquat<T>& right) noexcept
+    {
+        left *= right;
+
+        return left;
+    }
+
+    template<typename T>
+    constexpr dualquat<T> operator * (dualquat<T> left, T right) noexcept
+    {
+        left *= right;
+
+        return left;
+    }
+
+    template<typename T>
+    constexpr vec3<T> operator * (const dualquat<T>& left, const vec3<T>& right) noexcept
+    {
+        return left.transformPoint(right);
+    }
+
+    // Predefined types
+    typedef dualquat<f32> fdualquat;
+    typedef dualquat<f64> ddualquat;
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class dualquat<f32>)
+    SML_EXTERN_TEMPLATE(class dualquat<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_dualquat_h__
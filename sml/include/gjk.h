@@ -0,0 +1,792 @@
+#ifndef sml_gjk_h__
+#define sml_gjk_h__
+
+/* gjk.h -- GJK and EPA convex collision queries of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec3.h"
+#include "quat.h"
+
+// Distance, intersection and penetration depth between convex shapes given by support functions.
+// A support function is any callable taking a direction d and returning the point of the shape
+// furthest along d, d doesn't have to be normalized and can be zero.
+//
+// gjk() finds the distance and closest points between two shapes, or that they intersect, and
+// epa() expands the simplex of an intersecting pair into the penetration depth and normal. Both
+// take the simplex of the previous query of the same pair: its vertices are evaluated again along
+// the directions that found them, which for shapes that moved a little is usually close to the
+// answer already. A reset simplex starts from scratch.
+//
+// The built in support functions cover points clouds (convex hulls), spheres, boxes and capsules
+// in local space, transformedsupport places any of them in the world.
+
+SML_NAMESPACE_BEGIN
+    // Index of the vertex furthest along d, the first of them on ties. Evaluated 8 (f32) or 4 (f64)
+    // vertices at a time on the AVX backends, f32 hulls are limited to 2^24 vertices.
+    template<typename T>
+    SML_NO_DISCARD inline size_t maxdot(const vec3<T>* vertices, size_t count, const vec3<T>& d) noexcept
+    {
+        size_t best = 0;
+        T bestdot = -std::numeric_limits<T>::infinity();
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> O;
+            typedef typename O::type R;
+
+            if (count >= O::lanes)
+            {
+                R dx = O::set1(d.x), dy = O::set1(d.y), dz = O::set1(d.z);
+                R maximum = O::set1(-std::numeric_limits<T>::infinity());
+
+                // Vertex index per lane, kept as T so it can be selected along with the dot
+                T offsets[O::lanes];
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    offsets[l] = static_cast<T>(l);
+                }
+
+                R index = O::load(offsets), bestindex = O::zero(), step = O::set1(static_cast<T>(O::lanes));
+
+                for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+                {
+                    R x, y, z, w;
+                    O::load4(vertices[i].v, sizeof(vec3<T>) / sizeof(T), x, y, z, w);
+
+                    R dot = O::madd(x, dx, O::madd(y, dy, O::mul(z, dz)));
+                    R greater = O::gt(dot, maximum);
+
+                    maximum = O::select(greater, dot, maximum);
+                    bestindex = O::select(greater, index, bestindex);
+                    index = O::add(index, step);
+                }
+
+                T dots[O::lanes], indices[O::lanes];
+                O::store(dots, maximum);
+                O::store(indices, bestindex);
+
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    size_t at = static_cast<size_t>(indices[l]);
+
+                    if (dots[l] > bestdot || (dots[l] == bestdot && at < best))
+                    {
+                        bestdot = dots[l];
+                        best = at;
+                    }
+                }
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            T dot = vertices[i].dot(d);
+
+            if (dot > bestdot)
+            {
+                bestdot = dot;
+                best = i;
+            }
+        }
+
+        return best;
+    }
+
+    // Convex hull of a point cloud, the points don't have to be the hull's vertices only
+    template<typename T>
+    struct hullsupport
+    {
+        const vec3<T>* vertices;
+        size_t count;
+
+        SML_NO_DISCARD inline vec3<T> operator()(const vec3<T>& d) const noexcept
+        {
+            return vertices[maxdot(vertices, count, d)];
+        }
+    };
+
+    template<typename T>
+    struct spheresupport
+    {
+        vec3<T> center;
+        T radius;
+
+        SML_NO_DISCARD inline vec3<T> operator()(const vec3<T>& d) const noexcept
+        {
+            T length = d.length();
+
+            if (length <= static_cast<T>(0))
+                return center + vec3<T>(radius, 0, 0);
+
+            return center + d * (radius / length);
+        }
+    };
+
+    // Axis aligned box, use transformedsupport for an oriented one
+    template<typename T>
+    struct boxsupport
+    {
+        vec3<T> center;
+        vec3<T> extents;
+
+        SML_NO_DISCARD inline vec3<T> operator()(const vec3<T>& d) const noexcept
+        {
+            return vec3<T>(center.x + (d.x < 0 ? -extents.x : extents.x),
+                           center.y + (d.y < 0 ? -extents.y : extents.y),
+                           center.z + (d.z < 0 ? -extents.z : extents.z));
+        }
+    };
+
+    // Segment ab swept by a sphere
+    template<typename T>
+    struct capsulesupport
+    {
+        vec3<T> a, b;
+        T radius;
+
+        SML_NO_DISCARD inline vec3<T> operator()(const vec3<T>& d) const noexcept
+        {
+            return spheresupport<T>{ d.dot(b - a) > 0 ? b : a, radius }(d);
+        }
+    };
+
+    // Shape S rotated by rotation, then moved to position
+    template<typename S, typename T>
+    struct transformedsupport
+    {
+        S shape;
+        quat<T> rotation;
+        vec3<T> position;
+
+        SML_NO_DISCARD inline vec3<T> operator()(const vec3<T>& d) const noexcept
+        {
+            return position + rotation * shape(rotation.conjugate() * d);
+        }
+    };
+
+    // Vertex of the Minkowski difference A - B, with the points of A and B it came from and the
+    // direction that found it
+    template<typename T>
+    struct gjkvertex
+    {
+        vec3<T> w;
+        vec3<T> a, b;
+        vec3<T> direction;
+    };
+
+    // Keep one per shape pair to warm start the next query, count = 0 starts over
+    template<typename T>
+    struct gjksimplex
+    {
+        gjkvertex<T> vertices[4];
+        u32 count = 0;
+
+        inline void reset() noexcept
+        {
+            count = 0;
+        }
+    };
+
+    template<typename T>
+    struct gjkresult
+    {
+        bool intersecting;
+        T distance;
+
+        // Closest points on A and B, only meaningful when the shapes don't intersect
+        vec3<T> pointa, pointb;
+
+        u32 iterations;
+    };
+
+    template<typename T>
+    struct penetration
+    {
+        // Moving B along normal by depth separates the shapes
+        vec3<T> normal;
+        T depth;
+
+        // Deepest points of A in B and of B in A, pointa - pointb = normal * depth
+        vec3<T> pointa, pointb;
+    };
+
+    namespace detail
+    {
+        template<typename T, typename A, typename B>
+        static inline gjkvertex<T> gjksupport(const A& a, const B& b, const vec3<T>& d) noexcept
+        {
+            gjkvertex<T> v;
+            v.a = a(d);
+            v.b = b(-d);
+            v.w = v.a - v.b;
+            v.direction = d;
+
+            return v;
+        }
+
+        // Weights of the segment's endpoints for its point closest to the origin
+        template<typename T>
+        static inline void gjksegment(const vec3<T>& a, const vec3<T>& b, T (&weights)[2]) noexcept
+        {
+            vec3<T> ab = b - a;
+            T length = ab.dot(ab);
+            T t = length > 0 ? -a.dot(ab) / length : static_cast<T>(0);
+
+            t = sml::clamp(t, static_cast<T>(0), static_cast<T>(1));
+            weights[0] = static_cast<T>(1) - t;
+            weights[1] = t;
+        }
+
+        // Weights of the triangle's corners for its point closest to the origin (Ericson 5.1.5)
+        template<typename T>
+        static inline void gjktriangle(const vec3<T>& a, const vec3<T>& b, const vec3<T>& c, T (&weights)[3]) noexcept
+        {
+            const T zero = static_cast<T>(0), one = static_cast<T>(1);
+
+            vec3<T> ab = b - a, ac = c - a;
+
+            T d1 = -ab.dot(a), d2 = -ac.dot(a);
+            if (d1 <= zero && d2 <= zero)
+            {
+                weights[0] = one; weights[1] = weights[2] = zero;
+                return;
+            }
+
+            T d3 = -ab.dot(b), d4 = -ac.dot(b);
+            if (d3 >= zero && d4 <= d3)
+            {
+                weights[1] = one; weights[0] = weights[2] = zero;
+                return;
+            }
+
+            T vc = d1 * d4 - d3 * d2;
+            if (vc <= zero && d1 >= zero && d3 <= zero)
+            {
+                T v = d1 / (d1 - d3);
+                weights[0] = one - v; weights[1] = v; weights[2] = zero;
+                return;
+            }
+
+            T d5 = -ab.dot(c), d6 = -ac.dot(c);
+            if (d6 >= zero && d5 <= d6)
+            {
+                weights[2] = one; weights[0] = weights[1] = zero;
+                return;
+            }
+
+            T vb = d5 * d2 - d1 * d6;
+            if (vb <= zero && d2 >= zero && d6 <= zero)
+            {
+                T w = d2 / (d2 - d6);
+                weights[0] = one - w; weights[1] = zero; weights[2] = w;
+                return;
+            }
+
+            T va = d3 * d6 - d5 * d4;
+            if (va <= zero && (d4 - d3) >= zero && (d5 - d6) >= zero)
+            {
+                T w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                weights[0] = zero; weights[1] = one - w; weights[2] = w;
+                return;
+            }
+
+            T sum = va + vb + vc;
+            if (sum <= zero)
+            {
+                // Degenerate, the closest point is on one of the edges
+                T e[2], best = std::numeric_limits<T>::infinity();
+                const vec3<T>* corners[3] = { &a, &b, &c };
+
+                for (u32 i = 0; i < 3; i++)
+                {
+                    u32 j = (i + 1) % 3;
+                    gjksegment(*corners[i], *corners[j], e);
+
+                    vec3<T> p = *corners[i] * e[0] + *corners[j] * e[1];
+                    T distsq = p.dot(p);
+
+                    if (distsq < best)
+                    {
+                        best = distsq;
+                        weights[i] = e[0]; weights[j] = e[1]; weights[3 - i - j] = zero;
+                    }
+                }
+
+                return;
+            }
+
+            T v = vb / sum, w = vc / sum;
+            weights[0] = one - v - w; weights[1] = v; weights[2] = w;
+        }
+
+        // Reduces the simplex to the vertices with a non zero weight for its point closest to the
+        // origin, returns that point. Returns false when the simplex is a tetrahedron that
+        // contains the origin.
+        template<typename T>
+        static inline bool gjksolve(gjksimplex<T>& s, T (&weights)[4], vec3<T>& closest) noexcept
+        {
+            gjkvertex<T>* v = s.vertices;
+
+            switch (s.count)
+            {
+                case 1:
+                    weights[0] = static_cast<T>(1);
+                    break;
+                case 2:
+                {
+                    T w[2];
+                    gjksegment(v[0].w, v[1].w, w);
+                    weights[0] = w[0]; weights[1] = w[1];
+                    break;
+                }
+                case 3:
+                {
+                    T w[3];
+                    gjktriangle(v[0].w, v[1].w, v[2].w, w);
+                    weights[0] = w[0]; weights[1] = w[1]; weights[2] = w[2];
+                    break;
+                }
+                case 4:
+                {
+                    // Faces with the opposite corner last, the origin is inside when it is on the
+                    // same side of every face as the opposite corner
+                    static const u32 faces[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+
+                    T best = std::numeric_limits<T>::infinity();
+                    bool inside = true;
+
+                    for (const u32 (&f)[4] : faces)
+                    {
+                        const vec3<T>& a = v[f[0]].w;
+                        vec3<T> n = vec3<T>::cross(v[f[1]].w - a, v[f[2]].w - a);
+
+                        T origin = -n.dot(a), opposite = n.dot(v[f[3]].w - a);
+
+                        if (origin * opposite > 0)
+                            continue;
+
+                        inside = false;
+
+                        T w[3];
+                        gjktriangle(a, v[f[1]].w, v[f[2]].w, w);
+
+                        vec3<T> p = a * w[0] + v[f[1]].w * w[1] + v[f[2]].w * w[2];
+                        T distsq = p.dot(p);
+
+                        if (distsq < best)
+                        {
+                            best = distsq;
+                            weights[f[0]] = w[0]; weights[f[1]] = w[1]; weights[f[2]] = w[2]; weights[f[3]] = 0;
+                        }
+                    }
+
+                    if (inside)
+                        return false;
+
+                    break;
+                }
+            }
+
+            // Drop the vertices that don't contribute
+            u32 kept = 0;
+            closest = vec3<T>(0, 0, 0);
+
+            for (u32 i = 0; i < s.count; i++)
+            {
+                if (weights[i] > 0)
+                {
+                    closest += v[i].w * weights[i];
+
+                    v[kept] = v[i];
+                    weights[kept] = weights[i];
+                    kept++;
+                }
+            }
+
+            s.count = kept;
+            return true;
+        }
+
+        // The simplex vertices found along the same directions for the shapes as they are now,
+        // without duplicates
+        template<typename T, typename A, typename B>
+        static inline void gjkwarmstart(const A& a, const B& b, gjksimplex<T>& s) noexcept
+        {
+            u32 kept = 0;
+
+            for (u32 i = 0; i < s.count; i++)
+            {
+                gjkvertex<T> v = gjksupport(a, b, s.vertices[i].direction);
+
+                bool duplicate = false;
+                for (u32 j = 0; j < kept && !duplicate; j++)
+                {
+                    duplicate = (s.vertices[j].w - v.w).lengthsquared() <= 0;
+                }
+
+                if (!duplicate)
+                    s.vertices[kept++] = v;
+            }
+
+            if (kept == 0)
+                s.vertices[kept++] = gjksupport(a, b, vec3<T>(1, 0, 0));
+
+            s.count = kept;
+        }
+
+        template<typename T>
+        static inline T gjktolerance() noexcept
+        {
+            return std::numeric_limits<T>::epsilon() * 32;
+        }
+
+        template<typename T>
+        static inline T gjkscale(const gjksimplex<T>& s) noexcept
+        {
+            T scale = static_cast<T>(0);
+
+            for (u32 i = 0; i < s.count; i++)
+            {
+                scale = std::max(scale, s.vertices[i].w.lengthsquared());
+            }
+
+            return scale;
+        }
+    } // namespace detail
+
+    // Distance and closest points between convex shapes a and b
+    template<typename T, typename A, typename B>
+    inline gjkresult<T> gjk(const A& a, const B& b, gjksimplex<T>& simplex, u32 maxiterations = 64) noexcept
+    {
+        const T tolerance = detail::gjktolerance<T>();
+
+        gjkresult<T> result = { false, static_cast<T>(0), vec3<T>(0, 0, 0), vec3<T>(0, 0, 0), 0 };
+        T weights[4] = {};
+        vec3<T> v;
+
+        detail::gjkwarmstart(a, b, simplex);
+
+        for (; result.iterations < maxiterations; result.iterations++)
+        {
+            if (!detail::gjksolve(simplex, weights, v))
+            {
+                result.intersecting = true;
+                return result;
+            }
+
+            T vv = v.dot(v);
+
+            // Touching, the origin is on the simplex up to rounding
+            if (vv <= tolerance * detail::gjkscale(simplex))
+            {
+                result.intersecting = true;
+                return result;
+            }
+
+            gjkvertex<T> w = detail::gjksupport(a, b, -v);
+
+            // No progress towards the origin, v is the closest point of A - B. The dot products
+            // carry rounding relative to the size of the simplex, which bounds how far it gets.
+            T scale = std::max(detail::gjkscale(simplex), w.w.lengthsquared());
+            if (vv - v.dot(w.w) <= tolerance * std::max(vv, scale))
+                break;
+
+            bool duplicate = false;
+            for (u32 i = 0; i < simplex.count && !duplicate; i++)
+            {
+                duplicate = (simplex.vertices[i].w - w.w).lengthsquared() <= tolerance * vv;
+            }
+
+            // Out of iterations, keep the simplex that v was solved for
+            if (duplicate || result.iterations + 1 == maxiterations)
+                break;
+
+            simplex.vertices[simplex.count++] = w;
+        }
+
+        for (u32 i = 0; i < simplex.count; i++)
+        {
+            result.pointa += simplex.vertices[i].a * weights[i];
+            result.pointb += simplex.vertices[i].b * weights[i];
+        }
+
+        result.distance = v.length();
+        return result;
+    }
+
+    // Intersection test only, stops as soon as a separating direction is found
+    template<typename T, typename A, typename B>
+    inline bool gjkintersect(const A& a, const B& b, gjksimplex<T>& simplex, u32 maxiterations = 64) noexcept
+    {
+        const T tolerance = detail::gjktolerance<T>();
+
+        T weights[4];
+        vec3<T> v;
+
+        detail::gjkwarmstart(a, b, simplex);
+
+        for (u32 i = 0; i < maxiterations; i++)
+        {
+            if (!detail::gjksolve(simplex, weights, v))
+                return true;
+
+            T vv = v.dot(v);
+
+            if (vv <= tolerance * detail::gjkscale(simplex))
+                return true;
+
+            gjkvertex<T> w = detail::gjksupport(a, b, -v);
+
+            // The shapes don't reach past the plane through the origin normal to v
+            if (w.w.dot(v) > 0)
+            {
+                simplex.vertices[simplex.count++] = w;
+                return false;
+            }
+
+            if (vv - v.dot(w.w) <= tolerance * std::max(vv, std::max(detail::gjkscale(simplex), w.w.lengthsquared())))
+                return false;
+
+            simplex.vertices[simplex.count++] = w;
+        }
+
+        return false;
+    }
+
+    namespace detail
+    {
+        template<typename T>
+        struct epaface
+        {
+            u32 index[3];
+            vec3<T> normal;
+            T distance;
+        };
+
+        template<typename T>
+        static inline epaface<T> epamakeface(const std::vector<gjkvertex<T>>& vertices, u32 i, u32 j, u32 k) noexcept
+        {
+            epaface<T> f = { { i, j, k }, vec3<T>::cross(vertices[j].w - vertices[i].w, vertices[k].w - vertices[i].w), std::numeric_limits<T>::infinity() };
+
+            T length = f.normal.length();
+            if (length > 0)
+            {
+                f.normal /= length;
+                f.distance = f.normal.dot(vertices[i].w);
+            }
+
+            return f;
+        }
+
+        // Grows a simplex that contains the origin to a tetrahedron, false if A - B is flat
+        template<typename T, typename A, typename B>
+        static inline bool epatetrahedron(const A& a, const B& b, std::vector<gjkvertex<T>>& v) noexcept
+        {
+            const T tolerance = gjktolerance<T>();
+            const vec3<T> axes[3] = { vec3<T>(1, 0, 0), vec3<T>(0, 1, 0), vec3<T>(0, 0, 1) };
+
+            if (v.size() == 1)
+            {
+                for (const vec3<T>& axis : axes)
+                {
+                    for (T sign : { static_cast<T>(1), static_cast<T>(-1) })
+                    {
+                        gjkvertex<T> w = gjksupport(a, b, axis * sign);
+
+                        if (v.size() == 1 && (w.w - v[0].w).lengthsquared() > tolerance * std::max(w.w.lengthsquared(), static_cast<T>(1)))
+                            v.push_back(w);
+                    }
+                }
+
+                if (v.size() == 1)
+                    return false;
+            }
+
+            if (v.size() == 2)
+            {
+                vec3<T> u = v[1].w - v[0].w;
+
+                // Axis least aligned with the segment
+                vec3<T> axis = axes[0];
+                if (sml::abs(u.y) < sml::abs(u.x) && sml::abs(u.y) <= sml::abs(u.z))
+                    axis = axes[1];
+                else if (sml::abs(u.z) < sml::abs(u.x))
+                    axis = axes[2];
+
+                vec3<T> e1 = vec3<T>::cross(u, axis), e2 = vec3<T>::cross(u, e1);
+                const vec3<T> directions[4] = { e1, -e1, e2, -e2 };
+
+                for (const vec3<T>& d : directions)
+                {
+                    gjkvertex<T> w = gjksupport(a, b, d);
+
+                    if (v.size() == 2 && vec3<T>::cross(w.w - v[0].w, u).lengthsquared() > tolerance * u.lengthsquared() * std::max(w.w.lengthsquared(), static_cast<T>(1)))
+                        v.push_back(w);
+                }
+
+                if (v.size() == 2)
+                    return false;
+            }
+
+            if (v.size() == 3)
+            {
+                vec3<T> n = vec3<T>::cross(v[1].w - v[0].w, v[2].w - v[0].w);
+
+                for (T sign : { static_cast<T>(1), static_cast<T>(-1) })
+                {
+                    gjkvertex<T> w = gjksupport(a, b, n * sign);
+                    T height = n.dot(w.w - v[0].w);
+
+                    if (v.size() == 3 && height * height > tolerance * n.lengthsquared() * std::max(w.w.lengthsquared(), static_cast<T>(1)))
+                        v.push_back(w);
+                }
+
+                if (v.size() == 3)
+                    return false;
+            }
+
+            return true;
+        }
+    } // namespace detail
+
+    // Penetration depth of intersecting shapes, simplex is the one gjk() or gjkintersect() found
+    // them intersecting with. Returns false when the simplex can't be grown into a tetrahedron,
+    // which happens when A - B is flat. Polytopes converge in a few iterations, curved shapes are
+    // approximated by ever more faces and may stop at maxiterations slightly short of the depth.
+    template<typename T, typename A, typename B>
+    inline bool epa(const A& a, const B& b, const gjksimplex<T>& simplex, penetration<T>& out, u32 maxiterations = 64)
+    {
+        typedef detail::epaface<T> face;
+
+        const T tolerance = sml::sqrt(detail::gjktolerance<T>());
+
+        std::vector<gjkvertex<T>> vertices(simplex.vertices, simplex.vertices + simplex.count);
+
+        if (vertices.empty() || !detail::epatetrahedron(a, b, vertices))
+            return false;
+
+        // Faces wound outwards
+        if ((vertices[3].w - vertices[0].w).dot(vec3<T>::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w)) > 0)
+            std::swap(vertices[1], vertices[2]);
+
+        std::vector<face> faces = {
+            detail::epamakeface(vertices, 0, 1, 2), detail::epamakeface(vertices, 0, 3, 1),
+            detail::epamakeface(vertices, 0, 2, 3), detail::epamakeface(vertices, 1, 3, 2)
+        };
+
+        std::vector<std::pair<u32, u32>> horizon;
+
+        auto nearest = [&]()
+        {
+            size_t closest = 0;
+            for (size_t i = 1; i < faces.size(); i++)
+            {
+                if (faces[i].distance < faces[closest].distance)
+                    closest = i;
+            }
+
+            return closest;
+        };
+
+        for (u32 iteration = 0; iteration < maxiterations; iteration++)
+        {
+            const face& f = faces[nearest()];
+            gjkvertex<T> w = detail::gjksupport(a, b, f.normal);
+
+            if (f.normal.dot(w.w) - f.distance <= tolerance * std::max(f.distance, static_cast<T>(1)))
+                break;
+
+            u32 added = static_cast<u32>(vertices.size());
+            vertices.push_back(w);
+
+            // Remove the faces that see the new vertex, their edges that aren't shared form the
+            // horizon the new faces are built on
+            horizon.clear();
+
+            for (size_t i = 0; i < faces.size();)
+            {
+                if (faces[i].normal.dot(w.w - vertices[faces[i].index[0]].w) > 0)
+                {
+                    for (u32 e = 0; e < 3; e++)
+                    {
+                        std::pair<u32, u32> edge(faces[i].index[e], faces[i].index[(e + 1) % 3]);
+
+                        auto shared = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+                        if (shared != horizon.end())
+                            horizon.erase(shared);
+                        else
+                            horizon.push_back(edge);
+                    }
+
+                    faces[i] = faces.back();
+                    faces.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+
+            for (const std::pair<u32, u32>& edge : horizon)
+            {
+                faces.push_back(detail::epamakeface(vertices, edge.first, edge.second, added));
+            }
+
+            if (faces.empty())
+                return false;
+        }
+
+        const face& f = faces[nearest()];
+
+        // Barycentric coordinates of the origin's projection on the closest face
+        const vec3<T>& p0 = vertices[f.index[0]].w;
+        const vec3<T>& p1 = vertices[f.index[1]].w;
+        const vec3<T>& p2 = vertices[f.index[2]].w;
+
+        vec3<T> p = f.normal * f.distance;
+        T area = vec3<T>::cross(p1 - p0, p2 - p0).dot(f.normal);
+        T u = static_cast<T>(1), v = static_cast<T>(0);
+
+        if (area > 0)
+        {
+            u = vec3<T>::cross(p1 - p, p2 - p).dot(f.normal) / area;
+            v = vec3<T>::cross(p2 - p, p0 - p).dot(f.normal) / area;
+        }
+
+        T w = static_cast<T>(1) - u - v;
+
+        out.normal = f.normal;
+        out.depth = f.distance;
+        out.pointa = vertices[f.index[0]].a * u + vertices[f.index[1]].a * v + vertices[f.index[2]].a * w;
+        out.pointb = vertices[f.index[0]].b * u + vertices[f.index[1]].b * v + vertices[f.index[2]].b * w;
+
+        return true;
+    }
+SML_NAMESPACE_END
+
+#endif // sml_gjk_h__
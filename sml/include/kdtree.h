@@ -0,0 +1,505 @@
+#ifndef sml_kdtree_h__
+#define sml_kdtree_h__
+
+/* kdtree.h -- static k-d tree of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "mask.h"
+#include "vec2.h"
+#include "vec3.h"
+
+// Static k-d tree over vec2 or vec3 points for nearest, k nearest and fixed radius queries.
+//
+// The tree is balanced and implicit: every split halves the point range, so all leaves sit at
+// the same depth, node n has the children 2n + 1 and 2n + 2 and a node's point range follows from
+// its parent's. The tree itself is only a split value and axis per inner node. Points are stored
+// as structure of arrays in leaf order, a leaf holds at most leafsize of them and is scanned 8
+// (f32) or 4 (f64) at a time.
+//
+// The array queries sort the query points by the leaf they fall in first. Neighbouring queries
+// then walk the same part of the tree, and a nearest query starts out with the previous query's
+// answer as its bound, which prunes most of the tree before the first leaf is scanned.
+
+SML_NAMESPACE_BEGIN
+    template<template<typename> class V, typename T>
+    class kdtree
+    {
+        static_assert(std::is_floating_point<T>::value, "kdtree needs f32 or f64 points");
+        static_assert(veclanes<V>::value == 2 || veclanes<V>::value == 3, "kdtree takes vec2 or vec3 points");
+
+        public:
+            static constexpr size_t dimensions = veclanes<V>::value;
+            static constexpr size_t leafsize = 16;
+            static constexpr u32 none = 0xFFFFFFFFu;
+
+            kdtree() noexcept = default;
+
+            kdtree(const V<T>* points, size_t count)
+            {
+                build(points, count);
+            }
+
+            void build(const V<T>* points, size_t count)
+            {
+                leaves = 1;
+                while (leaves * leafsize < count)
+                    leaves <<= 1;
+
+                split.assign(leaves - 1, static_cast<T>(0));
+                axis.assign(leaves - 1, 0);
+                order.resize(count);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    order[i] = static_cast<u32>(i);
+                }
+
+                if (count > leafsize)
+                {
+                    divide(points, 0, 0, static_cast<u32>(count));
+                }
+
+                for (size_t k = 0; k < dimensions; k++)
+                {
+                    coordinates[k].resize(count);
+
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        coordinates[k][i] = points[order[i]].v[k];
+                    }
+                }
+            }
+
+            // Index of the point closest to p, none when the tree is empty
+            SML_NO_DISCARD u32 nearest(const V<T>& p, T* distsq = nullptr) const noexcept
+            {
+                u32 slot = none;
+                T bound = std::numeric_limits<T>::infinity();
+
+                closest(p, slot, bound);
+
+                if (distsq)
+                    *distsq = bound;
+
+                return slot == none ? none : order[slot];
+            }
+
+            // The k points closest to p sorted by distance, returns how many were found, which is k
+            // unless the tree holds fewer points
+            size_t nearest(const V<T>& p, size_t k, u32* indices, T* distsq = nullptr) const
+            {
+                std::vector<T> scratch;
+                T* d = distsq;
+
+                if (!d)
+                {
+                    scratch.resize(k);
+                    d = scratch.data();
+                }
+
+                size_t found = knearest(p, k, indices, d);
+
+                for (size_t i = 0; i < found; i++)
+                {
+                    indices[i] = order[indices[i]];
+                }
+
+                return found;
+            }
+
+            // Calls visit(index, distance squared) for every point within radius of center, in no
+            // particular order
+            template<typename F>
+            void query(const V<T>& center, T radius, const F& visit) const
+            {
+                T rsq = radius * radius;
+
+                search(center, rsq, [&](u32 begin, u32 end)
+                {
+                    scan(center, begin, end, rsq, [&](u32 slot, T dsq)
+                    {
+                        visit(order[slot], dsq);
+                    });
+                });
+            }
+
+            // Appends the indices of the points within radius of center to out, returns how many
+            size_t query(const V<T>& center, T radius, std::vector<u32>& out) const
+            {
+                size_t before = out.size();
+                query(center, radius, [&](u32 index, T) { out.push_back(index); });
+
+                return out.size() - before;
+            }
+
+            // Nearest point of every query point, distsq is optional
+            void nearest(const V<T>* queries, size_t count, u32* indices, T* distsq = nullptr) const
+            {
+                u32 previous = none;
+
+                batch(queries, count, [&](size_t q)
+                {
+                    const V<T>& p = queries[q];
+
+                    // Any point bounds the distance to the nearest one, the previous answer
+                    // is usually close to it
+                    u32 slot = previous;
+                    T bound = previous == none ? std::numeric_limits<T>::infinity() : distance(p, previous);
+
+                    closest(p, slot, bound);
+
+                    indices[q] = slot == none ? none : order[slot];
+                    if (distsq)
+                        distsq[q] = bound;
+
+                    previous = slot;
+                });
+            }
+
+            // k nearest points of every query point, written k per query point. The entries past
+            // the number found are none and infinity.
+            void nearest(const V<T>* queries, size_t count, size_t k, u32* indices, T* distsq = nullptr) const
+            {
+                std::vector<T> scratch;
+                if (!distsq)
+                    scratch.resize(k);
+
+                batch(queries, count, [&](size_t q)
+                {
+                    u32* i = indices + q * k;
+                    T* d = distsq ? distsq + q * k : scratch.data();
+
+                    size_t found = knearest(queries[q], k, i, d);
+
+                    for (size_t j = 0; j < found; j++)
+                    {
+                        i[j] = order[i[j]];
+                    }
+
+                    for (size_t j = found; j < k; j++)
+                    {
+                        i[j] = none;
+                        d[j] = std::numeric_limits<T>::infinity();
+                    }
+                });
+            }
+
+            // Calls visit(query, index, distance squared) for every point within radius of every
+            // query point, grouped by query but in no particular order
+            template<typename F>
+            void query(const V<T>* queries, size_t count, T radius, const F& visit) const
+            {
+                batch(queries, count, [&](size_t q)
+                {
+                    query(queries[q], radius, [&](u32 index, T dsq) { visit(q, index, dsq); });
+                });
+            }
+
+            SML_NO_DISCARD inline size_t size() const noexcept
+            {
+                return order.size();
+            }
+
+            // Point index of every slot in leaf order
+            SML_NO_DISCARD inline const std::vector<u32>& ordering() const noexcept
+            {
+                return order;
+            }
+
+        private:
+            // Median split of the slots [begin, end) along the axis of largest extent
+            void divide(const V<T>* points, u32 node, u32 begin, u32 end)
+            {
+                if (node >= leaves - 1)
+                    return;
+
+                V<T> lo = points[order[begin]], hi = lo;
+                for (u32 i = begin + 1; i < end; i++)
+                {
+                    const V<T>& p = points[order[i]];
+
+                    for (size_t k = 0; k < dimensions; k++)
+                    {
+                        lo.v[k] = std::min(lo.v[k], p.v[k]);
+                        hi.v[k] = std::max(hi.v[k], p.v[k]);
+                    }
+                }
+
+                u8 a = 0;
+                for (u8 k = 1; k < dimensions; k++)
+                {
+                    if (hi.v[k] - lo.v[k] > hi.v[a] - lo.v[a])
+                        a = k;
+                }
+
+                u32 mid = begin + (end - begin) / 2;
+                std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](u32 l, u32 r)
+                {
+                    return points[l].v[a] < points[r].v[a];
+                });
+
+                axis[node] = a;
+                split[node] = points[order[mid]].v[a];
+
+                divide(points, 2 * node + 1, begin, mid);
+                divide(points, 2 * node + 2, mid, end);
+            }
+
+            // Walks the tree depth first, nearer child first, and calls leaf(begin, end) for every
+            // leaf that can hold a point within sqrt(bound) of p. leaf() may shrink bound.
+            template<typename F>
+            inline void search(const V<T>& p, const T& bound, const F& leaf) const
+            {
+                struct entry
+                {
+                    u32 node, begin, end;
+                    T distsq;
+                };
+
+                if (order.empty())
+                    return;
+
+                // One far child per level, leaves are at most 32 levels down
+                entry stack[32];
+                size_t top = 0;
+
+                stack[top++] = { 0, 0, static_cast<u32>(order.size()), static_cast<T>(0) };
+
+                while (top > 0)
+                {
+                    entry e = stack[--top];
+
+                    if (e.distsq > bound)
+                        continue;
+
+                    while (e.node < leaves - 1)
+                    {
+                        T d = p.v[axis[e.node]] - split[e.node];
+                        u32 mid = e.begin + (e.end - e.begin) / 2;
+
+                        entry left = { 2 * e.node + 1, e.begin, mid, e.distsq };
+                        entry right = { 2 * e.node + 2, mid, e.end, e.distsq };
+
+                        entry& nearer = d < 0 ? left : right;
+                        entry& farther = d < 0 ? right : left;
+
+                        farther.distsq = d * d;
+                        if (farther.distsq <= bound)
+                            stack[top++] = farther;
+
+                        e = nearer;
+                    }
+
+                    leaf(e.begin, e.end);
+                }
+            }
+
+            // Leaf containing p
+            inline u32 leafof(const V<T>& p) const noexcept
+            {
+                u32 node = 0;
+
+                while (node < leaves - 1)
+                {
+                    node = 2 * node + (p.v[axis[node]] < split[node] ? 1 : 2);
+                }
+
+                return node - static_cast<u32>(leaves - 1);
+            }
+
+            template<typename O, typename F>
+            inline void scanlanes(const typename O::type (&c)[dimensions], u32 i, T bound, const F& hit) const
+            {
+                typedef typename O::type R;
+
+                R d = O::sub(O::load(coordinates[0].data() + i), c[0]);
+                R dsq = O::mul(d, d);
+
+                for (size_t k = 1; k < dimensions; k++)
+                {
+                    d = O::sub(O::load(coordinates[k].data() + i), c[k]);
+                    dsq = O::madd(d, d, dsq);
+                }
+
+                s32 bits = O::movemask(O::le(dsq, O::set1(bound)));
+
+                if (bits == 0)
+                    return;
+
+                T values[O::lanes];
+                O::store(values, dsq);
+
+                for (u32 l = 0; l < O::lanes; l++)
+                {
+                    if (bits & (1 << l))
+                    {
+                        hit(i + l, values[l]);
+                    }
+                }
+            }
+
+            // hit(slot, distance squared) for the slots in [begin, end) within sqrt(bound) of p.
+            // hit() may shrink bound, the lanes already loaded are still compared against the old
+            // one.
+            template<typename F>
+            inline void scan(const V<T>& p, u32 begin, u32 end, const T& bound, const F& hit) const
+            {
+                u32 i = begin;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> O;
+
+                    typename O::type c[dimensions];
+                    for (size_t k = 0; k < dimensions; k++)
+                    {
+                        c[k] = O::set1(p.v[k]);
+                    }
+
+                    for (; i + O::lanes <= end; i += O::lanes)
+                    {
+                        scanlanes<O>(c, i, bound, hit);
+                    }
+                }
+#endif
+
+                T c[dimensions];
+                for (size_t k = 0; k < dimensions; k++)
+                {
+                    c[k] = p.v[k];
+                }
+
+                for (; i < end; i++)
+                {
+                    scanlanes<narrow<T>>(c, i, bound, hit);
+                }
+            }
+
+            inline T distance(const V<T>& p, u32 slot) const noexcept
+            {
+                T dsq = static_cast<T>(0);
+
+                for (size_t k = 0; k < dimensions; k++)
+                {
+                    T d = coordinates[k][slot] - p.v[k];
+                    dsq += d * d;
+                }
+
+                return dsq;
+            }
+
+            // Closest slot to p that is nearer than bound, leaves slot and bound as they are if none
+            inline void closest(const V<T>& p, u32& slot, T& bound) const noexcept
+            {
+                search(p, bound, [&](u32 begin, u32 end)
+                {
+                    scan(p, begin, end, bound, [&](u32 s, T dsq)
+                    {
+                        if (dsq < bound || (dsq == bound && s < slot))
+                        {
+                            bound = dsq;
+                            slot = s;
+                        }
+                    });
+                });
+            }
+
+            // k closest slots sorted by distance, returns how many
+            size_t knearest(const V<T>& p, size_t k, u32* slots, T* distsq) const
+            {
+                if (k == 0)
+                    return 0;
+
+                size_t found = 0;
+                T bound = std::numeric_limits<T>::infinity();
+
+                search(p, bound, [&](u32 begin, u32 end)
+                {
+                    scan(p, begin, end, bound, [&](u32 s, T dsq)
+                    {
+                        if (found == k && dsq >= bound)
+                            return;
+
+                        // Insertion into the sorted list, k is expected to be small
+                        size_t j = found < k ? found++ : k - 1;
+                        for (; j > 0 && distsq[j - 1] > dsq; j--)
+                        {
+                            distsq[j] = distsq[j - 1];
+                            slots[j] = slots[j - 1];
+                        }
+
+                        distsq[j] = dsq;
+                        slots[j] = s;
+
+                        if (found == k)
+                            bound = distsq[k - 1];
+                    });
+                });
+
+                return found;
+            }
+
+            // Calls run(query) for every query point, ordered by the leaf the query falls in
+            template<typename F>
+            void batch(const V<T>* queries, size_t count, const F& run) const
+            {
+                std::vector<u32> start(leaves + 1, 0), leaf(count), sorted(count);
+
+                for (size_t q = 0; q < count; q++)
+                {
+                    leaf[q] = leafof(queries[q]);
+                    start[leaf[q] + 1]++;
+                }
+
+                for (size_t l = 0; l < leaves; l++)
+                {
+                    start[l + 1] += start[l];
+                }
+
+                for (size_t q = 0; q < count; q++)
+                {
+                    sorted[start[leaf[q]]++] = static_cast<u32>(q);
+                }
+
+                for (u32 q : sorted)
+                {
+                    run(q);
+                }
+            }
+
+            size_t leaves = 1;
+
+            // Split value and axis of every inner node
+            std::vector<T> split;
+            std::vector<u8> axis;
+
+            // Point coordinates and index per slot, in leaf order
+            std::vector<T> coordinates[dimensions];
+            std::vector<u32> order;
+    };
+SML_NAMESPACE_END
+
+#endif // sml_kdtree_h__
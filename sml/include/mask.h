@@ -0,0 +1,495 @@
+#ifndef sml_mask_h__
+#define sml_mask_h__
+
+/* mask.h -- vector masks and comparisons of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "smltypes.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+SML_NAMESPACE_BEGIN
+    template<template<typename> class V>
+    struct veclanes;
+
+    template<>
+    struct veclanes<vec2> : std::integral_constant<size_t, 2>
+    {
+    };
+
+    template<>
+    struct veclanes<vec3> : std::integral_constant<size_t, 3>
+    {
+    };
+
+    template<>
+    struct veclanes<vec4> : std::integral_constant<size_t, 4>
+    {
+    };
+
+    enum class compare
+    {
+        less,
+        lessequal,
+        greater,
+        greaterequal,
+        equal,
+        notequal
+    };
+
+    // Result of a component wise comparison of N lane vectors of T. Lanes are all ones (true) or
+    // all zeros (false) with the same width as T, so the mask can be used directly as an SSE/AVX
+    // blend operand. Lanes past N are padding and are ignored by bits(), any(), all() and none().
+    template<typename T, size_t N>
+    class alignas(simdalign<T>::value) vecmask
+    {
+        public:
+            typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type lane;
+
+            constexpr vecmask() noexcept
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v[i] = 0;
+                }
+            }
+
+            constexpr explicit vecmask(bool value) noexcept
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v[i] = value ? ~lane(0) : lane(0);
+                }
+            }
+
+            // Operators
+            SML_NO_DISCARD inline constexpr bool operator [] (size_t i) const noexcept
+            {
+                return v[i] != 0;
+            }
+
+            inline constexpr bool operator == (const vecmask& other) const noexcept
+            {
+                return bits() == other.bits();
+            }
+
+            inline constexpr bool operator != (const vecmask& other) const noexcept
+            {
+                return bits() != other.bits();
+            }
+
+            vecmask& operator &= (const vecmask& other) noexcept
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v[i] &= other.v[i];
+                }
+
+                return *this;
+            }
+
+            vecmask& operator |= (const vecmask& other) noexcept
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v[i] |= other.v[i];
+                }
+
+                return *this;
+            }
+
+            vecmask& operator ^= (const vecmask& other) noexcept
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v[i] ^= other.v[i];
+                }
+
+                return *this;
+            }
+
+            // Operations
+            SML_NO_DISCARD inline s32 bits() const noexcept
+            {
+                constexpr s32 used = (1 << N) - 1;
+
+#if SML_SSE
+                if constexpr (sizeof(lane) == 4 && simdalign<T>::value == 16)
+                {
+                    return _mm_movemask_ps(_mm_load_ps(reinterpret_cast<const f32*>(v))) & used;
+                }
+#endif
+
+#if SML_AVX
+                if constexpr (sizeof(lane) == 8 && simdalign<T>::value == 32)
+                {
+                    return _mm256_movemask_pd(_mm256_load_pd(reinterpret_cast<const f64*>(v))) & used;
+                }
+#endif
+
+                s32 res = 0;
+                for (size_t i = 0; i < N; i++)
+                {
+                    res |= v[i] ? (1 << i) : 0;
+                }
+
+                return res;
+            }
+
+            SML_NO_DISCARD inline bool any() const noexcept
+            {
+                return bits() != 0;
+            }
+
+            SML_NO_DISCARD inline bool all() const noexcept
+            {
+                return bits() == (1 << N) - 1;
+            }
+
+            SML_NO_DISCARD inline bool none() const noexcept
+            {
+                return bits() == 0;
+            }
+
+            // Data
+            lane v[4];
+    };
+
+    // Operators
+    template<typename T, size_t N>
+    vecmask<T, N> operator & (const vecmask<T, N>& left, const vecmask<T, N>& right) noexcept
+    {
+        vecmask<T, N> temp = left;
+        temp &= right;
+
+        return temp;
+    }
+
+    template<typename T, size_t N>
+    vecmask<T, N> operator | (const vecmask<T, N>& left, const vecmask<T, N>& right) noexcept
+    {
+        vecmask<T, N> temp = left;
+        temp |= right;
+
+        return temp;
+    }
+
+    template<typename T, size_t N>
+    vecmask<T, N> operator ^ (const vecmask<T, N>& left, const vecmask<T, N>& right) noexcept
+    {
+        vecmask<T, N> temp = left;
+        temp ^= right;
+
+        return temp;
+    }
+
+    template<typename T, size_t N>
+    vecmask<T, N> operator ~ (const vecmask<T, N>& left) noexcept
+    {
+        vecmask<T, N> temp = left;
+        temp ^= vecmask<T, N>(true);
+
+        return temp;
+    }
+
+    namespace detail
+    {
+#if SML_SSE
+        template<compare Op>
+        static inline __m128 comparesimd(__m128 a, __m128 b) noexcept
+        {
+            if constexpr (Op == compare::less)
+                return _mm_cmplt_ps(a, b);
+            if constexpr (Op == compare::lessequal)
+                return _mm_cmple_ps(a, b);
+            if constexpr (Op == compare::greater)
+                return _mm_cmpgt_ps(a, b);
+            if constexpr (Op == compare::greaterequal)
+                return _mm_cmpge_ps(a, b);
+            if constexpr (Op == compare::equal)
+                return _mm_cmpeq_ps(a, b);
+            if constexpr (Op == compare::notequal)
+                return _mm_cmpneq_ps(a, b);
+        }
+#endif
+
+#if SML_AVX
+        template<compare Op>
+        static inline __m256d comparesimd(__m256d a, __m256d b) noexcept
+        {
+            if constexpr (Op == compare::less)
+                return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+            if constexpr (Op == compare::lessequal)
+                return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+            if constexpr (Op == compare::greater)
+                return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+            if constexpr (Op == compare::greaterequal)
+                return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+            if constexpr (Op == compare::equal)
+                return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+            if constexpr (Op == compare::notequal)
+                return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+        }
+#endif
+
+#if SML_SSE
+        // SSE only has signed integer compares, unsigned lanes are biased by the sign bit first
+        template<compare Op, typename T>
+        static inline __m128i comparesimd(__m128i a, __m128i b) noexcept
+        {
+            if constexpr (std::is_same<T, u32>::value)
+            {
+                __m128i bias = _mm_set1_epi32(static_cast<s32>(0x80000000u));
+                a = _mm_xor_si128(a, bias);
+                b = _mm_xor_si128(b, bias);
+            }
+
+            __m128i ones = _mm_set1_epi32(-1);
+
+            if constexpr (Op == compare::less)
+                return _mm_cmplt_epi32(a, b);
+            if constexpr (Op == compare::lessequal)
+                return _mm_xor_si128(_mm_cmpgt_epi32(a, b), ones);
+            if constexpr (Op == compare::greater)
+                return _mm_cmpgt_epi32(a, b);
+            if constexpr (Op == compare::greaterequal)
+                return _mm_xor_si128(_mm_cmplt_epi32(a, b), ones);
+            if constexpr (Op == compare::equal)
+                return _mm_cmpeq_epi32(a, b);
+            if constexpr (Op == compare::notequal)
+                return _mm_xor_si128(_mm_cmpeq_epi32(a, b), ones);
+        }
+#endif
+
+        template<compare Op, typename T>
+        static inline constexpr bool comparescalar(T a, T b) noexcept
+        {
+            if constexpr (Op == compare::less)
+                return a < b;
+            if constexpr (Op == compare::lessequal)
+                return a <= b;
+            if constexpr (Op == compare::greater)
+                return a > b;
+            if constexpr (Op == compare::greaterequal)
+                return a >= b;
+            if constexpr (Op == compare::equal)
+                return a == b;
+            if constexpr (Op == compare::notequal)
+                return a != b;
+        }
+
+        template<compare Op, typename T, size_t N>
+        static inline vecmask<T, N> comparelanes(const T* a, const T* b) noexcept
+        {
+            vecmask<T, N> res;
+
+#if SML_SSE
+            if constexpr (simdf32<T>::value)
+            {
+                _mm_store_ps(reinterpret_cast<f32*>(res.v), comparesimd<Op>(_mm_load_ps(a), _mm_load_ps(b)));
+
+                return res;
+            }
+#endif
+
+#if SML_AVX
+            if constexpr (simdf64<T>::value)
+            {
+                _mm256_store_pd(reinterpret_cast<f64*>(res.v), comparesimd<Op>(_mm256_load_pd(a), _mm256_load_pd(b)));
+
+                return res;
+            }
+#endif
+
+#if SML_SSE
+            if constexpr (simdi32<T>::value)
+            {
+                __m128i lhs = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+                __m128i rhs = _mm_load_si128(reinterpret_cast<const __m128i*>(b));
+
+                _mm_store_si128(reinterpret_cast<__m128i*>(res.v), comparesimd<Op, T>(lhs, rhs));
+
+                return res;
+            }
+#endif
+
+            for (size_t i = 0; i < N; i++)
+            {
+                res.v[i] = comparescalar<Op>(a[i], b[i]) ? ~typename vecmask<T, N>::lane(0) : 0;
+            }
+
+            return res;
+        }
+    } // namespace detail
+
+    // Component wise comparisons
+    template<compare Op, template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> compared(const V<T>& a, const V<T>& b) noexcept
+    {
+        return detail::comparelanes<Op, T, veclanes<V>::value>(a.v, b.v);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> lessThan(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::less>(a, b);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> lessEqual(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::lessequal>(a, b);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> greaterThan(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::greater>(a, b);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> greaterEqual(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::greaterequal>(a, b);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> equal(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::equal>(a, b);
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vecmask<T, veclanes<V>::value> notEqual(const V<T>& a, const V<T>& b) noexcept
+    {
+        return compared<compare::notequal>(a, b);
+    }
+
+    // Branchless per lane mask ? a : b
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> select(const vecmask<T, veclanes<V>::value>& mask, const V<T>& a, const V<T>& b) noexcept
+    {
+        V<T> res;
+
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
+        {
+            __m128 m = _mm_load_ps(reinterpret_cast<const f32*>(mask.v));
+            _mm_store_ps(res.v, _mm_blendv_ps(_mm_load_ps(b.v), _mm_load_ps(a.v), m));
+
+            return res;
+        }
+#endif
+
+#if SML_AVX
+        if constexpr (simdf64<T>::value)
+        {
+            __m256d m = _mm256_load_pd(reinterpret_cast<const f64*>(mask.v));
+            _mm256_store_pd(res.v, _mm256_blendv_pd(_mm256_load_pd(b.v), _mm256_load_pd(a.v), m));
+
+            return res;
+        }
+#endif
+
+#if SML_SSE
+        if constexpr (simdi32<T>::value)
+        {
+            __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.v));
+            __m128i lhs = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+            __m128i rhs = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(res.v), _mm_blendv_epi8(rhs, lhs, m));
+
+            return res;
+        }
+#endif
+
+        for (size_t i = 0; i < veclanes<V>::value; i++)
+        {
+            res.v[i] = mask[i] ? a.v[i] : b.v[i];
+        }
+
+        return res;
+    }
+
+    // Bulk comparisons against a reference vector. The indices of the vectors for which all (findall)
+    // or any (findany) of the compared components hold are written to indices, in order, and the number
+    // of written indices is returned. indices must have room for count entries.
+    template<compare Op, template<typename> class V, typename T>
+    inline size_t findall(const V<T>* values, const V<T>& reference, u32* indices, size_t count) noexcept
+    {
+        constexpr s32 full = (1 << veclanes<V>::value) - 1;
+        size_t written = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            indices[written] = static_cast<u32>(i);
+            written += compared<Op>(values[i], reference).bits() == full;
+        }
+
+        return written;
+    }
+
+    template<compare Op, template<typename> class V, typename T>
+    inline size_t findany(const V<T>* values, const V<T>& reference, u32* indices, size_t count) noexcept
+    {
+        size_t written = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            indices[written] = static_cast<u32>(i);
+            written += compared<Op>(values[i], reference).bits() != 0;
+        }
+
+        return written;
+    }
+
+    // Indices of the vectors with min <= value <= max on every component
+    template<template<typename> class V, typename T>
+    inline size_t findinside(const V<T>* values, const V<T>& min, const V<T>& max, u32* indices, size_t count) noexcept
+    {
+        constexpr s32 full = (1 << veclanes<V>::value) - 1;
+        size_t written = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            s32 lo = compared<compare::greaterequal>(values[i], min).bits();
+            s32 hi = compared<compare::lessequal>(values[i], max).bits();
+
+            indices[written] = static_cast<u32>(i);
+            written += (lo & hi) == full;
+        }
+
+        return written;
+    }
+
+    // Predefined types
+    template<typename T>
+    using vec2mask = vecmask<T, 2>;
+
+    template<typename T>
+    using vec3mask = vecmask<T, 3>;
+
+    template<typename T>
+    using vec4mask = vecmask<T, 4>;
+SML_NAMESPACE_END
+
+#endif // sml_mask_h__
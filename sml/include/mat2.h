@@ -18,15 +18,10 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
-#include <immintrin.h>
-#include <mmintrin.h>
-#include <smmintrin.h>
-
 #include "vec2.h"
 #include "smltypes.h"
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
     template<typename T>
     class alignas(simdalign<T>::value) mat2
     {
@@ -101,7 +96,8 @@ namespace sml
             // Operators
             inline constexpr bool operator == (const mat2& other) const noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     union m128
                     {
@@ -117,8 +113,10 @@ namespace sml
 
                     return result == 0xFFFF; 
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     union m128
                     {
@@ -142,13 +140,15 @@ namespace sml
 
                     return result == 0xFFFF;
                 }
+#endif
 
-                return m00 != other.m00 || m10 != other.m10 || m01 != other.m01 || m11 != other.m11;
+                return m00 == other.m00 && m10 == other.m10 && m01 == other.m01 && m11 == other.m11;
             }
 
             inline constexpr bool operator != (const mat2& other) const noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     union m128
                     {
@@ -164,8 +164,10 @@ namespace sml
 
                     return result != 0; 
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     union m128
                     {
@@ -189,6 +191,7 @@ namespace sml
 
                     return result != 0;
                 }
+#endif
 
                 return m00 != other.m00 || m10 != other.m10 || m01 != other.m01 || m11 != other.m11;
             }
@@ -212,7 +215,8 @@ namespace sml
 
             mat2& operator *= (const mat2& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 lhs = _mm_load_ps(v);
                     __m128 rhs = _mm_load_ps(other.v);
@@ -233,8 +237,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     alignas(simdalign<T>::value) f64 res[4];
 
@@ -256,6 +262,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 T newM00 = m00 * other.m00 + m10 * other.m01;
                 T newM01 = m01 * other.m00 + m11 * other.m01;
@@ -286,7 +293,7 @@ namespace sml
 
             SML_NO_DISCARD inline constexpr mat2 transposed() const noexcept
             {
-                mat2 c = mat2(v);
+                mat2 c(*this);
                 c.transpose();
 
                 return c;
@@ -300,7 +307,8 @@ namespace sml
                 {
                     T det_inv = static_cast<T>(1) / det;
 
-                    if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                    if constexpr(simdf32<T>::value)
                     {
                         __m128 me = _mm_set_ps(m00, -m10, -m01, m11);
                         __m128 det = _mm_set_ps1(det_inv);
@@ -311,8 +319,10 @@ namespace sml
 
                         return;
                     }
+#endif
 
-                    if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                    if constexpr(simdf64<T>::value)
                     {
                         __m128d me1 = _mm_set_pd(m00, -m10);
                         __m128d me2 = _mm_set_pd(-m01, m11);
@@ -327,11 +337,17 @@ namespace sml
 
                         return;
                     }
+#endif
 
-                    m00 = m11 * det_inv;
-                    m10 = -m01 * det_inv;
-                    m01 = -m10 * det_inv;
-                    m11 = m00 * det_inv;
+                    T newM00 = m11 * det_inv;
+                    T newM01 = -m01 * det_inv;
+                    T newM10 = -m10 * det_inv;
+                    T newM11 = m00 * det_inv;
+
+                    m00 = newM00;
+                    m01 = newM01;
+                    m10 = newM10;
+                    m11 = newM11;
                 }
             }
 
@@ -345,7 +361,7 @@ namespace sml
 
             SML_NO_DISCARD inline constexpr mat2 negated() const noexcept
             {
-                mat2 c(v);
+                mat2 c(*this);
                 c.negate();
 
                 return c;
@@ -353,7 +369,7 @@ namespace sml
 
             SML_NO_DISCARD inline constexpr mat2 inverted() const noexcept
             {
-                mat2 c(v);
+                mat2 c(*this);
                 c.invert();
 
                 return c;
@@ -398,10 +414,11 @@ namespace sml
     {
         alignas(simdalign<T>::value) vec2<T> res;
 
-        if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+        if constexpr(simdf32<T>::value)
         {
-            __m128 x = _mm_broadcast_ss(&rhs.x);
-            __m128 y = _mm_broadcast_ss(&rhs.y);
+            __m128 x = _mm_set1_ps(rhs.x);
+            __m128 y = _mm_set1_ps(rhs.y);
 
             __m128 c0 = _mm_load_ps(&lhs.m00);
             __m128 c1 = _mm_shuffle_ps(c0, c0, _MM_SHUFFLE(0, 0, 3, 2));
@@ -410,8 +427,10 @@ namespace sml
 
             return res;
         }
+#endif
 
-        if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+        if constexpr(simdf64<T>::value)
         {
             __m256d x = _mm256_set1_pd(rhs.x);
             __m256d y = _mm256_set1_pd(rhs.y);
@@ -423,6 +442,7 @@ namespace sml
 
             return res;
         }
+#endif
 
         T x = lhs.m00 * rhs.x + lhs.m10 * rhs.y;
         T y = lhs.m01 * rhs.x + lhs.m11 * rhs.y;
@@ -433,6 +453,10 @@ namespace sml
     // Predefined types
     typedef mat2<f32> fmat2;
     typedef mat2<f64> dmat2;
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class mat2<f32>)
+    SML_EXTERN_TEMPLATE(class mat2<f64>)
+SML_NAMESPACE_END
 
 #endif // sml_mat2_h__
@@ -18,15 +18,10 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
-#include <immintrin.h>
-#include <mmintrin.h>
-#include <smmintrin.h>
-
 #include "vec3.h"
 #include "smltypes.h"
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
     template<typename T>
     class alignas(simdalign<T>::value) mat3
     {
@@ -190,7 +185,8 @@ namespace sml
             // Operators
             inline constexpr bool operator == (const mat3& other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     union m128
                     {
@@ -212,8 +208,10 @@ namespace sml
 
                     return result == 0;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     union m128
                     {
@@ -240,6 +238,7 @@ namespace sml
 
                     return result == 0;
                 }
+#endif
 
                 return m00 == other.m00 && m10 == other.m10 && m20 == other.m20 
                     && m01 == other.m01 && m11 == other.m11 && m21 == other.m21
@@ -248,7 +247,8 @@ namespace sml
 
             inline constexpr bool operator != (const mat3& other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     union m128
                     {
@@ -269,8 +269,10 @@ namespace sml
 
                     return result != 0xFFFF;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     union m128
                     {
@@ -297,6 +299,7 @@ namespace sml
 
                     return result != 0xFFFF;
                 }
+#endif
 
                 return m00 != other.m00 || m10 != other.m10 || m20 != other.m20 
                     || m01 != other.m01 || m11 != other.m11 || m21 != other.m21
@@ -305,7 +308,8 @@ namespace sml
 
             mat3& operator *= (const mat3& other) noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 col0 = _mm_load_ps(v + 0);
                     __m128 col1 = _mm_load_ps(v + 4);
@@ -313,9 +317,9 @@ namespace sml
 
                     for (s32 i = 0; i < 3; i++)
                     {
-                        __m128 elem0 = _mm_broadcast_ss(other.v + (4 * i + 0));
-                        __m128 elem1 = _mm_broadcast_ss(other.v + (4 * i + 1));
-                        __m128 elem2 = _mm_broadcast_ss(other.v + (4 * i + 2));
+                        __m128 elem0 = _mm_set1_ps(other.v[4 * i + 0]);
+                        __m128 elem1 = _mm_set1_ps(other.v[4 * i + 1]);
+                        __m128 elem2 = _mm_set1_ps(other.v[4 * i + 2]);
 
                         __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(elem0, col0), _mm_mul_ps(elem1, col1)), _mm_mul_ps(elem2, col2));
                         _mm_store_ps(v + 4 * i, result);
@@ -323,8 +327,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     alignas(simdalign<T>::value) f64 res[12];
                     __m256d col0 = _mm256_load_pd(&m00);
@@ -348,6 +354,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 T newM00 = m00 * other.m00 + m10 * other.m01 + m20 * other.m02;
                 T newM01 = m01 * other.m00 + m11 * other.m01 + m21 * other.m02;
@@ -413,7 +420,7 @@ namespace sml
                 {
                     T det_inv = static_cast<T>(1) / det;
 
-                    /*if constexpr (std::is_same<T, f32>::value)
+                    /*if constexpr (simdf32<T>::value)
                     {
                         __m128 me1 = _mm_set_ps(m11, m12, m10, m02);
                         __m128 me2 = _mm_set_ps(m00, m01, m01, m02);
@@ -443,7 +450,7 @@ namespace sml
                         __m128 res2 = _mm_sub_ps(mul2, mul5);
                         __m128 res3 = _mm_sub_ps(mul3, mul6);
 
-                        __m128 detinvregister = _mm_broadcast_ss(&det_inv);
+                        __m128 detinvregister = _mm_set1_ps(det_inv);
 
                         res1 = _mm_mul_ps(res1, detinvregister);
                         res2 = _mm_mul_ps(res2, detinvregister);
@@ -580,11 +587,12 @@ namespace sml
     {
         alignas(simdalign<T>::value) vec3<T> res;
 
-        if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
         {
-            __m128 x = _mm_broadcast_ss(&rhs.x);
-            __m128 y = _mm_broadcast_ss(&rhs.y);
-            __m128 z = _mm_broadcast_ss(&rhs.z);
+            __m128 x = _mm_set1_ps(rhs.x);
+            __m128 y = _mm_set1_ps(rhs.y);
+            __m128 z = _mm_set1_ps(rhs.z);
 
             __m128 c0 = _mm_load_ps(&lhs.m00);
             __m128 c1 = _mm_load_ps(&lhs.m10);
@@ -594,8 +602,10 @@ namespace sml
 
             return res;
         }
+#endif
 
-        if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+        if constexpr (simdf64<T>::value)
         {
             __m256d x = _mm256_set1_pd(rhs.x);
             __m256d y = _mm256_set1_pd(rhs.y);
@@ -611,10 +621,11 @@ namespace sml
 
             return res;
         }
+#endif
 
         T x = lhs.m00 * rhs.x + lhs.m10 * rhs.y + lhs.m20 * rhs.z;
         T y = lhs.m01 * rhs.x + lhs.m11 * rhs.y + lhs.m21 * rhs.z;
-        T z = lhs.m02 * rhs.x + lhs.m11 * rhs.y + lhs.m22 * rhs.z;
+        T z = lhs.m02 * rhs.x + lhs.m12 * rhs.y + lhs.m22 * rhs.z;
 
         return { x, y, z };
     }
@@ -622,6 +633,10 @@ namespace sml
     // Predefined types
     typedef mat3<f32> fmat3;
     typedef mat3<f64> dmat3;
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class mat3<f32>)
+    SML_EXTERN_TEMPLATE(class mat3<f64>)
+SML_NAMESPACE_END
 
 #endif // sml_mat3_h__
@@ -18,15 +18,16 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
-#include <immintrin.h>
-
 #include "vec3.h"
 #include "vec4.h"
+#include "mat3.h"
 #include "smltypes.h"
 #include "common.h"
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
+    template<typename T>
+    class quat;
+
     template<typename T>
     class alignas(simdalign<T>::value) mat4
     {
@@ -237,7 +238,8 @@ namespace sml
             // Operators
             inline bool constexpr operator == (const mat4& other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     union m128
                     {
@@ -250,7 +252,7 @@ namespace sml
                     {
                         __m128 me = _mm_load_ps(v + (4 * i));
                         __m128 ot = _mm_load_ps(other.v + (4 * i));
-                        __m128 res = _mm_cmp_ps(me, ot, _CMP_NEQ_OQ);
+                        __m128 res = _mm_and_ps(_mm_cmpneq_ps(me, ot), _mm_cmpord_ps(me, ot));
 
                         m128 cmp = { res };
                         result |= _mm_movemask_epi8(cmp.i);
@@ -258,8 +260,10 @@ namespace sml
 
                     return result == 0;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     union m128
                     {
@@ -286,6 +290,7 @@ namespace sml
 
                     return result == 0;
                 }
+#endif
 
                 return m00 == other.m00 && m10 == other.m10 && m20 == other.m20  && m30 == other.m30
                     && m01 == other.m01 && m11 == other.m11 && m21 == other.m21 && m31 == other.m31
@@ -295,7 +300,8 @@ namespace sml
 
             inline bool constexpr operator != (const mat4& other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     union m128
                     {
@@ -315,8 +321,10 @@ namespace sml
 
                     return result != 0xFFFF;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     union m128
                     {
@@ -343,6 +351,7 @@ namespace sml
 
                     return result != 0xFFFF;
                 }
+#endif
 
                 return m00 != other.m00 || m10 != other.m10 || m20 != other.m20 || m30 != other.m30
                     || m01 != other.m01 || m11 != other.m11 || m21 != other.m21 || m31 != other.m31
@@ -352,7 +361,8 @@ namespace sml
 
             mat4& operator *= (const mat4& other) noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 col0 = _mm_load_ps(v + 0);
                     __m128 col1 = _mm_load_ps(v + 4);
@@ -361,10 +371,10 @@ namespace sml
                     
                     for (s32 i = 0; i < 4; i++)
                     {
-                        __m128 elem0 = _mm_broadcast_ss(other.v + (4 * i + 0));
-                        __m128 elem1 = _mm_broadcast_ss(other.v + (4 * i + 1));
-                        __m128 elem2 = _mm_broadcast_ss(other.v + (4 * i + 2));
-                        __m128 elem3 = _mm_broadcast_ss(other.v + (4 * i + 3));
+                        __m128 elem0 = _mm_set1_ps(other.v[4 * i + 0]);
+                        __m128 elem1 = _mm_set1_ps(other.v[4 * i + 1]);
+                        __m128 elem2 = _mm_set1_ps(other.v[4 * i + 2]);
+                        __m128 elem3 = _mm_set1_ps(other.v[4 * i + 3]);
 
                         __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(elem0, col0),
                             _mm_mul_ps(elem1, col1)),
@@ -375,8 +385,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     alignas(simdalign<T>::value) f64 res[16];
                     __m256d col0 = _mm256_load_pd(&m00);
@@ -403,22 +415,38 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+                T res[16];
+
+                for (s32 i = 0; i < 4; i++)
+                {
+                    for (s32 j = 0; j < 4; j++)
+                    {
+                        res[4 * i + j] = (other.v[4 * i + 0] * v[j + 0] + other.v[4 * i + 1] * v[j + 4])
+                                       + (other.v[4 * i + 2] * v[j + 8] + other.v[4 * i + 3] * v[j + 12]);
+                    }
+                }
 
-                // TODO (Roderick): Implement non SIMD mat4 mul
+                for (s32 i = 0; i < 16; i++)
+                {
+                    v[i] = res[i];
+                }
 
                 return *this;
             }
 
             mat4& operator *= (const T other) noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 col0 = _mm_load_ps(v + 0);
                     __m128 col1 = _mm_load_ps(v + 4);
                     __m128 col2 = _mm_load_ps(v + 8);
                     __m128 col3 = _mm_load_ps(v + 12);
 
-                    __m128 multi = _mm_broadcast_ss(&other);
+                    __m128 multi = _mm_set1_ps(other);
 
                     col0 = _mm_mul_ps(col0, multi);
                     col1 = _mm_mul_ps(col1, multi);
@@ -432,8 +460,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d col0 = _mm256_load_pd(v + 0);
                     __m256d col1 = _mm256_load_pd(v + 4);
@@ -454,6 +484,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 for (int i = 0; i < 16; i++)
                 {
@@ -646,6 +677,94 @@ namespace sml
                 return f;
             }
 
+            // Applies the matrix to a point (w = 1) and to a direction (w = 0), without a perspective
+            // divide
+            SML_NO_DISCARD inline constexpr vec3<T> transformPoint(const vec3<T>& point) const noexcept
+            {
+                return vec3<T>(m00 * point.x + m10 * point.y + m20 * point.z + m30,
+                               m01 * point.x + m11 * point.y + m21 * point.z + m31,
+                               m02 * point.x + m12 * point.y + m22 * point.z + m32);
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> transformVector(const vec3<T>& vector) const noexcept
+            {
+                return vec3<T>(m00 * vector.x + m10 * vector.y + m20 * vector.z,
+                               m01 * vector.x + m11 * vector.y + m21 * vector.z,
+                               m02 * vector.x + m12 * vector.y + m22 * vector.z);
+            }
+
+            // Splits an affine matrix into translation, rotation and scale, the inverse of compose().
+            // The rotation is taken from the Gram-Schmidt orthonormalized upper 3x3, so shear is
+            // dropped and a mirroring matrix ends up with a negative z scale. Returns false when an
+            // axis has (near) zero length, the result is still a valid transform in that case: the
+            // missing axes are rebuilt from the remaining columns, so compose() gives back the matrix.
+            inline constexpr bool decompose(vec3<T>& translation, quat<T>& rotation, vec3<T>& scale) const noexcept
+            {
+                const T eps = static_cast<T>(constants::epsilon);
+                const T nearaxis = static_cast<T>(0.9);
+
+                vec3<T> c0(m00, m01, m02);
+                vec3<T> c1(m10, m11, m12);
+                vec3<T> c2(m20, m21, m22);
+
+                T sx = c0.length();
+                bool valid = sx > eps;
+                vec3<T> x;
+
+                if (valid)
+                {
+                    x = c0 / sx;
+                }
+                else
+                {
+                    // Perpendicular to the other two columns, or to the one that is left. With
+                    // nothing left it is unit x
+                    vec3<T> n = vec3<T>::cross(c1, c2);
+                    T ln = n.length();
+
+                    vec3<T> other = c1.length() > eps ? c1 : c2;
+                    vec3<T> p = sml::abs(other.z) < nearaxis * other.length() ? vec3<T>(other.y, -other.x, static_cast<T>(0)) : vec3<T>(other.z, static_cast<T>(0), -other.x);
+                    T lp = p.length();
+
+                    x = ln > eps ? n / ln : lp > eps ? p / lp : vec3<T>(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
+                }
+
+                vec3<T> y = c1 - x * vec3<T>::dot(x, c1);
+                T ly = y.length();
+
+                if (ly > eps)
+                {
+                    y /= ly;
+                }
+                else
+                {
+                    // cross(z, x) with z from the third column, any axis perpendicular to x when that
+                    // is degenerate as well (unit y for x = unit x)
+                    valid = false;
+
+                    vec3<T> w = c2 - x * vec3<T>::dot(x, c2);
+                    T lw = w.length();
+
+                    if (lw > eps)
+                    {
+                        y = vec3<T>::cross(w / lw, x);
+                    }
+                    else
+                    {
+                        y = sml::abs(x.z) < nearaxis ? vec3<T>(-x.y, x.x, static_cast<T>(0)) : vec3<T>(x.z, static_cast<T>(0), -x.x);
+                        y /= y.length();
+                    }
+                }
+
+                vec3<T> z = vec3<T>::cross(x, y);
+
+                translation = vec3<T>(m30, m31, m32);
+                scale = vec3<T>(sx, vec3<T>::dot(y, c1), vec3<T>::dot(z, c2));
+                rotation = quat<T>::frommatrix3(mat3<T>(x.x, x.y, x.z, y.x, y.y, y.z, z.x, z.y, z.z));
+
+                return valid && sml::abs(scale.z) > eps;
+            }
+
             SML_NO_DISCARD inline std::string toString() const noexcept
             {
                 return std::to_string(m00) + ", " + std::to_string(m10) + ", " + std::to_string(m20) + std::to_string(m30) + "\n" 
@@ -720,6 +839,24 @@ namespace sml
                 return res;
             }
 
+            // translate(translation) * rotation * scale(scale) without the matrix products, the
+            // rotation columns come straight from the quaternion, which must be normalized
+            SML_NO_DISCARD static inline constexpr mat4 compose(const vec3<T>& translation, const quat<T>& rotation, const vec3<T>& scale) noexcept
+            {
+                const T one = static_cast<T>(1);
+                const T zero = static_cast<T>(0);
+
+                T x2 = rotation.x + rotation.x, y2 = rotation.y + rotation.y, z2 = rotation.z + rotation.z;
+                T xx = rotation.x * x2, yy = rotation.y * y2, zz = rotation.z * z2;
+                T xy = rotation.x * y2, xz = rotation.x * z2, yz = rotation.y * z2;
+                T wx = rotation.w * x2, wy = rotation.w * y2, wz = rotation.w * z2;
+
+                return mat4((one - (yy + zz)) * scale.x, (xy + wz) * scale.x, (xz - wy) * scale.x, zero,
+                            (xy - wz) * scale.y, (one - (xx + zz)) * scale.y, (yz + wx) * scale.y, zero,
+                            (xz + wy) * scale.z, (yz - wx) * scale.z, (one - (xx + yy)) * scale.z, zero,
+                            translation.x, translation.y, translation.z, one);
+            }
+
             SML_NO_DISCARD static inline constexpr mat4 rotateX(T theta) noexcept
             {
                 mat4 res(static_cast<T>(1));
@@ -866,12 +1003,13 @@ namespace sml
     {
         alignas(simdalign<T>::value) vec4<T> res;
 
-        if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
         {
-            __m128 x = _mm_broadcast_ss(&rhs.x);
-            __m128 y = _mm_broadcast_ss(&rhs.y);
-            __m128 z = _mm_broadcast_ss(&rhs.z);
-            __m128 w = _mm_broadcast_ss(&rhs.w);
+            __m128 x = _mm_set1_ps(rhs.x);
+            __m128 y = _mm_set1_ps(rhs.y);
+            __m128 z = _mm_set1_ps(rhs.z);
+            __m128 w = _mm_set1_ps(rhs.w);
 
             __m128 c0 = _mm_load_ps(&lhs.m00);
             __m128 c1 = _mm_load_ps(&lhs.m10);
@@ -882,8 +1020,10 @@ namespace sml
 
             return res;
         }
+#endif
 
-        if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+        if constexpr (simdf64<T>::value)
         {
             __m256d x = _mm256_set1_pd(rhs.x);
             __m256d y = _mm256_set1_pd(rhs.y);
@@ -899,6 +1039,7 @@ namespace sml
 
             return res;
         }
+#endif
 
         T x = lhs.m00 * rhs.x + lhs.m10 * rhs.y + lhs.m20 * rhs.z + lhs.m30 * rhs.w;
         T y = lhs.m01 * rhs.x + lhs.m11 * rhs.y + lhs.m21 * rhs.z + lhs.m31 * rhs.w;
@@ -911,6 +1052,10 @@ namespace sml
     // Predefined types
     typedef mat4<f32> fmat4;
     typedef mat4<f64> dmat4;
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class mat4<f32>)
+    SML_EXTERN_TEMPLATE(class mat4<f64>)
+SML_NAMESPACE_END
 
 #endif // sml_mat4_h__
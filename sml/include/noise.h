@@ -0,0 +1,870 @@
+#ifndef sml_noise_h__
+#define sml_noise_h__
+
+/* noise.h -- procedural noise of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mask.h"
+
+// Perlin, simplex, value and Worley (cellular) noise with analytic derivatives. Every noise is
+// written once against the narrow<T> / wide<T> interface, the single point functions run it on
+// one T and the structure of arrays functions on 8 (f32) or 4 (f64) points at a time.
+//
+// Lattice points are hashed with the permutation polynomial (34x^2 + 10x) mod 289 of Gustavson
+// and McEwan ("Demystifying noise"), which is exact in floating point, so the hash needs no integer
+// SIMD (AVX has none) and every lane gets the same value the scalar path does. The noise
+// repeats every 289 units along the axes, simplex noise only along offsets whose components
+// add up to zero (the skew of its lattice is irrational).
+
+SML_NAMESPACE_BEGIN
+    enum class noisetype
+    {
+        perlin,
+        simplex,
+        value,
+        worley
+    };
+
+    // Fractal Brownian motion, the sum of 'octaves' noise layers where every layer has
+    // 'lacunarity' times the frequency and 'gain' times the amplitude of the layer before. The
+    // first layer has amplitude 1, the sum isn't normalized.
+    template<typename T>
+    struct fbmparams
+    {
+        u32 octaves = 5;
+        T frequency = static_cast<T>(1);
+        T lacunarity = static_cast<T>(2);
+        T gain = static_cast<T>(0.5);
+    };
+
+    // Points and results of the array noise functions in structure of arrays form, every array
+    // is indexed by point. 'dimensions' (2 to 4) position streams are read. The derivatives are
+    // optional, they are skipped when derivative[0] is null. 'second' receives the distance to
+    // the second closest feature point of Worley noise and is ignored by the other noises, it's
+    // optional as well.
+    template<typename T>
+    struct noisestreams
+    {
+        const T* position[4];
+        u32 dimensions;
+
+        T* value;
+        T* derivative[4];
+        T* second;
+    };
+
+    namespace detail
+    {
+        // Hash and interpolation helpers on O::lanes points
+        template<typename O, typename T>
+        struct noisemath
+        {
+            typedef typename O::type R;
+
+            static inline R constant(f64 c) noexcept
+            {
+                return O::set1(static_cast<T>(c));
+            }
+
+            static inline R fract(R a) noexcept
+            {
+                return O::sub(a, O::floor(a));
+            }
+
+            // a mod 289 in [0, 289) for integral a, the rounded reciprocal can put the quotient
+            // one off, which the two selects correct so equal lattice points always hash equal
+            static inline R mod289(R a) noexcept
+            {
+                R m = constant(289.0);
+                R r = O::sub(a, O::mul(O::floor(O::mul(a, constant(1.0 / 289.0))), m));
+
+                r = O::select(O::ge(r, m), O::sub(r, m), r);
+                return O::select(O::lt(r, O::zero()), O::add(r, m), r);
+            }
+
+            // (34a + 10)a mod 289, exact in f32 for integral a in [-1, 577]
+            static inline R permute(R a) noexcept
+            {
+                return mod289(O::mul(O::add(O::mul(a, constant(34.0)), constant(10.0)), a));
+            }
+
+            // Hash in [0, 289) of an integral lattice point, every coordinate in [-1, 289]
+            template<size_t N>
+            static inline R hash(const R (&lattice)[N]) noexcept
+            {
+                R h = permute(lattice[N - 1]);
+
+                for (size_t k = N - 1; k-- > 0;)
+                {
+                    h = permute(O::add(h, lattice[k]));
+                }
+
+                return h;
+            }
+
+            // Component k of the N dimensional R sequence (Roberts), fract(h * alpha) spreads the
+            // 289 hashes evenly over the unit cube
+            static inline constexpr f64 alpha(size_t n, size_t k) noexcept
+            {
+                constexpr f64 a2[2] = { 0.7548776662466927, 0.5698402909980532 };
+                constexpr f64 a3[3] = { 0.8191725133961645, 0.6710436067037893, 0.5497004779019703 };
+                constexpr f64 a4[4] = { 0.8566748838545029, 0.7338918566271260, 0.6287067210378087, 0.5385972572236101 };
+
+                return n == 2 ? a2[k] : n == 3 ? a3[k] : a4[k];
+            }
+
+            // Point in [0, 1)^N picked by a hash
+            template<size_t N>
+            static inline void jitter(R h, R (&v)[N]) noexcept
+            {
+                for (size_t k = 0; k < N; k++)
+                {
+                    v[k] = fract(O::mul(h, constant(alpha(N, k))));
+                }
+            }
+
+            // Unit gradient picked by a hash
+            template<size_t N>
+            static inline void gradient(R h, R (&g)[N]) noexcept
+            {
+                jitter(h, g);
+
+                R lsq = O::zero();
+                for (size_t k = 0; k < N; k++)
+                {
+                    g[k] = O::sub(O::add(g[k], g[k]), constant(1.0));
+                    lsq = O::madd(g[k], g[k], lsq);
+                }
+
+                R inv = O::div(constant(1.0), O::sqrt(O::max(lsq, constant(1e-4))));
+                for (size_t k = 0; k < N; k++)
+                {
+                    g[k] = O::mul(g[k], inv);
+                }
+            }
+
+            template<size_t N>
+            static inline R dot(const R (&a)[N], const R (&b)[N]) noexcept
+            {
+                R d = O::mul(a[0], b[0]);
+
+                for (size_t k = 1; k < N; k++)
+                {
+                    d = O::madd(a[k], b[k], d);
+                }
+
+                return d;
+            }
+
+            // Quintic fade 6f^5 - 15f^4 + 10f^3 and its derivative 30f^2(f - 1)^2
+            static inline R fade(R f) noexcept
+            {
+                R f3 = O::mul(O::mul(f, f), f);
+                return O::mul(f3, O::madd(f, O::madd(f, constant(6.0), constant(-15.0)), constant(10.0)));
+            }
+
+            static inline R dfade(R f) noexcept
+            {
+                R g = O::mul(f, O::sub(f, constant(1.0)));
+                return O::mul(constant(30.0), O::mul(g, g));
+            }
+        };
+
+        // Perlin (gradient) noise when Gradient is true, value noise when false. Both blend the
+        // 2^N corners of the lattice cell with the quintic fade, Perlin blends the dot product of
+        // the corner gradient with the offset to the corner, value noise a random value per corner.
+        template<bool Gradient>
+        struct latticekernel
+        {
+            static constexpr size_t dimensions = 4;
+
+            template<size_t N, typename O, typename T, bool Derivative>
+            inline typename O::type eval(const typename O::type (&p)[N], typename O::type (&d)[N], typename O::type& second) const noexcept
+            {
+                typedef typename O::type R;
+                typedef noisemath<O, T> M;
+
+                R one = M::constant(1.0);
+                R cell[N], f[N], u[N], du[N];
+
+                for (size_t k = 0; k < N; k++)
+                {
+                    R fl = O::floor(p[k]);
+
+                    f[k] = O::sub(p[k], fl);
+                    cell[k] = M::mod289(fl);
+                    u[k] = M::fade(f[k]);
+                    du[k] = M::dfade(f[k]);
+
+                    if constexpr (Derivative)
+                    {
+                        d[k] = O::zero();
+                    }
+                }
+
+                R value = O::zero();
+
+                for (size_t c = 0; c < (size_t(1) << N); c++)
+                {
+                    R lattice[N], weight[N];
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        bool upper = (c >> k) & 1;
+
+                        lattice[k] = upper ? O::add(cell[k], one) : cell[k];
+                        weight[k] = upper ? u[k] : O::sub(one, u[k]);
+                    }
+
+                    R h = M::hash(lattice);
+                    R n, g[N];
+
+                    if constexpr (Gradient)
+                    {
+                        R offset[N];
+                        for (size_t k = 0; k < N; k++)
+                        {
+                            offset[k] = (c >> k) & 1 ? O::sub(f[k], one) : f[k];
+                        }
+
+                        M::gradient(h, g);
+                        n = M::dot(g, offset);
+                    }
+                    else
+                    {
+                        n = O::sub(O::mul(h, M::constant(2.0 / 288.0)), one);
+                    }
+
+                    R w = weight[0];
+                    for (size_t k = 1; k < N; k++)
+                    {
+                        w = O::mul(w, weight[k]);
+                    }
+
+                    value = O::madd(w, n, value);
+
+                    if constexpr (Derivative)
+                    {
+                        for (size_t j = 0; j < N; j++)
+                        {
+                            // d(weight product) / dp[j], only factor j depends on p[j]
+                            R dw = (c >> j) & 1 ? du[j] : O::neg(du[j]);
+                            for (size_t k = 0; k < N; k++)
+                            {
+                                if (k != j)
+                                {
+                                    dw = O::mul(dw, weight[k]);
+                                }
+                            }
+
+                            d[j] = O::madd(dw, n, d[j]);
+
+                            if constexpr (Gradient)
+                            {
+                                d[j] = O::madd(w, g[j], d[j]);
+                            }
+                        }
+                    }
+                }
+
+                second = O::zero();
+
+                // Unit gradients reach at most sqrt(N) / 2
+                if constexpr (Gradient)
+                {
+                    R scale = M::constant(2.0 / sml::sqrt(static_cast<f64>(N)));
+
+                    value = O::mul(value, scale);
+
+                    if constexpr (Derivative)
+                    {
+                        for (size_t k = 0; k < N; k++)
+                        {
+                            d[k] = O::mul(d[k], scale);
+                        }
+                    }
+                }
+
+                return value;
+            }
+        };
+
+        // Simplex noise (Perlin 2001) in 2 or 3 dimensions, the sum of the N + 1 corners of the
+        // simplex around p, each a radial falloff (r^2 - |x|^2)^4 times the corner gradient dot x
+        struct simplexkernel
+        {
+            static constexpr size_t dimensions = 3;
+
+            template<size_t N, typename O, typename T, bool Derivative>
+            static inline void corner(const typename O::type (&x)[N], const typename O::type (&lattice)[N], typename O::type falloff, typename O::type& value, typename O::type (&d)[N]) noexcept
+            {
+                typedef typename O::type R;
+                typedef noisemath<O, T> M;
+
+                R g[N];
+                M::gradient(M::hash(lattice), g);
+
+                R t = O::max(O::sub(falloff, M::dot(x, x)), O::zero());
+                R t2 = O::mul(t, t);
+                R t4 = O::mul(t2, t2);
+                R n = M::dot(g, x);
+
+                value = O::madd(t4, n, value);
+
+                if constexpr (Derivative)
+                {
+                    // d(t^4) / dx = -8t^3 x
+                    R c = O::mul(M::constant(-8.0), O::mul(O::mul(t2, t), n));
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        d[k] = O::madd(t4, g[k], O::madd(c, x[k], d[k]));
+                    }
+                }
+            }
+
+            template<size_t N, typename O, typename T, bool Derivative>
+            inline typename O::type eval(const typename O::type (&p)[N], typename O::type (&d)[N], typename O::type& second) const noexcept
+            {
+                static_assert(N == 2 || N == 3, "simplex noise is 2 or 3 dimensional");
+
+                typedef typename O::type R;
+                typedef noisemath<O, T> M;
+
+                // Skew p onto the integer lattice of the simplices, F = (sqrt(N + 1) - 1) / N and
+                // unskew with G = (1 - 1 / sqrt(N + 1)) / N
+                const f64 skew = N == 2 ? 0.36602540378443865 : 1.0 / 3.0;
+                const f64 unskew = N == 2 ? 0.21132486540518713 : 1.0 / 6.0;
+
+                R one = M::constant(1.0);
+                R zero = O::zero();
+                R s = p[0];
+                for (size_t k = 1; k < N; k++)
+                {
+                    s = O::add(s, p[k]);
+                }
+
+                s = O::mul(s, M::constant(skew));
+
+                R cell[N], x0[N];
+                R t = O::zero();
+
+                for (size_t k = 0; k < N; k++)
+                {
+                    cell[k] = O::floor(O::add(p[k], s));
+                    t = O::add(t, cell[k]);
+                }
+
+                t = O::mul(t, M::constant(unskew));
+
+                for (size_t k = 0; k < N; k++)
+                {
+                    x0[k] = O::sub(p[k], O::sub(cell[k], t));
+                    cell[k] = M::mod289(cell[k]);
+
+                    if constexpr (Derivative)
+                    {
+                        d[k] = O::zero();
+                    }
+                }
+
+                // The middle corners step along the axes in decreasing order of x0
+                R step[N - 1][N];
+
+                if constexpr (N == 2)
+                {
+                    step[0][0] = O::select(O::gt(x0[0], x0[1]), one, zero);
+                    step[0][1] = O::sub(one, step[0][0]);
+                }
+                else
+                {
+                    R g[3] = { O::select(O::ge(x0[0], x0[1]), one, zero), O::select(O::ge(x0[1], x0[2]), one, zero), O::select(O::ge(x0[2], x0[0]), one, zero) };
+                    R l[3] = { O::sub(one, g[2]), O::sub(one, g[0]), O::sub(one, g[1]) };
+
+                    for (size_t k = 0; k < 3; k++)
+                    {
+                        step[0][k] = O::min(g[k], l[k]);
+                        step[1][k] = O::max(g[k], l[k]);
+                    }
+                }
+
+                // A falloff radius of sqrt(0.5) keeps every corner inside the simplices that share
+                // it (0.6, as in Perlin's reference, leaves small discontinuities). The scales were
+                // measured over the 289 period and bring the result to about [-1, 1].
+                R falloff = M::constant(0.5);
+                R value = O::zero();
+
+                for (size_t c = 0; c <= N; c++)
+                {
+                    R x[N], lattice[N];
+                    R offset = M::constant(unskew * static_cast<f64>(c));
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        R corner = c == 0 ? zero : c == N ? one : step[c - 1][k];
+
+                        x[k] = O::add(O::sub(x0[k], corner), offset);
+                        lattice[k] = O::add(cell[k], corner);
+                    }
+
+                    simplexkernel::corner<N, O, T, Derivative>(x, lattice, falloff, value, d);
+                }
+
+                R scale = M::constant(N == 2 ? 99.0 : 107.0);
+                value = O::mul(value, scale);
+
+                if constexpr (Derivative)
+                {
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        d[k] = O::mul(d[k], scale);
+                    }
+                }
+
+                second = O::zero();
+                return value;
+            }
+        };
+
+        // Worley (cellular) noise in 2 or 3 dimensions, the distance to the closest of the
+        // feature points jittered into every lattice cell. Only the 3^N cells around p are searched,
+        // like every cellular noise that does so a closer point two cells away is missed in rare
+        // spots. 'second' gets the distance to the second closest point.
+        struct worleykernel
+        {
+            static constexpr size_t dimensions = 3;
+
+            template<size_t N, typename O, typename T, bool Derivative>
+            inline typename O::type eval(const typename O::type (&p)[N], typename O::type (&d)[N], typename O::type& second) const noexcept
+            {
+                static_assert(N == 2 || N == 3, "worley noise is 2 or 3 dimensional");
+
+                typedef typename O::type R;
+                typedef noisemath<O, T> M;
+
+                R cell[N], f[N], nearest[N];
+
+                for (size_t k = 0; k < N; k++)
+                {
+                    R fl = O::floor(p[k]);
+
+                    f[k] = O::sub(p[k], fl);
+                    cell[k] = M::mod289(fl);
+                    nearest[k] = O::zero();
+                }
+
+                // Squared distances, anything in the neighbourhood is closer than 4N
+                R first = M::constant(4.0 * N);
+                R next = first;
+
+                const size_t cells = N == 2 ? 9 : 27;
+
+                for (size_t c = 0; c < cells; c++)
+                {
+                    R lattice[N], offset[N], delta[N];
+
+                    for (size_t k = 0, r = c; k < N; k++, r /= 3)
+                    {
+                        offset[k] = M::constant(static_cast<f64>(r % 3) - 1.0);
+                        lattice[k] = O::add(cell[k], offset[k]);
+                    }
+
+                    M::jitter(M::hash(lattice), delta);
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        delta[k] = O::sub(O::add(offset[k], delta[k]), f[k]);
+                    }
+
+                    R dsq = M::dot(delta, delta);
+                    auto closer = O::lt(dsq, first);
+
+                    next = O::select(closer, first, O::min(next, dsq));
+                    first = O::min(first, dsq);
+
+                    if constexpr (Derivative)
+                    {
+                        for (size_t k = 0; k < N; k++)
+                        {
+                            nearest[k] = O::select(closer, delta[k], nearest[k]);
+                        }
+                    }
+                }
+
+                R distance = O::sqrt(first);
+                second = O::sqrt(next);
+
+                // p - feature normalized, delta points from p to the feature
+                if constexpr (Derivative)
+                {
+                    R inv = O::div(M::constant(-1.0), O::max(distance, M::constant(1e-12)));
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        d[k] = O::mul(nearest[k], inv);
+                    }
+                }
+
+                return distance;
+            }
+        };
+
+        template<typename K, typename T>
+        struct fbmkernel
+        {
+            static constexpr size_t dimensions = K::dimensions;
+
+            K noise;
+            fbmparams<T> params;
+
+            template<size_t N, typename O, typename, bool Derivative>
+            inline typename O::type eval(const typename O::type (&p)[N], typename O::type (&d)[N], typename O::type& second) const noexcept
+            {
+                typedef typename O::type R;
+
+                R value = O::zero();
+                T frequency = params.frequency;
+                T amplitude = static_cast<T>(1);
+
+                if constexpr (Derivative)
+                {
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        d[k] = O::zero();
+                    }
+                }
+
+                for (u32 o = 0; o < params.octaves; o++)
+                {
+                    R q[N], g[N], s;
+                    R f = O::set1(frequency);
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        q[k] = O::mul(p[k], f);
+                    }
+
+                    value = O::madd(O::set1(amplitude), noise.template eval<N, O, T, Derivative>(q, g, s), value);
+
+                    if constexpr (Derivative)
+                    {
+                        R a = O::set1(amplitude * frequency);
+
+                        for (size_t k = 0; k < N; k++)
+                        {
+                            d[k] = O::madd(a, g[k], d[k]);
+                        }
+                    }
+
+                    frequency *= params.lacunarity;
+                    amplitude *= params.gain;
+                }
+
+                second = O::zero();
+                return value;
+            }
+        };
+
+        template<typename K, typename T, size_t N>
+        static inline T noisepoint(const K& kernel, const T (&p)[N], T* derivative, T* second) noexcept
+        {
+            T d[N], s, value;
+
+            if (derivative)
+            {
+                value = kernel.template eval<N, narrow<T>, T, true>(p, d, s);
+
+                for (size_t k = 0; k < N; k++)
+                {
+                    derivative[k] = d[k];
+                }
+            }
+            else
+            {
+                value = kernel.template eval<N, narrow<T>, T, false>(p, d, s);
+            }
+
+            if (second)
+            {
+                *second = s;
+            }
+
+            return value;
+        }
+
+        template<typename K, template<typename> class V, typename T>
+        static inline T noisevector(const K& kernel, const V<T>& p, V<T>* derivative, T* second = nullptr) noexcept
+        {
+            constexpr size_t N = veclanes<V>::value;
+            static_assert(N <= K::dimensions, "the noise doesn't support this many dimensions");
+
+            T q[N];
+            for (size_t k = 0; k < N; k++)
+            {
+                q[k] = p.v[k];
+            }
+
+            return noisepoint(kernel, q, derivative ? derivative->v : nullptr, second);
+        }
+
+        // The noise of O::lanes points starting at i
+        template<size_t N, bool Derivative, typename O, typename T, typename K>
+        static inline void noiselanes(const K& kernel, const noisestreams<T>& s, size_t i) noexcept
+        {
+            typedef typename O::type R;
+
+            R p[N], d[N], second;
+
+            for (size_t k = 0; k < N; k++)
+            {
+                p[k] = O::load(s.position[k] + i);
+            }
+
+            O::store(s.value + i, kernel.template eval<N, O, T, Derivative>(p, d, second));
+
+            if constexpr (Derivative)
+            {
+                for (size_t k = 0; k < N; k++)
+                {
+                    O::store(s.derivative[k] + i, d[k]);
+                }
+            }
+
+            if (s.second)
+            {
+                O::store(s.second + i, second);
+            }
+        }
+
+        template<size_t N, bool Derivative, typename K, typename T>
+        static inline void noisearray(const K& kernel, const noisestreams<T>& s, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_AVX
+            if constexpr (simdwide<T>::value)
+            {
+                for (size_t end = count - count % wide<T>::lanes; i < end; i += wide<T>::lanes)
+                {
+                    noiselanes<N, Derivative, wide<T>>(kernel, s, i);
+                }
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                noiselanes<N, Derivative, narrow<T>>(kernel, s, i);
+            }
+        }
+
+        template<size_t N, typename K, typename T>
+        static inline void noisearray(const K& kernel, const noisestreams<T>& s, size_t count) noexcept
+        {
+            if constexpr (N <= K::dimensions)
+            {
+                if (s.derivative[0])
+                {
+                    noisearray<N, true>(kernel, s, count);
+                }
+                else
+                {
+                    noisearray<N, false>(kernel, s, count);
+                }
+            }
+        }
+
+        template<typename K, typename T>
+        static inline void noisedispatch(const K& kernel, const noisestreams<T>& s, size_t count) noexcept
+        {
+            switch (s.dimensions)
+            {
+                case 2:
+                    noisearray<2>(kernel, s, count);
+                    break;
+                case 3:
+                    noisearray<3>(kernel, s, count);
+                    break;
+                case 4:
+                    noisearray<4>(kernel, s, count);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        template<typename T, typename F>
+        static inline void fbmdispatch(noisetype type, const fbmparams<T>& params, const F& run) noexcept
+        {
+            switch (type)
+            {
+                case noisetype::perlin:
+                    run(fbmkernel<latticekernel<true>, T>{ {}, params });
+                    break;
+                case noisetype::simplex:
+                    run(fbmkernel<simplexkernel, T>{ {}, params });
+                    break;
+                case noisetype::value:
+                    run(fbmkernel<latticekernel<false>, T>{ {}, params });
+                    break;
+                case noisetype::worley:
+                    run(fbmkernel<worleykernel, T>{ {}, params });
+                    break;
+            }
+        }
+    } // namespace detail
+
+    // Perlin noise of a vec2, vec3 or vec4 in [-1, 1], zero on the integer lattice
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline T perlin(const V<T>& p) noexcept
+    {
+        return detail::noisevector(detail::latticekernel<true>(), p, static_cast<V<T>*>(nullptr));
+    }
+
+    // Same, also returns the derivative (gradient) of the noise at p
+    template<template<typename> class V, typename T>
+    inline T perlin(const V<T>& p, V<T>& derivative) noexcept
+    {
+        return detail::noisevector(detail::latticekernel<true>(), p, &derivative);
+    }
+
+    // Simplex noise of a vec2 or vec3 in about [-1, 1]
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline T simplex(const V<T>& p) noexcept
+    {
+        return detail::noisevector(detail::simplexkernel(), p, static_cast<V<T>*>(nullptr));
+    }
+
+    template<template<typename> class V, typename T>
+    inline T simplex(const V<T>& p, V<T>& derivative) noexcept
+    {
+        return detail::noisevector(detail::simplexkernel(), p, &derivative);
+    }
+
+    // Value noise of a vec2, vec3 or vec4 in [-1, 1]
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline T valuenoise(const V<T>& p) noexcept
+    {
+        return detail::noisevector(detail::latticekernel<false>(), p, static_cast<V<T>*>(nullptr));
+    }
+
+    template<template<typename> class V, typename T>
+    inline T valuenoise(const V<T>& p, V<T>& derivative) noexcept
+    {
+        return detail::noisevector(detail::latticekernel<false>(), p, &derivative);
+    }
+
+    // Worley noise of a vec2 or vec3, the distance to the closest feature point (F1) in x and
+    // to the second closest (F2) in y
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline vec2<T> worley(const V<T>& p) noexcept
+    {
+        T second;
+        T first = detail::noisevector(detail::worleykernel(), p, static_cast<V<T>*>(nullptr), &second);
+
+        return vec2<T>(first, second);
+    }
+
+    // Same, also returns the derivative of F1 at p (the unit vector away from the closest point)
+    template<template<typename> class V, typename T>
+    inline vec2<T> worley(const V<T>& p, V<T>& derivative) noexcept
+    {
+        T second;
+        T first = detail::noisevector(detail::worleykernel(), p, &derivative, &second);
+
+        return vec2<T>(first, second);
+    }
+
+    // Fractal sum of a noise (F1 for Worley). Simplex and Worley noise of a vec4 return 0.
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline T fbm(noisetype type, const V<T>& p, const fbmparams<T>& params = fbmparams<T>()) noexcept
+    {
+        T value = static_cast<T>(0);
+
+        detail::fbmdispatch(type, params, [&](const auto& kernel)
+        {
+            if constexpr (veclanes<V>::value <= std::decay_t<decltype(kernel)>::dimensions)
+            {
+                value = detail::noisevector(kernel, p, static_cast<V<T>*>(nullptr));
+            }
+        });
+
+        return value;
+    }
+
+    template<template<typename> class V, typename T>
+    inline T fbm(noisetype type, const V<T>& p, V<T>& derivative, const fbmparams<T>& params = fbmparams<T>()) noexcept
+    {
+        T value = static_cast<T>(0);
+        derivative = V<T>();
+
+        detail::fbmdispatch(type, params, [&](const auto& kernel)
+        {
+            if constexpr (veclanes<V>::value <= std::decay_t<decltype(kernel)>::dimensions)
+            {
+                value = detail::noisevector(kernel, p, &derivative);
+            }
+        });
+
+        return value;
+    }
+
+    // The array forms evaluate every point of the streams, 8 (f32) or 4 (f64) at a time on the
+    // AVX backends. Simplex and Worley noise take 2 or 3 dimensions, the streams are left
+    // untouched for other counts.
+    template<typename T>
+    inline void perlin(const noisestreams<T>& streams, size_t count) noexcept
+    {
+        detail::noisedispatch(detail::latticekernel<true>(), streams, count);
+    }
+
+    template<typename T>
+    inline void simplex(const noisestreams<T>& streams, size_t count) noexcept
+    {
+        detail::noisedispatch(detail::simplexkernel(), streams, count);
+    }
+
+    template<typename T>
+    inline void valuenoise(const noisestreams<T>& streams, size_t count) noexcept
+    {
+        detail::noisedispatch(detail::latticekernel<false>(), streams, count);
+    }
+
+    template<typename T>
+    inline void worley(const noisestreams<T>& streams, size_t count) noexcept
+    {
+        detail::noisedispatch(detail::worleykernel(), streams, count);
+    }
+
+    template<typename T>
+    inline void fbm(noisetype type, const noisestreams<T>& streams, size_t count, const fbmparams<T>& params = fbmparams<T>()) noexcept
+    {
+        detail::fbmdispatch(type, params, [&](const auto& kernel)
+        {
+            detail::noisedispatch(kernel, streams, count);
+        });
+    }
+SML_NAMESPACE_END
+
+#endif // sml_noise_h__
@@ -0,0 +1,226 @@
+#ifndef sml_plane_h__
+#define sml_plane_h__
+
+/* plane.h -- plane of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "common.h"
+#include "smltypes.h"
+#include "simd.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat4.h"
+
+SML_NAMESPACE_BEGIN
+    // Points p with dot(normal, p) + d = 0, stored as one vec4 (normal, d). The signed distance
+    // of a point is positive on the side the normal points to, and only a distance when the
+    // normal has unit length.
+    template<typename T>
+    class alignas(simdalign<T>::value) plane
+    {
+        public:
+            constexpr plane() noexcept
+            {
+                v.set(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
+            }
+
+            constexpr plane(const vec3<T>& normal, T d) noexcept
+            {
+                set(normal, d);
+            }
+
+            constexpr plane(T a, T b, T c, T d) noexcept
+            {
+                v.set(a, b, c, d);
+            }
+
+            constexpr explicit plane(const vec4<T>& coefficients) noexcept
+            {
+                v = coefficients;
+            }
+
+            constexpr void set(const vec3<T>& normal, T d) noexcept
+            {
+                v.set(normal.x, normal.y, normal.z, d);
+            }
+
+            // Operators
+            inline constexpr bool operator == (const plane& other) const noexcept
+            {
+                return v == other.v;
+            }
+
+            inline constexpr bool operator != (const plane& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            SML_NO_DISCARD inline constexpr vec3<T> normal() const noexcept
+            {
+                return vec3<T>(v.x, v.y, v.z);
+            }
+
+            SML_NO_DISCARD inline constexpr T distance() const noexcept
+            {
+                return v.w;
+            }
+
+            // Scales the plane to a unit normal, a zero normal is left as it is
+            inline constexpr void normalize() noexcept
+            {
+                T length = normal().length();
+
+                if (length > static_cast<T>(0))
+                    v /= length;
+            }
+
+            SML_NO_DISCARD inline constexpr plane normalized() const noexcept
+            {
+                plane copy(*this);
+                copy.normalize();
+
+                return copy;
+            }
+
+            SML_NO_DISCARD inline constexpr T signeddistance(const vec3<T>& point) const noexcept
+            {
+                return v.x * point.x + v.y * point.y + v.z * point.z + v.w;
+            }
+
+            // Closest point on the plane, the normal must have unit length
+            SML_NO_DISCARD inline constexpr vec3<T> project(const vec3<T>& point) const noexcept
+            {
+                return point - normal() * signeddistance(point);
+            }
+
+            // The plane through the transformed points. Planes transform with the inverse transpose
+            // of the matrix, which is computed here, transformed(matrix, true) takes it as is.
+            // Normalize the result when the matrix scales.
+            SML_NO_DISCARD inline constexpr plane transformed(const mat4<T>& matrix, bool inversetranspose = false) const noexcept
+            {
+                return plane(inversetranspose ? matrix * v : matrix.inverted().transposed() * v);
+            }
+
+            // Statics
+            SML_NO_DISCARD inline static constexpr plane frompointnormal(const vec3<T>& point, const vec3<T>& normal) noexcept
+            {
+                return plane(normal, -normal.dot(point));
+            }
+
+            // Plane through a, b and c with the normal of the counter clockwise winding, normalized
+            SML_NO_DISCARD inline static constexpr plane frompoints(const vec3<T>& a, const vec3<T>& b, const vec3<T>& c) noexcept
+            {
+                return frompointnormal(a, vec3<T>::cross(b - a, c - a)).normalized();
+            }
+
+            // Variables
+            vec4<T> v;
+    };
+
+    // Predefined types
+    typedef plane<f32> fplane;
+    typedef plane<f64> dplane;
+
+    // Signed distances of the points to the plane, 8 (f32) or 4 (f64) at a time on the AVX backends
+    template<typename T>
+    inline void signeddistance(const plane<T>& p, const vec3<T>* points, size_t count, T* out) noexcept
+    {
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> O;
+            typedef typename O::type R;
+
+            R a = O::set1(p.v.x), b = O::set1(p.v.y), c = O::set1(p.v.z), d = O::set1(p.v.w);
+
+            for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+            {
+                R x, y, z, w;
+                O::load4(points[i].v, sizeof(vec3<T>) / sizeof(T), x, y, z, w);
+
+                O::store(out + i, O::madd(a, x, O::madd(b, y, O::madd(c, z, d))));
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            out[i] = p.signeddistance(points[i]);
+        }
+    }
+
+    // Writes 1 for the points in front of the plane, -1 for those behind it and 0 for the ones
+    // within epsilon of it. Returns which sides occurred: bit 0 behind, bit 1 on, bit 2 in front, so
+    // 4 means every point is in front.
+    template<typename T>
+    inline u32 classify(const plane<T>& p, const vec3<T>* points, size_t count, s8* sides, T epsilon = static_cast<T>(0)) noexcept
+    {
+        u32 found = 0;
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> O;
+            typedef typename O::type R;
+
+            R a = O::set1(p.v.x), b = O::set1(p.v.y), c = O::set1(p.v.z), d = O::set1(p.v.w);
+            R front = O::set1(epsilon), back = O::set1(-epsilon);
+
+            for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+            {
+                R x, y, z, w;
+                O::load4(points[i].v, sizeof(vec3<T>) / sizeof(T), x, y, z, w);
+
+                R distance = O::madd(a, x, O::madd(b, y, O::madd(c, z, d)));
+                s32 infront = O::movemask(O::gt(distance, front));
+                s32 behind = O::movemask(O::lt(distance, back));
+
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    sides[i + l] = static_cast<s8>(((infront >> l) & 1) - ((behind >> l) & 1));
+                }
+
+                const s32 all = (1 << O::lanes) - 1;
+                found |= (behind ? 1u : 0u) | ((infront | behind) != all ? 2u : 0u) | (infront ? 4u : 0u);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            T distance = p.signeddistance(points[i]);
+            s8 side = static_cast<s8>(distance > epsilon ? 1 : distance < -epsilon ? -1 : 0);
+
+            sides[i] = side;
+            found |= 1u << (side + 1);
+        }
+
+        return found;
+    }
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class plane<f32>)
+    SML_EXTERN_TEMPLATE(class plane<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_plane_h__
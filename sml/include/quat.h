@@ -23,9 +23,116 @@
 #include "vec3.h"
 #include "vec4.h"
 #include "mat3.h"
+#include "mat4.h"
+#include "simd.h"
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+#if SML_SSE
+        // Hamilton product a * b of two xyzw quaternions
+        static inline __m128 quatmul(__m128 a, __m128 b) noexcept
+        {
+            const __m128 signw = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+
+            __m128 t0 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+            __m128 t1 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3)));
+            __m128 t2 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2)));
+            __m128 t3 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1)));
+
+            return _mm_sub_ps(_mm_add_ps(t0, _mm_xor_ps(_mm_add_ps(t1, t2), signw)), t3);
+        }
+#endif
+
+        // SIMD form of quat::frommatrix3 for wide<T>::lanes rotations at once, the arguments are
+        // the columns of the rotation matrices (m<column><row>) in structure of arrays form
+        template<typename T, typename R = typename wide<T>::type>
+        static inline void quatfrombasis(R m00, R m01, R m02, R m10, R m11, R m12, R m20, R m21, R m22, R& x, R& y, R& z, R& w) noexcept
+        {
+            typedef wide<T> W;
+
+            const R one = W::set1(static_cast<T>(1));
+            const R half = W::set1(static_cast<T>(0.5));
+
+            R tw = W::add(W::add(W::add(one, m00), m11), m22);
+            R tx = W::sub(W::sub(W::add(one, m00), m11), m22);
+            R ty = W::sub(W::add(W::sub(one, m00), m11), m22);
+            R tz = W::add(W::sub(W::sub(one, m00), m11), m22);
+
+            R s01 = W::add(m10, m01);
+            R s02 = W::add(m20, m02);
+            R s12 = W::add(m21, m12);
+            R d21 = W::sub(m12, m21);
+            R d02 = W::sub(m20, m02);
+            R d10 = W::sub(m01, m10);
+
+            R kx = W::gt(tx, tw);
+            R t = W::select(kx, tx, tw);
+            R ky = W::gt(ty, t);
+            t = W::select(ky, ty, t);
+            R kz = W::gt(tz, t);
+            t = W::select(kz, tz, t);
+
+            R scale = W::div(half, W::sqrt(t));
+
+            x = W::select(kz, s02, W::select(ky, s01, W::select(kx, tx, d21)));
+            y = W::select(kz, s12, W::select(ky, ty, W::select(kx, s01, d02)));
+            z = W::select(kz, tz, W::select(ky, s12, W::select(kx, s02, d10)));
+            w = W::select(kz, d10, W::select(ky, d02, W::select(kx, d21, tw)));
+
+            x = W::mul(x, scale);
+            y = W::mul(y, scale);
+            z = W::mul(z, scale);
+            w = W::mul(w, scale);
+        }
+
+        // Slerp of O::lanes pairs of unit quaternions in structure of arrays form, the short way
+        // around. The half angle comes from atan2 of the sine and cosine, which stays accurate for
+        // small angles where acos doesn't, and the weights fall back to a normalized lerp only
+        // once the sine is too small to divide by.
+        template<typename O, typename T>
+        static inline void quatslerp(typename O::type ax, typename O::type ay, typename O::type az, typename O::type aw,
+                                     typename O::type bx, typename O::type by, typename O::type bz, typename O::type bw,
+                                     typename O::type t, typename O::type& x, typename O::type& y, typename O::type& z, typename O::type& w) noexcept
+        {
+            typedef typename O::type R;
+
+            const R one = O::set1(static_cast<T>(1));
+
+            R c = O::madd(ax, bx, O::madd(ay, by, O::madd(az, bz, O::mul(aw, bw))));
+            auto flip = O::lt(c, O::zero());
+            bx = O::select(flip, O::neg(bx), bx);
+            by = O::select(flip, O::neg(by), by);
+            bz = O::select(flip, O::neg(bz), bz);
+            bw = O::select(flip, O::neg(bw), bw);
+            c = O::min(O::abs(c), one);
+
+            R s = O::sqrt(O::max(O::sub(one, O::mul(c, c)), O::zero()));
+            R angle = atan2<O, T>(s, c);
+            R sa, sb, unused;
+            sincos<O, T>(O::mul(angle, O::sub(one, t)), sa, unused);
+            sincos<O, T>(O::mul(angle, t), sb, unused);
+
+            auto small = O::lt(s, O::set1(std::is_same<T, f32>::value ? static_cast<T>(3e-4) : static_cast<T>(1e-8)));
+            R inverse = O::div(one, O::select(small, one, s));
+            R wa = O::select(small, O::sub(one, t), O::mul(sa, inverse));
+            R wb = O::select(small, t, O::mul(sb, inverse));
+
+            x = O::madd(ax, wa, O::mul(bx, wb));
+            y = O::madd(ay, wa, O::mul(by, wb));
+            z = O::madd(az, wa, O::mul(bz, wb));
+            w = O::madd(aw, wa, O::mul(bw, wb));
+
+            R length = O::madd(x, x, O::madd(y, y, O::madd(z, z, O::mul(w, w))));
+            R scale = O::div(one, O::sqrt(length));
+
+            x = O::mul(x, scale);
+            y = O::mul(y, scale);
+            z = O::mul(z, scale);
+            w = O::mul(w, scale);
+        }
+    } // namespace detail
 
-namespace sml
-{
 	template<typename T>
 	class alignas(simdalign<T>::value) quat
 	{
@@ -160,7 +267,16 @@ namespace sml
 
             quat& operator *= (const quat& other) noexcept
             {
-                alignas(simdalign<T>::value) vec3<T> res = (xyz * other.w) + (other.xyz * other.w) + vec3<T>::cross(xyz, other.xyz);
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    _mm_store_ps(v.v, detail::quatmul(_mm_load_ps(v.v), _mm_load_ps(other.v.v)));
+
+                    return *this;
+                }
+#endif
+
+                alignas(simdalign<T>::value) vec3<T> res = (xyz * other.w) + (other.xyz * w) + vec3<T>::cross(xyz, other.xyz);
                 T scalar = (w * other.w) - vec3<T>::dot(xyz, other.xyz);
 
                 set(res, scalar);
@@ -190,6 +306,41 @@ namespace sml
                 return q;
             }
 
+            // rsqrt based normalize, see vec4::normalizeFast. Quaternions with a length at or
+            // below epsilon become the identity rotation.
+            inline void normalizeFast() noexcept
+            {
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    __m128 me = _mm_load_ps(v.v);
+                    __m128 lsq = _mm_mul_ps(me, me);
+                    lsq = _mm_add_ps(lsq, _mm_shuffle_ps(lsq, lsq, 0xB1));
+                    lsq = _mm_add_ps(lsq, _mm_shuffle_ps(lsq, lsq, 0x4E));
+
+                    __m128 valid = _mm_cmpgt_ps(lsq, _mm_set1_ps(constants::epsilon * constants::epsilon));
+
+                    __m128 res = _mm_mul_ps(me, detail::rsqrtnr(lsq));
+                    _mm_store_ps(v.v, _mm_blendv_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), res, valid));
+
+                    return;
+                }
+#endif
+
+                v.normalizeFast();
+
+                if (v.none())
+                    w = static_cast<T>(1);
+            }
+
+            SML_NO_DISCARD inline quat normalizedFast() const noexcept
+            {
+                quat q(v);
+                q.normalizeFast();
+
+                return q;
+            }
+
             SML_NO_DISCARD inline constexpr T length() const noexcept
             {
                 return v.length();
@@ -232,6 +383,34 @@ namespace sml
                 return v.dot(other.v);
             }
 
+            // (axis * half angle, log |q|), the inverse of exp. For unit quaternions w is zero and
+            // log(q) * t scales the rotation angle by t.
+            SML_NO_DISCARD inline constexpr quat log() const noexcept
+            {
+                T vectorlength = xyz.length();
+                T scale = vectorlength > static_cast<T>(0) ? sml::atan2(vectorlength, w) / vectorlength : static_cast<T>(0);
+
+                return quat(xyz * scale, std::log(length()));
+            }
+
+            // e^w (cos |v|, v / |v| sin |v|) for the vector part v
+            SML_NO_DISCARD inline constexpr quat exp() const noexcept
+            {
+                T angle = xyz.length();
+                T magnitude = sml::exp(w);
+                T scale = angle > static_cast<T>(0) ? sml::sin(angle) / angle : static_cast<T>(1);
+
+                return quat(xyz * (scale * magnitude), sml::cos(angle) * magnitude);
+            }
+
+            // The rotation of a unit quaternion scaled to exponent times its angle, about the same axis
+            SML_NO_DISCARD inline constexpr quat pow(T exponent) const noexcept
+            {
+                quat l = log();
+
+                return quat(l.xyz * exponent, l.w * exponent).exp();
+            }
+
             SML_NO_DISCARD inline constexpr vec3<T> normalizeAngles(vec3<T> angles) const noexcept
             {
                 alignas(simdalign<T>::value) vec3<T> v(angles);
@@ -345,18 +524,34 @@ namespace sml
                 quat q = identity();
 
                 angle *= static_cast<T>(0.5);
-                axis.normalize();
 
-                q.xyz = axis * sml::sin(angle);
+                q.xyz = axis.normalized() * sml::sin(angle);
                 q.w = sml::cos(angle);
 
                 return q.normalized();
             }
 
-            SML_NO_DISCARD inline static constexpr quat frommatrix3(const mat3<T>& matrix)
+            // The matrix must be a pure rotation (orthonormal), scale has to be removed first
+            SML_NO_DISCARD inline static constexpr quat frommatrix3(const mat3<T>& matrix) noexcept
             {
-                // TODO (Roderick): Implement this
-                return quat();
+                return fromcolumns(&matrix.m00, &matrix.m10, &matrix.m20);
+            }
+
+            // Rotation of the upper 3x3, translation and the bottom row are ignored
+            SML_NO_DISCARD inline static constexpr quat frommatrix4(const mat4<T>& matrix) noexcept
+            {
+                return fromcolumns(&matrix.m00, &matrix.m10, &matrix.m20);
+            }
+
+            // Converts count matrices at once, 8 (f32) or 4 (f64) per iteration
+            inline static void frommatrix3(const mat3<T>* matrices, quat* out, size_t count) noexcept
+            {
+                frommatrices<sizeof(mat3<T>) / sizeof(T)>(&matrices->m00, out, count);
+            }
+
+            inline static void frommatrix4(const mat4<T>* matrices, quat* out, size_t count) noexcept
+            {
+                frommatrices<sizeof(mat4<T>) / sizeof(T)>(&matrices->m00, out, count);
             }
 
             SML_NO_DISCARD inline static constexpr quat slerp(const quat<T>& a, const quat<T>& b, T blend) noexcept
@@ -382,10 +577,12 @@ namespace sml
                     return a;
                 }
 
+                // Take the short way around, q and -q are the same rotation
+                quat to(b);
                 if (coshalfangle < static_cast<T>(0))
                 {
-                    b.xyz = -b.xyz;
-                    a.w = -a.w;
+                    to.xyz = -to.xyz;
+                    to.w = -to.w;
                     coshalfangle = -coshalfangle;
                 }
 
@@ -404,7 +601,7 @@ namespace sml
                     blendB = blend;
                 }
 
-                quat res((blendA * a.xyz) + (blendB * b.xyz), (blendA * a.w) + (blendB * b.w));
+                quat res((a.xyz * blendA) + (to.xyz * blendB), (a.w * blendA) + (to.w * blendB));
                 if (res.lengthsquared() > static_cast<T>(0))
                 {
                     return res.normalized();
@@ -413,6 +610,136 @@ namespace sml
                 return identity();
             }
 
+            // Squad, the cubic interpolation between q1 and q2 with the inner control points a1 and
+            // a2 from squadcontrol
+            SML_NO_DISCARD inline static constexpr quat squad(const quat& q1, const quat& a1, const quat& a2, const quat& q2, T t) noexcept
+            {
+                return slerp(slerp(q1, q2, t), slerp(a1, a2, t), static_cast<T>(2) * t * (static_cast<T>(1) - t));
+            }
+
+            // Inner control point at current for a squad spline through previous, current and next,
+            // which makes the angular velocity continuous across current. The neighbours must be on
+            // the same hemisphere as current (non negative dot).
+            SML_NO_DISCARD inline static constexpr quat squadcontrol(const quat& previous, const quat& current, const quat& next) noexcept
+            {
+                quat inverse = current.conjugate();
+                quat l0 = (inverse * previous).log(), l2 = (inverse * next).log();
+                T scale = static_cast<T>(-0.25);
+
+                return (current * quat((l0.xyz + l2.xyz) * scale, static_cast<T>(0)).exp()).normalized();
+            }
+
+            // out[i] = slerp(a[i], b[i], t[i]) for unit quaternions, 8 (f32) or 4 (f64) at a time on
+            // the AVX backends
+            inline static void slerp(const quat* a, const quat* b, const T* t, size_t count, quat* out) noexcept
+            {
+                size_t i = 0;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> W;
+                    typedef typename W::type R;
+                    constexpr size_t qstride = sizeof(quat) / sizeof(T);
+
+                    for (; i + W::lanes <= count; i += W::lanes)
+                    {
+                        R ax, ay, az, aw, bx, by, bz, bw, x, y, z, w;
+                        W::load4(&a[i].x, qstride, ax, ay, az, aw);
+                        W::load4(&b[i].x, qstride, bx, by, bz, bw);
+
+                        detail::quatslerp<W, T>(ax, ay, az, aw, bx, by, bz, bw, W::load(t + i), x, y, z, w);
+
+                        W::store4(&out[i].x, qstride, x, y, z, w);
+                    }
+                }
+#endif
+
+                for (; i < count; i++)
+                {
+                    T x, y, z, w;
+                    detail::quatslerp<narrow<T>, T>(a[i].x, a[i].y, a[i].z, a[i].w, b[i].x, b[i].y, b[i].z, b[i].w, t[i], x, y, z, w);
+                    out[i].set(x, y, z, w);
+                }
+            }
+
+        private:
+            // Shepperd's method: 4 * x^2, 4 * y^2, 4 * z^2 and 4 * w^2 follow from the diagonal, the
+            // largest of them gives the best conditioned square root and the other components come from
+            // the off diagonal sums and differences. The largest one is picked with selects instead of
+            // branches so the scalar and the SIMD path below compute exactly the same thing.
+            SML_NO_DISCARD inline static constexpr quat fromcolumns(const T* c0, const T* c1, const T* c2) noexcept
+            {
+                const T one = static_cast<T>(1);
+
+                T tw = one + c0[0] + c1[1] + c2[2];
+                T tx = one + c0[0] - c1[1] - c2[2];
+                T ty = one - c0[0] + c1[1] - c2[2];
+                T tz = one - c0[0] - c1[1] + c2[2];
+
+                T s01 = c1[0] + c0[1];
+                T s02 = c2[0] + c0[2];
+                T s12 = c2[1] + c1[2];
+                T d21 = c1[2] - c2[1];
+                T d02 = c2[0] - c0[2];
+                T d10 = c0[1] - c1[0];
+
+                bool kx = tx > tw;
+                T t = kx ? tx : tw;
+                bool ky = ty > t;
+                t = ky ? ty : t;
+                bool kz = tz > t;
+                t = kz ? tz : t;
+
+                T scale = static_cast<T>(0.5) / sml::sqrt(t);
+
+                quat res;
+                res.x = (kz ? s02 : ky ? s01 : kx ? tx : d21) * scale;
+                res.y = (kz ? s12 : ky ? ty : kx ? s01 : d02) * scale;
+                res.z = (kz ? tz : ky ? s12 : kx ? s02 : d10) * scale;
+                res.w = (kz ? d10 : ky ? d02 : kx ? d21 : tw) * scale;
+
+                return res;
+            }
+
+            // Matrix i starts at m + i * Stride, its columns are 4 elements apart
+            template<size_t Stride>
+            inline static void frommatrices(const T* m, quat* out, size_t count) noexcept
+            {
+                size_t i = 0;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> W;
+                    typedef typename W::type R;
+                    constexpr size_t qstride = sizeof(quat) / sizeof(T);
+
+                    for (; i + W::lanes <= count; i += W::lanes)
+                    {
+                        const T* p = m + i * Stride;
+
+                        R m00, m01, m02, m10, m11, m12, m20, m21, m22, pad;
+                        W::load4(p + 0, Stride, m00, m01, m02, pad);
+                        W::load4(p + 4, Stride, m10, m11, m12, pad);
+                        W::load4(p + 8, Stride, m20, m21, m22, pad);
+
+                        R x, y, z, w;
+                        detail::quatfrombasis<T>(m00, m01, m02, m10, m11, m12, m20, m21, m22, x, y, z, w);
+
+                        W::store4(&out[i].x, qstride, x, y, z, w);
+                    }
+                }
+#endif
+
+                for (; i < count; i++)
+                {
+                    const T* p = m + i * Stride;
+                    out[i] = fromcolumns(p, p + 4, p + 8);
+                }
+            }
+
+        public:
             // Data
 			union
 			{
@@ -485,6 +812,10 @@ namespace sml
 
     typedef quat<f32> fquat;
     typedef quat<f64> dquat;
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class quat<f32>)
+    SML_EXTERN_TEMPLATE(class quat<f64>)
+SML_NAMESPACE_END
 
 #endif // sml_quat_h__
\ No newline at end of file
@@ -0,0 +1,223 @@
+#ifndef sml_quatspline_h__
+#define sml_quatspline_h__
+
+/* quatspline.h -- quaternion splines of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <vector>
+
+#include "common.h"
+#include "smltypes.h"
+#include "simd.h"
+#include "quat.h"
+
+// A quatspline is a squad spline through rotation keys at t = 0, 1, 2, ..., the rotation
+// counterpart of a Catmull-Rom spline. Each key is flipped onto the hemisphere of the one before
+// it so every segment takes the short way, and gets the inner control point of quat::squadcontrol
+// so the angular velocity is continuous across it.
+//
+// Sampling evaluates three slerps with the atan2 and sincos polynomials of simd.h, so the array
+// forms run 8 (f32) or 4 (f64) samples at a time on the AVX backends without calling the scalar
+// transcendentals. The single sample form runs the same kernel on one lane.
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        // Squad of O::lanes samples, lane l uses the keys at q1[l], a1[l], a2[l] and q2[l]
+        template<typename O, typename T>
+        static inline void quatsquad(const T* const* q1, const T* const* a1, const T* const* a2, const T* const* q2, typename O::type t,
+                                     typename O::type& x, typename O::type& y, typename O::type& z, typename O::type& w) noexcept
+        {
+            typedef typename O::type R;
+
+            R k[4][4];
+            const T* const* sources[4] = { q1, q2, a1, a2 };
+
+            for (size_t j = 0; j < 4; j++)
+            {
+                if constexpr (O::lanes == 1)
+                {
+                    const T* p = sources[j][0];
+                    k[j][0] = p[0], k[j][1] = p[1], k[j][2] = p[2], k[j][3] = p[3];
+                }
+#if SML_AVX
+                else
+                {
+                    O::load4(sources[j], k[j][0], k[j][1], k[j][2], k[j][3]);
+                }
+#endif
+            }
+
+            R px, py, pz, pw, cx, cy, cz, cw;
+            quatslerp<O, T>(k[0][0], k[0][1], k[0][2], k[0][3], k[1][0], k[1][1], k[1][2], k[1][3], t, px, py, pz, pw);
+            quatslerp<O, T>(k[2][0], k[2][1], k[2][2], k[2][3], k[3][0], k[3][1], k[3][2], k[3][3], t, cx, cy, cz, cw);
+
+            R blend = O::mul(O::add(t, t), O::sub(O::set1(static_cast<T>(1)), t));
+            quatslerp<O, T>(px, py, pz, pw, cx, cy, cz, cw, blend, x, y, z, w);
+        }
+    } // namespace detail
+
+    template<typename T>
+    class quatspline
+    {
+        public:
+            quatspline() noexcept = default;
+
+            quatspline(const quat<T>* keys, size_t count)
+            {
+                build(keys, count);
+            }
+
+            void build(const quat<T>* keys, size_t count)
+            {
+                points.assign(keys, keys + count);
+                inner.resize(count);
+
+                for (size_t i = 1; i < count; i++)
+                {
+                    if (points[i].dot(points[i - 1]) < static_cast<T>(0))
+                        points[i] = quat<T>(-points[i].xyz, -points[i].w);
+                }
+
+                // The end keys are their own neighbours on the missing side
+                for (size_t i = 0; i < count; i++)
+                {
+                    inner[i] = quat<T>::squadcontrol(points[i > 0 ? i - 1 : i], points[i], points[i + 1 < count ? i + 1 : i]);
+                }
+            }
+
+            // Rotation at t, clamped to [0, size() - 1], identity without keys
+            SML_NO_DISCARD inline quat<T> evaluate(T t) const noexcept
+            {
+                if (points.empty())
+                    return quat<T>::identity();
+
+                const T* q1, * a1, * a2, * q2;
+                T local = locate(t, q1, a1, a2, q2);
+                T x, y, z, w;
+
+                detail::quatsquad<narrow<T>, T>(&q1, &a1, &a2, &q2, local, x, y, z, w);
+
+                return quat<T>(x, y, z, w);
+            }
+
+            // Rotations at t[0..count)
+            inline void evaluate(const T* t, size_t count, quat<T>* out) const noexcept
+            {
+                evaluate(this, 0, t, count, out);
+            }
+
+            SML_NO_DISCARD inline size_t size() const noexcept
+            {
+                return points.size();
+            }
+
+            // The keys after the hemisphere flips, and their inner control points
+            SML_NO_DISCARD inline const std::vector<quat<T>>& keys() const noexcept
+            {
+                return points;
+            }
+
+            SML_NO_DISCARD inline const std::vector<quat<T>>& controls() const noexcept
+            {
+                return inner;
+            }
+
+            // Sample i is spline tracks[i * step] at t[i], a step of 0 samples one spline throughout
+            inline static void evaluate(const quatspline* tracks, size_t step, const T* t, size_t count, quat<T>* out) noexcept
+            {
+                size_t i = 0;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> W;
+                    typedef typename W::type R;
+                    constexpr size_t qstride = sizeof(quat<T>) / sizeof(T);
+
+                    for (size_t end = count - count % W::lanes; i < end; i += W::lanes)
+                    {
+                        const T* q1[W::lanes], * a1[W::lanes], * a2[W::lanes], * q2[W::lanes];
+                        alignas(simdalign<T>::value) T local[W::lanes];
+                        bool empty = false;
+
+                        for (size_t l = 0; l < W::lanes; l++)
+                        {
+                            const quatspline& track = tracks[(i + l) * step];
+                            empty |= track.points.empty();
+                            local[l] = empty ? static_cast<T>(0) : track.locate(t[i + l], q1[l], a1[l], a2[l], q2[l]);
+                        }
+
+                        if (empty)
+                        {
+                            for (size_t l = 0; l < W::lanes; l++)
+                            {
+                                out[i + l] = tracks[(i + l) * step].evaluate(t[i + l]);
+                            }
+
+                            continue;
+                        }
+
+                        R x, y, z, w;
+                        detail::quatsquad<W, T>(q1, a1, a2, q2, W::load(local), x, y, z, w);
+
+                        W::store4(&out[i].x, qstride, x, y, z, w);
+                    }
+                }
+#endif
+
+                for (; i < count; i++)
+                {
+                    out[i] = tracks[i * step].evaluate(t[i]);
+                }
+            }
+
+        private:
+            // Keys of the segment containing t and the parameter within it
+            inline T locate(T t, const T*& q1, const T*& a1, const T*& a2, const T*& q2) const noexcept
+            {
+                size_t last = points.size() - 1;
+                t = sml::clamp(t, static_cast<T>(0), static_cast<T>(last));
+                size_t segment = sml::min(static_cast<size_t>(t), last > 0 ? last - 1 : 0);
+                size_t next = sml::min(segment + 1, last);
+
+                q1 = &points[segment].x;
+                a1 = &inner[segment].x;
+                a2 = &inner[next].x;
+                q2 = &points[next].x;
+
+                return t - static_cast<T>(segment);
+            }
+
+            std::vector<quat<T>> points;
+            std::vector<quat<T>> inner;
+    };
+
+    // Predefined types
+    typedef quatspline<f32> fquatspline;
+    typedef quatspline<f64> dquatspline;
+
+    // Samples track i at t[i], for many tracks that each need one rotation
+    template<typename T>
+    inline void evaluate(const quatspline<T>* tracks, const T* t, size_t count, quat<T>* out) noexcept
+    {
+        quatspline<T>::evaluate(tracks, 1, t, count, out);
+    }
+SML_NAMESPACE_END
+
+#endif // sml_quatspline_h__
@@ -0,0 +1,655 @@
+#ifndef sml_random_h__
+#define sml_random_h__
+
+/* random.h -- random numbers and samplers of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "quat.h"
+
+// rng runs 8 xoshiro128** generators (Blackman & Vigna) side by side, one step advances all
+// of them in a single AVX2 register (two SSE registers, or a plain loop on the scalar backend)
+// and yields 8 x u32, which the array samplers turn into 8 f32 or 4 f64 lanes of wide<T> at once.
+// Single values are served from a buffer of the last step.
+//
+// A generator is seeded with a seed and a stream number, give every thread the same seed and its
+// own stream to get reproducible, independent sequences. The sequence of a seed depends on the
+// order of the calls and on the backend (the array samplers consume values a register at a time).
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        // 32 bit lane operations of the xoshiro step
+        struct xoshiroscalar
+        {
+            typedef u32 type;
+
+            static inline type load(const u32* p) noexcept { return *p; }
+            static inline void store(u32* p, type a) noexcept { *p = a; }
+            static inline type add(type a, type b) noexcept { return a + b; }
+            static inline type bxor(type a, type b) noexcept { return a ^ b; }
+            template<s32 N> static inline type shl(type a) noexcept { return a << N; }
+            template<s32 N> static inline type rotl(type a) noexcept { return (a << N) | (a >> (32 - N)); }
+        };
+
+#if SML_SSE
+        struct xoshirosse
+        {
+            typedef __m128i type;
+
+            static inline type load(const u32* p) noexcept { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+            static inline void store(u32* p, type a) noexcept { _mm_store_si128(reinterpret_cast<__m128i*>(p), a); }
+            static inline type add(type a, type b) noexcept { return _mm_add_epi32(a, b); }
+            static inline type bxor(type a, type b) noexcept { return _mm_xor_si128(a, b); }
+            template<s32 N> static inline type shl(type a) noexcept { return _mm_slli_epi32(a, N); }
+            template<s32 N> static inline type rotl(type a) noexcept { return _mm_or_si128(_mm_slli_epi32(a, N), _mm_srli_epi32(a, 32 - N)); }
+        };
+#endif
+
+#if SML_AVX2
+        struct xoshiroavx2
+        {
+            typedef __m256i type;
+
+            static inline type load(const u32* p) noexcept { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+            static inline void store(u32* p, type a) noexcept { _mm256_store_si256(reinterpret_cast<__m256i*>(p), a); }
+            static inline type add(type a, type b) noexcept { return _mm256_add_epi32(a, b); }
+            static inline type bxor(type a, type b) noexcept { return _mm256_xor_si256(a, b); }
+            template<s32 N> static inline type shl(type a) noexcept { return _mm256_slli_epi32(a, N); }
+            template<s32 N> static inline type rotl(type a) noexcept { return _mm256_or_si256(_mm256_slli_epi32(a, N), _mm256_srli_epi32(a, 32 - N)); }
+        };
+#endif
+
+        // One xoshiro128** step of the generators in state[0..3][lane..], returns their outputs.
+        // The multiplies by 5 and 9 are shifts and adds, cheaper than the 10 cycle pmulld.
+        template<typename I>
+        static inline typename I::type xoshirostep(u32 (&state)[4][8], size_t lane) noexcept
+        {
+            typedef typename I::type V;
+
+            V s0 = I::load(state[0] + lane);
+            V s1 = I::load(state[1] + lane);
+            V s2 = I::load(state[2] + lane);
+            V s3 = I::load(state[3] + lane);
+
+            V x5 = I::add(I::template shl<2>(s1), s1);
+            V r = I::template rotl<7>(x5);
+            V res = I::add(I::template shl<3>(r), r);
+
+            V t = I::template shl<9>(s1);
+
+            s2 = I::bxor(s2, s0);
+            s3 = I::bxor(s3, s1);
+            s1 = I::bxor(s1, s2);
+            s0 = I::bxor(s0, s3);
+            s2 = I::bxor(s2, t);
+            s3 = I::template rotl<11>(s3);
+
+            I::store(state[0] + lane, s0);
+            I::store(state[1] + lane, s1);
+            I::store(state[2] + lane, s2);
+            I::store(state[3] + lane, s3);
+
+            return res;
+        }
+
+        static inline uint64_t splitmix64(uint64_t& x) noexcept
+        {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+            return z ^ (z >> 31);
+        }
+    } // namespace detail
+
+    class rng
+    {
+        public:
+            static constexpr size_t lanes = 8;
+
+            explicit rng(uint64_t seed = 0, uint64_t stream = 0) noexcept
+            {
+                this->seed(seed, stream);
+            }
+
+            // The state is filled from splitmix64, started at the seed mixed with the stream, so
+            // nearby seeds and streams don't give related sequences
+            void seed(uint64_t seed, uint64_t stream = 0) noexcept
+            {
+                uint64_t s = stream;
+                uint64_t x = seed ^ detail::splitmix64(s);
+
+                for (size_t l = 0; l < lanes; l++)
+                {
+                    uint64_t a = detail::splitmix64(x);
+                    uint64_t b = detail::splitmix64(x);
+
+                    state[0][l] = static_cast<u32>(a);
+                    state[1][l] = static_cast<u32>(a >> 32);
+                    state[2][l] = static_cast<u32>(b);
+                    state[3][l] = static_cast<u32>(b >> 32);
+
+                    // The all zero state is the one fixed point of xoshiro
+                    if ((state[0][l] | state[1][l] | state[2][l] | state[3][l]) == 0)
+                        state[0][l] = 1;
+                }
+
+                index = lanes;
+            }
+
+            // One step of every generator
+            inline void next(u32 (&out)[lanes]) noexcept
+            {
+#if SML_AVX2
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), detail::xoshirostep<detail::xoshiroavx2>(state, 0));
+#elif SML_SSE
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), detail::xoshirostep<detail::xoshirosse>(state, 0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), detail::xoshirostep<detail::xoshirosse>(state, 4));
+#else
+                for (size_t l = 0; l < lanes; l++)
+                {
+                    out[l] = detail::xoshirostep<detail::xoshiroscalar>(state, l);
+                }
+#endif
+            }
+
+            SML_NO_DISCARD inline u32 next() noexcept
+            {
+                if (index == lanes)
+                {
+                    next(buffer);
+                    index = 0;
+                }
+
+                return buffer[index++];
+            }
+
+            // Uniform in [0, 1), from the top 24 (f32) or 53 (f64) bits
+            template<typename T>
+            SML_NO_DISCARD inline T uniform() noexcept
+            {
+                if constexpr (std::is_same<T, f32>::value)
+                {
+                    return static_cast<f32>(next() >> 8) * 0x1.0p-24f;
+                }
+                else
+                {
+                    f64 a = static_cast<f64>(next() >> 5);
+                    f64 b = static_cast<f64>(next() >> 6);
+
+                    return (a * 0x1.0p26 + b) * 0x1.0p-53;
+                }
+            }
+
+            template<typename T>
+            SML_NO_DISCARD inline T uniform(T lo, T hi) noexcept
+            {
+                return lo + (hi - lo) * uniform<T>();
+            }
+
+#if SML_AVX
+            // O::lanes uniform values in [0, 1) at once, the same conversion as uniform()
+            template<typename T>
+            SML_NO_DISCARD inline typename wide<T>::type uniformwide() noexcept
+            {
+#if SML_AVX2
+                __m256i u = detail::xoshirostep<detail::xoshiroavx2>(state, 0);
+                __m128i lo = _mm256_castsi256_si128(u);
+                __m128i hi = _mm256_extracti128_si256(u, 1);
+#else
+                __m128i lo = detail::xoshirostep<detail::xoshirosse>(state, 0);
+                __m128i hi = detail::xoshirostep<detail::xoshirosse>(state, 4);
+#endif
+
+                if constexpr (std::is_same<T, f32>::value)
+                {
+                    __m256i top = _mm256_insertf128_si256(_mm256_castsi128_si256(_mm_srli_epi32(lo, 8)), _mm_srli_epi32(hi, 8), 1);
+                    return _mm256_mul_ps(_mm256_cvtepi32_ps(top), _mm256_set1_ps(0x1.0p-24f));
+                }
+                else
+                {
+                    __m256d a = _mm256_cvtepi32_pd(_mm_srli_epi32(lo, 5));
+                    __m256d b = _mm256_cvtepi32_pd(_mm_srli_epi32(hi, 6));
+
+                    return _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(a, _mm256_set1_pd(0x1.0p26)), b), _mm256_set1_pd(0x1.0p-53));
+                }
+            }
+#endif
+
+            template<typename O, typename T>
+            SML_NO_DISCARD inline typename O::type uniformlanes() noexcept
+            {
+#if SML_AVX
+                if constexpr (O::lanes > 1)
+                {
+                    return uniformwide<T>();
+                }
+                else
+#endif
+                {
+                    return uniform<T>();
+                }
+            }
+
+            // Single samples, see the array forms below for the distributions
+            template<typename T>
+            SML_NO_DISCARD inline vec3<T> inbox(const vec3<T>& min, const vec3<T>& max) noexcept;
+
+            template<typename T>
+            SML_NO_DISCARD inline vec3<T> insphere() noexcept;
+
+            template<typename T>
+            SML_NO_DISCARD inline vec3<T> onsphere() noexcept;
+
+            template<typename T>
+            SML_NO_DISCARD inline vec2<T> indisc() noexcept;
+
+            template<typename T>
+            SML_NO_DISCARD inline vec3<T> hemisphere() noexcept;
+
+            template<typename T>
+            SML_NO_DISCARD inline quat<T> rotation() noexcept;
+
+        private:
+            alignas(32) u32 state[4][lanes];
+            u32 buffer[lanes];
+            size_t index = lanes;
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        struct boxsampler
+        {
+            static constexpr size_t components = 3;
+
+            vec3<T> min;
+            vec3<T> extent;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[3]) const noexcept
+            {
+                for (size_t k = 0; k < 3; k++)
+                {
+                    c[k] = O::madd(r.uniformlanes<O, T>(), O::set1(extent.v[k]), O::set1(min.v[k]));
+                }
+            }
+        };
+
+        // cos and sin of an angle uniform in [0, 2 pi)
+        template<typename O, typename T>
+        static inline void randomangle(rng& r, typename O::type& c, typename O::type& s) noexcept
+        {
+            detail::sincos<O, T>(O::mul(r.uniformlanes<O, T>(), O::set1(static_cast<T>(6.28318530717958647692))), s, c);
+        }
+
+        // On the unit sphere, z uniform in [-1, 1] (Archimedes) and a uniform angle around z
+        template<typename T>
+        struct onspheresampler
+        {
+            static constexpr size_t components = 3;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[3]) const noexcept
+            {
+                typedef typename O::type R;
+
+                R one = O::set1(static_cast<T>(1));
+                R z = O::sub(one, O::mul(O::set1(static_cast<T>(2)), r.uniformlanes<O, T>()));
+                R radius = O::sqrt(O::max(O::sub(one, O::mul(z, z)), O::zero()));
+
+                R cs, sn;
+                randomangle<O, T>(r, cs, sn);
+
+                c[0] = O::mul(radius, cs);
+                c[1] = O::mul(radius, sn);
+                c[2] = z;
+            }
+        };
+
+        // In the unit ball, the largest of three uniforms has the r^2 density of the radius
+        // without a cube root
+        template<typename T>
+        struct spheresampler
+        {
+            static constexpr size_t components = 3;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[3]) const noexcept
+            {
+                onspheresampler<T>().template sample<O>(r, c);
+
+                typename O::type radius = O::max(r.uniformlanes<O, T>(), O::max(r.uniformlanes<O, T>(), r.uniformlanes<O, T>()));
+
+                for (size_t k = 0; k < 3; k++)
+                {
+                    c[k] = O::mul(c[k], radius);
+                }
+            }
+        };
+
+        // In the unit disc, radius sqrt(u)
+        template<typename T>
+        struct discsampler
+        {
+            static constexpr size_t components = 2;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[2]) const noexcept
+            {
+                typename O::type radius = O::sqrt(r.uniformlanes<O, T>());
+                typename O::type cs, sn;
+
+                randomangle<O, T>(r, cs, sn);
+
+                c[0] = O::mul(radius, cs);
+                c[1] = O::mul(radius, sn);
+            }
+        };
+
+        // Cosine weighted around +z (Malley), a disc sample lifted onto the hemisphere
+        template<typename T>
+        struct hemispheresampler
+        {
+            static constexpr size_t components = 3;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[3]) const noexcept
+            {
+                typename O::type u = r.uniformlanes<O, T>();
+                typename O::type radius = O::sqrt(u);
+                typename O::type cs, sn;
+
+                randomangle<O, T>(r, cs, sn);
+
+                c[0] = O::mul(radius, cs);
+                c[1] = O::mul(radius, sn);
+                c[2] = O::sqrt(O::max(O::sub(O::set1(static_cast<T>(1)), u), O::zero()));
+            }
+        };
+
+        // Uniform over the rotations (Shoemake, "Uniform random rotations"), x y z w
+        template<typename T>
+        struct rotationsampler
+        {
+            static constexpr size_t components = 4;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[4]) const noexcept
+            {
+                typedef typename O::type R;
+
+                R u = r.uniformlanes<O, T>();
+                R a = O::sqrt(O::sub(O::set1(static_cast<T>(1)), u));
+                R b = O::sqrt(u);
+                R c1, s1, c2, s2;
+
+                randomangle<O, T>(r, c1, s1);
+                randomangle<O, T>(r, c2, s2);
+
+                c[0] = O::mul(a, s1);
+                c[1] = O::mul(a, c1);
+                c[2] = O::mul(b, s2);
+                c[3] = O::mul(b, c2);
+            }
+        };
+
+        template<typename T>
+        struct uniformsampler
+        {
+            static constexpr size_t components = 1;
+
+            T lo;
+            T extent;
+
+            template<typename O>
+            inline void sample(rng& r, typename O::type (&c)[1]) const noexcept
+            {
+                c[0] = O::madd(r.uniformlanes<O, T>(), O::set1(extent), O::set1(lo));
+            }
+        };
+
+        template<typename O, typename T, typename S>
+        static inline void samplelanes(rng& r, const S& sampler, T* const (&out)[S::components], size_t stride, size_t i) noexcept
+        {
+            typename O::type c[S::components];
+            sampler.template sample<O>(r, c);
+
+            for (size_t k = 0; k < S::components; k++)
+            {
+                if constexpr (O::lanes == 1)
+                {
+                    out[k][i * stride] = c[k];
+                }
+                else
+                {
+                    if (stride == 1)
+                    {
+                        O::store(out[k] + i, c[k]);
+                    }
+                    else
+                    {
+                        O::scatter(out[k] + i * stride, stride, c[k]);
+                    }
+                }
+            }
+        }
+
+        // Writes count samples, component k of sample i goes to out[k][i * stride]
+        template<typename T, typename S>
+        static inline void samplearray(rng& r, const S& sampler, T* const (&out)[S::components], size_t stride, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_AVX
+            if constexpr (simdwide<T>::value)
+            {
+                for (size_t end = count - count % wide<T>::lanes; i < end; i += wide<T>::lanes)
+                {
+                    samplelanes<wide<T>>(r, sampler, out, stride, i);
+                }
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                samplelanes<narrow<T>>(r, sampler, out, stride, i);
+            }
+        }
+
+        template<typename T, typename S>
+        static inline void samplesingle(rng& r, const S& sampler, T* out) noexcept
+        {
+            T c[S::components];
+            sampler.template sample<narrow<T>>(r, c);
+
+            for (size_t k = 0; k < S::components; k++)
+            {
+                out[k] = c[k];
+            }
+        }
+
+        template<typename V, typename T>
+        static inline constexpr size_t stride() noexcept
+        {
+            return sizeof(V) / sizeof(T);
+        }
+    } // namespace detail
+
+    template<typename T>
+    inline vec3<T> rng::inbox(const vec3<T>& min, const vec3<T>& max) noexcept
+    {
+        vec3<T> res;
+        detail::samplesingle(*this, detail::boxsampler<T>{ min, max - min }, res.v);
+
+        return res;
+    }
+
+    template<typename T>
+    inline vec3<T> rng::insphere() noexcept
+    {
+        vec3<T> res;
+        detail::samplesingle(*this, detail::spheresampler<T>(), res.v);
+
+        return res;
+    }
+
+    template<typename T>
+    inline vec3<T> rng::onsphere() noexcept
+    {
+        vec3<T> res;
+        detail::samplesingle(*this, detail::onspheresampler<T>(), res.v);
+
+        return res;
+    }
+
+    template<typename T>
+    inline vec2<T> rng::indisc() noexcept
+    {
+        vec2<T> res;
+        detail::samplesingle(*this, detail::discsampler<T>(), res.v);
+
+        return res;
+    }
+
+    template<typename T>
+    inline vec3<T> rng::hemisphere() noexcept
+    {
+        vec3<T> res;
+        detail::samplesingle(*this, detail::hemispheresampler<T>(), res.v);
+
+        return res;
+    }
+
+    template<typename T>
+    inline quat<T> rng::rotation() noexcept
+    {
+        T c[4];
+        detail::samplesingle(*this, detail::rotationsampler<T>(), c);
+
+        return quat<T>(c[0], c[1], c[2], c[3]);
+    }
+
+    // Uniform in [lo, hi)
+    template<typename T>
+    inline void uniform(rng& r, T* out, size_t count, T lo = static_cast<T>(0), T hi = static_cast<T>(1)) noexcept
+    {
+        T* const soa[1] = { out };
+        detail::samplearray(r, detail::uniformsampler<T>{ lo, hi - lo }, soa, 1, count);
+    }
+
+    // Uniform in the box [min, max)
+    template<typename T>
+    inline void inbox(rng& r, const vec3<T>& min, const vec3<T>& max, T* x, T* y, T* z, size_t count) noexcept
+    {
+        T* const soa[3] = { x, y, z };
+        detail::samplearray(r, detail::boxsampler<T>{ min, max - min }, soa, 1, count);
+    }
+
+    template<typename T>
+    inline void inbox(rng& r, const vec3<T>& min, const vec3<T>& max, vec3<T>* out, size_t count) noexcept
+    {
+        T* const aos[3] = { &out->x, &out->y, &out->z };
+        detail::samplearray(r, detail::boxsampler<T>{ min, max - min }, aos, detail::stride<vec3<T>, T>(), count);
+    }
+
+    // Uniform in the unit ball
+    template<typename T>
+    inline void insphere(rng& r, T* x, T* y, T* z, size_t count) noexcept
+    {
+        T* const soa[3] = { x, y, z };
+        detail::samplearray(r, detail::spheresampler<T>(), soa, 1, count);
+    }
+
+    template<typename T>
+    inline void insphere(rng& r, vec3<T>* out, size_t count) noexcept
+    {
+        T* const aos[3] = { &out->x, &out->y, &out->z };
+        detail::samplearray(r, detail::spheresampler<T>(), aos, detail::stride<vec3<T>, T>(), count);
+    }
+
+    // Uniform on the unit sphere, unit directions
+    template<typename T>
+    inline void onsphere(rng& r, T* x, T* y, T* z, size_t count) noexcept
+    {
+        T* const soa[3] = { x, y, z };
+        detail::samplearray(r, detail::onspheresampler<T>(), soa, 1, count);
+    }
+
+    template<typename T>
+    inline void onsphere(rng& r, vec3<T>* out, size_t count) noexcept
+    {
+        T* const aos[3] = { &out->x, &out->y, &out->z };
+        detail::samplearray(r, detail::onspheresampler<T>(), aos, detail::stride<vec3<T>, T>(), count);
+    }
+
+    // Uniform in the unit disc
+    template<typename T>
+    inline void indisc(rng& r, T* x, T* y, size_t count) noexcept
+    {
+        T* const soa[2] = { x, y };
+        detail::samplearray(r, detail::discsampler<T>(), soa, 1, count);
+    }
+
+    template<typename T>
+    inline void indisc(rng& r, vec2<T>* out, size_t count) noexcept
+    {
+        T* const aos[2] = { &out->x, &out->y };
+        detail::samplearray(r, detail::discsampler<T>(), aos, detail::stride<vec2<T>, T>(), count);
+    }
+
+    // Unit directions on the hemisphere around +z with a density proportional to z (cosine
+    // weighted), rotate them onto a normal with a quat or tangent frame
+    template<typename T>
+    inline void hemisphere(rng& r, T* x, T* y, T* z, size_t count) noexcept
+    {
+        T* const soa[3] = { x, y, z };
+        detail::samplearray(r, detail::hemispheresampler<T>(), soa, 1, count);
+    }
+
+    template<typename T>
+    inline void hemisphere(rng& r, vec3<T>* out, size_t count) noexcept
+    {
+        T* const aos[3] = { &out->x, &out->y, &out->z };
+        detail::samplearray(r, detail::hemispheresampler<T>(), aos, detail::stride<vec3<T>, T>(), count);
+    }
+
+    // Uniformly distributed unit quaternions
+    template<typename T>
+    inline void rotation(rng& r, T* x, T* y, T* z, T* w, size_t count) noexcept
+    {
+        T* const soa[4] = { x, y, z, w };
+        detail::samplearray(r, detail::rotationsampler<T>(), soa, 1, count);
+    }
+
+    template<typename T>
+    inline void rotation(rng& r, quat<T>* out, size_t count) noexcept
+    {
+        T* const aos[4] = { &out->x, &out->y, &out->z, &out->w };
+        detail::samplearray(r, detail::rotationsampler<T>(), aos, detail::stride<quat<T>, T>(), count);
+    }
+SML_NAMESPACE_END
+
+#endif // sml_random_h__
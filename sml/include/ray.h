@@ -0,0 +1,198 @@
+#ifndef sml_ray_h__
+#define sml_ray_h__
+
+/* ray.h -- ray and line of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "common.h"
+#include "smltypes.h"
+#include "vec3.h"
+#include "mat4.h"
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        // Parameter of the point on origin + t * direction closest to point, unclamped
+        template<typename T>
+        static inline constexpr T lineparameter(const vec3<T>& origin, const vec3<T>& direction, const vec3<T>& point) noexcept
+        {
+            T length = direction.dot(direction);
+            return length > static_cast<T>(0) ? direction.dot(point - origin) / length : static_cast<T>(0);
+        }
+    } // namespace detail
+
+    // Points origin + t * direction for t >= 0. The direction doesn't need unit length, t is then
+    // in multiples of it.
+    template<typename T>
+    class ray
+    {
+        public:
+            constexpr ray() noexcept
+                : origin(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), direction(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))
+            {
+            }
+
+            constexpr ray(const vec3<T>& origin, const vec3<T>& direction) noexcept
+                : origin(origin), direction(direction)
+            {
+            }
+
+            // Operators
+            inline constexpr bool operator == (const ray& other) const noexcept
+            {
+                return origin == other.origin && direction == other.direction;
+            }
+
+            inline constexpr bool operator != (const ray& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            SML_NO_DISCARD inline constexpr vec3<T> at(T t) const noexcept
+            {
+                return origin + direction * t;
+            }
+
+            inline constexpr void normalize() noexcept
+            {
+                direction.normalize();
+            }
+
+            SML_NO_DISCARD inline constexpr ray normalized() const noexcept
+            {
+                return ray(origin, direction.normalized());
+            }
+
+            // Parameter of the closest point, 0 for points behind the origin
+            SML_NO_DISCARD inline constexpr T closestparameter(const vec3<T>& point) const noexcept
+            {
+                return sml::max(detail::lineparameter(origin, direction, point), static_cast<T>(0));
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> project(const vec3<T>& point) const noexcept
+            {
+                return at(closestparameter(point));
+            }
+
+            SML_NO_DISCARD inline constexpr T distancesquared(const vec3<T>& point) const noexcept
+            {
+                return (point - project(point)).lengthsquared();
+            }
+
+            SML_NO_DISCARD inline constexpr T distance(const vec3<T>& point) const noexcept
+            {
+                return sml::sqrt(distancesquared(point));
+            }
+
+            // Same parameters for the transformed points when the direction isn't normalized
+            SML_NO_DISCARD inline constexpr ray transformed(const mat4<T>& matrix) const noexcept
+            {
+                return ray(matrix.transformPoint(origin), matrix.transformVector(direction));
+            }
+
+            // Variables
+            vec3<T> origin;
+            vec3<T> direction;
+    };
+
+    // Points origin + t * direction for any t
+    template<typename T>
+    class line
+    {
+        public:
+            constexpr line() noexcept
+                : origin(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), direction(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))
+            {
+            }
+
+            constexpr line(const vec3<T>& origin, const vec3<T>& direction) noexcept
+                : origin(origin), direction(direction)
+            {
+            }
+
+            // Operators
+            inline constexpr bool operator == (const line& other) const noexcept
+            {
+                return origin == other.origin && direction == other.direction;
+            }
+
+            inline constexpr bool operator != (const line& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            SML_NO_DISCARD inline constexpr vec3<T> at(T t) const noexcept
+            {
+                return origin + direction * t;
+            }
+
+            inline constexpr void normalize() noexcept
+            {
+                direction.normalize();
+            }
+
+            SML_NO_DISCARD inline constexpr line normalized() const noexcept
+            {
+                return line(origin, direction.normalized());
+            }
+
+            SML_NO_DISCARD inline constexpr T closestparameter(const vec3<T>& point) const noexcept
+            {
+                return detail::lineparameter(origin, direction, point);
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> project(const vec3<T>& point) const noexcept
+            {
+                return at(closestparameter(point));
+            }
+
+            SML_NO_DISCARD inline constexpr T distancesquared(const vec3<T>& point) const noexcept
+            {
+                return (point - project(point)).lengthsquared();
+            }
+
+            SML_NO_DISCARD inline constexpr T distance(const vec3<T>& point) const noexcept
+            {
+                return sml::sqrt(distancesquared(point));
+            }
+
+            SML_NO_DISCARD inline constexpr line transformed(const mat4<T>& matrix) const noexcept
+            {
+                return line(matrix.transformPoint(origin), matrix.transformVector(direction));
+            }
+
+            // Variables
+            vec3<T> origin;
+            vec3<T> direction;
+    };
+
+    // Predefined types
+    typedef ray<f32> fray;
+    typedef ray<f64> dray;
+    typedef line<f32> fline;
+    typedef line<f64> dline;
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class ray<f32>)
+    SML_EXTERN_TEMPLATE(class ray<f64>)
+    SML_EXTERN_TEMPLATE(class line<f32>)
+    SML_EXTERN_TEMPLATE(class line<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_ray_h__
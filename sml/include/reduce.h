@@ -0,0 +1,382 @@
+#ifndef sml_reduce_h__
+#define sml_reduce_h__
+
+/* reduce.h -- vector array reductions of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "common.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat3.h"
+
+// Reductions over arrays of vec2, vec3 and vec4. Sums are accumulated in blocks of reduceblock
+// vectors using four independent accumulators (to hide add latency), and the block results are
+// combined pairwise, so the rounding error grows with log(count) instead of count. Every function
+// only reads its input range, so large arrays can be split over threads and the partial sums,
+// bounds or maxima combined afterwards.
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        static constexpr size_t reduceblock = 256;
+
+        template<typename R, typename B>
+        static inline R pairwise(size_t begin, size_t end, const B& block) noexcept
+        {
+            if (end - begin <= reduceblock)
+                return block(begin, end);
+
+            size_t mid = begin + (end - begin) / 2;
+
+            R res = pairwise<R>(begin, mid, block);
+            res += pairwise<R>(mid, end, block);
+
+            return res;
+        }
+
+        // Sums term(i) over [begin, end) with four accumulators
+        template<typename R, typename F>
+        static inline R accumulate(size_t begin, size_t end, const F& term) noexcept
+        {
+            R acc0, acc1, acc2, acc3;
+
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4)
+            {
+                acc0 += term(i + 0);
+                acc1 += term(i + 1);
+                acc2 += term(i + 2);
+                acc3 += term(i + 3);
+            }
+
+            for (; i < end; i++)
+            {
+                acc0 += term(i);
+            }
+
+            acc0 += acc1;
+            acc2 += acc3;
+            acc0 += acc2;
+
+            return acc0;
+        }
+
+#if SML_SSE
+        // f32 vectors are 16 bytes, so an AVX register holds two of them
+        static inline __m128 sumf32(const f32* values, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_AVX
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps();
+            __m256 acc3 = _mm256_setzero_ps();
+
+            for (; i + 8 <= count; i += 8)
+            {
+                acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(values + 4 * i + 0));
+                acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(values + 4 * i + 8));
+                acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(values + 4 * i + 16));
+                acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(values + 4 * i + 24));
+            }
+
+            __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+            __m128 res = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+#else
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            __m128 acc2 = _mm_setzero_ps();
+            __m128 acc3 = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                acc0 = _mm_add_ps(acc0, _mm_loadu_ps(values + 4 * i + 0));
+                acc1 = _mm_add_ps(acc1, _mm_loadu_ps(values + 4 * i + 4));
+                acc2 = _mm_add_ps(acc2, _mm_loadu_ps(values + 4 * i + 8));
+                acc3 = _mm_add_ps(acc3, _mm_loadu_ps(values + 4 * i + 12));
+            }
+
+            __m128 res = _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+#endif
+
+            for (; i < count; i++)
+            {
+                res = _mm_add_ps(res, _mm_loadu_ps(values + 4 * i));
+            }
+
+            return res;
+        }
+
+        template<bool Max>
+        static inline __m128 extremef32(const f32* values, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_AVX
+            __m256 acc0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(values));
+            __m256 acc1 = acc0;
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256 a = _mm256_loadu_ps(values + 4 * i + 0);
+                __m256 b = _mm256_loadu_ps(values + 4 * i + 8);
+
+                acc0 = Max ? _mm256_max_ps(acc0, a) : _mm256_min_ps(acc0, a);
+                acc1 = Max ? _mm256_max_ps(acc1, b) : _mm256_min_ps(acc1, b);
+            }
+
+            __m256 acc = Max ? _mm256_max_ps(acc0, acc1) : _mm256_min_ps(acc0, acc1);
+            __m128 lo = _mm256_castps256_ps128(acc);
+            __m128 hi = _mm256_extractf128_ps(acc, 1);
+            __m128 res = Max ? _mm_max_ps(lo, hi) : _mm_min_ps(lo, hi);
+#else
+            __m128 res = _mm_loadu_ps(values);
+#endif
+
+            for (; i < count; i++)
+            {
+                __m128 v = _mm_loadu_ps(values + 4 * i);
+                res = Max ? _mm_max_ps(res, v) : _mm_min_ps(res, v);
+            }
+
+            return res;
+        }
+#endif
+
+        template<typename T>
+        struct covarianceterms
+        {
+            vec3<T> diagonal;
+            vec3<T> offdiagonal;
+
+            covarianceterms& operator += (const covarianceterms& other) noexcept
+            {
+                diagonal += other.diagonal;
+                offdiagonal += other.offdiagonal;
+
+                return *this;
+            }
+        };
+    } // namespace detail
+
+    // Component wise sum of all vectors
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> sum(const V<T>* values, size_t count) noexcept
+    {
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
+        {
+            return detail::pairwise<V<T>>(0, count, [values](size_t begin, size_t end)
+            {
+                V<T> res;
+                _mm_store_ps(res.v, detail::sumf32(values[begin].v, end - begin));
+
+                return res;
+            });
+        }
+#endif
+
+        return detail::pairwise<V<T>>(0, count, [values](size_t begin, size_t end)
+        {
+            return detail::accumulate<V<T>>(begin, end, [values](size_t i) { return values[i]; });
+        });
+    }
+
+    // Component wise minimum of all vectors, zero for an empty array
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> minimum(const V<T>* values, size_t count) noexcept
+    {
+        V<T> res;
+
+        if (count == 0)
+            return res;
+
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
+        {
+            _mm_store_ps(res.v, detail::extremef32<false>(values->v, count));
+
+            return res;
+        }
+#endif
+
+        res = values[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            res = V<T>::min(res, values[i]);
+        }
+
+        return res;
+    }
+
+    // Component wise maximum of all vectors, zero for an empty array
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> maximum(const V<T>* values, size_t count) noexcept
+    {
+        V<T> res;
+
+        if (count == 0)
+            return res;
+
+#if SML_SSE
+        if constexpr (simdf32<T>::value)
+        {
+            _mm_store_ps(res.v, detail::extremef32<true>(values->v, count));
+
+            return res;
+        }
+#endif
+
+        res = values[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            res = V<T>::max(res, values[i]);
+        }
+
+        return res;
+    }
+
+    // Axis aligned bounds of all vectors in a single pass
+    template<template<typename> class V, typename T>
+    inline void bounds(const V<T>* values, size_t count, V<T>& min, V<T>& max) noexcept
+    {
+        if (count == 0)
+        {
+            min.zero();
+            max.zero();
+
+            return;
+        }
+
+        V<T> lo0 = values[0], lo1 = values[0];
+        V<T> hi0 = values[0], hi1 = values[0];
+
+        size_t i = 1;
+        for (; i + 2 <= count; i += 2)
+        {
+            lo0 = V<T>::min(lo0, values[i + 0]);
+            hi0 = V<T>::max(hi0, values[i + 0]);
+            lo1 = V<T>::min(lo1, values[i + 1]);
+            hi1 = V<T>::max(hi1, values[i + 1]);
+        }
+
+        for (; i < count; i++)
+        {
+            lo0 = V<T>::min(lo0, values[i]);
+            hi0 = V<T>::max(hi0, values[i]);
+        }
+
+        min = V<T>::min(lo0, lo1);
+        max = V<T>::max(hi0, hi1);
+    }
+
+    // Mean of all vectors
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> centroid(const V<T>* values, size_t count) noexcept
+    {
+        if (count == 0)
+            return V<T>();
+
+        return sum(values, count) / static_cast<T>(count);
+    }
+
+    // Component wise population variance, computed in two passes around the centroid
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline V<T> variance(const V<T>* values, size_t count) noexcept
+    {
+        if (count == 0)
+            return V<T>();
+
+        V<T> mean = centroid(values, count);
+
+        V<T> squares = detail::pairwise<V<T>>(0, count, [values, &mean](size_t begin, size_t end)
+        {
+            return detail::accumulate<V<T>>(begin, end, [values, &mean](size_t i)
+            {
+                V<T> delta = values[i] - mean;
+
+                return delta * delta;
+            });
+        });
+
+        return squares / static_cast<T>(count);
+    }
+
+    // Population covariance matrix of a point set
+    template<typename T>
+    SML_NO_DISCARD inline mat3<T> covariance(const vec3<T>* values, size_t count) noexcept
+    {
+        if (count == 0)
+            return mat3<T>(static_cast<T>(0));
+
+        vec3<T> mean = centroid(values, count);
+
+        detail::covarianceterms<T> terms = detail::pairwise<detail::covarianceterms<T>>(0, count, [values, &mean](size_t begin, size_t end)
+        {
+            return detail::accumulate<detail::covarianceterms<T>>(begin, end, [values, &mean](size_t i)
+            {
+                vec3<T> delta = values[i] - mean;
+
+                // xx yy zz, xy yz zx
+                return detail::covarianceterms<T> { delta * delta, delta * vec3<T>(delta.y, delta.z, delta.x) };
+            });
+        });
+
+        T inv = static_cast<T>(1) / static_cast<T>(count);
+        vec3<T> d = terms.diagonal * inv;
+        vec3<T> o = terms.offdiagonal * inv;
+
+        return mat3<T>(d.x, o.x, o.z,
+                       o.x, d.y, o.y,
+                       o.z, o.y, d.z);
+    }
+
+    // Index of the longest vector, the first one on ties and 0 for an empty array
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline size_t argmaxlength(const V<T>* values, size_t count) noexcept
+    {
+        size_t best = 0;
+        T bestLength = count > 0 ? values[0].lengthsquared() : static_cast<T>(0);
+
+        for (size_t i = 1; i < count; i++)
+        {
+            T l = values[i].lengthsquared();
+            bool greater = l > bestLength;
+
+            best = greater ? i : best;
+            bestLength = greater ? l : bestLength;
+        }
+
+        return best;
+    }
+
+    template<template<typename> class V, typename T>
+    SML_NO_DISCARD inline T maxlength(const V<T>* values, size_t count) noexcept
+    {
+        if (count == 0)
+            return static_cast<T>(0);
+
+        return values[argmaxlength(values, count)].length();
+    }
+SML_NAMESPACE_END
+
+#endif // sml_reduce_h__
@@ -0,0 +1,473 @@
+#ifndef sml_rotation_h__
+#define sml_rotation_h__
+
+/* rotation.h -- rotation conversions of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "common.h"
+#include "smltypes.h"
+#include "simd.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat4.h"
+#include "quat.h"
+
+// Batch conversions between the four ways rotations are stored:
+//   Euler angles    vec3<T>, the angle about x in .x, about y in .y and about z in .z
+//   axis angle      vec4<T>, the unit axis in .xyz and the angle in .w
+//   quaternion      quat<T>, unit length
+//   matrix          mat4<T>, the rotation in the upper 3x3 and no translation
+//
+// eulerorder names the axes in the order their rotations are applied, so eulerorder::xyz rotates
+// about x first and about z last, the matrix Rz * Ry * Rx. Each rotation follows the right hand
+// rule like mat4::rotate(axis, angle), mat4::rotateY turns the other way so mat4::rotate(yaw,
+// pitch, roll) is eulerorder::zxy for the angles (pitch, -yaw, roll). Angles go in and come out in
+// radians unless angleunit::degrees is passed.
+//
+// Every conversion goes through quaternions kept in registers, 8 (f32) or 4 (f64) rotations at a
+// time on the AVX backends. The sines, cosines and atan2 are the polynomials of simd.h, the
+// rotations past the last full register run the same kernels on one lane, so the results don't
+// depend on where a rotation sits in the array.
+
+SML_NAMESPACE_BEGIN
+    enum class eulerorder
+    {
+        xyz,
+        xzy,
+        yxz,
+        yzx,
+        zxy,
+        zyx
+    };
+
+    enum class angleunit
+    {
+        radians,
+        degrees
+    };
+
+    namespace detail
+    {
+        // Axes of the first, second and third rotation, and +1 when they are a cyclic permutation
+        // of x, y, z (-1 otherwise)
+        static inline void euleraxes(eulerorder order, size_t& i, size_t& j, size_t& k, s32& parity) noexcept
+        {
+            static const u8 axes[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+            const u8* a = axes[static_cast<size_t>(order)];
+
+            i = a[0];
+            j = a[1];
+            k = a[2];
+            parity = (j == (i + 1) % 3) ? 1 : -1;
+        }
+
+        template<typename T>
+        static inline T anglescale(angleunit unit) noexcept
+        {
+            return unit == angleunit::degrees ? static_cast<T>(0.01745329251994329577) : static_cast<T>(1);
+        }
+
+        // Quaternions as four registers of components
+        template<typename O>
+        struct quatlanes
+        {
+            typename O::type x, y, z, w;
+        };
+
+        // Hamilton product a * b
+        template<typename O>
+        static inline quatlanes<O> quatlanesmul(const quatlanes<O>& a, const quatlanes<O>& b) noexcept
+        {
+            quatlanes<O> r;
+            r.x = O::sub(O::madd(a.w, b.x, O::madd(a.x, b.w, O::mul(a.y, b.z))), O::mul(a.z, b.y));
+            r.y = O::sub(O::madd(a.w, b.y, O::madd(a.y, b.w, O::mul(a.z, b.x))), O::mul(a.x, b.z));
+            r.z = O::sub(O::madd(a.w, b.z, O::madd(a.z, b.w, O::mul(a.x, b.y))), O::mul(a.y, b.x));
+            r.w = O::sub(O::sub(O::sub(O::mul(a.w, b.w), O::mul(a.x, b.x)), O::mul(a.y, b.y)), O::mul(a.z, b.z));
+            return r;
+        }
+
+        // Rotation matrix rows r and columns c of unit quaternions, m[r][c]
+        template<typename O, typename T>
+        static inline void quatlanesmatrix(const quatlanes<O>& q, typename O::type (&m)[3][3]) noexcept
+        {
+            typedef typename O::type R;
+
+            const R one = O::set1(static_cast<T>(1)), two = O::set1(static_cast<T>(2));
+            R xx = O::mul(q.x, q.x), yy = O::mul(q.y, q.y), zz = O::mul(q.z, q.z);
+            R xy = O::mul(q.x, q.y), xz = O::mul(q.x, q.z), yz = O::mul(q.y, q.z);
+            R wx = O::mul(q.w, q.x), wy = O::mul(q.w, q.y), wz = O::mul(q.w, q.z);
+
+            m[0][0] = O::sub(one, O::mul(two, O::add(yy, zz)));
+            m[0][1] = O::mul(two, O::sub(xy, wz));
+            m[0][2] = O::mul(two, O::add(xz, wy));
+            m[1][0] = O::mul(two, O::add(xy, wz));
+            m[1][1] = O::sub(one, O::mul(two, O::add(xx, zz)));
+            m[1][2] = O::mul(two, O::sub(yz, wx));
+            m[2][0] = O::mul(two, O::sub(xz, wy));
+            m[2][1] = O::mul(two, O::add(yz, wx));
+            m[2][2] = O::sub(one, O::mul(two, O::add(xx, yy)));
+        }
+
+        template<typename O, typename T>
+        static inline quatlanes<O> eulertoquatlanes(typename O::type ax, typename O::type ay, typename O::type az, eulerorder order, T scale) noexcept
+        {
+            typedef typename O::type R;
+
+            size_t i, j, k;
+            s32 parity;
+            euleraxes(order, i, j, k, parity);
+
+            const R half = O::set1(scale * static_cast<T>(0.5));
+            R angles[3] = { ax, ay, az };
+            quatlanes<O> axis[3];
+
+            for (size_t a = 0; a < 3; a++)
+            {
+                R s, c;
+                sincos<O, T>(O::mul(angles[a], half), s, c);
+
+                R* components[3] = { &axis[a].x, &axis[a].y, &axis[a].z };
+                axis[a].x = axis[a].y = axis[a].z = O::zero();
+                *components[a] = s;
+                axis[a].w = c;
+            }
+
+            return quatlanesmul<O>(axis[k], quatlanesmul<O>(axis[j], axis[i]));
+        }
+
+        // The Euler angles of R = Rk(c) Rj(b) Ri(a) with e the parity of the order: b = asin(-e
+        // R[k][i]), a = atan2(e R[k][j], R[k][k]) and c = atan2(e R[j][i], R[i][i]). At b = +-90
+        // degrees only a + c or a - c is defined, c is then 0 and a = atan2(-e R[j][k], R[j][j]).
+        template<typename O, typename T>
+        static inline void quatlanestoeuler(const quatlanes<O>& q, eulerorder order, T scale, typename O::type& ax, typename O::type& ay, typename O::type& az) noexcept
+        {
+            typedef typename O::type R;
+
+            size_t i, j, k;
+            s32 parity;
+            euleraxes(order, i, j, k, parity);
+
+            R m[3][3];
+            quatlanesmatrix<O, T>(q, m);
+
+            const R one = O::set1(static_cast<T>(1));
+            const R e = O::set1(static_cast<T>(parity));
+
+            R sb = O::min(O::max(O::neg(O::mul(e, m[k][i])), O::neg(one)), one);
+            R b = atan2<O, T>(sb, O::sqrt(O::sub(one, O::mul(sb, sb))));
+
+            auto locked = O::gt(O::abs(sb), O::set1(std::is_same<T, f32>::value ? static_cast<T>(0.99999) : static_cast<T>(0.9999999999)));
+            R a = O::select(locked, atan2<O, T>(O::neg(O::mul(e, m[j][k])), m[j][j]), atan2<O, T>(O::mul(e, m[k][j]), m[k][k]));
+            R c = O::select(locked, O::zero(), atan2<O, T>(O::mul(e, m[j][i]), m[i][i]));
+
+            const R inverse = O::set1(static_cast<T>(1) / scale);
+            R angles[3];
+            angles[i] = O::mul(a, inverse);
+            angles[j] = O::mul(b, inverse);
+            angles[k] = O::mul(c, inverse);
+
+            ax = angles[0];
+            ay = angles[1];
+            az = angles[2];
+        }
+
+        // Loads and stores of each representation, lanes consecutive elements at p
+        template<typename O, typename T>
+        static inline void rotationload(const quat<T>* p, quatlanes<O>& q, eulerorder, T) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                q.x = p->x, q.y = p->y, q.z = p->z, q.w = p->w;
+            }
+#if SML_AVX
+            else
+            {
+                O::load4(&p->x, sizeof(quat<T>) / sizeof(T), q.x, q.y, q.z, q.w);
+            }
+#endif
+        }
+
+        template<typename O, typename T>
+        static inline void rotationstore(quat<T>* p, const quatlanes<O>& q, eulerorder, T) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                p->set(q.x, q.y, q.z, q.w);
+            }
+#if SML_AVX
+            else
+            {
+                O::store4(&p->x, sizeof(quat<T>) / sizeof(T), q.x, q.y, q.z, q.w);
+            }
+#endif
+        }
+
+        template<typename O, typename T>
+        static inline void rotationload(const vec3<T>* p, quatlanes<O>& q, eulerorder order, T scale) noexcept
+        {
+            typename O::type x, y, z, pad;
+
+            if constexpr (O::lanes == 1)
+            {
+                x = p->x, y = p->y, z = p->z;
+            }
+#if SML_AVX
+            else
+            {
+                O::load4(&p->x, sizeof(vec3<T>) / sizeof(T), x, y, z, pad);
+            }
+#endif
+
+            q = eulertoquatlanes<O, T>(x, y, z, order, scale);
+        }
+
+        template<typename O, typename T>
+        static inline void rotationstore(vec3<T>* p, const quatlanes<O>& q, eulerorder order, T scale) noexcept
+        {
+            typename O::type x, y, z;
+            quatlanestoeuler<O, T>(q, order, scale, x, y, z);
+
+            if constexpr (O::lanes == 1)
+            {
+                *p = vec3<T>(x, y, z);
+            }
+#if SML_AVX
+            else
+            {
+                O::store4(&p->x, sizeof(vec3<T>) / sizeof(T), x, y, z, O::zero());
+            }
+#endif
+        }
+
+        // Axis angle, the quaternion is (axis sin(angle / 2), cos(angle / 2))
+        template<typename O, typename T>
+        static inline void rotationload(const vec4<T>* p, quatlanes<O>& q, eulerorder, T scale) noexcept
+        {
+            typename O::type x, y, z, angle, s, c;
+
+            if constexpr (O::lanes == 1)
+            {
+                x = p->x, y = p->y, z = p->z, angle = p->w;
+            }
+#if SML_AVX
+            else
+            {
+                O::load4(&p->x, sizeof(vec4<T>) / sizeof(T), x, y, z, angle);
+            }
+#endif
+
+            sincos<O, T>(O::mul(angle, O::set1(scale * static_cast<T>(0.5))), s, c);
+
+            q.x = O::mul(x, s);
+            q.y = O::mul(y, s);
+            q.z = O::mul(z, s);
+            q.w = c;
+        }
+
+        // The angle comes out in [0, 180] degrees, the axis is x without rotation
+        template<typename O, typename T>
+        static inline void rotationstore(vec4<T>* p, const quatlanes<O>& q, eulerorder, T scale) noexcept
+        {
+            typedef typename O::type R;
+
+            auto negative = O::lt(q.w, O::zero());
+            R x = O::select(negative, O::neg(q.x), q.x);
+            R y = O::select(negative, O::neg(q.y), q.y);
+            R z = O::select(negative, O::neg(q.z), q.z);
+            R w = O::abs(q.w);
+
+            R length = O::sqrt(O::madd(x, x, O::madd(y, y, O::mul(z, z))));
+            R angle = O::mul(atan2<O, T>(length, w), O::set1(static_cast<T>(2) / scale));
+
+            auto none = O::le(length, O::zero());
+            R inverse = O::div(O::set1(static_cast<T>(1)), O::select(none, O::set1(static_cast<T>(1)), length));
+            x = O::select(none, O::set1(static_cast<T>(1)), O::mul(x, inverse));
+            y = O::mul(y, inverse);
+            z = O::mul(z, inverse);
+
+            if constexpr (O::lanes == 1)
+            {
+                p->set(x, y, z, angle);
+            }
+#if SML_AVX
+            else
+            {
+                O::store4(&p->x, sizeof(vec4<T>) / sizeof(T), x, y, z, angle);
+            }
+#endif
+        }
+
+        template<typename O, typename T>
+        static inline void rotationload(const mat4<T>* p, quatlanes<O>& q, eulerorder, T) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                quat<T> r = quat<T>::frommatrix4(*p);
+                q.x = r.x, q.y = r.y, q.z = r.z, q.w = r.w;
+            }
+#if SML_AVX
+            else
+            {
+                typedef typename O::type R;
+                constexpr size_t stride = sizeof(mat4<T>) / sizeof(T);
+
+                R m00, m01, m02, m10, m11, m12, m20, m21, m22, pad;
+                O::load4(&p->m00, stride, m00, m01, m02, pad);
+                O::load4(&p->m10, stride, m10, m11, m12, pad);
+                O::load4(&p->m20, stride, m20, m21, m22, pad);
+
+                quatfrombasis<T>(m00, m01, m02, m10, m11, m12, m20, m21, m22, q.x, q.y, q.z, q.w);
+            }
+#endif
+        }
+
+        template<typename O, typename T>
+        static inline void rotationstore(mat4<T>* p, const quatlanes<O>& q, eulerorder, T) noexcept
+        {
+            typedef typename O::type R;
+
+            R m[3][3];
+            quatlanesmatrix<O, T>(q, m);
+
+            if constexpr (O::lanes == 1)
+            {
+                *p = mat4<T>(m[0][0], m[1][0], m[2][0], static_cast<T>(0),
+                             m[0][1], m[1][1], m[2][1], static_cast<T>(0),
+                             m[0][2], m[1][2], m[2][2], static_cast<T>(0),
+                             static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
+            }
+#if SML_AVX
+            else
+            {
+                constexpr size_t stride = sizeof(mat4<T>) / sizeof(T);
+                const R zero = O::zero();
+
+                O::store4(&p->m00, stride, m[0][0], m[1][0], m[2][0], zero);
+                O::store4(&p->m10, stride, m[0][1], m[1][1], m[2][1], zero);
+                O::store4(&p->m20, stride, m[0][2], m[1][2], m[2][2], zero);
+                O::store4(&p->m30, stride, zero, zero, zero, O::set1(static_cast<T>(1)));
+            }
+#endif
+        }
+
+        template<typename T, typename From, typename To>
+        static inline void convertrotations(const From* in, To* out, size_t count, eulerorder order, angleunit unit) noexcept
+        {
+            const T scale = anglescale<T>(unit);
+            size_t i = 0;
+
+#if SML_AVX
+            if constexpr (simdwide<T>::value)
+            {
+                typedef wide<T> O;
+
+                for (size_t end = count - count % O::lanes; i < end; i += O::lanes)
+                {
+                    quatlanes<O> q;
+                    rotationload<O, T>(in + i, q, order, scale);
+                    rotationstore<O, T>(out + i, q, order, scale);
+                }
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                quatlanes<narrow<T>> q;
+                rotationload<narrow<T>, T>(in + i, q, order, scale);
+                rotationstore<narrow<T>, T>(out + i, q, order, scale);
+            }
+        }
+    } // namespace detail
+
+    template<typename T>
+    inline void eulertoquat(const vec3<T>* angles, quat<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(angles, out, count, order, unit);
+    }
+
+    template<typename T>
+    inline void eulertomatrix(const vec3<T>* angles, mat4<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(angles, out, count, order, unit);
+    }
+
+    template<typename T>
+    inline void eulertoaxisangle(const vec3<T>* angles, vec4<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(angles, out, count, order, unit);
+    }
+
+    // The middle angle comes out in [-90, 90] degrees and the others in [-180, 180]
+    template<typename T>
+    inline void quattoeuler(const quat<T>* rotations, vec3<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(rotations, out, count, order, unit);
+    }
+
+    template<typename T>
+    inline void quattomatrix(const quat<T>* rotations, mat4<T>* out, size_t count) noexcept
+    {
+        detail::convertrotations<T>(rotations, out, count, eulerorder::xyz, angleunit::radians);
+    }
+
+    template<typename T>
+    inline void quattoaxisangle(const quat<T>* rotations, vec4<T>* out, size_t count, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(rotations, out, count, eulerorder::xyz, unit);
+    }
+
+    template<typename T>
+    inline void matrixtoeuler(const mat4<T>* matrices, vec3<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(matrices, out, count, order, unit);
+    }
+
+    // Same as quat::frommatrix4(matrices, out, count)
+    template<typename T>
+    inline void matrixtoquat(const mat4<T>* matrices, quat<T>* out, size_t count) noexcept
+    {
+        detail::convertrotations<T>(matrices, out, count, eulerorder::xyz, angleunit::radians);
+    }
+
+    template<typename T>
+    inline void matrixtoaxisangle(const mat4<T>* matrices, vec4<T>* out, size_t count, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(matrices, out, count, eulerorder::xyz, unit);
+    }
+
+    template<typename T>
+    inline void axisangletoquat(const vec4<T>* axisangles, quat<T>* out, size_t count, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(axisangles, out, count, eulerorder::xyz, unit);
+    }
+
+    template<typename T>
+    inline void axisangletomatrix(const vec4<T>* axisangles, mat4<T>* out, size_t count, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(axisangles, out, count, eulerorder::xyz, unit);
+    }
+
+    template<typename T>
+    inline void axisangletoeuler(const vec4<T>* axisangles, vec3<T>* out, size_t count, eulerorder order = eulerorder::xyz, angleunit unit = angleunit::radians) noexcept
+    {
+        detail::convertrotations<T>(axisangles, out, count, order, unit);
+    }
+SML_NAMESPACE_END
+
+#endif // sml_rotation_h__
@@ -0,0 +1,121 @@
+#ifndef sml_segment_h__
+#define sml_segment_h__
+
+/* segment.h -- line segment of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "common.h"
+#include "smltypes.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "closest.h"
+
+SML_NAMESPACE_BEGIN
+    // Points between a and b, at(0) is a and at(1) is b
+    template<typename T>
+    class segment
+    {
+        public:
+            constexpr segment() noexcept
+                : a(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), b(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0))
+            {
+            }
+
+            constexpr segment(const vec3<T>& a, const vec3<T>& b) noexcept
+                : a(a), b(b)
+            {
+            }
+
+            // Operators
+            inline constexpr bool operator == (const segment& other) const noexcept
+            {
+                return a == other.a && b == other.b;
+            }
+
+            inline constexpr bool operator != (const segment& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            SML_NO_DISCARD inline constexpr vec3<T> at(T t) const noexcept
+            {
+                return a + (b - a) * t;
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> direction() const noexcept
+            {
+                return b - a;
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> midpoint() const noexcept
+            {
+                return (a + b) * static_cast<T>(0.5);
+            }
+
+            SML_NO_DISCARD inline constexpr T lengthsquared() const noexcept
+            {
+                return (b - a).lengthsquared();
+            }
+
+            SML_NO_DISCARD inline constexpr T length() const noexcept
+            {
+                return (b - a).length();
+            }
+
+            SML_NO_DISCARD inline vec3<T> closestpoint(const vec3<T>& point) const noexcept
+            {
+                return closestpointsegment(point, a, b);
+            }
+
+            SML_NO_DISCARD inline T distancesquared(const vec3<T>& point) const noexcept
+            {
+                return distancesquaredsegment(point, a, b);
+            }
+
+            SML_NO_DISCARD inline T distance(const vec3<T>& point) const noexcept
+            {
+                return distancesegment(point, a, b);
+            }
+
+            SML_NO_DISCARD inline constexpr segment transformed(const mat4<T>& matrix) const noexcept
+            {
+                return segment(matrix.transformPoint(a), matrix.transformPoint(b));
+            }
+
+            // Statics
+            // Closest points between the two segments, returns their squared distance
+            inline static T closestpoints(const segment& p, const segment& q, vec3<T>& onp, vec3<T>& onq) noexcept
+            {
+                return closestpointssegments(p.a, p.b, q.a, q.b, onp, onq);
+            }
+
+            // Variables
+            vec3<T> a;
+            vec3<T> b;
+    };
+
+    // Predefined types
+    typedef segment<f32> fsegment;
+    typedef segment<f64> dsegment;
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class segment<f32>)
+    SML_EXTERN_TEMPLATE(class segment<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_segment_h__
@@ -0,0 +1,419 @@
+#ifndef sml_simd_h__
+#define sml_simd_h__
+
+/* simd.h -- SIMD register wrappers of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "common.h"
+
+// wide<T> wraps one AVX register of T (8 x f32 or 4 x f64) so structure of arrays kernels,
+// which run the same scalar formula on 'lanes' elements at once, are only written once for
+// both precisions. Masks are registers of the same type with all bits set in the true lanes.
+// narrow<T> has the same interface for a single T (with bool masks), so a kernel written
+// against either can also handle the remainder of an array that doesn't fill a register.
+// wide<T> is only defined on the AVX backends, kernels check simdwide<T> before using it.
+
+SML_NAMESPACE_BEGIN
+    template<typename T>
+    struct narrow
+    {
+        typedef T type;
+        static constexpr size_t lanes = 1;
+
+        static inline type load(const T* p) noexcept { return *p; }
+        static inline void store(T* p, type a) noexcept { *p = a; }
+        static inline type set1(T a) noexcept { return a; }
+        static inline type zero() noexcept { return static_cast<T>(0); }
+
+        static inline type add(type a, type b) noexcept { return a + b; }
+        static inline type sub(type a, type b) noexcept { return a - b; }
+        static inline type mul(type a, type b) noexcept { return a * b; }
+        static inline type div(type a, type b) noexcept { return a / b; }
+        static inline type sqrt(type a) noexcept { return sml::sqrt(a); }
+        static inline type min(type a, type b) noexcept { return a < b ? a : b; }
+        static inline type max(type a, type b) noexcept { return a > b ? a : b; }
+        static inline type floor(type a) noexcept { return sml::floor(a); }
+        static inline type round(type a) noexcept { return std::nearbyint(a); }
+        static inline type abs(type a) noexcept { return sml::abs(a); }
+        static inline type neg(type a) noexcept { return -a; }
+        static inline type madd(type a, type b, type c) noexcept { return a * b + c; }
+
+        static inline bool lt(type a, type b) noexcept { return a < b; }
+        static inline bool le(type a, type b) noexcept { return a <= b; }
+        static inline bool gt(type a, type b) noexcept { return a > b; }
+        static inline bool ge(type a, type b) noexcept { return a >= b; }
+        static inline bool eq(type a, type b) noexcept { return a == b; }
+
+        // Mask operations only, narrow masks are bool
+        static inline bool band(bool a, bool b) noexcept { return a && b; }
+        static inline bool bor(bool a, bool b) noexcept { return a || b; }
+
+        static inline type select(bool mask, type a, type b) noexcept { return mask ? a : b; }
+        static inline s32 movemask(bool mask) noexcept { return mask ? 1 : 0; }
+    };
+
+    template<typename T>
+    struct wide;
+
+#if SML_AVX
+    template<>
+    struct wide<f32>
+    {
+        typedef __m256 type;
+        static constexpr size_t lanes = 8;
+
+        static inline type load(const f32* p) noexcept { return _mm256_loadu_ps(p); }
+        static inline void store(f32* p, type a) noexcept { _mm256_storeu_ps(p, a); }
+        static inline type set1(f32 a) noexcept { return _mm256_set1_ps(a); }
+        static inline type zero() noexcept { return _mm256_setzero_ps(); }
+
+        static inline type add(type a, type b) noexcept { return _mm256_add_ps(a, b); }
+        static inline type sub(type a, type b) noexcept { return _mm256_sub_ps(a, b); }
+        static inline type mul(type a, type b) noexcept { return _mm256_mul_ps(a, b); }
+        static inline type div(type a, type b) noexcept { return _mm256_div_ps(a, b); }
+        static inline type sqrt(type a) noexcept { return _mm256_sqrt_ps(a); }
+        static inline type min(type a, type b) noexcept { return _mm256_min_ps(a, b); }
+        static inline type max(type a, type b) noexcept { return _mm256_max_ps(a, b); }
+        static inline type floor(type a) noexcept { return _mm256_floor_ps(a); }
+        static inline type round(type a) noexcept { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static inline type abs(type a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static inline type neg(type a) noexcept { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+
+        // a * b + c, fused when FMA is enabled
+        static inline type madd(type a, type b, type c) noexcept
+        {
+#if SML_FMA
+            return _mm256_fmadd_ps(a, b, c);
+#else
+            return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+        }
+
+        static inline type lt(type a, type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static inline type le(type a, type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static inline type gt(type a, type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static inline type ge(type a, type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static inline type eq(type a, type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+
+        static inline type band(type a, type b) noexcept { return _mm256_and_ps(a, b); }
+        static inline type bor(type a, type b) noexcept { return _mm256_or_ps(a, b); }
+        static inline type bxor(type a, type b) noexcept { return _mm256_xor_ps(a, b); }
+        static inline type bandnot(type a, type b) noexcept { return _mm256_andnot_ps(a, b); }
+
+        // mask ? a : b per lane. Masks are always full lanes so plain bit operations are enough, some
+        // compilers scalarize blendv when they try to fold it without AVX2
+        static inline type select(type mask, type a, type b) noexcept { return _mm256_or_ps(_mm256_and_ps(mask, a), _mm256_andnot_ps(mask, b)); }
+        static inline s32 movemask(type mask) noexcept { return _mm256_movemask_ps(mask); }
+
+        // Copies the sign bit of s onto a
+        static inline type copysign(type a, type s) noexcept
+        {
+            type sign = _mm256_set1_ps(-0.0f);
+            return _mm256_or_ps(_mm256_andnot_ps(sign, a), _mm256_and_ps(sign, s));
+        }
+
+        // Loads p[0], p[stride], ... p[7 * stride], stride is in elements
+        static inline type gather(const f32* p, size_t stride) noexcept
+        {
+            return _mm256_setr_ps(p[0 * stride], p[1 * stride], p[2 * stride], p[3 * stride],
+                                  p[4 * stride], p[5 * stride], p[6 * stride], p[7 * stride]);
+        }
+
+        static inline void scatter(f32* p, size_t stride, type a) noexcept
+        {
+            alignas(32) f32 tmp[8];
+            _mm256_store_ps(tmp, a);
+
+            for (size_t i = 0; i < 8; i++)
+            {
+                p[i * stride] = tmp[i];
+            }
+        }
+
+        // Transposes groups of four: lane i of x, y, z, w is p[i * stride + 0..3]
+        static inline void load4(const f32* p, size_t stride, type& x, type& y, type& z, type& w) noexcept
+        {
+            type r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 0 * stride)), _mm_loadu_ps(p + 4 * stride), 1);
+            type r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 1 * stride)), _mm_loadu_ps(p + 5 * stride), 1);
+            type r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 2 * stride)), _mm_loadu_ps(p + 6 * stride), 1);
+            type r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 3 * stride)), _mm_loadu_ps(p + 7 * stride), 1);
+
+            transpose(r0, r1, r2, r3, x, y, z, w);
+        }
+
+        // Like load4 with an arbitrary address per lane, p[i][0..3] goes to lane i
+        static inline void load4(const f32* const* p, type& x, type& y, type& z, type& w) noexcept
+        {
+            type r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p[0])), _mm_loadu_ps(p[4]), 1);
+            type r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p[1])), _mm_loadu_ps(p[5]), 1);
+            type r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p[2])), _mm_loadu_ps(p[6]), 1);
+            type r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p[3])), _mm_loadu_ps(p[7]), 1);
+
+            transpose(r0, r1, r2, r3, x, y, z, w);
+        }
+
+        // Inverse of load4
+        static inline void store4(f32* p, size_t stride, type x, type y, type z, type w) noexcept
+        {
+            type r0, r1, r2, r3;
+            transpose(x, y, z, w, r0, r1, r2, r3);
+
+            _mm_storeu_ps(p + 0 * stride, _mm256_castps256_ps128(r0));
+            _mm_storeu_ps(p + 1 * stride, _mm256_castps256_ps128(r1));
+            _mm_storeu_ps(p + 2 * stride, _mm256_castps256_ps128(r2));
+            _mm_storeu_ps(p + 3 * stride, _mm256_castps256_ps128(r3));
+            _mm_storeu_ps(p + 4 * stride, _mm256_extractf128_ps(r0, 1));
+            _mm_storeu_ps(p + 5 * stride, _mm256_extractf128_ps(r1, 1));
+            _mm_storeu_ps(p + 6 * stride, _mm256_extractf128_ps(r2, 1));
+            _mm_storeu_ps(p + 7 * stride, _mm256_extractf128_ps(r3, 1));
+        }
+
+        // 4x4 transpose within each 128 bit half
+        static inline void transpose(type a, type b, type c, type d, type& x, type& y, type& z, type& w) noexcept
+        {
+            type t0 = _mm256_unpacklo_ps(a, b);
+            type t1 = _mm256_unpacklo_ps(c, d);
+            type t2 = _mm256_unpackhi_ps(a, b);
+            type t3 = _mm256_unpackhi_ps(c, d);
+
+            x = _mm256_shuffle_ps(t0, t1, 0x44);
+            y = _mm256_shuffle_ps(t0, t1, 0xEE);
+            z = _mm256_shuffle_ps(t2, t3, 0x44);
+            w = _mm256_shuffle_ps(t2, t3, 0xEE);
+        }
+    };
+
+    template<>
+    struct wide<f64>
+    {
+        typedef __m256d type;
+        static constexpr size_t lanes = 4;
+
+        static inline type load(const f64* p) noexcept { return _mm256_loadu_pd(p); }
+        static inline void store(f64* p, type a) noexcept { _mm256_storeu_pd(p, a); }
+        static inline type set1(f64 a) noexcept { return _mm256_set1_pd(a); }
+        static inline type zero() noexcept { return _mm256_setzero_pd(); }
+
+        static inline type add(type a, type b) noexcept { return _mm256_add_pd(a, b); }
+        static inline type sub(type a, type b) noexcept { return _mm256_sub_pd(a, b); }
+        static inline type mul(type a, type b) noexcept { return _mm256_mul_pd(a, b); }
+        static inline type div(type a, type b) noexcept { return _mm256_div_pd(a, b); }
+        static inline type sqrt(type a) noexcept { return _mm256_sqrt_pd(a); }
+        static inline type min(type a, type b) noexcept { return _mm256_min_pd(a, b); }
+        static inline type max(type a, type b) noexcept { return _mm256_max_pd(a, b); }
+        static inline type floor(type a) noexcept { return _mm256_floor_pd(a); }
+        static inline type round(type a) noexcept { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static inline type abs(type a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static inline type neg(type a) noexcept { return _mm256_xor_pd(_mm256_set1_pd(-0.0), a); }
+
+        static inline type madd(type a, type b, type c) noexcept
+        {
+#if SML_FMA
+            return _mm256_fmadd_pd(a, b, c);
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+        }
+
+        static inline type lt(type a, type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        static inline type le(type a, type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+        static inline type gt(type a, type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static inline type ge(type a, type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+        static inline type eq(type a, type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+
+        static inline type band(type a, type b) noexcept { return _mm256_and_pd(a, b); }
+        static inline type bor(type a, type b) noexcept { return _mm256_or_pd(a, b); }
+        static inline type bxor(type a, type b) noexcept { return _mm256_xor_pd(a, b); }
+        static inline type bandnot(type a, type b) noexcept { return _mm256_andnot_pd(a, b); }
+
+        static inline type select(type mask, type a, type b) noexcept { return _mm256_or_pd(_mm256_and_pd(mask, a), _mm256_andnot_pd(mask, b)); }
+        static inline s32 movemask(type mask) noexcept { return _mm256_movemask_pd(mask); }
+
+        static inline type copysign(type a, type s) noexcept
+        {
+            type sign = _mm256_set1_pd(-0.0);
+            return _mm256_or_pd(_mm256_andnot_pd(sign, a), _mm256_and_pd(sign, s));
+        }
+
+        static inline type gather(const f64* p, size_t stride) noexcept
+        {
+            return _mm256_setr_pd(p[0 * stride], p[1 * stride], p[2 * stride], p[3 * stride]);
+        }
+
+        static inline void scatter(f64* p, size_t stride, type a) noexcept
+        {
+            alignas(32) f64 tmp[4];
+            _mm256_store_pd(tmp, a);
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                p[i * stride] = tmp[i];
+            }
+        }
+
+        static inline void load4(const f64* p, size_t stride, type& x, type& y, type& z, type& w) noexcept
+        {
+            transpose(_mm256_loadu_pd(p + 0 * stride), _mm256_loadu_pd(p + 1 * stride), _mm256_loadu_pd(p + 2 * stride), _mm256_loadu_pd(p + 3 * stride), x, y, z, w);
+        }
+
+        static inline void load4(const f64* const* p, type& x, type& y, type& z, type& w) noexcept
+        {
+            transpose(_mm256_loadu_pd(p[0]), _mm256_loadu_pd(p[1]), _mm256_loadu_pd(p[2]), _mm256_loadu_pd(p[3]), x, y, z, w);
+        }
+
+        static inline void store4(f64* p, size_t stride, type x, type y, type z, type w) noexcept
+        {
+            type r0, r1, r2, r3;
+            transpose(x, y, z, w, r0, r1, r2, r3);
+
+            _mm256_storeu_pd(p + 0 * stride, r0);
+            _mm256_storeu_pd(p + 1 * stride, r1);
+            _mm256_storeu_pd(p + 2 * stride, r2);
+            _mm256_storeu_pd(p + 3 * stride, r3);
+        }
+
+        static inline void transpose(type a, type b, type c, type d, type& x, type& y, type& z, type& w) noexcept
+        {
+            type t0 = _mm256_unpacklo_pd(a, b);
+            type t1 = _mm256_unpackhi_pd(a, b);
+            type t2 = _mm256_unpacklo_pd(c, d);
+            type t3 = _mm256_unpackhi_pd(c, d);
+
+            x = _mm256_permute2f128_pd(t0, t2, 0x20);
+            y = _mm256_permute2f128_pd(t1, t3, 0x20);
+            z = _mm256_permute2f128_pd(t0, t2, 0x31);
+            w = _mm256_permute2f128_pd(t1, t3, 0x31);
+        }
+    };
+#endif
+
+    namespace detail
+    {
+        // sin and cos of O::lanes angles in radians, the same polynomials on every backend. The
+        // angle is reduced around the closest multiple of pi / 2 (Cody-Waite, pi / 2 split in three
+        // parts) and both functions are evaluated on [-pi / 4, pi / 4] with the minimax polynomials
+        // of Cephes, the quadrant then swaps and negates them. Within a few ulps of std::sin and
+        // std::cos for |a| up to about 8192 (f32), the reduction loses precision past that.
+        template<typename O, typename T>
+        static inline void sincos(typename O::type a, typename O::type& s, typename O::type& c) noexcept
+        {
+            typedef typename O::type R;
+
+            R one = O::set1(static_cast<T>(1));
+            R two = O::set1(static_cast<T>(2));
+            R q = O::round(O::mul(a, O::set1(static_cast<T>(0.63661977236758134308))));
+            R r, z, ps, pc;
+
+            if constexpr (std::is_same<T, f32>::value)
+            {
+                r = O::madd(q, O::set1(-1.5703125f), a);
+                r = O::madd(q, O::set1(-4.837512969970703125e-4f), r);
+                r = O::madd(q, O::set1(-7.54978995489188216e-8f), r);
+                z = O::mul(r, r);
+
+                ps = O::madd(z, O::set1(-1.9515295891e-4f), O::set1(8.3321608736e-3f));
+                ps = O::madd(z, ps, O::set1(-1.6666654611e-1f));
+                pc = O::madd(z, O::set1(2.443315711809948e-5f), O::set1(-1.388731625493765e-3f));
+                pc = O::madd(z, pc, O::set1(4.166664568298827e-2f));
+            }
+            else
+            {
+                r = O::madd(q, O::set1(-1.57079625129699707031), a);
+                r = O::madd(q, O::set1(-7.54978941586159635335e-8), r);
+                r = O::madd(q, O::set1(-5.39030285815811905290e-15), r);
+                z = O::mul(r, r);
+
+                ps = O::madd(z, O::set1(1.58962301576546568060e-10), O::set1(-2.50507477628578072866e-8));
+                ps = O::madd(z, ps, O::set1(2.75573136213857245213e-6));
+                ps = O::madd(z, ps, O::set1(-1.98412698295895385996e-4));
+                ps = O::madd(z, ps, O::set1(8.33333333332211858878e-3));
+                ps = O::madd(z, ps, O::set1(-1.66666666666666307295e-1));
+                pc = O::madd(z, O::set1(-1.13585365213876817300e-11), O::set1(2.08757008419747316778e-9));
+                pc = O::madd(z, pc, O::set1(-2.75573141792967388112e-7));
+                pc = O::madd(z, pc, O::set1(2.48015872888517045348e-5));
+                pc = O::madd(z, pc, O::set1(-1.38888888888730564116e-3));
+                pc = O::madd(z, pc, O::set1(4.16666666666665929218e-2));
+            }
+
+            // sin r = r + r^3 ps(r^2), cos r = 1 - r^2 / 2 + r^4 pc(r^2)
+            R sr = O::madd(O::mul(r, z), ps, r);
+            R cr = O::madd(O::mul(z, z), pc, O::sub(one, O::mul(z, O::set1(static_cast<T>(0.5)))));
+
+            // Quadrant m = q mod 4: sin a is sr, cr, -sr, -cr and cos a is cr, -sr, -cr, sr
+            R m = O::sub(q, O::mul(O::floor(O::mul(q, O::set1(static_cast<T>(0.25)))), O::set1(static_cast<T>(4))));
+            auto odd = O::eq(O::sub(m, O::mul(O::floor(O::mul(m, O::set1(static_cast<T>(0.5)))), two)), one);
+
+            s = O::select(odd, cr, sr);
+            c = O::select(odd, sr, cr);
+            s = O::select(O::ge(m, two), O::neg(s), s);
+            c = O::select(O::bor(O::eq(m, one), O::eq(m, two)), O::neg(c), c);
+        }
+
+        // atan2 of O::lanes pairs, the same polynomials on every backend. The smaller of |y| and |x|
+        // over the larger gives an argument in [0, 1], which is reduced once more around 1 (atan a
+        // = pi / 4 + atan((a - 1) / (a + 1))) and evaluated with the polynomial (f32) or rational
+        // function (f64) of Cephes. The octant then mirrors the result. Zero for x = y = 0.
+        template<typename O, typename T>
+        static inline typename O::type atan2(typename O::type y, typename O::type x) noexcept
+        {
+            typedef typename O::type R;
+
+            R one = O::set1(static_cast<T>(1));
+            R ay = O::abs(y), ax = O::abs(x);
+            R hi = O::max(ay, ax), lo = O::min(ay, ax);
+            R a = O::div(lo, O::select(O::gt(hi, O::zero()), hi, one));
+
+            auto reduce = O::gt(a, O::set1(std::is_same<T, f32>::value ? static_cast<T>(0.4142135623730950) : static_cast<T>(0.66)));
+            a = O::select(reduce, O::div(O::sub(a, one), O::add(a, one)), a);
+            R z = O::mul(a, a), r;
+
+            if constexpr (std::is_same<T, f32>::value)
+            {
+                R p = O::madd(z, O::set1(8.05374449538e-2f), O::set1(-1.38776856032e-1f));
+                p = O::madd(z, p, O::set1(1.99777106478e-1f));
+                p = O::madd(z, p, O::set1(-3.33329491539e-1f));
+                r = O::madd(O::mul(z, a), p, a);
+            }
+            else
+            {
+                R p = O::madd(z, O::set1(-8.750608600031904122785e-1), O::set1(-1.615753718733365076637e1));
+                p = O::madd(z, p, O::set1(-7.500855792314704667340e1));
+                p = O::madd(z, p, O::set1(-1.228866684490136173410e2));
+                p = O::madd(z, p, O::set1(-6.485021904942025371773e1));
+                R q = O::add(z, O::set1(2.485846490142306297962e1));
+                q = O::madd(z, q, O::set1(1.650270098316988542046e2));
+                q = O::madd(z, q, O::set1(4.328810604912902668951e2));
+                q = O::madd(z, q, O::set1(4.853903996359136964868e2));
+                q = O::madd(z, q, O::set1(1.945506571482613964425e2));
+                r = O::madd(O::mul(z, a), O::div(p, q), a);
+            }
+
+            const R halfpi = O::set1(static_cast<T>(1.57079632679489661923));
+
+            r = O::select(reduce, O::add(r, O::set1(static_cast<T>(0.78539816339744830962))), r);
+            r = O::select(O::gt(ay, ax), O::sub(halfpi, r), r);
+            r = O::select(O::lt(x, O::zero()), O::sub(O::add(halfpi, halfpi), r), r);
+
+            return O::select(O::lt(y, O::zero()), O::neg(r), r);
+        }
+    } // namespace detail
+SML_NAMESPACE_END
+
+#endif // sml_simd_h__
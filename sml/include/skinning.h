@@ -0,0 +1,385 @@
+#ifndef sml_skinning_h__
+#define sml_skinning_h__
+
+/* skinning.h -- bulk vertex skinning of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "simd.h"
+#include "mat4.h"
+#include "dualquat.h"
+
+SML_NAMESPACE_BEGIN
+    // Vertex streams of a skinned mesh in structure of arrays form, every array is indexed by
+    // vertex. Weights of a vertex should add up to 1. Each vertex reads 'influences' (1 to 4)
+    // joint and weight streams, unused slots of vertices with fewer influences need a weight
+    // of 0. Normals are optional, they are skipped when normal[0] is null.
+    template<typename T>
+    struct skinstreams
+    {
+        const T* position[3];
+        const T* normal[3];
+
+        const u16* joint[4];
+        const T* weight[4];
+        u32 influences;
+
+        T* outposition[3];
+        T* outnormal[3];
+    };
+
+    namespace detail
+    {
+        // real xyzw, dual xyzw of palette[joint[i + lane]] for every lane
+        template<typename O, typename T>
+        static inline void gatherdualquat(const dualquat<T>* palette, const u16* joint, size_t i, typename O::type (&q)[8]) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                const dualquat<T>& dq = palette[joint[i]];
+
+                q[0] = dq.real.x;
+                q[1] = dq.real.y;
+                q[2] = dq.real.z;
+                q[3] = dq.real.w;
+                q[4] = dq.dual.x;
+                q[5] = dq.dual.y;
+                q[6] = dq.dual.z;
+                q[7] = dq.dual.w;
+            }
+            else
+            {
+                const T* real[O::lanes];
+                const T* dual[O::lanes];
+
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    real[l] = &palette[joint[i + l]].real.x;
+                    dual[l] = &palette[joint[i + l]].dual.x;
+                }
+
+                O::load4(real, q[0], q[1], q[2], q[3]);
+                O::load4(dual, q[4], q[5], q[6], q[7]);
+            }
+        }
+
+        // Dual quaternion linear blending (Kavan et al.) of O::lanes vertices starting at i
+        template<typename O, typename T>
+        static inline void skindualquatlanes(const dualquat<T>* palette, const skinstreams<T>& s, size_t i) noexcept
+        {
+            typedef typename O::type R;
+
+            R b[8];
+            gatherdualquat<O>(palette, s.joint[0], i, b);
+
+            // The first joint picks the hemisphere, the others are flipped onto it so
+            // q and -q (the same rotation) don't cancel out
+            R first[4] = { b[0], b[1], b[2], b[3] };
+
+            R w = O::load(s.weight[0] + i);
+            for (s32 c = 0; c < 8; c++)
+            {
+                b[c] = O::mul(b[c], w);
+            }
+
+            for (u32 k = 1; k < s.influences; k++)
+            {
+                R q[8];
+                gatherdualquat<O>(palette, s.joint[k], i, q);
+
+                R d = O::madd(first[0], q[0], O::madd(first[1], q[1], O::madd(first[2], q[2], O::mul(first[3], q[3]))));
+                w = O::load(s.weight[k] + i);
+                w = O::select(O::lt(d, O::zero()), O::neg(w), w);
+
+                for (s32 c = 0; c < 8; c++)
+                {
+                    b[c] = O::madd(q[c], w, b[c]);
+                }
+            }
+
+            R inv = O::div(O::set1(static_cast<T>(1)), O::sqrt(O::madd(b[0], b[0], O::madd(b[1], b[1], O::madd(b[2], b[2], O::mul(b[3], b[3]))))));
+
+            R rx = O::mul(b[0], inv), ry = O::mul(b[1], inv), rz = O::mul(b[2], inv), rw = O::mul(b[3], inv);
+            R dx = O::mul(b[4], inv), dy = O::mul(b[5], inv), dz = O::mul(b[6], inv), dw = O::mul(b[7], inv);
+
+            // Translation 2 * (rw * d - dw * r + cross(r, d))
+            R tx = O::sub(O::madd(rw, dx, O::mul(ry, dz)), O::madd(dw, rx, O::mul(rz, dy)));
+            R ty = O::sub(O::madd(rw, dy, O::mul(rz, dx)), O::madd(dw, ry, O::mul(rx, dz)));
+            R tz = O::sub(O::madd(rw, dz, O::mul(rx, dy)), O::madd(dw, rz, O::mul(ry, dx)));
+
+            // v + 2 * cross(r, cross(r, v) + rw * v)
+            auto rotate = [&](R vx, R vy, R vz, R& ox, R& oy, R& oz)
+            {
+                R cx = O::madd(rw, vx, O::sub(O::mul(ry, vz), O::mul(rz, vy)));
+                R cy = O::madd(rw, vy, O::sub(O::mul(rz, vx), O::mul(rx, vz)));
+                R cz = O::madd(rw, vz, O::sub(O::mul(rx, vy), O::mul(ry, vx)));
+
+                ox = O::sub(O::mul(ry, cz), O::mul(rz, cy));
+                oy = O::sub(O::mul(rz, cx), O::mul(rx, cz));
+                oz = O::sub(O::mul(rx, cy), O::mul(ry, cx));
+
+                ox = O::add(vx, O::add(ox, ox));
+                oy = O::add(vy, O::add(oy, oy));
+                oz = O::add(vz, O::add(oz, oz));
+            };
+
+            R px, py, pz;
+            rotate(O::load(s.position[0] + i), O::load(s.position[1] + i), O::load(s.position[2] + i), px, py, pz);
+
+            O::store(s.outposition[0] + i, O::add(px, O::add(tx, tx)));
+            O::store(s.outposition[1] + i, O::add(py, O::add(ty, ty)));
+            O::store(s.outposition[2] + i, O::add(pz, O::add(tz, tz)));
+
+            if (s.normal[0])
+            {
+                R nx, ny, nz;
+                rotate(O::load(s.normal[0] + i), O::load(s.normal[1] + i), O::load(s.normal[2] + i), nx, ny, nz);
+
+                O::store(s.outnormal[0] + i, nx);
+                O::store(s.outnormal[1] + i, ny);
+                O::store(s.outnormal[2] + i, nz);
+            }
+        }
+
+        // Rows of the affine part of palette[joint[i + lane]], m[4 * row + column]
+        template<typename O, typename T>
+        static inline void gathermatrix(const mat4<T>* palette, const u16* joint, size_t i, typename O::type (&m)[12]) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                const mat4<T>& j = palette[joint[i]];
+
+                m[0] = j.m00; m[1] = j.m10; m[2] = j.m20; m[3] = j.m30;
+                m[4] = j.m01; m[5] = j.m11; m[6] = j.m21; m[7] = j.m31;
+                m[8] = j.m02; m[9] = j.m12; m[10] = j.m22; m[11] = j.m32;
+            }
+            else
+            {
+                typename O::type pad;
+                const T* col[4][O::lanes];
+
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    const mat4<T>& j = palette[joint[i + l]];
+
+                    col[0][l] = &j.m00;
+                    col[1][l] = &j.m10;
+                    col[2][l] = &j.m20;
+                    col[3][l] = &j.m30;
+                }
+
+                for (s32 c = 0; c < 4; c++)
+                {
+                    O::load4(col[c], m[c], m[4 + c], m[8 + c], pad);
+                }
+            }
+        }
+
+        // Same for a row major 3x4 palette, 12 elements per joint
+        template<typename O, typename T>
+        static inline void gatheraffine(const T* palette, const u16* joint, size_t i, typename O::type (&m)[12]) noexcept
+        {
+            if constexpr (O::lanes == 1)
+            {
+                const T* j = palette + 12 * joint[i];
+
+                for (s32 e = 0; e < 12; e++)
+                {
+                    m[e] = j[e];
+                }
+            }
+            else
+            {
+                const T* row[3][O::lanes];
+
+                for (size_t l = 0; l < O::lanes; l++)
+                {
+                    const T* j = palette + 12 * joint[i + l];
+
+                    row[0][l] = j;
+                    row[1][l] = j + 4;
+                    row[2][l] = j + 8;
+                }
+
+                for (s32 r = 0; r < 3; r++)
+                {
+                    O::load4(row[r], m[4 * r + 0], m[4 * r + 1], m[4 * r + 2], m[4 * r + 3]);
+                }
+            }
+        }
+
+        template<typename O, typename P, typename T>
+        static inline void gatherpalette(const P* palette, const u16* joint, size_t i, typename O::type (&m)[12]) noexcept
+        {
+            if constexpr (std::is_same<P, T>::value)
+            {
+                gatheraffine<O>(palette, joint, i, m);
+            }
+            else
+            {
+                gathermatrix<O>(palette, joint, i, m);
+            }
+        }
+
+        // Linear blend skinning of O::lanes vertices starting at i. N is the number of influences
+        // when known up front: 1 is a rigid transform that ignores the weights, 2 blends with
+        // w0 and 1 - w0. N = 0 reads s.influences streams.
+        template<s32 N, typename O, typename P, typename T>
+        static inline void skinlinearlanes(const P* palette, const skinstreams<T>& s, size_t i) noexcept
+        {
+            typedef typename O::type R;
+
+            R m[12];
+            gatherpalette<O, P, T>(palette, s.joint[0], i, m);
+
+            if constexpr (N != 1)
+            {
+                R w = O::load(s.weight[0] + i);
+                R rest = O::sub(O::set1(static_cast<T>(1)), w);
+
+                for (s32 e = 0; e < 12; e++)
+                {
+                    m[e] = O::mul(m[e], w);
+                }
+
+                u32 influences = N == 2 ? 2 : s.influences;
+                for (u32 k = 1; k < influences; k++)
+                {
+                    R b[12];
+                    gatherpalette<O, P, T>(palette, s.joint[k], i, b);
+
+                    w = N == 2 ? rest : O::load(s.weight[k] + i);
+
+                    for (s32 e = 0; e < 12; e++)
+                    {
+                        m[e] = O::madd(b[e], w, m[e]);
+                    }
+                }
+            }
+
+            R px = O::load(s.position[0] + i);
+            R py = O::load(s.position[1] + i);
+            R pz = O::load(s.position[2] + i);
+
+            O::store(s.outposition[0] + i, O::madd(m[0], px, O::madd(m[1], py, O::madd(m[2], pz, m[3]))));
+            O::store(s.outposition[1] + i, O::madd(m[4], px, O::madd(m[5], py, O::madd(m[6], pz, m[7]))));
+            O::store(s.outposition[2] + i, O::madd(m[8], px, O::madd(m[9], py, O::madd(m[10], pz, m[11]))));
+
+            if (s.normal[0])
+            {
+                R nx = O::load(s.normal[0] + i);
+                R ny = O::load(s.normal[1] + i);
+                R nz = O::load(s.normal[2] + i);
+
+                R ox = O::madd(m[0], nx, O::madd(m[1], ny, O::mul(m[2], nz)));
+                R oy = O::madd(m[4], nx, O::madd(m[5], ny, O::mul(m[6], nz)));
+                R oz = O::madd(m[8], nx, O::madd(m[9], ny, O::mul(m[10], nz)));
+
+                // Blending (and scale) changes the length, zero stays zero
+                R lsq = O::madd(ox, ox, O::madd(oy, oy, O::mul(oz, oz)));
+                R inv = O::select(O::gt(lsq, O::zero()), O::div(O::set1(static_cast<T>(1)), O::sqrt(lsq)), O::zero());
+
+                O::store(s.outnormal[0] + i, O::mul(ox, inv));
+                O::store(s.outnormal[1] + i, O::mul(oy, inv));
+                O::store(s.outnormal[2] + i, O::mul(oz, inv));
+            }
+        }
+
+        template<s32 N, typename P, typename T>
+        static inline void skinlinear(const P* palette, const skinstreams<T>& streams, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_AVX
+            if constexpr (simdwide<T>::value)
+            {
+                for (; i + wide<T>::lanes <= count; i += wide<T>::lanes)
+                {
+                    skinlinearlanes<N, wide<T>>(palette, streams, i);
+                }
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                skinlinearlanes<N, narrow<T>>(palette, streams, i);
+            }
+        }
+
+        template<typename P, typename T>
+        static inline void skinlineardispatch(const P* palette, const skinstreams<T>& streams, size_t count) noexcept
+        {
+            switch (streams.influences)
+            {
+                case 1:
+                    skinlinear<1>(palette, streams, count);
+                    break;
+                case 2:
+                    skinlinear<2>(palette, streams, count);
+                    break;
+                default:
+                    skinlinear<0>(palette, streams, count);
+                    break;
+            }
+        }
+    } // namespace detail
+
+    // Linear blend skinning, the palette holds the skinning matrix (joint world transform times
+    // inverse bind pose) of every joint, only the affine part is used. Positions get the full
+    // blended matrix and normals its upper 3x3, renormalized (this is exact for rotation and
+    // uniform scale). One and two influences take fast paths that assume the weights add up
+    // to 1, so the weight stream of a single influence isn't read at all.
+    template<typename T>
+    inline void skinlinear(const mat4<T>* palette, const skinstreams<T>& streams, size_t count) noexcept
+    {
+        detail::skinlineardispatch(palette, streams, count);
+    }
+
+    // Same for a palette of row major 3x4 affine matrices, 12 T per joint
+    template<typename T>
+    inline void skinlinearaffine(const T* palette, const skinstreams<T>& streams, size_t count) noexcept
+    {
+        detail::skinlineardispatch(palette, streams, count);
+    }
+
+    // Dual quaternion skinning, palette holds the skinning transform (joint world transform
+    // times inverse bind pose) of every joint. Rigid transforms only, scale isn't supported.
+    template<typename T>
+    inline void skindualquat(const dualquat<T>* palette, const skinstreams<T>& streams, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            for (; i + wide<T>::lanes <= count; i += wide<T>::lanes)
+            {
+                detail::skindualquatlanes<wide<T>>(palette, streams, i);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            detail::skindualquatlanes<narrow<T>>(palette, streams, i);
+        }
+    }
+SML_NAMESPACE_END
+
+#endif // sml_skinning_h__
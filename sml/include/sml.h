@@ -19,8 +19,10 @@
 */
 
 #include <smltypes.h>
+#include <backend.h>
 #include <config.h>
 #include <common.h>
+#include <simd.h>
 
 #include <vec2.h>
 #include <vec3.h>
@@ -31,5 +33,25 @@
 #include <mat4.h>
 
 #include <quat.h>
+#include <trs.h>
+#include <dualquat.h>
+
+#include <divider.h>
+#include <vecarray.h>
+#include <mask.h>
+#include <reduce.h>
+#include <skinning.h>
+#include <noise.h>
+#include <random.h>
+#include <spatialhash.h>
+#include <kdtree.h>
+#include <closest.h>
+#include <gjk.h>
+#include <plane.h>
+#include <ray.h>
+#include <segment.h>
+#include <triangle.h>
+#include <capsule.h>
+#include <curve.h>
 
 #endif // sml_h__
\ No newline at end of file
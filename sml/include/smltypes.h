@@ -18,9 +18,12 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
+#include "backend.h"
+
 // Predefined types
 typedef unsigned char u8;
 typedef signed char s8;
@@ -52,6 +55,22 @@ namespace sml
     struct simdalign<f64> : std::integral_constant<size_t, 32>
     {
     };
+
+    template<>
+    struct simdalign<s32> : std::integral_constant<size_t, 16>
+    {
+    };
+
+    template<>
+    struct simdalign<u32> : std::integral_constant<size_t, 16>
+    {
+    };
+
+    // 32 bit integer types, see simdi32 for the ones that take the SSE4.1 / AVX2 integer paths
+    template<typename T>
+    struct simdint : std::integral_constant<bool, std::is_same<T, s32>::value || std::is_same<T, u32>::value>
+    {
+    };
 }
 
 #endif // smltypes_h__
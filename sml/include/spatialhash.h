@@ -0,0 +1,361 @@
+#ifndef sml_spatialhash_h__
+#define sml_spatialhash_h__
+
+/* spatialhash.h -- spatial hash grid of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec3.h"
+
+// Fixed radius neighbour queries over a vec3 point set. Points are bucketed by the hash of their
+// grid cell with a counting sort into one flat array, so the points of a cell are contiguous and
+// stored as structure of arrays in bucket order, which the queries filter 8 (f32) or 4 (f64) at
+// a time. Cells that hash to the same bucket share it, the distance filter sorts them out.
+//
+// update() moves the points in place when they stay in their bucket and keeps the few that
+// change buckets in a small overflow list that every query scans as well, the grid is only
+// rebuilt once that list grows past a fraction of the points.
+
+SML_NAMESPACE_BEGIN
+    template<typename T>
+    class spatialhash
+    {
+        static_assert(std::is_floating_point<T>::value, "spatialhash needs f32 or f64 points");
+
+        public:
+            static constexpr u32 none = 0xFFFFFFFFu;
+
+            // cellsize is best close to the query radius, a query scans the cells its bounding
+            // box touches
+            explicit spatialhash(T cellsize) noexcept
+                : cell(cellsize), inverse(static_cast<T>(1) / cellsize)
+            {
+            }
+
+            // Rebuilds the grid from scratch
+            void build(const vec3<T>* points, size_t count)
+            {
+                size_t buckets = 1;
+                while (buckets < count)
+                    buckets <<= 1;
+
+                mask = static_cast<u32>(buckets - 1);
+                start.assign(buckets + 1, 0);
+                bucketof.resize(count);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    u32 b = bucket(points[i]);
+
+                    bucketof[i] = b;
+                    start[b + 1]++;
+                }
+
+                for (size_t b = 0; b < buckets; b++)
+                {
+                    start[b + 1] += start[b];
+                }
+
+                // Stable scatter, points keep their relative order within a bucket
+                std::vector<u32> fill(start.begin(), start.end() - 1);
+
+                x.resize(count);
+                y.resize(count);
+                z.resize(count);
+                order.resize(count);
+                slot.resize(count);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    u32 s = fill[bucketof[i]]++;
+
+                    x[s] = points[i].x;
+                    y[s] = points[i].y;
+                    z[s] = points[i].z;
+                    order[s] = static_cast<u32>(i);
+                    slot[i] = s;
+                }
+
+                moved.clear();
+                mx.clear();
+                my.clear();
+                mz.clear();
+                movedslot.assign(count, none);
+            }
+
+            // Takes the new positions of the same points. Returns true when the grid had to be
+            // rebuilt, either because the count changed or because more than count / threshold
+            // points left their bucket since the last build.
+            bool update(const vec3<T>* points, size_t count, size_t threshold = 16)
+            {
+                if (count != slot.size())
+                {
+                    build(points, count);
+                    return true;
+                }
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    const vec3<T>& p = points[i];
+                    u32 m = movedslot[i];
+
+                    if (m != none)
+                    {
+                        mx[m] = p.x;
+                        my[m] = p.y;
+                        mz[m] = p.z;
+                    }
+                    else if (bucket(p) == bucketof[i])
+                    {
+                        u32 s = slot[i];
+
+                        x[s] = p.x;
+                        y[s] = p.y;
+                        z[s] = p.z;
+                    }
+                    else
+                    {
+                        // The old slot stays behind, infinitely far away so no query matches it
+                        u32 s = slot[i];
+                        x[s] = y[s] = z[s] = std::numeric_limits<T>::infinity();
+
+                        movedslot[i] = static_cast<u32>(moved.size());
+                        moved.push_back(static_cast<u32>(i));
+                        mx.push_back(p.x);
+                        my.push_back(p.y);
+                        mz.push_back(p.z);
+                    }
+                }
+
+                if (moved.size() * threshold > count)
+                {
+                    build(points, count);
+                    return true;
+                }
+
+                return false;
+            }
+
+            // Calls visit(index, distance squared) for every point within radius of center, in no
+            // particular order
+            template<typename F>
+            void query(const vec3<T>& center, T radius, const F& visit) const
+            {
+                if (slot.empty())
+                    return;
+
+                T rsq = radius * radius;
+
+                s32 lo[3], hi[3];
+                for (s32 k = 0; k < 3; k++)
+                {
+                    lo[k] = coordinate(center.v[k] - radius);
+                    hi[k] = coordinate(center.v[k] + radius);
+                }
+
+                uint64_t cells = 1;
+                for (s32 k = 0; k < 3; k++)
+                {
+                    cells *= static_cast<uint64_t>(static_cast<int64_t>(hi[k]) - lo[k] + 1);
+                }
+
+                if (cells > mask)
+                {
+                    // The range covers at least as many cells as there are buckets, one pass over
+                    // all slots is cheaper than hashing every cell
+                    filter(x.data(), y.data(), z.data(), order.data(), 0, start[mask + 1], center, rsq, visit);
+                }
+                else
+                {
+                    // Different cells can share a bucket, every bucket is scanned once
+                    u32 local[64];
+                    std::vector<u32> heap;
+                    u32* buckets = local;
+
+                    if (cells > 64)
+                    {
+                        heap.resize(static_cast<size_t>(cells));
+                        buckets = heap.data();
+                    }
+
+                    size_t used = 0;
+                    for (s32 cz = lo[2]; cz <= hi[2]; cz++)
+                    {
+                        for (s32 cy = lo[1]; cy <= hi[1]; cy++)
+                        {
+                            for (s32 cx = lo[0]; cx <= hi[0]; cx++)
+                            {
+                                u32 b = hash(cx, cy, cz);
+
+                                if (start[b] != start[b + 1])
+                                    buckets[used++] = b;
+                            }
+                        }
+                    }
+
+                    std::sort(buckets, buckets + used);
+
+                    for (size_t i = 0; i < used; i++)
+                    {
+                        u32 b = buckets[i];
+
+                        if (i == 0 || buckets[i - 1] != b)
+                            filter(x.data(), y.data(), z.data(), order.data(), start[b], start[b + 1], center, rsq, visit);
+                    }
+                }
+
+                if (!moved.empty())
+                {
+                    filter(mx.data(), my.data(), mz.data(), moved.data(), 0, static_cast<u32>(moved.size()), center, rsq, visit);
+                }
+            }
+
+            // Appends the indices of the points within radius of center to out, returns how many
+            size_t query(const vec3<T>& center, T radius, std::vector<u32>& out) const
+            {
+                size_t before = out.size();
+                query(center, radius, [&](u32 index, T) { out.push_back(index); });
+
+                return out.size() - before;
+            }
+
+            // Point index of every slot in bucket order. Reordering per point data by it keeps
+            // neighbours close in memory, rebuild with the reordered points afterwards.
+            SML_NO_DISCARD inline const std::vector<u32>& ordering() const noexcept
+            {
+                return order;
+            }
+
+            SML_NO_DISCARD inline size_t size() const noexcept
+            {
+                return slot.size();
+            }
+
+            SML_NO_DISCARD inline size_t movedcount() const noexcept
+            {
+                return moved.size();
+            }
+
+            SML_NO_DISCARD inline T cellsize() const noexcept
+            {
+                return cell;
+            }
+
+        private:
+            inline s32 coordinate(T v) const noexcept
+            {
+                return static_cast<s32>(sml::floor(v * inverse));
+            }
+
+            // Teschner et al., "Optimized spatial hashing for collision detection of deformable objects"
+            inline u32 hash(s32 cx, s32 cy, s32 cz) const noexcept
+            {
+                return ((static_cast<u32>(cx) * 73856093u) ^ (static_cast<u32>(cy) * 19349663u) ^ (static_cast<u32>(cz) * 83492791u)) & mask;
+            }
+
+            inline u32 bucket(const vec3<T>& p) const noexcept
+            {
+                return hash(coordinate(p.x), coordinate(p.y), coordinate(p.z));
+            }
+
+            template<typename O, typename F>
+            static inline void filterlanes(const T* px, const T* py, const T* pz, const u32* index, u32 i, typename O::type cx, typename O::type cy, typename O::type cz, typename O::type rsq, const F& visit)
+            {
+                typedef typename O::type R;
+
+                R dx = O::sub(O::load(px + i), cx);
+                R dy = O::sub(O::load(py + i), cy);
+                R dz = O::sub(O::load(pz + i), cz);
+                R dsq = O::madd(dx, dx, O::madd(dy, dy, O::mul(dz, dz)));
+
+                s32 bits = O::movemask(O::le(dsq, rsq));
+
+                if (bits == 0)
+                    return;
+
+                T d[O::lanes];
+                O::store(d, dsq);
+
+                for (u32 l = 0; l < O::lanes; l++)
+                {
+                    if (bits & (1 << l))
+                    {
+                        visit(index[i + l], d[l]);
+                    }
+                }
+            }
+
+            // visit() for the points in slots [begin, end) within sqrt(rsq) of center
+            template<typename F>
+            static inline void filter(const T* px, const T* py, const T* pz, const u32* index, u32 begin, u32 end, const vec3<T>& center, T rsq, const F& visit)
+            {
+                u32 i = begin;
+
+#if SML_AVX
+                if constexpr (simdwide<T>::value)
+                {
+                    typedef wide<T> O;
+
+                    if (end - begin >= O::lanes)
+                    {
+                        typename O::type cx = O::set1(center.x), cy = O::set1(center.y), cz = O::set1(center.z), r = O::set1(rsq);
+
+                        for (; i + O::lanes <= end; i += O::lanes)
+                        {
+                            filterlanes<O>(px, py, pz, index, i, cx, cy, cz, r, visit);
+                        }
+                    }
+                }
+#endif
+
+                for (; i < end; i++)
+                {
+                    filterlanes<narrow<T>>(px, py, pz, index, i, center.x, center.y, center.z, rsq, visit);
+                }
+            }
+
+            T cell;
+            T inverse;
+            u32 mask = 0;
+
+            // Bucket b holds the slots [start[b], start[b + 1])
+            std::vector<u32> start;
+
+            // Positions and point index per slot, in bucket order
+            std::vector<T> x, y, z;
+            std::vector<u32> order;
+
+            // Slot and bucket of every point as of the last build
+            std::vector<u32> slot;
+            std::vector<u32> bucketof;
+
+            // Points that left their bucket since the last build and their current positions
+            std::vector<u32> moved;
+            std::vector<T> mx, my, mz;
+            std::vector<u32> movedslot;
+    };
+SML_NAMESPACE_END
+
+#endif // sml_spatialhash_h__
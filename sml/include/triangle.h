@@ -0,0 +1,135 @@
+#ifndef sml_triangle_h__
+#define sml_triangle_h__
+
+/* triangle.h -- triangle of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "common.h"
+#include "smltypes.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "plane.h"
+#include "closest.h"
+
+SML_NAMESPACE_BEGIN
+    // Triangle a, b, c, front facing when counter clockwise
+    template<typename T>
+    class triangle
+    {
+        public:
+            constexpr triangle() noexcept
+                : a(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)), b(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0)), c(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0))
+            {
+            }
+
+            constexpr triangle(const vec3<T>& a, const vec3<T>& b, const vec3<T>& c) noexcept
+                : a(a), b(b), c(c)
+            {
+            }
+
+            // Operators
+            inline constexpr bool operator == (const triangle& other) const noexcept
+            {
+                return a == other.a && b == other.b && c == other.c;
+            }
+
+            inline constexpr bool operator != (const triangle& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            // Functions
+            // Normal of the counter clockwise winding with twice the area as length
+            SML_NO_DISCARD inline constexpr vec3<T> normal() const noexcept
+            {
+                return vec3<T>::cross(b - a, c - a);
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> unitnormal() const noexcept
+            {
+                return normal().normalized();
+            }
+
+            SML_NO_DISCARD inline constexpr T area() const noexcept
+            {
+                return normal().length() * static_cast<T>(0.5);
+            }
+
+            SML_NO_DISCARD inline constexpr vec3<T> centroid() const noexcept
+            {
+                return (a + b + c) * (static_cast<T>(1) / static_cast<T>(3));
+            }
+
+            SML_NO_DISCARD inline constexpr plane<T> toplane() const noexcept
+            {
+                return plane<T>::frompoints(a, b, c);
+            }
+
+            // Weights (u, v, w) with point = u * a + v * b + w * c for the projection of point onto
+            // the triangle's plane, zero for a degenerate triangle
+            SML_NO_DISCARD inline constexpr vec3<T> barycentric(const vec3<T>& point) const noexcept
+            {
+                vec3<T> ab = b - a, ac = c - a, ap = point - a;
+                T d00 = ab.dot(ab), d01 = ab.dot(ac), d11 = ac.dot(ac);
+                T d20 = ap.dot(ab), d21 = ap.dot(ac);
+                T denominator = d00 * d11 - d01 * d01;
+
+                if (denominator == static_cast<T>(0))
+                    return vec3<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0));
+
+                T v = (d11 * d20 - d01 * d21) / denominator;
+                T w = (d00 * d21 - d01 * d20) / denominator;
+
+                return vec3<T>(static_cast<T>(1) - v - w, v, w);
+            }
+
+            SML_NO_DISCARD inline vec3<T> closestpoint(const vec3<T>& point) const noexcept
+            {
+                return closestpointtriangle(point, a, b, c);
+            }
+
+            SML_NO_DISCARD inline T distancesquared(const vec3<T>& point) const noexcept
+            {
+                return distancesquaredtriangle(point, a, b, c);
+            }
+
+            SML_NO_DISCARD inline T distance(const vec3<T>& point) const noexcept
+            {
+                return distancetriangle(point, a, b, c);
+            }
+
+            SML_NO_DISCARD inline constexpr triangle transformed(const mat4<T>& matrix) const noexcept
+            {
+                return triangle(matrix.transformPoint(a), matrix.transformPoint(b), matrix.transformPoint(c));
+            }
+
+            // Variables
+            vec3<T> a;
+            vec3<T> b;
+            vec3<T> c;
+    };
+
+    // Predefined types
+    typedef triangle<f32> ftriangle;
+    typedef triangle<f64> dtriangle;
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class triangle<f32>)
+    SML_EXTERN_TEMPLATE(class triangle<f64>)
+SML_NAMESPACE_END
+
+#endif // sml_triangle_h__
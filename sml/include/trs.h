@@ -0,0 +1,241 @@
+#ifndef sml_trs_h__
+#define sml_trs_h__
+
+/* trs.h -- bulk translation, rotation, scale conversion of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "common.h"
+#include "simd.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "quat.h"
+
+SML_NAMESPACE_BEGIN
+    // Transforms stored as structure of arrays, one array per component. Element i of every
+    // array belongs to transform i, so compose() and decompose() can handle wide<T>::lanes
+    // transforms per instruction without shuffling.
+    template<typename T>
+    struct trsarray
+    {
+        T* tx;
+        T* ty;
+        T* tz;
+
+        T* qx;
+        T* qy;
+        T* qz;
+        T* qw;
+
+        T* sx;
+        T* sy;
+        T* sz;
+    };
+
+    // Array form of mat4::compose
+    template<typename T>
+    inline void compose(const trsarray<T>& trs, mat4<T>* out, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> W;
+            typedef typename W::type R;
+
+            constexpr size_t stride = sizeof(mat4<T>) / sizeof(T);
+
+            const R one = W::set1(static_cast<T>(1));
+            const R zero = W::zero();
+
+            for (; i + W::lanes <= count; i += W::lanes)
+            {
+                R x = W::load(trs.qx + i), y = W::load(trs.qy + i), z = W::load(trs.qz + i), w = W::load(trs.qw + i);
+                R sx = W::load(trs.sx + i), sy = W::load(trs.sy + i), sz = W::load(trs.sz + i);
+
+                R x2 = W::add(x, x), y2 = W::add(y, y), z2 = W::add(z, z);
+                R xx = W::mul(x, x2), yy = W::mul(y, y2), zz = W::mul(z, z2);
+                R xy = W::mul(x, y2), xz = W::mul(x, z2), yz = W::mul(y, z2);
+                R wx = W::mul(w, x2), wy = W::mul(w, y2), wz = W::mul(w, z2);
+
+                T* p = &out[i].m00;
+
+                W::store4(p + 0, stride, W::mul(W::sub(one, W::add(yy, zz)), sx), W::mul(W::add(xy, wz), sx), W::mul(W::sub(xz, wy), sx), zero);
+                W::store4(p + 4, stride, W::mul(W::sub(xy, wz), sy), W::mul(W::sub(one, W::add(xx, zz)), sy), W::mul(W::add(yz, wx), sy), zero);
+                W::store4(p + 8, stride, W::mul(W::add(xz, wy), sz), W::mul(W::sub(yz, wx), sz), W::mul(W::sub(one, W::add(xx, yy)), sz), zero);
+                W::store4(p + 12, stride, W::load(trs.tx + i), W::load(trs.ty + i), W::load(trs.tz + i), one);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            out[i] = mat4<T>::compose(vec3<T>(trs.tx[i], trs.ty[i], trs.tz[i]),
+                                      quat<T>(trs.qx[i], trs.qy[i], trs.qz[i], trs.qw[i]),
+                                      vec3<T>(trs.sx[i], trs.sy[i], trs.sz[i]));
+        }
+    }
+
+    // Array form of mat4::decompose, returns the number of degenerate matrices
+    template<typename T>
+    inline size_t decompose(const mat4<T>* matrices, const trsarray<T>& trs, size_t count) noexcept
+    {
+        size_t degenerate = 0;
+        size_t i = 0;
+
+#if SML_AVX
+        if constexpr (simdwide<T>::value)
+        {
+            typedef wide<T> W;
+            typedef typename W::type R;
+
+            constexpr size_t stride = sizeof(mat4<T>) / sizeof(T);
+
+            const R one = W::set1(static_cast<T>(1));
+            const R zero = W::zero();
+            const R eps = W::set1(static_cast<T>(constants::epsilon));
+            const R nearaxis = W::set1(static_cast<T>(0.9));
+
+            for (; i + W::lanes <= count; i += W::lanes)
+            {
+                const T* p = &matrices[i].m00;
+
+                R m00, m01, m02, m10, m11, m12, m20, m21, m22, tx, ty, tz, pad;
+                W::load4(p + 0, stride, m00, m01, m02, pad);
+                W::load4(p + 4, stride, m10, m11, m12, pad);
+                W::load4(p + 8, stride, m20, m21, m22, pad);
+                W::load4(p + 12, stride, tx, ty, tz, pad);
+
+                // x axis, when the column is degenerate perpendicular to the other two columns, or
+                // to the one that is left, or unit x (same as mat4::decompose)
+                R sx = W::sqrt(W::madd(m00, m00, W::madd(m01, m01, W::mul(m02, m02))));
+                R validx = W::gt(sx, eps);
+
+                R nx = W::sub(W::mul(m11, m22), W::mul(m12, m21));
+                R ny = W::sub(W::mul(m12, m20), W::mul(m10, m22));
+                R nz = W::sub(W::mul(m10, m21), W::mul(m11, m20));
+                R ln = W::sqrt(W::madd(nx, nx, W::madd(ny, ny, W::mul(nz, nz))));
+
+                R l1 = W::sqrt(W::madd(m10, m10, W::madd(m11, m11, W::mul(m12, m12))));
+                R l2 = W::sqrt(W::madd(m20, m20, W::madd(m21, m21, W::mul(m22, m22))));
+                R usec1 = W::gt(l1, eps);
+                R ox = W::select(usec1, m10, m20);
+                R oy = W::select(usec1, m11, m21);
+                R oz = W::select(usec1, m12, m22);
+                R lo = W::select(usec1, l1, l2);
+
+                R usez = W::lt(W::abs(oz), W::mul(nearaxis, lo));
+                R px = W::select(usez, oy, oz);
+                R py = W::select(usez, W::neg(ox), zero);
+                R pz = W::select(usez, zero, W::neg(ox));
+                R lp = W::sqrt(W::madd(px, px, W::madd(py, py, W::mul(pz, pz))));
+
+                R usen = W::gt(ln, eps);
+                R usep = W::gt(lp, eps);
+                R rx = W::select(validx, sx, W::select(usen, ln, W::select(usep, lp, one)));
+                R xx = W::div(W::select(validx, m00, W::select(usen, nx, W::select(usep, px, one))), rx);
+                R xy = W::div(W::select(validx, m01, W::select(usen, ny, W::select(usep, py, zero))), rx);
+                R xz = W::div(W::select(validx, m02, W::select(usen, nz, W::select(usep, pz, zero))), rx);
+
+                // y axis, Gram-Schmidt against x. When that is degenerate cross(z, x) with z from the
+                // third column, or any axis perpendicular to x (unit y for x = unit x)
+                R d = W::madd(xx, m10, W::madd(xy, m11, W::mul(xz, m12)));
+                R yx = W::sub(m10, W::mul(xx, d));
+                R yy = W::sub(m11, W::mul(xy, d));
+                R yz = W::sub(m12, W::mul(xz, d));
+                R ly = W::sqrt(W::madd(yx, yx, W::madd(yy, yy, W::mul(yz, yz))));
+                R validy = W::gt(ly, eps);
+
+                R e = W::madd(xx, m20, W::madd(xy, m21, W::mul(xz, m22)));
+                R wx = W::sub(m20, W::mul(xx, e));
+                R wy = W::sub(m21, W::mul(xy, e));
+                R wz = W::sub(m22, W::mul(xz, e));
+                R lw = W::sqrt(W::madd(wx, wx, W::madd(wy, wy, W::mul(wz, wz))));
+                R usew = W::gt(lw, eps);
+
+                R cx = W::sub(W::mul(wy, xz), W::mul(wz, xy));
+                R cy = W::sub(W::mul(wz, xx), W::mul(wx, xz));
+                R cz = W::sub(W::mul(wx, xy), W::mul(wy, xx));
+
+                R usexy = W::lt(W::abs(xz), nearaxis);
+                R fx = W::select(usexy, W::neg(xy), xz);
+                R fy = W::select(usexy, xx, zero);
+                R fz = W::select(usexy, zero, W::neg(xx));
+                R lf = W::sqrt(W::madd(fx, fx, W::madd(fy, fy, W::mul(fz, fz))));
+
+                R ry = W::select(validy, ly, W::select(usew, lw, lf));
+                yx = W::div(W::select(validy, yx, W::select(usew, cx, fx)), ry);
+                yy = W::div(W::select(validy, yy, W::select(usew, cy, fy)), ry);
+                yz = W::div(W::select(validy, yz, W::select(usew, cz, fz)), ry);
+
+                // z = cross(x, y)
+                R zx = W::sub(W::mul(xy, yz), W::mul(xz, yy));
+                R zy = W::sub(W::mul(xz, yx), W::mul(xx, yz));
+                R zz = W::sub(W::mul(xx, yy), W::mul(xy, yx));
+
+                R sy = W::madd(yx, m10, W::madd(yy, m11, W::mul(yz, m12)));
+                R sz = W::madd(zx, m20, W::madd(zy, m21, W::mul(zz, m22)));
+                R validz = W::gt(W::abs(sz), eps);
+
+                R qx, qy, qz, qw;
+                detail::quatfrombasis<T>(xx, xy, xz, yx, yy, yz, zx, zy, zz, qx, qy, qz, qw);
+
+                W::store(trs.tx + i, tx);
+                W::store(trs.ty + i, ty);
+                W::store(trs.tz + i, tz);
+                W::store(trs.qx + i, qx);
+                W::store(trs.qy + i, qy);
+                W::store(trs.qz + i, qz);
+                W::store(trs.qw + i, qw);
+                W::store(trs.sx + i, sx);
+                W::store(trs.sy + i, sy);
+                W::store(trs.sz + i, sz);
+
+                s32 invalid = ~W::movemask(W::band(W::band(validx, validy), validz)) & ((1 << W::lanes) - 1);
+                for (; invalid != 0; invalid &= invalid - 1)
+                    degenerate++;
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            vec3<T> translation, scale;
+            quat<T> rotation;
+
+            degenerate += matrices[i].decompose(translation, rotation, scale) ? 0 : 1;
+
+            trs.tx[i] = translation.x;
+            trs.ty[i] = translation.y;
+            trs.tz[i] = translation.z;
+            trs.qx[i] = rotation.x;
+            trs.qy[i] = rotation.y;
+            trs.qz[i] = rotation.z;
+            trs.qw[i] = rotation.w;
+            trs.sx[i] = scale.x;
+            trs.sy[i] = scale.y;
+            trs.sz[i] = scale.z;
+        }
+
+        return degenerate;
+    }
+SML_NAMESPACE_END
+
+#endif // sml_trs_h__
@@ -19,13 +19,11 @@
 */
 
 #include <string>
-#include <immintrin.h>
 
 #include "smltypes.h"
 #include "common.h"
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
     template<typename T>
     class vec2view;
 
@@ -124,7 +122,8 @@ namespace sml
 
             vec2& operator += (const vec2& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -135,8 +134,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_load_pd(other.v);
@@ -146,6 +147,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_add_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x += other.x;
                 y += other.y;
@@ -155,7 +170,8 @@ namespace sml
 
             vec2& operator -= (const vec2& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -165,8 +181,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_load_pd(other.v);
@@ -176,6 +194,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_sub_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x -= other.x;
                 y -= other.y;
@@ -185,7 +217,8 @@ namespace sml
 
             vec2& operator *= (const vec2& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -195,8 +228,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_load_pd(other.v);
@@ -206,6 +241,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other.x;
                 y *= other.y;
@@ -215,18 +264,21 @@ namespace sml
 
             vec2& operator *= (const T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 ot = _mm_broadcast_ss(&other);
+                    __m128 ot = _mm_set1_ps(other);
                     __m128 res = _mm_mul_ps(me, ot);
 
                     _mm_store_ps(v, res);
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_set1_pd(other);
@@ -236,6 +288,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_set1_epi32(static_cast<s32>(other));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other;
                 y *= other;
@@ -245,7 +311,8 @@ namespace sml
 
             vec2& operator /= (const vec2& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -255,8 +322,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_load_pd(other.v);
@@ -266,6 +335,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other.x;
                 y /= other.y;
@@ -275,10 +345,11 @@ namespace sml
 
             vec2& operator /= (const T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 ot = _mm_broadcast_ss(&other);
+                    __m128 ot = _mm_set1_ps(other);
                     __m128 res = _mm_div_ps(me, ot);
 
                     _mm_store_ps(v, res);
@@ -287,8 +358,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m128d me = _mm_load_pd(v);
                     __m128d ot = _mm_set1_pd(other);
@@ -300,6 +373,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other;
                 y /= other;
@@ -310,7 +384,8 @@ namespace sml
             // Operations 
             SML_NO_DISCARD inline constexpr T dot(vec2 other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -321,6 +396,7 @@ namespace sml
 
                     return *reinterpret_cast<f32*>(&(res));
                 }
+#endif
 
                 return (x * other.x) + (y * other.y);
             }
@@ -342,12 +418,46 @@ namespace sml
                 if(mag > constants::epsilon)
                     *this /= length();
                 else
-                    set(0);
+                    zero();
+            }
+
+            // Normalizes with the rsqrt estimate and one Newton-Raphson step instead of sqrt and divide.
+            // The relative error is below 2^-21 for f32, other types use a single exact 1 / sqrt.
+            // Like normalize(), vectors with a length at or below epsilon become zero.
+            inline void normalizeFast() noexcept
+            {
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    __m128 me = _mm_load_ps(v);
+                    __m128 lsq = _mm_dp_ps(me, me, 0x3f);
+                    __m128 valid = _mm_cmpgt_ps(lsq, _mm_set1_ps(constants::epsilon * constants::epsilon));
+
+                    _mm_store_ps(v, _mm_and_ps(_mm_mul_ps(me, detail::rsqrtnr(lsq)), valid));
+
+                    return;
+                }
+#endif
+
+                T lsq = lengthsquared();
+
+                if (lsq > static_cast<T>(constants::epsilon * constants::epsilon))
+                    *this *= static_cast<T>(1) / sml::sqrt(lsq);
+                else
+                    zero();
+            }
+
+            SML_NO_DISCARD inline vec2 normalizedFast() const noexcept
+            {
+                vec2 copy(*this);
+                copy.normalizeFast();
+
+                return copy;
             }
 
             SML_NO_DISCARD inline constexpr vec2 normalized() const  noexcept
             {
-                vec2 copy(v);
+                vec2 copy(*this);
                 copy.normalize();
 
                 return copy;
@@ -376,12 +486,17 @@ namespace sml
             // Statics
             SML_NO_DISCARD static inline constexpr vec2 normalize(const vec2& a) noexcept
             {
-                vec2 copy(a.v);
+                vec2 copy(a);
                 copy.normalize();
 
                 return copy;
             }
 
+            SML_NO_DISCARD static inline vec2 normalizeFast(const vec2& a) noexcept
+            {
+                return a.normalizedFast();
+            }
+
             SML_NO_DISCARD static inline constexpr T dot(const vec2& lhs, const vec2& rhs) noexcept
             {
                 return lhs.dot(rhs);
@@ -397,7 +512,8 @@ namespace sml
             {
                 vec2 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -408,8 +524,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -420,6 +538,35 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
@@ -432,7 +579,8 @@ namespace sml
             {
                 vec2 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -443,8 +591,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -455,10 +605,39 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
-                    sml::max(a.x, b.y), 
+                    sml::max(a.x, b.x), 
                     sml::max(a.y, b.y)
                 };
             }
@@ -621,6 +800,11 @@ namespace sml
 
         return *this;
     }
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class vec2<f32>)
+    SML_EXTERN_TEMPLATE(class vec2<f64>)
+    SML_EXTERN_TEMPLATE(class vec2<s32>)
+SML_NAMESPACE_END
 
 #endif // sml_vec2_h__
\ No newline at end of file
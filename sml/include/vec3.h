@@ -19,13 +19,11 @@
 */
 
 #include <string>
-#include <immintrin.h>
 
 #include "smltypes.h"
 #include "common.h"
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
     template<typename T>
     class vec3view;
 
@@ -122,7 +120,8 @@ namespace sml
 
             vec3& operator += (const vec3& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -132,8 +131,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -143,6 +144,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_add_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x += other.x;
                 y += other.y;
@@ -153,7 +168,8 @@ namespace sml
 
             vec3& operator -= (const vec3& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -163,8 +179,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -174,6 +192,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_sub_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x -= other.x;
                 y -= other.y;
@@ -184,7 +216,8 @@ namespace sml
 
             vec3& operator *= (const vec3& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -194,8 +227,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -205,6 +240,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other.x;
                 y *= other.y;
@@ -215,18 +264,21 @@ namespace sml
 
             vec3& operator *= (T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 him = _mm_broadcast_ss(&other);
+                    __m128 him = _mm_set1_ps(other);
                     __m128 res = _mm_mul_ps(me, him);
 
                     _mm_store_ps(v, res);
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_set1_pd(other);
@@ -236,6 +288,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_set1_epi32(static_cast<s32>(other));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other;
                 y *= other;
@@ -246,7 +312,8 @@ namespace sml
 
             vec3& operator /= (const vec3& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -256,8 +323,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -267,6 +336,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other.x;
                 y /= other.y;
@@ -277,18 +347,21 @@ namespace sml
 
             vec3& operator /= (const T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 him = _mm_broadcast_ss(&other);
+                    __m128 him = _mm_set1_ps(other);
                     __m128 res = _mm_div_ps(me, him);
 
                     _mm_store_ps(v, res);
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_set1_pd(other);
@@ -298,6 +371,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other;
                 y /= other;
@@ -309,7 +383,8 @@ namespace sml
             // Operations
             SML_NO_DISCARD inline constexpr T dot(vec3 other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_loadu_ps(v);
                     __m128 ot = _mm_loadu_ps(other.v);
@@ -318,33 +393,35 @@ namespace sml
 
                     return _mm_cvtss_f32(dp);
                 }
+#endif
 
                 return (x * other.x) + (y * other.y) + (z * other.z);
             }
 
-            SML_NO_DISCARD inline constexpr T sqrt() const noexcept
+            // Component wise square root
+            SML_NO_DISCARD inline constexpr vec3 sqrt() const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
-                    __m128 t = _mm_load_ps(v);
-                    __m128 res = _mm_sqrt_ps(t);
+                    vec3 res;
+                    _mm_store_ps(res.v, _mm_sqrt_ps(_mm_load_ps(v)));
 
-                    _mm128_store_ps(v, res);
+                    return res;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
-                    __m256 t = _mm256_load_pd(v);
-                    __m256 res = _mm256_sqrt_pd(t);
+                    vec3 res;
+                    _mm256_store_pd(res.v, _mm256_sqrt_pd(_mm256_load_pd(v)));
 
-                    _mm256_store_pd(v, res);
+                    return res;
                 }
+#endif
 
-                x = sml::sqrt(x);
-                y = sml::sqrt(y);
-                z = sml::sqrt(z);
-
-                return *this;
+                return vec3(sml::sqrt(x), sml::sqrt(y), sml::sqrt(z));
             }
 
             SML_NO_DISCARD inline constexpr T length() const noexcept
@@ -364,12 +441,46 @@ namespace sml
                 if(mag > constants::epsilon)
                     *this /= length();
                 else
-                    set(0);
+                    zero();
+            }
+
+            // Normalizes with the rsqrt estimate and one Newton-Raphson step instead of sqrt and divide.
+            // The relative error is below 2^-21 for f32, other types use a single exact 1 / sqrt.
+            // Like normalize(), vectors with a length at or below epsilon become zero.
+            inline void normalizeFast() noexcept
+            {
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    __m128 me = _mm_load_ps(v);
+                    __m128 lsq = _mm_dp_ps(me, me, 0x7f);
+                    __m128 valid = _mm_cmpgt_ps(lsq, _mm_set1_ps(constants::epsilon * constants::epsilon));
+
+                    _mm_store_ps(v, _mm_and_ps(_mm_mul_ps(me, detail::rsqrtnr(lsq)), valid));
+
+                    return;
+                }
+#endif
+
+                T lsq = lengthsquared();
+
+                if (lsq > static_cast<T>(constants::epsilon * constants::epsilon))
+                    *this *= static_cast<T>(1) / sml::sqrt(lsq);
+                else
+                    zero();
+            }
+
+            SML_NO_DISCARD inline vec3 normalizedFast() const noexcept
+            {
+                vec3 copy(*this);
+                copy.normalizeFast();
+
+                return copy;
             }
 
             SML_NO_DISCARD inline constexpr vec3 normalized() const noexcept
             {
-                vec3 copy(v);
+                vec3 copy(*this);
                 copy.normalize();
 
                 return copy;
@@ -398,12 +509,17 @@ namespace sml
             // Statics
             SML_NO_DISCARD static inline constexpr vec3 normalize(const vec3& a) noexcept
             {
-                vec3 copy(a.v);
+                vec3 copy(a);
                 copy.normalize();
 
                 return copy;
             }
 
+            SML_NO_DISCARD static inline vec3 normalizeFast(const vec3& a) noexcept
+            {
+                return a.normalizedFast();
+            }
+
             SML_NO_DISCARD static inline constexpr T dot(const vec3& lhs, const vec3& rhs) noexcept
             {
                 return lhs.dot(rhs);
@@ -419,7 +535,8 @@ namespace sml
             {
                 vec3 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -430,8 +547,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -442,6 +561,35 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
@@ -455,7 +603,8 @@ namespace sml
             {
                 vec3 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -466,8 +615,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -478,10 +629,39 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
-                    sml::max(a.x, b.y), 
+                    sml::max(a.x, b.x), 
                     sml::max(a.y, b.y),
                     sml::max(a.z, b.z)
                 };
@@ -662,6 +842,11 @@ namespace sml
 
         return *this;
     }
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class vec3<f32>)
+    SML_EXTERN_TEMPLATE(class vec3<f64>)
+    SML_EXTERN_TEMPLATE(class vec3<s32>)
+SML_NAMESPACE_END
 
 #endif // sml_vec3_h__
@@ -19,14 +19,12 @@
 */
 
 #include <string>
-#include <immintrin.h>
 
 #include "smltypes.h"
 #include "common.h"
 
 
-namespace sml
-{
+SML_NAMESPACE_BEGIN
     template<typename T>
     class vec4view;
 
@@ -121,7 +119,8 @@ namespace sml
 
             vec4& operator += (const vec4& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -131,8 +130,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -142,6 +143,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_add_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x += other.x;
                 y += other.y;
@@ -153,7 +168,8 @@ namespace sml
 
             vec4& operator -= (const vec4& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -163,8 +179,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -174,6 +192,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_sub_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x -= other.x;
                 y -= other.y;
@@ -185,7 +217,8 @@ namespace sml
 
             vec4& operator *= (const vec4& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -195,8 +228,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -206,6 +241,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_load_si128(reinterpret_cast<const __m128i*>(other.v));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other.x;
                 y *= other.y;
@@ -217,18 +266,21 @@ namespace sml
 
             vec4& operator *= (const T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 him = _mm_broadcast_ss(&other);
+                    __m128 him = _mm_set1_ps(other);
                     __m128 res = _mm_mul_ps(me, him);
 
                     _mm_store_ps(v, res);
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_set1_pd(other);
@@ -238,6 +290,20 @@ namespace sml
 
                     return *this;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr(simdi32<T>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+                    __m128i him = _mm_set1_epi32(static_cast<s32>(other));
+                    __m128i res = _mm_mullo_epi32(me, him);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(v), res);
+
+                    return *this;
+                }
+#endif
 
                 x *= other;
                 y *= other;
@@ -249,7 +315,8 @@ namespace sml
 
             vec4& operator /= (const vec4& other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 him = _mm_load_ps(other.v);
@@ -259,8 +326,10 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_load_pd(other.v);
@@ -270,6 +339,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other.x;
                 y /= other.y;
@@ -281,18 +351,21 @@ namespace sml
 
             vec4& operator /= (const T other) noexcept
             {
-                if constexpr(std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr(simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
-                    __m128 him = _mm_broadcast_ss(&other);
+                    __m128 him = _mm_set1_ps(other);
                     __m128 res = _mm_div_ps(me, him);
 
                     _mm_store_ps(v, res);
 
                     return *this;
                 }
+#endif
 
-                if constexpr(std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr(simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(v);
                     __m256d him = _mm256_set1_pd(other);
@@ -302,6 +375,7 @@ namespace sml
 
                     return *this;
                 }
+#endif
 
                 x /= other;
                 y /= other;
@@ -314,7 +388,8 @@ namespace sml
             // Operations
             SML_NO_DISCARD inline constexpr T dot(const vec4& other) const noexcept
             {
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(v);
                     __m128 ot = _mm_load_ps(other.v);
@@ -325,6 +400,7 @@ namespace sml
 
                     return *reinterpret_cast<f32*>(&(res));
                 }
+#endif
 
                 return (x * other.x) + (y * other.y) + (z * other.z) + (w * other.w);
             }
@@ -346,7 +422,41 @@ namespace sml
                 if(mag > constants::epsilon)
                     *this /= length();
                 else
-                    set(0);
+                    zero();
+            }
+
+            // Normalizes with the rsqrt estimate and one Newton-Raphson step instead of sqrt and divide.
+            // The relative error is below 2^-21 for f32, other types use a single exact 1 / sqrt.
+            // Like normalize(), vectors with a length at or below epsilon become zero.
+            inline void normalizeFast() noexcept
+            {
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
+                {
+                    __m128 me = _mm_load_ps(v);
+                    __m128 lsq = _mm_dp_ps(me, me, 0xff);
+                    __m128 valid = _mm_cmpgt_ps(lsq, _mm_set1_ps(constants::epsilon * constants::epsilon));
+
+                    _mm_store_ps(v, _mm_and_ps(_mm_mul_ps(me, detail::rsqrtnr(lsq)), valid));
+
+                    return;
+                }
+#endif
+
+                T lsq = lengthsquared();
+
+                if (lsq > static_cast<T>(constants::epsilon * constants::epsilon))
+                    *this *= static_cast<T>(1) / sml::sqrt(lsq);
+                else
+                    zero();
+            }
+
+            SML_NO_DISCARD inline vec4 normalizedFast() const noexcept
+            {
+                vec4 copy(*this);
+                copy.normalizeFast();
+
+                return copy;
             }
 
             SML_NO_DISCARD inline constexpr vec4 normalized() const noexcept
@@ -380,12 +490,17 @@ namespace sml
             // Statics
             SML_NO_DISCARD static inline constexpr vec4 normalize(const vec4& a) noexcept
             {
-                vec4 copy(a.v);
+                vec4 copy(a);
                 copy.normalize();
 
                 return copy;
             }
 
+            SML_NO_DISCARD static inline vec4 normalizeFast(const vec4& a) noexcept
+            {
+                return a.normalizedFast();
+            }
+
             SML_NO_DISCARD static inline constexpr T dot(const vec4& lhs, const vec4& rhs) noexcept
             {
                 return lhs.dot(rhs);
@@ -401,7 +516,8 @@ namespace sml
             {
                 vec4 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -412,8 +528,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -424,6 +542,35 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_min_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
@@ -438,7 +585,8 @@ namespace sml
             {
                 vec4 result;
 
-                if constexpr (std::is_same<T, f32>::value)
+#if SML_SSE
+                if constexpr (simdf32<T>::value)
                 {
                     __m128 me = _mm_load_ps(a.v);
                     __m128 ot = _mm_load_ps(b.v);
@@ -449,8 +597,10 @@ namespace sml
 
                     return result;
                 }
+#endif
 
-                if constexpr (std::is_same<T, f64>::value)
+#if SML_AVX
+                if constexpr (simdf64<T>::value)
                 {
                     __m256d me = _mm256_load_pd(a.v);
                     __m256d ot = _mm256_load_pd(b.v);
@@ -461,10 +611,39 @@ namespace sml
 
                     return result;
                 }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, s32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epi32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
+
+#if SML_SSE
+                if constexpr (std::is_same<T, u32>::value)
+                {
+                    __m128i me = _mm_load_si128(reinterpret_cast<const __m128i*>(a.v));
+                    __m128i ot = _mm_load_si128(reinterpret_cast<const __m128i*>(b.v));
+
+                    __m128i maxres = _mm_max_epu32(me, ot);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(result.v), maxres);
+
+                    return result;
+                }
+#endif
 
                 return 
                 {
-                    sml::max(a.x, b.y), 
+                    sml::max(a.x, b.x), 
                     sml::max(a.y, b.y),
                     sml::max(a.z, b.z),
                     sml::max(a.w, b.w)
@@ -648,6 +827,11 @@ namespace sml
 
         return *this;
     }
-} // namespace sml
+
+    // Instantiated once in the compiled library, see SML_EXTERN_TEMPLATES
+    SML_EXTERN_TEMPLATE(class vec4<f32>)
+    SML_EXTERN_TEMPLATE(class vec4<f64>)
+    SML_EXTERN_TEMPLATE(class vec4<s32>)
+SML_NAMESPACE_END
 
 #endif // sml_vec4_h__
\ No newline at end of file
@@ -0,0 +1,440 @@
+#ifndef sml_vecarray_h__
+#define sml_vecarray_h__
+
+/* vecarray.h -- bulk vector array kernels of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstddef>
+
+#include "smltypes.h"
+#include "common.h"
+#include "divider.h"
+
+// vec2, vec3 and vec4 all store four lanes, so an array of N vectors is 4 * N contiguous
+// values. The kernels below work on those lanes directly and handle two f32 / s32 / u32
+// vectors (or one f64 vector) per AVX register. The output may alias either input.
+
+SML_NAMESPACE_BEGIN
+    namespace detail
+    {
+        enum class arrayop
+        {
+            add,
+            sub,
+            mul,
+            min,
+            max
+        };
+
+        template<arrayop Op, typename T>
+        static inline T arrayapply(T a, T b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return a + b;
+            if constexpr (Op == arrayop::sub)
+                return a - b;
+            if constexpr (Op == arrayop::mul)
+                return a * b;
+            if constexpr (Op == arrayop::min)
+                return sml::min(a, b);
+            if constexpr (Op == arrayop::max)
+                return sml::max(a, b);
+        }
+
+#if SML_SSE
+        template<arrayop Op>
+        static inline __m128 arrayapply(__m128 a, __m128 b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return _mm_add_ps(a, b);
+            if constexpr (Op == arrayop::sub)
+                return _mm_sub_ps(a, b);
+            if constexpr (Op == arrayop::mul)
+                return _mm_mul_ps(a, b);
+            if constexpr (Op == arrayop::min)
+                return _mm_min_ps(a, b);
+            if constexpr (Op == arrayop::max)
+                return _mm_max_ps(a, b);
+        }
+#endif
+
+#if SML_AVX
+        template<arrayop Op>
+        static inline __m256 arrayapply(__m256 a, __m256 b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return _mm256_add_ps(a, b);
+            if constexpr (Op == arrayop::sub)
+                return _mm256_sub_ps(a, b);
+            if constexpr (Op == arrayop::mul)
+                return _mm256_mul_ps(a, b);
+            if constexpr (Op == arrayop::min)
+                return _mm256_min_ps(a, b);
+            if constexpr (Op == arrayop::max)
+                return _mm256_max_ps(a, b);
+        }
+
+        template<arrayop Op>
+        static inline __m256d arrayapply(__m256d a, __m256d b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return _mm256_add_pd(a, b);
+            if constexpr (Op == arrayop::sub)
+                return _mm256_sub_pd(a, b);
+            if constexpr (Op == arrayop::mul)
+                return _mm256_mul_pd(a, b);
+            if constexpr (Op == arrayop::min)
+                return _mm256_min_pd(a, b);
+            if constexpr (Op == arrayop::max)
+                return _mm256_max_pd(a, b);
+        }
+#endif
+
+#if SML_SSE
+        template<arrayop Op, typename T>
+        static inline __m128i arrayapplyint(__m128i a, __m128i b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return _mm_add_epi32(a, b);
+            if constexpr (Op == arrayop::sub)
+                return _mm_sub_epi32(a, b);
+            if constexpr (Op == arrayop::mul)
+                return _mm_mullo_epi32(a, b);
+            if constexpr (Op == arrayop::min)
+                return std::is_same<T, s32>::value ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b);
+            if constexpr (Op == arrayop::max)
+                return std::is_same<T, s32>::value ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b);
+        }
+#endif
+
+#if SML_AVX2
+        template<arrayop Op, typename T>
+        static inline __m256i arrayapplyint(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (Op == arrayop::add)
+                return _mm256_add_epi32(a, b);
+            if constexpr (Op == arrayop::sub)
+                return _mm256_sub_epi32(a, b);
+            if constexpr (Op == arrayop::mul)
+                return _mm256_mullo_epi32(a, b);
+            if constexpr (Op == arrayop::min)
+                return std::is_same<T, s32>::value ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+            if constexpr (Op == arrayop::max)
+                return std::is_same<T, s32>::value ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+        }
+#endif
+
+        // Applies Op over 'lanes' values (always a multiple of four). With Broadcast set, b points
+        // to a single scalar that is used for every lane.
+        template<arrayop Op, bool Broadcast, typename T>
+        static inline void arraykernel(const T* a, const T* b, T* out, size_t lanes) noexcept
+        {
+            size_t i = 0;
+
+#if SML_SSE
+            if constexpr (simdf32<T>::value)
+            {
+#if SML_AVX
+                __m256 wide = Broadcast ? _mm256_broadcast_ss(b) : _mm256_setzero_ps();
+
+                for (; i + 8 <= lanes; i += 8)
+                {
+                    __m256 rhs = Broadcast ? wide : _mm256_loadu_ps(b + i);
+                    _mm256_storeu_ps(out + i, arrayapply<Op>(_mm256_loadu_ps(a + i), rhs));
+                }
+#endif
+
+                for (; i < lanes; i += 4)
+                {
+                    __m128 rhs = Broadcast ? _mm_set1_ps(*b) : _mm_loadu_ps(b + i);
+                    _mm_storeu_ps(out + i, arrayapply<Op>(_mm_loadu_ps(a + i), rhs));
+                }
+
+                return;
+            }
+#endif
+
+#if SML_AVX
+            if constexpr (simdf64<T>::value)
+            {
+                __m256d wide = Broadcast ? _mm256_set1_pd(*b) : _mm256_setzero_pd();
+
+                for (; i < lanes; i += 4)
+                {
+                    __m256d rhs = Broadcast ? wide : _mm256_loadu_pd(b + i);
+                    _mm256_storeu_pd(out + i, arrayapply<Op>(_mm256_loadu_pd(a + i), rhs));
+                }
+
+                return;
+            }
+#endif
+
+#if SML_SSE
+            if constexpr (simdi32<T>::value)
+            {
+#if SML_AVX2
+                __m256i wide = Broadcast ? _mm256_set1_epi32(static_cast<s32>(*b)) : _mm256_setzero_si256();
+
+                for (; i + 8 <= lanes; i += 8)
+                {
+                    __m256i rhs = Broadcast ? wide : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                    __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), arrayapplyint<Op, T>(lhs, rhs));
+                }
+#endif
+                __m128i narrow = Broadcast ? _mm_set1_epi32(static_cast<s32>(*b)) : _mm_setzero_si128();
+
+                for (; i < lanes; i += 4)
+                {
+                    __m128i rhs = Broadcast ? narrow : _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                    __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), arrayapplyint<Op, T>(lhs, rhs));
+                }
+
+                return;
+            }
+#endif
+
+            for (; i < lanes; i++)
+            {
+                out[i] = arrayapply<Op>(a[i], Broadcast ? *b : b[i]);
+            }
+        }
+
+        // Normalizes count four lane vectors in place. The squared length is summed across each
+        // vector's lanes with in-lane permutes, so vec2 / vec3 rely on their padding lanes being zero.
+        template<bool Fast, typename T>
+        static inline void normalizekernel(T* p, size_t count) noexcept
+        {
+            size_t i = 0;
+
+#if SML_SSE
+            if constexpr (simdf32<T>::value)
+            {
+                const f32 eps = constants::epsilon * constants::epsilon;
+
+#if SML_AVX512
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m512 v = _mm512_loadu_ps(p + 4 * i);
+                    __m512 lsq = _mm512_mul_ps(v, v);
+                    lsq = _mm512_add_ps(lsq, _mm512_permute_ps(lsq, 0xB1));
+                    lsq = _mm512_add_ps(lsq, _mm512_permute_ps(lsq, 0x4E));
+
+                    __mmask16 valid = _mm512_cmp_ps_mask(lsq, _mm512_set1_ps(eps), _CMP_GT_OQ);
+                    __m512 res = Fast ? _mm512_maskz_mul_ps(valid, v, rsqrtnr(lsq)) : _mm512_maskz_div_ps(valid, v, _mm512_sqrt_ps(lsq));
+
+                    _mm512_storeu_ps(p + 4 * i, res);
+                }
+#endif
+
+#if SML_AVX
+                for (; i + 2 <= count; i += 2)
+                {
+                    __m256 v = _mm256_loadu_ps(p + 4 * i);
+                    __m256 lsq = _mm256_mul_ps(v, v);
+                    lsq = _mm256_add_ps(lsq, _mm256_permute_ps(lsq, 0xB1));
+                    lsq = _mm256_add_ps(lsq, _mm256_permute_ps(lsq, 0x4E));
+
+                    __m256 valid = _mm256_cmp_ps(lsq, _mm256_set1_ps(eps), _CMP_GT_OQ);
+                    __m256 res = Fast ? _mm256_mul_ps(v, rsqrtnr(lsq)) : _mm256_div_ps(v, _mm256_sqrt_ps(lsq));
+
+                    _mm256_storeu_ps(p + 4 * i, _mm256_and_ps(res, valid));
+                }
+#endif
+
+                for (; i < count; i++)
+                {
+                    __m128 v = _mm_loadu_ps(p + 4 * i);
+                    __m128 lsq = _mm_dp_ps(v, v, 0xff);
+
+                    __m128 valid = _mm_cmpgt_ps(lsq, _mm_set1_ps(eps));
+                    __m128 res = Fast ? _mm_mul_ps(v, rsqrtnr(lsq)) : _mm_div_ps(v, _mm_sqrt_ps(lsq));
+
+                    _mm_storeu_ps(p + 4 * i, _mm_and_ps(res, valid));
+                }
+
+                return;
+            }
+#endif
+
+#if SML_AVX
+            if constexpr (simdf64<T>::value)
+            {
+                const f64 eps = static_cast<f64>(constants::epsilon) * static_cast<f64>(constants::epsilon);
+
+#if SML_AVX512
+                for (; i + 2 <= count; i += 2)
+                {
+                    __m512d v = _mm512_loadu_pd(p + 4 * i);
+                    __m512d lsq = _mm512_mul_pd(v, v);
+                    lsq = _mm512_add_pd(lsq, _mm512_permute_pd(lsq, 0x55));
+                    lsq = _mm512_add_pd(lsq, _mm512_shuffle_f64x2(lsq, lsq, _MM_SHUFFLE(2, 3, 0, 1)));
+
+                    __mmask8 valid = _mm512_cmp_pd_mask(lsq, _mm512_set1_pd(eps), _CMP_GT_OQ);
+                    __m512d res = Fast ? _mm512_maskz_mul_pd(valid, v, rsqrtnr(lsq)) : _mm512_maskz_div_pd(valid, v, _mm512_sqrt_pd(lsq));
+
+                    _mm512_storeu_pd(p + 4 * i, res);
+                }
+#endif
+
+                // There is no double precision rsqrt before AVX-512, both variants divide by the sqrt
+                for (; i < count; i++)
+                {
+                    __m256d v = _mm256_loadu_pd(p + 4 * i);
+                    __m256d lsq = _mm256_mul_pd(v, v);
+                    lsq = _mm256_add_pd(lsq, _mm256_permute_pd(lsq, 0x5));
+                    lsq = _mm256_add_pd(lsq, _mm256_permute2f128_pd(lsq, lsq, 0x1));
+
+                    __m256d valid = _mm256_cmp_pd(lsq, _mm256_set1_pd(eps), _CMP_GT_OQ);
+                    __m256d res = _mm256_div_pd(v, _mm256_sqrt_pd(lsq));
+
+                    _mm256_storeu_pd(p + 4 * i, _mm256_and_pd(res, valid));
+                }
+
+                return;
+            }
+#endif
+        }
+
+        template<template<typename> class V, typename T>
+        static inline constexpr size_t arraylanes(size_t count) noexcept
+        {
+            static_assert(sizeof(V<T>) == 4 * sizeof(T), "array kernels require a four lane vector type");
+
+            return count * 4;
+        }
+    } // namespace detail
+
+    // Bulk operators, out[i] = a[i] op b[i]
+    template<template<typename> class V, typename T>
+    inline void add(const V<T>* a, const V<T>* b, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::add, false>(a->v, b->v, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    template<template<typename> class V, typename T>
+    inline void sub(const V<T>* a, const V<T>* b, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::sub, false>(a->v, b->v, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    template<template<typename> class V, typename T>
+    inline void mul(const V<T>* a, const V<T>* b, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::mul, false>(a->v, b->v, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    template<template<typename> class V, typename T>
+    inline void min(const V<T>* a, const V<T>* b, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::min, false>(a->v, b->v, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    template<template<typename> class V, typename T>
+    inline void max(const V<T>* a, const V<T>* b, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::max, false>(a->v, b->v, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    // out[i] = a[i] * scalar
+    template<template<typename> class V, typename T>
+    inline void scale(const V<T>* a, T scalar, V<T>* out, size_t count) noexcept
+    {
+        detail::arraykernel<detail::arrayop::mul, true>(a->v, &scalar, out->v, detail::arraylanes<V, T>(count));
+    }
+
+    // Normalizes every vector in place with sqrt and divide, see vec3::normalize
+    template<template<typename> class V, typename T>
+    inline void normalize(V<T>* values, size_t count) noexcept
+    {
+        static_assert(sizeof(V<T>) == 4 * sizeof(T), "array kernels require a four lane vector type");
+
+#if SML_SSE
+        if constexpr (simdf32<T>::value || simdf64<T>::value)
+        {
+            detail::normalizekernel<false>(values->v, count);
+
+            return;
+        }
+#endif
+
+        for (size_t i = 0; i < count; i++)
+        {
+            values[i].normalize();
+        }
+    }
+
+    // Normalizes every vector in place using rsqrt plus one Newton-Raphson step (rsqrt14 with AVX-512),
+    // with a relative error below 2^-21 for f32. f64 uses rsqrt14 plus two steps with AVX-512 and the
+    // exact path otherwise. Vectors with a length at or below epsilon become zero.
+    template<template<typename> class V, typename T>
+    inline void normalizeFast(V<T>* values, size_t count) noexcept
+    {
+        static_assert(sizeof(V<T>) == 4 * sizeof(T), "array kernels require a four lane vector type");
+
+#if SML_SSE
+        if constexpr (simdf32<T>::value || simdf64<T>::value)
+        {
+            detail::normalizekernel<true>(values->v, count);
+
+            return;
+        }
+#endif
+
+        for (size_t i = 0; i < count; i++)
+        {
+            values[i].normalizeFast();
+        }
+    }
+
+    // out[i] = a[i] / divider, for s32 and u32 vectors
+    template<template<typename> class V, typename T>
+    inline void divide(const V<T>* a, const intdivider<T>& divider, V<T>* out, size_t count) noexcept
+    {
+        const T* in = a->v;
+        T* res = out->v;
+
+        size_t lanes = detail::arraylanes<V, T>(count);
+        size_t i = 0;
+
+#if SML_AVX2
+        for (; i + 8 <= lanes; i += 8)
+        {
+            __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(res + i), divider.divide(n));
+        }
+#endif
+
+#if SML_SSE
+        for (; i < lanes; i += 4)
+        {
+            __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(res + i), divider.divide(n));
+        }
+#endif
+
+        for (; i < lanes; i++)
+        {
+            res[i] = divider.divide(in[i]);
+        }
+    }
+SML_NAMESPACE_END
+
+#endif // sml_vecarray_h__
@@ -0,0 +1,243 @@
+/* sml.cppm -- C++20 module interface of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+// Optional 'import sml;' interface over the headers. Build it as a module interface unit with the
+// same backend defines and instruction set flags as the code importing it.
+module;
+
+#include "sml.h"
+
+export module sml;
+
+export namespace constants
+{
+    using constants::pi;
+    using constants::two_pi;
+    using constants::half_pi;
+    using constants::maxflt;
+    using constants::epsilon;
+    using constants::infinity;
+    using constants::negativeinfinity;
+    using constants::deg2rad;
+    using constants::rad2deg;
+}
+
+export namespace sml
+{
+    // Configuration
+    using sml::smlVersion;
+    using sml::version;
+    using sml::backend;
+    using sml::backendname;
+    using sml::simdalign;
+
+    // Types
+    using sml::vec2;
+    using sml::vec3;
+    using sml::vec4;
+    using sml::vec2view;
+    using sml::vec3view;
+    using sml::vec4view;
+    using sml::mat2;
+    using sml::mat3;
+    using sml::mat4;
+    using sml::quat;
+    using sml::dualquat;
+    using sml::trsarray;
+    using sml::skinstreams;
+    using sml::noisestreams;
+    using sml::noisetype;
+    using sml::fbmparams;
+    using sml::rng;
+    using sml::spatialhash;
+    using sml::kdtree;
+    using sml::hullsupport;
+    using sml::spheresupport;
+    using sml::boxsupport;
+    using sml::capsulesupport;
+    using sml::transformedsupport;
+    using sml::gjkvertex;
+    using sml::gjksimplex;
+    using sml::gjkresult;
+    using sml::penetration;
+    using sml::plane;
+    using sml::ray;
+    using sml::line;
+    using sml::segment;
+    using sml::triangle;
+    using sml::capsule;
+    using sml::cubiccurve;
+    using sml::intdivider;
+    using sml::vecmask;
+
+    using sml::bvec2;
+    using sml::uvec2;
+    using sml::ivec2;
+    using sml::fvec2;
+    using sml::dvec2;
+    using sml::bvec3;
+    using sml::uvec3;
+    using sml::ivec3;
+    using sml::fvec3;
+    using sml::dvec3;
+    using sml::bvec4;
+    using sml::uvec4;
+    using sml::ivec4;
+    using sml::fvec4;
+    using sml::dvec4;
+    using sml::fmat2;
+    using sml::dmat2;
+    using sml::fmat3;
+    using sml::dmat3;
+    using sml::fmat4;
+    using sml::dmat4;
+    using sml::fquat;
+    using sml::dquat;
+    using sml::fdualquat;
+    using sml::ddualquat;
+    using sml::fplane;
+    using sml::dplane;
+    using sml::fray;
+    using sml::dray;
+    using sml::fline;
+    using sml::dline;
+    using sml::fsegment;
+    using sml::dsegment;
+    using sml::ftriangle;
+    using sml::dtriangle;
+    using sml::fcapsule;
+    using sml::dcapsule;
+    using sml::fcurve2;
+    using sml::dcurve2;
+    using sml::fcurve3;
+    using sml::dcurve3;
+    using sml::fcurve4;
+    using sml::dcurve4;
+    using sml::idivider;
+    using sml::udivider;
+
+    // Scalar functions
+    using sml::sin;
+    using sml::cos;
+    using sml::tan;
+    using sml::asin;
+    using sml::acos;
+    using sml::atan;
+    using sml::atan2;
+    using sml::sqrt;
+    using sml::abs;
+    using sml::min;
+    using sml::max;
+    using sml::pow;
+    using sml::exp;
+    using sml::log;
+    using sml::log10;
+    using sml::ceil;
+    using sml::floor;
+    using sml::round;
+    using sml::sign;
+    using sml::clamp;
+    using sml::clamp01;
+    using sml::lerp;
+    using sml::lerpclamped;
+    using sml::radtodeg;
+    using sml::degtorad;
+    using sml::normalizeAngle;
+
+    // Operators
+    using sml::operator+;
+    using sml::operator-;
+    using sml::operator*;
+    using sml::operator/;
+    using sml::operator&;
+    using sml::operator|;
+    using sml::operator^;
+    using sml::operator~;
+
+    // Array kernels
+    using sml::add;
+    using sml::sub;
+    using sml::mul;
+    using sml::scale;
+    using sml::normalize;
+    using sml::normalizeFast;
+    using sml::divide;
+    using sml::sum;
+    using sml::minimum;
+    using sml::maximum;
+    using sml::bounds;
+    using sml::centroid;
+    using sml::variance;
+    using sml::argmaxlength;
+    using sml::maxlength;
+    using sml::compose;
+    using sml::decompose;
+    using sml::skinlinear;
+    using sml::skinlinearaffine;
+    using sml::skindualquat;
+    // Noise
+    using sml::perlin;
+    using sml::simplex;
+    using sml::valuenoise;
+    using sml::worley;
+    using sml::fbm;
+    // Random
+    using sml::uniform;
+    using sml::inbox;
+    using sml::insphere;
+    using sml::onsphere;
+    using sml::indisc;
+    using sml::hemisphere;
+    using sml::rotation;
+    // Closest points
+    using sml::closestpointsegment;
+    using sml::closestpointtriangle;
+    using sml::closestpointaabb;
+    using sml::closestpointssegments;
+    using sml::distancesquaredsegment;
+    using sml::distancesegment;
+    using sml::distancesquaredtriangle;
+    using sml::distancetriangle;
+    using sml::distancesquaredaabb;
+    using sml::distanceaabb;
+    using sml::distancesquaredsegments;
+    using sml::distancesegments;
+    using sml::closesttriangle;
+    using sml::closestsegment;
+    // Convex collision
+    using sml::maxdot;
+    using sml::gjk;
+    using sml::gjkintersect;
+    using sml::epa;
+    // Primitives
+    using sml::signeddistance;
+    using sml::classify;
+    // Curves
+    using sml::evaluate;
+
+    // Masks
+    using sml::lessThan;
+    using sml::lessEqual;
+    using sml::greaterThan;
+    using sml::greaterEqual;
+    using sml::equal;
+    using sml::notEqual;
+    using sml::select;
+    using sml::findall;
+    using sml::findany;
+    using sml::findinside;
+}
@@ -0,0 +1,67 @@
+/* Instantiate.cpp -- explicit instantiations of the 'Simple Math Library'
+  Copyright (C) 2020 Roderick Griffioen
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+// Every class the headers declare with SML_EXTERN_TEMPLATE is instantiated here, so translation
+// units that define SML_EXTERN_TEMPLATES don't instantiate them again. Keep both lists in sync.
+#include <sml.h>
+
+SML_NAMESPACE_BEGIN
+    template class vec2<f32>;
+    template class vec2<f64>;
+    template class vec2<s32>;
+
+    template class vec3<f32>;
+    template class vec3<f64>;
+    template class vec3<s32>;
+
+    template class vec4<f32>;
+    template class vec4<f64>;
+    template class vec4<s32>;
+
+    template class mat2<f32>;
+    template class mat2<f64>;
+
+    template class mat3<f32>;
+    template class mat3<f64>;
+
+    template class mat4<f32>;
+    template class mat4<f64>;
+
+    template class quat<f32>;
+    template class quat<f64>;
+
+    template class dualquat<f32>;
+    template class dualquat<f64>;
+
+    template class plane<f32>;
+    template class plane<f64>;
+
+    template class ray<f32>;
+    template class ray<f64>;
+
+    template class line<f32>;
+    template class line<f64>;
+
+    template class segment<f32>;
+    template class segment<f64>;
+
+    template class triangle<f32>;
+    template class triangle<f64>;
+
+    template class capsule<f32>;
+    template class capsule<f64>;
+SML_NAMESPACE_END
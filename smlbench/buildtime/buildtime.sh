@@ -0,0 +1,150 @@
+#!/bin/sh
+# Build time of a project with many translation units that use sml: header only, against the
+# explicit instantiations of the compiled library (SML_EXTERN_TEMPLATES) and, when the compiler
+# supports it, through 'import sml;'.
+#
+# Usage: smlbench/buildtime/buildtime.sh [translation units] [compiler flags]
+#   CXX        compiler, c++ by default
+#   MODULEFLAGS flags that enable modules, -fmodules-ts by default (empty skips the module build)
+
+set -e
+
+units=${1:-32}
+flags=${2:-"-O0 -mavx"}
+cxx=${CXX:-c++}
+moduleflags=${MODULEFLAGS-"-fmodules-ts"}
+
+root=$(cd "$(dirname "$0")/../.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+now()
+{
+    date +%s%N
+}
+
+# Every translation unit uses most of the f32 and f64 classes, like the gameplay and tools code
+# this is meant to model
+unit()
+{
+    cat <<UNIT
+$1
+
+namespace unit$2
+{
+    template<typename T>
+    T work(T a)
+    {
+        using namespace sml;
+
+        vec2<T> v2(a, a + 1);
+        vec3<T> v3(a, a + 1, a + 2);
+        vec4<T> v4(a, a + 1, a + 2, a + 3);
+        v2 = v2.normalized() * a + vec2<T>(1, 2);
+        v3 = vec3<T>::cross(v3.normalized(), vec3<T>(0, 1, 0)) + v3 / a;
+        v4 = vec4<T>::lerp(v4, v4.normalized(), a) - v4;
+
+        mat2<T> m2(a, 1, 2, a);
+        mat3<T> m3(a, 1, 0, 0, a, 1, 1, 0, a);
+        mat4<T> m4 = mat4<T>::compose(v3, quat<T>::euler(a, a, a), vec3<T>(1, 2, 3));
+        m2 = m2.inverted() * m2.transposed();
+        m3 = m3.inverted() * m3.transposed();
+        m4 = m4.inverted() * m4.transposed();
+
+        quat<T> q = quat<T>::slerp(quat<T>::frommatrix4(m4), quat<T>::identity(), a).normalized();
+        dualquat<T> d = dualquat<T>(q, v3) * dualquat<T>(q.conjugate(), v3);
+
+        vec3<T> t, s;
+        quat<T> r;
+        m4.decompose(t, r, s);
+
+        return v2.length() + v3.length() + v4.dot(v4) + m2.determinant() + m3.determinant() + m4.determinant()
+             + d.transformPoint(t).length() + (m3 * s).length() + (m4 * v4).length() + r.w;
+    }
+}
+
+double run$2(double a)
+{
+    return unit$2::work<float>(static_cast<float>(a)) + unit$2::work<double>(a) + (sml::ivec4(1, 2, 3, 4) + sml::ivec4(2, 2, 2, 2)).x + sml::ivec3(1, 2, 3).x;
+}
+UNIT
+}
+
+generate()
+{
+    mkdir -p "$work/$1"
+    i=0
+    while [ $i -lt "$units" ]; do
+        unit "$2" $i > "$work/$1/unit$i.cpp"
+        i=$((i + 1))
+    done
+}
+
+# Seconds to compile every unit of a variant, one after the other so the result doesn't depend
+# on the core count
+build()
+{
+    start=$(now)
+    for f in "$work/$1"/unit*.cpp; do
+        $cxx -std=$2 $flags $3 -I"$root/sml/include" -c "$f" -o "$f.o"
+    done
+    end=$(now)
+    echo "$(( (end - start) / 1000000 ))"
+}
+
+report()
+{
+    printf "%-28s %8s ms %8s ms/unit\n" "$1" "$2" "$(( $2 / units ))"
+}
+
+# Links the units of a variant into a program, which also checks that every symbol the extern
+# declarations leave out is in the library
+link()
+{
+    {
+        i=0
+        while [ $i -lt "$units" ]; do
+            echo "double run$i(double a);"
+            i=$((i + 1))
+        done
+        echo "int main() { double r = 0.0;"
+        i=0
+        while [ $i -lt "$units" ]; do
+            echo "r += run$i(0.5);"
+            i=$((i + 1))
+        done
+        echo "return r != r; }"
+    } > "$work/$1/main.cpp"
+
+    $cxx -std=c++17 -c "$work/$1/main.cpp" -o "$work/$1/main.o"
+    $cxx "$work/$1"/*.o $2 -o "$work/$1/program"
+    "$work/$1/program" > /dev/null
+}
+
+echo "$units translation units, $cxx $flags"
+
+generate header "#include <sml.h>"
+report "header only" "$(build header c++17 "")"
+link header
+
+start=$(now)
+$cxx -std=c++17 $flags -I"$root/sml/include" -c "$root/sml/src/Instantiate.cpp" -o "$work/Instantiate.o"
+end=$(now)
+generate extern "#include <sml.h>"
+report "SML_EXTERN_TEMPLATES" "$(build extern c++17 -DSML_EXTERN_TEMPLATES)"
+link extern "$work/Instantiate.o"
+printf "%-28s %8s ms\n" "  + sml library, once" "$(( (end - start) / 1000000 ))"
+
+if [ -n "$moduleflags" ]; then
+    cd "$work"
+    if $cxx -std=c++20 $moduleflags $flags -I"$root/sml/include" -c -x c++ "$root/sml/module/sml.cppm" -o "$work/sml.o" 2>/dev/null; then
+        generate module "import sml;"
+        if ms=$(build module c++20 "$moduleflags" 2>/dev/null); then
+            report "import sml" "$ms"
+        else
+            echo "import sml: the compiler can't import the module interface"
+        fi
+    else
+        echo "import sml: the compiler can't build the module interface"
+    fi
+fi
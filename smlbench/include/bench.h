@@ -0,0 +1,93 @@
+#ifndef sml_bench_h__
+#define sml_bench_h__
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Minimal benchmark harness for SMLBench. Benchmarks register themselves with SML_BENCH and
+// report the best time per item over a number of repeats.
+
+namespace bench
+{
+	typedef void (*benchfn)();
+
+	struct entry
+	{
+		const char* group;
+		const char* name;
+		benchfn fn;
+	};
+
+	inline std::vector<entry>& registry()
+	{
+		static std::vector<entry> entries;
+		return entries;
+	}
+
+	struct registrar
+	{
+		registrar(const char* group, const char* name, benchfn fn)
+		{
+			registry().push_back({ group, name, fn });
+		}
+	};
+
+	// Keeps the compiler from discarding results that are otherwise unused, the empty asm makes
+	// the compiler assume the memory behind p is read
+	inline void keep(const void* p)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(p) : "memory");
+#else
+		static const void* volatile sink;
+		sink = p;
+		p = sink;
+#endif
+	}
+
+	// Runs fn 'repeats' times and prints the best time per item in nanoseconds
+	template<typename F>
+	inline double measure(const char* label, size_t items, F&& fn, int repeats = 10)
+	{
+		fn();
+
+		double best = 1e300;
+		for (int i = 0; i < repeats; i++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			fn();
+			auto end = std::chrono::high_resolution_clock::now();
+
+			double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			best = ns < best ? ns : best;
+		}
+
+		double perItem = best / static_cast<double>(items);
+		std::printf("  %-48s %10.3f ns/item\n", label, perItem);
+
+		return perItem;
+	}
+
+	inline int runall(const char* filter)
+	{
+		for (const entry& e : registry())
+		{
+			if (filter && !std::strstr(e.group, filter) && !std::strstr(e.name, filter))
+				continue;
+
+			std::printf("[%s] %s\n", e.group, e.name);
+			e.fn();
+		}
+
+		return 0;
+	}
+} // namespace bench
+
+#define SML_BENCH(group, name) \
+	static void group##_##name(); \
+	static bench::registrar group##_##name##_registrar(#group, #name, group##_##name); \
+	static void group##_##name()
+
+#endif // sml_bench_h__
@@ -0,0 +1,96 @@
+#include <arclength.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(arclength, lookup)
+{
+	const size_t count = 1 << 12;
+	const size_t segments = 8;
+
+	std::vector<fvec3> points(segments + 3);
+
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		points[i] = fvec3(static_cast<f32>(i), static_cast<f32>(i % 3), static_cast<f32>((i * 7) % 5));
+	}
+
+	std::vector<fcurve3> curves(segments);
+
+	for (size_t i = 0; i < segments; i++)
+	{
+		curves[i] = fcurve3::catmullrom(points[i], points[i + 1], points[i + 2], points[i + 3]);
+	}
+
+	farclength3 table(curves.data(), segments);
+	std::vector<f32> distances(count), t(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		distances[i] = table.length() * static_cast<f32>((i * 2654435761u) % count) / static_cast<f32>(count);
+	}
+
+	// What the table replaces, walking a polyline of the spline until the distance is reached
+	const size_t polyline = 64;
+	std::vector<fvec3> samples(segments * polyline + 1);
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		size_t segment = std::min(i / polyline, segments - 1);
+		samples[i] = curves[segment].evaluate(static_cast<f32>(i - segment * polyline) / polyline);
+	}
+
+	bench::measure("vec3::distance walk per agent", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 walked = 0.0f;
+			size_t j = 1;
+
+			for (; j < samples.size(); j++)
+			{
+				f32 step = fvec3::distance(samples[j - 1], samples[j]);
+
+				if (walked + step >= distances[i])
+					break;
+
+				walked += step;
+			}
+
+			t[i] = static_cast<f32>(j - 1) / polyline;
+		}
+
+		bench::keep(t.data());
+	});
+
+	bench::measure("farclength3::distanceToT per agent", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			t[i] = table.distanceToT(distances[i]);
+		}
+
+		bench::keep(t.data());
+	});
+
+	bench::measure("farclength3::distanceToT(distances, count, t)", count, [&]()
+	{
+		table.distanceToT(distances.data(), count, t.data());
+		bench::keep(t.data());
+	});
+
+	bench::measure("farclength3::tToDistance(t, count, distances)", count, [&]()
+	{
+		table.tToDistance(t.data(), count, distances.data());
+		bench::keep(distances.data());
+	});
+
+	bench::measure("farclength3::build(curves, 8)", segments, [&]()
+	{
+		table.build(curves.data(), segments);
+		bench::keep(&table);
+	});
+}
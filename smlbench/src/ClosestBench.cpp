@@ -0,0 +1,48 @@
+#include <closest.h>
+#include <random.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(closest, triangles)
+{
+	const size_t count = 1 << 12;
+
+	std::vector<fvec3> vertices(count * 3);
+	rng r(3);
+	inbox(r, fvec3(-10, -10, -10), fvec3(10, 10, 10), vertices.data(), vertices.size());
+
+	fvec3 p(0.5f, -1.0f, 2.0f);
+	size_t best = 0;
+
+	bench::measure("sml::distancesquaredtriangle per triangle", count, [&]()
+	{
+		f32 bestdistsq = 1e30f;
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 d = distancesquaredtriangle(p, vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+			if (d < bestdistsq)
+			{
+				bestdistsq = d;
+				best = i;
+			}
+		}
+
+		bench::keep(&best);
+	});
+
+	bench::measure("sml::closesttriangle(p, vertices, count)", count, [&]()
+	{
+		best = closesttriangle(p, vertices.data(), static_cast<const u32*>(nullptr), count);
+		bench::keep(&best);
+	});
+
+	bench::measure("sml::closestsegment(p, endpoints, count)", count, [&]()
+	{
+		best = closestsegment(p, vertices.data(), count);
+		bench::keep(&best);
+	});
+}
@@ -0,0 +1,71 @@
+#include <curve.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(curve, evaluate)
+{
+	const size_t count = 1 << 12;
+
+	fvec3 p0(0, 0, 0), p1(1, 2, 0), p2(3, 2, 1), p3(4, 0, -1);
+	fcurve3 curve = fcurve3::bezier(p0, p1, p2, p3);
+
+	std::vector<f32> parameters(count);
+	std::vector<fvec3> points(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		parameters[i] = static_cast<f32>(i) / static_cast<f32>(count - 1);
+	}
+
+	bench::measure("vec3::lerp chain per point", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 t = parameters[i];
+			fvec3 a = fvec3::lerp(p0, p1, t), b = fvec3::lerp(p1, p2, t), c = fvec3::lerp(p2, p3, t);
+			fvec3 d = fvec3::lerp(a, b, t), e = fvec3::lerp(b, c, t);
+			points[i] = fvec3::lerp(d, e, t);
+		}
+
+		bench::keep(points.data());
+	});
+
+	bench::measure("fcurve3::evaluate per point", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			points[i] = curve.evaluate(parameters[i]);
+		}
+
+		bench::keep(points.data());
+	});
+
+	bench::measure("fcurve3::evaluate(t, count, out)", count, [&]()
+	{
+		curve.evaluate(parameters.data(), count, points.data());
+		bench::keep(points.data());
+	});
+
+	bench::measure("fcurve3::tessellate(count, out)", count, [&]()
+	{
+		curve.tessellate(count, points.data());
+		bench::keep(points.data());
+	});
+
+	std::vector<fcurve3> curves(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		curves[i] = fcurve3::catmullrom(p0 * static_cast<f32>(i), p1, p2, p3);
+	}
+
+	bench::measure("sml::evaluate(curves, t, count, out)", count, [&]()
+	{
+		evaluate(curves.data(), parameters.data(), count, points.data());
+		bench::keep(points.data());
+	});
+}
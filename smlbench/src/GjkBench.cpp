@@ -0,0 +1,104 @@
+#include <gjk.h>
+#include <random.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(gjk, pairs)
+{
+	const size_t frames = 1 << 10;
+
+	rng r(5);
+	std::vector<fvec3> points(256);
+	onsphere(r, points.data(), points.size());
+
+	hullsupport<f32> hull{ points.data(), points.size() };
+	hullsupport<f32> small{ points.data(), 32 };
+
+	typedef transformedsupport<hullsupport<f32>, f32> movinghull;
+	typedef transformedsupport<boxsupport<f32>, f32> movingbox;
+	typedef transformedsupport<capsulesupport<f32>, f32> movingcapsule;
+
+	// Every frame moves the second shape a little along a path that passes through the first
+	std::vector<fvec3> path(frames);
+	std::vector<fquat> spin(frames);
+	for (size_t i = 0; i < frames; i++)
+	{
+		f32 t = static_cast<f32>(i) / frames;
+		path[i] = fvec3(-3.0f + 6.0f * t, 0.3f, 0.2f);
+		spin[i] = fquat::axisangle(fvec3(0, 1, 0), t * 3.0f);
+	}
+
+	fvec3 d(0.3f, -0.8f, 0.5f);
+	size_t index = 0;
+
+	bench::measure("sml::maxdot 256 vertices", 1, [&]()
+	{
+		index = maxdot(points.data(), points.size(), d);
+		bench::keep(&index);
+	});
+
+	bench::measure("scalar max dot 256 vertices", 1, [&]()
+	{
+		f32 best = points[0].dot(d);
+		index = 0;
+		for (size_t i = 1; i < points.size(); i++)
+		{
+			f32 dot = points[i].dot(d);
+			if (dot > best)
+			{
+				best = dot;
+				index = i;
+			}
+		}
+
+		bench::keep(&index);
+	});
+
+	f32 total = 0.0f;
+
+	auto pair = [&](const char* name, auto make, bool warm)
+	{
+		bench::measure(name, frames, [&]()
+		{
+			gjksimplex<f32> simplex;
+			for (size_t i = 0; i < frames; i++)
+			{
+				if (!warm)
+					simplex.reset();
+
+				auto shapes = make(i);
+				total += gjk(shapes.first, shapes.second, simplex).distance;
+			}
+
+			bench::keep(&total);
+		});
+	};
+
+	auto hulls = [&](size_t i) { return std::make_pair(movinghull{ hull, fquat(), fvec3(0, 0, 0) }, movinghull{ small, spin[i], path[i] }); };
+	auto hullsphere = [&](size_t i) { return std::make_pair(movinghull{ hull, fquat(), fvec3(0, 0, 0) }, spheresupport<f32>{ path[i], 0.5f }); };
+	auto boxcapsule = [&](size_t i) { return std::make_pair(movingbox{ { fvec3(0, 0, 0), fvec3(1, 0.5f, 0.5f) }, fquat(), fvec3(0, 0, 0) }, movingcapsule{ { fvec3(0, -1, 0), fvec3(0, 1, 0), 0.25f }, spin[i], path[i] }); };
+
+	pair("gjk hull 256 / hull 32", hulls, false);
+	pair("gjk hull 256 / hull 32 warm started", hulls, true);
+	pair("gjk hull 256 / sphere", hullsphere, false);
+	pair("gjk hull 256 / sphere warm started", hullsphere, true);
+	pair("gjk box / capsule", boxcapsule, false);
+	pair("gjk box / capsule warm started", boxcapsule, true);
+
+	boxsupport<f32> a{ fvec3(0, 0, 0), fvec3(1, 1, 1) };
+	movingbox b{ { fvec3(0, 0, 0), fvec3(1, 1, 1) }, fquat::axisangle(fvec3(1, 1, 0).normalized(), 0.4f), fvec3(1.5f, 0.2f, 0.1f) };
+	penetration<f32> p;
+
+	bench::measure("gjk + epa overlapping boxes", 1, [&]()
+	{
+		gjksimplex<f32> simplex;
+		if (gjkintersect(a, b, simplex))
+			(void)epa(a, b, simplex, p);
+
+		bench::keep(&p);
+	});
+}
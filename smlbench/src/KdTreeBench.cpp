@@ -0,0 +1,56 @@
+#include <kdtree.h>
+#include <random.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(kdtree, nearest)
+{
+	const size_t count = 1 << 16;
+	const size_t queries = 1 << 16;
+
+	std::vector<fvec3> points(count), centers(queries);
+	rng r(2);
+	inbox(r, fvec3(0, 0, 0), fvec3(100, 100, 100), points.data(), count);
+	inbox(r, fvec3(0, 0, 0), fvec3(100, 100, 100), centers.data(), queries);
+
+	kdtree<vec3, f32> tree;
+	std::vector<u32> nearest(queries), knn(queries * 8);
+
+	bench::measure("kdtree::build", count, [&]()
+	{
+		tree.build(points.data(), count);
+		bench::keep(&tree);
+	});
+
+	bench::measure("kdtree::nearest per query", queries, [&]()
+	{
+		for (size_t q = 0; q < queries; q++)
+			nearest[q] = tree.nearest(centers[q]);
+
+		bench::keep(nearest.data());
+	});
+
+	bench::measure("kdtree::nearest(queries, count)", queries, [&]()
+	{
+		tree.nearest(centers.data(), queries, nearest.data());
+		bench::keep(nearest.data());
+	});
+
+	bench::measure("kdtree::nearest k = 8 per query", queries, [&]()
+	{
+		for (size_t q = 0; q < queries; q++)
+			(void)tree.nearest(centers[q], 8, knn.data() + q * 8);
+
+		bench::keep(knn.data());
+	});
+
+	bench::measure("kdtree::nearest(queries, count, k = 8)", queries, [&]()
+	{
+		tree.nearest(centers.data(), queries, 8, knn.data());
+		bench::keep(knn.data());
+	});
+}
@@ -0,0 +1,6 @@
+#include <bench.h>
+
+int main(int argc, char** argv)
+{
+	return bench::runall(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,74 @@
+#include <noise.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(noise, evaluate)
+{
+	const size_t count = 1 << 14;
+	std::vector<f32> x(count), y(count), z(count), value(count), dx(count), dy(count), dz(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = static_cast<f32>(i % 128) * 0.173f;
+		y[i] = static_cast<f32>(i / 128) * 0.173f;
+		z[i] = static_cast<f32>(i % 7) * 0.5f;
+	}
+
+	noisestreams<f32> streams = { { x.data(), y.data(), z.data(), nullptr }, 3, value.data(), { nullptr, nullptr, nullptr, nullptr }, nullptr };
+
+	bench::measure("sml::perlin(fvec3) per point", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			value[i] = perlin(fvec3(x[i], y[i], z[i]));
+
+		bench::keep(value.data());
+	});
+
+	bench::measure("sml::perlin(noisestreams, count) 3d", count, [&]()
+	{
+		perlin(streams, count);
+		bench::keep(value.data());
+	});
+
+	bench::measure("sml::simplex(fvec3) per point", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			value[i] = simplex(fvec3(x[i], y[i], z[i]));
+
+		bench::keep(value.data());
+	});
+
+	bench::measure("sml::simplex(noisestreams, count) 3d", count, [&]()
+	{
+		simplex(streams, count);
+		bench::keep(value.data());
+	});
+
+	bench::measure("sml::worley(noisestreams, count) 3d", count, [&]()
+	{
+		worley(streams, count);
+		bench::keep(value.data());
+	});
+
+	streams.derivative[0] = dx.data();
+	streams.derivative[1] = dy.data();
+	streams.derivative[2] = dz.data();
+
+	bench::measure("sml::simplex(noisestreams, count) 3d + derivative", count, [&]()
+	{
+		simplex(streams, count);
+		bench::keep(value.data());
+	});
+
+	fbmparams<f32> params;
+
+	bench::measure("sml::fbm(perlin, noisestreams, count) 5 octaves", count, [&]()
+	{
+		fbm(noisetype::perlin, streams, count, params);
+		bench::keep(value.data());
+	});
+}
@@ -0,0 +1,104 @@
+#include <vec3.h>
+#include <quat.h>
+#include <vecarray.h>
+
+#include <bench.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace sml;
+
+static std::vector<fvec3> makevectors(size_t count)
+{
+	std::vector<fvec3> values;
+	values.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		f32 f = static_cast<f32>(i);
+		values.emplace_back(std::sin(f) * 10.0f, std::cos(f * 0.7f) * 3.0f, f * 0.001f + 0.5f);
+	}
+
+	return values;
+}
+
+SML_BENCH(normalize, vec3)
+{
+	const size_t count = 1 << 16;
+	std::vector<fvec3> source = makevectors(count);
+	std::vector<fvec3> values = source;
+
+	bench::measure("fvec3::normalize", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i].normalize();
+
+		bench::keep(values.data());
+	});
+
+	values = source;
+	bench::measure("fvec3::normalizeFast", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i].normalizeFast();
+
+		bench::keep(values.data());
+	});
+
+	values = source;
+	bench::measure("sml::normalize(fvec3*, count)", count, [&]()
+	{
+		sml::normalize(values.data(), count);
+		bench::keep(values.data());
+	});
+
+	values = source;
+	bench::measure("sml::normalizeFast(fvec3*, count)", count, [&]()
+	{
+		sml::normalizeFast(values.data(), count);
+		bench::keep(values.data());
+	});
+
+	// Worst relative length error of the fast path
+	values = source;
+	sml::normalizeFast(values.data(), count);
+
+	f64 worst = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		f64 l = std::sqrt(static_cast<f64>(values[i].x) * values[i].x + static_cast<f64>(values[i].y) * values[i].y + static_cast<f64>(values[i].z) * values[i].z);
+		worst = std::fmax(worst, std::fabs(l - 1.0));
+	}
+
+	std::printf("  %-48s %10.3g\n", "max |length - 1| (fast)", worst);
+}
+
+SML_BENCH(normalize, quat)
+{
+	const size_t count = 1 << 16;
+	std::vector<fquat> values;
+	for (size_t i = 0; i < count; i++)
+	{
+		f32 f = static_cast<f32>(i);
+		values.emplace_back(std::sin(f), std::cos(f), f * 0.01f, 2.0f);
+	}
+
+	std::vector<fquat> source = values;
+	bench::measure("fquat::normalize", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i].normalize();
+
+		bench::keep(values.data());
+	});
+
+	values = source;
+	bench::measure("fquat::normalizeFast", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i].normalizeFast();
+
+		bench::keep(values.data());
+	});
+}
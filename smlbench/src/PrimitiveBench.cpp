@@ -0,0 +1,43 @@
+#include <plane.h>
+#include <random.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(primitive, classify)
+{
+	const size_t count = 1 << 14;
+
+	std::vector<fvec3> points(count);
+	std::vector<s8> sides(count);
+	rng r(5);
+	inbox(r, fvec3(-10, -10, -10), fvec3(10, 10, 10), points.data(), points.size());
+
+	fplane p = fplane::frompointnormal(fvec3(0, 1, 0), fvec3(0.6f, 0.8f, 0));
+	u32 found = 0;
+
+	bench::measure("fplane::signeddistance per point", count, [&]()
+	{
+		found = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 distance = p.signeddistance(points[i]);
+			s8 side = static_cast<s8>(distance > 1e-4f ? 1 : distance < -1e-4f ? -1 : 0);
+			sides[i] = side;
+			found |= 1u << (side + 1);
+		}
+
+		bench::keep(&found);
+		bench::keep(sides.data());
+	});
+
+	bench::measure("sml::classify(plane, points, count)", count, [&]()
+	{
+		found = classify(p, points.data(), count, sides.data(), 1e-4f);
+		bench::keep(&found);
+		bench::keep(sides.data());
+	});
+}
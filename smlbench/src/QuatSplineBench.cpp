@@ -0,0 +1,98 @@
+#include <quatspline.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(quatspline, sample)
+{
+	const size_t count = 1 << 12;
+	const size_t keycount = 32;
+
+	std::vector<fquat> keys(keycount);
+
+	for (size_t i = 0; i < keycount; i++)
+	{
+		f32 s = static_cast<f32>(i);
+		keys[i] = fquat::axisangle(fvec3(sml::sin(s), 1.0f, sml::cos(2.0f * s)), 0.7f * s);
+	}
+
+	fquatspline spline(keys.data(), keycount);
+	std::vector<fquatspline> tracks(count, spline);
+	std::vector<f32> t(count);
+	std::vector<fquat> out(count), other(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		t[i] = static_cast<f32>((i * 2654435761u) % count) / count * (keycount - 1);
+		other[i] = keys[(i + 1) % keycount];
+	}
+
+	const std::vector<fquat>& k = spline.keys();
+	const std::vector<fquat>& c = spline.controls();
+
+	bench::measure("fquat::squad per sample", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t segment = std::min(static_cast<size_t>(t[i]), keycount - 2);
+			out[i] = fquat::squad(k[segment], c[segment], c[segment + 1], k[segment + 1], t[i] - segment);
+		}
+
+		bench::keep(out.data());
+	});
+
+	bench::measure("fquatspline::evaluate per sample", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] = spline.evaluate(t[i]);
+		}
+
+		bench::keep(out.data());
+	});
+
+	bench::measure("fquatspline::evaluate(t, count, out)", count, [&]()
+	{
+		spline.evaluate(t.data(), count, out.data());
+		bench::keep(out.data());
+	});
+
+	bench::measure("sml::evaluate(tracks, t, count, out)", count, [&]()
+	{
+		evaluate(tracks.data(), t.data(), count, out.data());
+		bench::keep(out.data());
+	});
+
+	std::vector<f32> blend(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		blend[i] = t[i] - static_cast<f32>(static_cast<size_t>(t[i]));
+	}
+
+	bench::measure("fquat::slerp per pair", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] = fquat::slerp(keys[i % keycount], other[i], blend[i]);
+		}
+
+		bench::keep(out.data());
+	});
+
+	std::vector<fquat> first(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		first[i] = keys[i % keycount];
+	}
+
+	bench::measure("fquat::slerp(a, b, t, count, out)", count, [&]()
+	{
+		fquat::slerp(first.data(), other.data(), blend.data(), count, out.data());
+		bench::keep(out.data());
+	});
+}
@@ -0,0 +1,40 @@
+#include <quat.h>
+#include <mat3.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(quat, frommatrix3)
+{
+	const size_t count = 1 << 16;
+	std::vector<fmat3> matrices(count);
+	std::vector<fquat> result(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fquat q = fquat::euler(static_cast<f32>(i % 360), static_cast<f32>((i * 7) % 360), static_cast<f32>((i * 13) % 360));
+
+		fvec3 c0 = q * fvec3(1, 0, 0);
+		fvec3 c1 = q * fvec3(0, 1, 0);
+		fvec3 c2 = q * fvec3(0, 0, 1);
+
+		matrices[i] = fmat3(c0.x, c0.y, c0.z, c1.x, c1.y, c1.z, c2.x, c2.y, c2.z);
+	}
+
+	bench::measure("fquat::frommatrix3", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			result[i] = fquat::frommatrix3(matrices[i]);
+
+		bench::keep(result.data());
+	});
+
+	bench::measure("fquat::frommatrix3(fmat3*, count)", count, [&]()
+	{
+		fquat::frommatrix3(matrices.data(), result.data(), count);
+		bench::keep(result.data());
+	});
+}
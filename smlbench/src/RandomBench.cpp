@@ -0,0 +1,62 @@
+#include <random.h>
+
+#include <bench.h>
+
+#include <random>
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(random, fill)
+{
+	const size_t count = 1 << 14;
+	std::vector<f32> values(count);
+	std::vector<fvec3> directions(count);
+	std::vector<fquat> rotations(count);
+
+	std::mt19937 mt(1);
+	std::uniform_real_distribution<f32> dist(0.0f, 1.0f);
+	rng r(1);
+
+	bench::measure("std::mt19937 uniform f32", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i] = dist(mt);
+
+		bench::keep(values.data());
+	});
+
+	bench::measure("rng::uniform<f32> per value", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i] = r.uniform<f32>();
+
+		bench::keep(values.data());
+	});
+
+	bench::measure("sml::uniform(rng, f32*, count)", count, [&]()
+	{
+		uniform(r, values.data(), count);
+		bench::keep(values.data());
+	});
+
+	bench::measure("rng::onsphere<f32> per value", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			directions[i] = r.onsphere<f32>();
+
+		bench::keep(directions.data());
+	});
+
+	bench::measure("sml::onsphere(rng, fvec3*, count)", count, [&]()
+	{
+		onsphere(r, directions.data(), count);
+		bench::keep(directions.data());
+	});
+
+	bench::measure("sml::rotation(rng, fquat*, count)", count, [&]()
+	{
+		rotation(r, rotations.data(), count);
+		bench::keep(rotations.data());
+	});
+}
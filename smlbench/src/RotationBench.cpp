@@ -0,0 +1,83 @@
+#include <rotation.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(rotation, convert)
+{
+	const size_t count = 1 << 12;
+
+	std::vector<fvec3> angles(count), back(count);
+	std::vector<fquat> rotations(count);
+	std::vector<fmat4> matrices(count);
+	std::vector<fvec4> axisangles(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		f32 s = static_cast<f32>(i);
+		angles[i] = fvec3(170.0f * sml::sin(s), 80.0f * sml::cos(0.7f * s), 170.0f * sml::sin(1.3f * s + 1.0f));
+	}
+
+	bench::measure("fquat::euler per rotation", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			rotations[i] = fquat::euler(angles[i]);
+		}
+
+		bench::keep(rotations.data());
+	});
+
+	bench::measure("eulertoquat(angles, out, count)", count, [&]()
+	{
+		eulertoquat(angles.data(), rotations.data(), count, eulerorder::xyz, angleunit::degrees);
+		bench::keep(rotations.data());
+	});
+
+	bench::measure("fquat::eulerAngles per rotation", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			back[i] = rotations[i].eulerAngles();
+		}
+
+		bench::keep(back.data());
+	});
+
+	bench::measure("quattoeuler(rotations, out, count)", count, [&]()
+	{
+		quattoeuler(rotations.data(), back.data(), count, eulerorder::xyz, angleunit::degrees);
+		bench::keep(back.data());
+	});
+
+	bench::measure("fmat4::rotate(yaw, pitch, roll) per rotation", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			matrices[i] = fmat4::rotate(angles[i].x, angles[i].y, angles[i].z);
+		}
+
+		bench::keep(matrices.data());
+	});
+
+	bench::measure("eulertomatrix(angles, out, count)", count, [&]()
+	{
+		eulertomatrix(angles.data(), matrices.data(), count, eulerorder::zxy);
+		bench::keep(matrices.data());
+	});
+
+	bench::measure("matrixtoeuler(matrices, out, count)", count, [&]()
+	{
+		matrixtoeuler(matrices.data(), back.data(), count, eulerorder::zxy);
+		bench::keep(back.data());
+	});
+
+	bench::measure("quattoaxisangle(rotations, out, count)", count, [&]()
+	{
+		quattoaxisangle(rotations.data(), axisangles.data(), count);
+		bench::keep(axisangles.data());
+	});
+}
@@ -0,0 +1,139 @@
+#include <skinning.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+struct skinmesh
+{
+	std::vector<f32> position[3], normal[3], weight[4], outposition[3], outnormal[3];
+	std::vector<u16> joint[4];
+
+	skinstreams<f32> streams = {};
+
+	skinmesh(size_t count, u16 joints, u32 influences)
+	{
+		for (s32 c = 0; c < 4; c++)
+		{
+			weight[c].resize(count);
+			joint[c].resize(count);
+		}
+
+		for (s32 c = 0; c < 3; c++)
+		{
+			position[c].resize(count);
+			normal[c].resize(count);
+			outposition[c].resize(count);
+			outnormal[c].resize(count);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			position[0][i] = static_cast<f32>(i % 100);
+			position[1][i] = static_cast<f32>(i % 37);
+			position[2][i] = static_cast<f32>(i % 11);
+			normal[1][i] = 1.0f;
+
+			for (u32 k = 0; k < 4; k++)
+			{
+				joint[k][i] = static_cast<u16>((i * 7 + k * 13) % joints);
+				weight[k][i] = k < influences ? 1.0f / influences : 0.0f;
+			}
+		}
+
+		for (s32 c = 0; c < 3; c++)
+		{
+			streams.position[c] = position[c].data();
+			streams.normal[c] = normal[c].data();
+			streams.outposition[c] = outposition[c].data();
+			streams.outnormal[c] = outnormal[c].data();
+		}
+
+		for (s32 c = 0; c < 4; c++)
+		{
+			streams.joint[c] = joint[c].data();
+			streams.weight[c] = weight[c].data();
+		}
+
+		streams.influences = influences;
+	}
+};
+
+SML_BENCH(skinning, dualquat)
+{
+	const size_t count = 1 << 15;
+	const u16 joints = 64;
+
+	std::vector<fdualquat> palette;
+	for (u16 j = 0; j < joints; j++)
+	{
+		palette.emplace_back(fquat::euler(j * 5.0f, j * 3.0f, 0), fvec3(static_cast<f32>(j), 0, 1));
+	}
+
+	for (u32 influences = 1; influences <= 4; influences++)
+	{
+		skinmesh mesh(count, joints, influences);
+
+		std::string label = "skindualquat, " + std::to_string(influences) + " influences";
+		bench::measure(label.c_str(), count, [&]()
+		{
+			skindualquat(palette.data(), mesh.streams, count);
+			bench::keep(mesh.outposition[0].data());
+		});
+	}
+}
+
+SML_BENCH(skinning, linear)
+{
+	const size_t count = 1 << 15;
+	const u16 joints = 64;
+
+	std::vector<fmat4> palette;
+	for (u16 j = 0; j < joints; j++)
+	{
+		palette.push_back(fmat4::compose(fvec3(static_cast<f32>(j), 0, 1), fquat::euler(j * 5.0f, j * 3.0f, 0), fvec3(1, 1, 1)));
+	}
+
+	for (u32 influences = 1; influences <= 4; influences++)
+	{
+		skinmesh mesh(count, joints, influences);
+
+		std::string label = "fmat4 * fvec4 loop, " + std::to_string(influences) + " influences";
+		bench::measure(label.c_str(), count, [&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				fvec4 p(mesh.position[0][i], mesh.position[1][i], mesh.position[2][i], 1.0f);
+				fvec4 n(mesh.normal[0][i], mesh.normal[1][i], mesh.normal[2][i], 0.0f);
+				fvec4 rp(0.0f, 0.0f, 0.0f, 0.0f), rn(0.0f, 0.0f, 0.0f, 0.0f);
+
+				for (u32 k = 0; k < influences; k++)
+				{
+					const fmat4& m = palette[mesh.joint[k][i]];
+					rp += (m * p) * mesh.weight[k][i];
+					rn += (m * n) * mesh.weight[k][i];
+				}
+
+				rn.normalize();
+
+				mesh.outposition[0][i] = rp.x;
+				mesh.outposition[1][i] = rp.y;
+				mesh.outposition[2][i] = rp.z;
+				mesh.outnormal[0][i] = rn.x;
+				mesh.outnormal[1][i] = rn.y;
+				mesh.outnormal[2][i] = rn.z;
+			}
+
+			bench::keep(mesh.outposition[0].data());
+		});
+
+		label = "skinlinear, " + std::to_string(influences) + " influences";
+		bench::measure(label.c_str(), count, [&]()
+		{
+			skinlinear(palette.data(), mesh.streams, count);
+			bench::keep(mesh.outposition[0].data());
+		});
+	}
+}
@@ -0,0 +1,64 @@
+#include <spatialhash.h>
+#include <random.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(spatialhash, query)
+{
+	const size_t count = 1 << 14;
+	const size_t queries = 256;
+	const f32 radius = 1.0f;
+
+	std::vector<fvec3> points(count), centers(queries);
+	rng r(1);
+	inbox(r, fvec3(0, 0, 0), fvec3(32, 32, 32), points.data(), count);
+	inbox(r, fvec3(0, 0, 0), fvec3(32, 32, 32), centers.data(), queries);
+
+	spatialhash<f32> grid(radius);
+	std::vector<u32> found;
+
+	bench::measure("spatialhash::build", count, [&]()
+	{
+		grid.build(points.data(), count);
+		bench::keep(&grid);
+	});
+
+	bench::measure("brute force radius query", queries, [&]()
+	{
+		found.clear();
+		for (const fvec3& c : centers)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				fvec3 d = points[i] - c;
+				if (d.x * d.x + d.y * d.y + d.z * d.z <= radius * radius)
+					found.push_back(static_cast<u32>(i));
+			}
+		}
+
+		bench::keep(found.data());
+	});
+
+	bench::measure("spatialhash::query", queries, [&]()
+	{
+		found.clear();
+		for (const fvec3& c : centers)
+			grid.query(c, radius, found);
+
+		bench::keep(found.data());
+	});
+
+	std::vector<fvec3> moved(points);
+	for (fvec3& p : moved)
+		p += fvec3(0.01f, -0.01f, 0.005f);
+
+	bench::measure("spatialhash::update small motion", count, [&]()
+	{
+		grid.update(moved.data(), count);
+		bench::keep(&grid);
+	});
+}
@@ -0,0 +1,67 @@
+#include <trs.h>
+
+#include <bench.h>
+
+#include <vector>
+
+using namespace sml;
+
+SML_BENCH(trs, compose)
+{
+	const size_t count = 1 << 14;
+	std::vector<f32> data(10 * count);
+	std::vector<fmat4> matrices(count);
+
+	trsarray<f32> trs = { &data[0], &data[count], &data[2 * count], &data[3 * count], &data[4 * count], &data[5 * count], &data[6 * count], &data[7 * count], &data[8 * count], &data[9 * count] };
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fquat q = fquat::euler(static_cast<f32>(i % 360), static_cast<f32>((i * 7) % 360), 0.0f);
+
+		trs.tx[i] = trs.ty[i] = trs.tz[i] = static_cast<f32>(i);
+		trs.qx[i] = q.x;
+		trs.qy[i] = q.y;
+		trs.qz[i] = q.z;
+		trs.qw[i] = q.w;
+		trs.sx[i] = trs.sy[i] = trs.sz[i] = 1.0f + (i % 3);
+	}
+
+	bench::measure("translate * scale (two mat4 products)", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			matrices[i] = fmat4::translate(fvec3(trs.tx[i], trs.ty[i], trs.tz[i])) * fmat4() * fmat4::scale(fvec3(trs.sx[i], trs.sy[i], trs.sz[i]));
+
+		bench::keep(matrices.data());
+	});
+
+	bench::measure("fmat4::compose", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			matrices[i] = fmat4::compose(fvec3(trs.tx[i], trs.ty[i], trs.tz[i]), fquat(trs.qx[i], trs.qy[i], trs.qz[i], trs.qw[i]), fvec3(trs.sx[i], trs.sy[i], trs.sz[i]));
+
+		bench::keep(matrices.data());
+	});
+
+	bench::measure("sml::compose(trsarray, fmat4*, count)", count, [&]()
+	{
+		sml::compose(trs, matrices.data(), count);
+		bench::keep(matrices.data());
+	});
+
+	fvec3 translation, scale;
+	fquat rotation;
+
+	bench::measure("fmat4::decompose", count, [&]()
+	{
+		for (size_t i = 0; i < count; i++)
+			matrices[i].decompose(translation, rotation, scale);
+
+		bench::keep(&rotation);
+	});
+
+	bench::measure("sml::decompose(fmat4*, trsarray, count)", count, [&]()
+	{
+		sml::decompose(matrices.data(), trs, count);
+		bench::keep(data.data());
+	});
+}
@@ -0,0 +1,58 @@
+#ifndef smltest_differential_h__
+#define smltest_differential_h__
+
+#include <cstddef>
+
+// Differential testing of the SIMD backends. Every backend translation unit in src/differential
+// builds the same operation table (differentialbackend.hpp) against its own backend, the test
+// runs each table on the same randomized inputs and compares the results to the scalar backend.
+namespace differential
+{
+	enum class element
+	{
+		f32,
+		f64,
+		s32
+	};
+
+	// One library operation over 'count' items. Item i reads 'inputs' elements from
+	// in + i * inputs and writes 'outputs' elements to out + i * outputs.
+	struct operation
+	{
+		const char* name;
+		element type;
+		size_t inputs;
+		size_t outputs;
+
+		// Allowed difference to the scalar backend, a result passes when it is within 'ulps'
+		// units in the last place or within 'absolute' (for results that cancel towards zero)
+		double ulps;
+		double absolute;
+
+		void (*run)(const void* in, void* out, size_t count);
+	};
+
+	struct backend
+	{
+		const char* name;
+
+		// False when the CPU lacks the instruction set the backend was compiled for
+		bool (*supported)();
+
+		const operation* operations;
+		size_t count;
+	};
+
+	// The backends linked into this binary, null when the compiler can't target a backend
+	const backend* scalarbackend();
+	const backend* ssebackend();
+	const backend* avxbackend();
+	const backend* avx512backend();
+
+	// Items per operation and whether to print the per backend report, set from the command
+	// line (--differential[=items]) in Main.cpp
+	extern size_t items;
+	extern bool report;
+}
+
+#endif // smltest_differential_h__
@@ -0,0 +1,997 @@
+// Operation table of the differential tests. There is no include guard on purpose: every file in
+// src/differential selects a backend and then includes this once, so the same operations are
+// compiled against each backend. Everything lives in an anonymous namespace and only plain
+// arrays cross the table, the library itself is kept apart by its per backend inline namespace.
+
+#include <cmath>
+#include <cstddef>
+
+#include <vec2.h>
+#include <vec3.h>
+#include <vec4.h>
+#include <mat2.h>
+#include <mat3.h>
+#include <mat4.h>
+#include <quat.h>
+#include <dualquat.h>
+#include <trs.h>
+#include <divider.h>
+#include <vecarray.h>
+#include <mask.h>
+#include <reduce.h>
+#include <skinning.h>
+#include <noise.h>
+
+#include "differential.h"
+
+namespace differential
+{
+namespace
+{
+	using namespace sml;
+
+	// Items of the array operations, so their tails are exercised as well
+	constexpr size_t block = 11;
+
+	template<typename T>
+	constexpr element typeof() noexcept
+	{
+		return std::is_same<T, f32>::value ? element::f32 : std::is_same<T, f64>::value ? element::f64 : element::s32;
+	}
+
+	template<typename T>
+	constexpr double defaultabsolute() noexcept
+	{
+		return std::is_same<T, f32>::value ? 1e-5 : std::is_same<T, f64>::value ? 1e-13 : 0.0;
+	}
+
+	// Calls f(in, out) for every item
+	template<typename T, size_t In, size_t Out, typename F>
+	static void each(const void* in, void* out, size_t count, const F& f)
+	{
+		const T* a = static_cast<const T*>(in);
+		T* o = static_cast<T*>(out);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			f(a + i * In, o + i * Out);
+		}
+	}
+
+	// Input helpers, the inputs are uniform in [-2, 2]
+	template<typename T> vec2<T> v2(const T* p) { return vec2<T>(p[0], p[1]); }
+	template<typename T> vec3<T> v3(const T* p) { return vec3<T>(p[0], p[1], p[2]); }
+	template<typename T> vec4<T> v4(const T* p) { return vec4<T>(p[0], p[1], p[2], p[3]); }
+
+	// Away from zero, for divisors and scales
+	template<typename T> T positive(T v) { return std::fabs(v) + static_cast<T>(0.5); }
+	template<typename T> vec3<T> positive3(const T* p) { return vec3<T>(positive(p[0]), positive(p[1]), positive(p[2])); }
+
+	template<typename T>
+	quat<T> unitquat(const T* p)
+	{
+		T l = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2] + p[3] * p[3]);
+
+		return quat<T>(p[0] / l, p[1] / l, p[2] / l, p[3] / l);
+	}
+
+	template<typename T>
+	mat2<T> m2(const T* p)
+	{
+		return mat2<T>(p[0], p[1], p[2], p[3]);
+	}
+
+	template<typename T>
+	mat3<T> m3(const T* p)
+	{
+		return mat3<T>(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]);
+	}
+
+	template<typename T>
+	mat4<T> m4(const T* p)
+	{
+		return mat4<T>(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9], p[10], p[11], p[12], p[13], p[14], p[15]);
+	}
+
+	// Diagonally dominant, so inverting doesn't amplify the rounding differences
+	template<typename T>
+	mat3<T> wellconditioned3(const T* p)
+	{
+		const T d = static_cast<T>(8);
+
+		return mat3<T>(p[0] + d, p[1], p[2], p[3], p[4] + d, p[5], p[6], p[7], p[8] + d);
+	}
+
+	template<typename T>
+	mat4<T> wellconditioned4(const T* p)
+	{
+		const T d = static_cast<T>(8);
+
+		return mat4<T>(p[0] + d, p[1], p[2], p[3], p[4], p[5] + d, p[6], p[7], p[8], p[9], p[10] + d, p[11], p[12], p[13], p[14], p[15] + d);
+	}
+
+	// Rotation matrix of a unit quaternion, written out so it doesn't depend on the backend
+	template<typename T>
+	mat3<T> rotation3(const quat<T>& q)
+	{
+		const T one = static_cast<T>(1);
+		const T two = static_cast<T>(2);
+
+		return mat3<T>(one - two * (q.y * q.y + q.z * q.z), two * (q.x * q.y + q.w * q.z), two * (q.x * q.z - q.w * q.y),
+		               two * (q.x * q.y - q.w * q.z), one - two * (q.x * q.x + q.z * q.z), two * (q.y * q.z + q.w * q.x),
+		               two * (q.x * q.z + q.w * q.y), two * (q.y * q.z - q.w * q.x), one - two * (q.x * q.x + q.y * q.y));
+	}
+
+	template<typename T> void put(T* o, const vec2<T>& v) { o[0] = v.x; o[1] = v.y; }
+	template<typename T> void put(T* o, const vec3<T>& v) { o[0] = v.x; o[1] = v.y; o[2] = v.z; }
+	template<typename T> void put(T* o, const vec4<T>& v) { o[0] = v.x; o[1] = v.y; o[2] = v.z; o[3] = v.w; }
+
+	// q and -q are the same rotation, the sign with a positive w is written
+	template<typename T>
+	void put(T* o, const quat<T>& q)
+	{
+		T s = q.w < static_cast<T>(0) ? static_cast<T>(-1) : static_cast<T>(1);
+
+		o[0] = q.x * s;
+		o[1] = q.y * s;
+		o[2] = q.z * s;
+		o[3] = q.w * s;
+	}
+
+	template<typename T>
+	void put(T* o, const mat2<T>& m)
+	{
+		o[0] = m.m00; o[1] = m.m01;
+		o[2] = m.m10; o[3] = m.m11;
+	}
+
+	template<typename T>
+	void put(T* o, const mat3<T>& m)
+	{
+		o[0] = m.m00; o[1] = m.m01; o[2] = m.m02;
+		o[3] = m.m10; o[4] = m.m11; o[5] = m.m12;
+		o[6] = m.m20; o[7] = m.m21; o[8] = m.m22;
+	}
+
+	template<typename T>
+	void put(T* o, const mat4<T>& m)
+	{
+		for (size_t i = 0; i < 16; i++)
+		{
+			o[i] = m.v[i];
+		}
+	}
+
+	// Vectors
+
+	template<typename T>
+	void vec2add(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 2>(in, out, count, [](const T* a, T* o) { put(o, v2(a) + v2(a + 2)); });
+	}
+
+	template<typename T>
+	void vec2mul(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 2>(in, out, count, [](const T* a, T* o) { put(o, v2(a) * v2(a + 2)); });
+	}
+
+	template<typename T>
+	void vec2normalize(const void* in, void* out, size_t count)
+	{
+		each<T, 2, 2>(in, out, count, [](const T* a, T* o) { put(o, v2(a).normalized()); });
+	}
+
+	template<typename T>
+	void vec3add(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a) + v3(a + 3)); });
+	}
+
+	template<typename T>
+	void vec3sub(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a) - v3(a + 3)); });
+	}
+
+	template<typename T>
+	void vec3mul(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a) * v3(a + 3)); });
+	}
+
+	template<typename T>
+	void vec3div(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a) / positive3(a + 3)); });
+	}
+
+	template<typename T>
+	void vec3scale(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a) * a[3]); });
+	}
+
+	template<typename T>
+	void vec3dot(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 1>(in, out, count, [](const T* a, T* o) { o[0] = vec3<T>::dot(v3(a), v3(a + 3)); });
+	}
+
+	template<typename T>
+	void vec3cross(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 3>(in, out, count, [](const T* a, T* o) { put(o, vec3<T>::cross(v3(a), v3(a + 3))); });
+	}
+
+	template<typename T>
+	void vec3length(const void* in, void* out, size_t count)
+	{
+		each<T, 3, 1>(in, out, count, [](const T* a, T* o) { o[0] = v3(a).length(); });
+	}
+
+	template<typename T>
+	void vec3normalize(const void* in, void* out, size_t count)
+	{
+		each<T, 3, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a).normalized()); });
+	}
+
+	template<typename T>
+	void vec3normalizefast(const void* in, void* out, size_t count)
+	{
+		each<T, 3, 3>(in, out, count, [](const T* a, T* o) { put(o, v3(a).normalizedFast()); });
+	}
+
+	template<typename T>
+	void vec3lerp(const void* in, void* out, size_t count)
+	{
+		each<T, 7, 3>(in, out, count, [](const T* a, T* o) { put(o, vec3<T>::lerp(v3(a), v3(a + 3), a[6])); });
+	}
+
+	template<typename T>
+	void vec3minmax(const void* in, void* out, size_t count)
+	{
+		each<T, 6, 6>(in, out, count, [](const T* a, T* o)
+		{
+			put(o, vec3<T>::min(v3(a), v3(a + 3)));
+			put(o + 3, vec3<T>::max(v3(a), v3(a + 3)));
+		});
+	}
+
+	template<typename T>
+	void vec4add(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 4>(in, out, count, [](const T* a, T* o) { put(o, v4(a) + v4(a + 4)); });
+	}
+
+	template<typename T>
+	void vec4mul(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 4>(in, out, count, [](const T* a, T* o) { put(o, v4(a) * v4(a + 4)); });
+	}
+
+	template<typename T>
+	void vec4dot(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 1>(in, out, count, [](const T* a, T* o) { o[0] = vec4<T>::dot(v4(a), v4(a + 4)); });
+	}
+
+	template<typename T>
+	void vec4normalize(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 4>(in, out, count, [](const T* a, T* o) { put(o, v4(a).normalized()); });
+	}
+
+	template<typename T>
+	void vec4normalizefast(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 4>(in, out, count, [](const T* a, T* o) { put(o, v4(a).normalizedFast()); });
+	}
+
+	template<typename T>
+	void vec4minmax(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 8>(in, out, count, [](const T* a, T* o)
+		{
+			put(o, vec4<T>::min(v4(a), v4(a + 4)));
+			put(o + 4, vec4<T>::max(v4(a), v4(a + 4)));
+		});
+	}
+
+	// Matrices
+
+	template<typename T>
+	void mat2mul(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 4>(in, out, count, [](const T* a, T* o) { put(o, m2(a) * m2(a + 4)); });
+	}
+
+	template<typename T>
+	void mat2inverse(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 4>(in, out, count, [](const T* a, T* o)
+		{
+			const T d = static_cast<T>(8);
+			put(o, mat2<T>(a[0] + d, a[1], a[2], a[3] + d).inverted());
+		});
+	}
+
+	template<typename T>
+	void mat2equal(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 2>(in, out, count, [](const T* a, T* o)
+		{
+			mat2<T> m = m2(a);
+			mat2<T> other = mat2<T>(a[0], a[1], a[2], a[3] + static_cast<T>(1));
+
+			o[0] = static_cast<T>((m == m) + 2 * (m == other));
+			o[1] = static_cast<T>((m != m) + 2 * (m != other));
+		});
+	}
+
+	template<typename T>
+	void mat3mul(const void* in, void* out, size_t count)
+	{
+		each<T, 18, 9>(in, out, count, [](const T* a, T* o) { put(o, m3(a) * m3(a + 9)); });
+	}
+
+	template<typename T>
+	void mat3transform(const void* in, void* out, size_t count)
+	{
+		each<T, 12, 3>(in, out, count, [](const T* a, T* o) { put(o, m3(a) * v3(a + 9)); });
+	}
+
+	template<typename T>
+	void mat3inverse(const void* in, void* out, size_t count)
+	{
+		each<T, 9, 9>(in, out, count, [](const T* a, T* o) { put(o, wellconditioned3(a).inverted()); });
+	}
+
+	template<typename T>
+	void mat3determinant(const void* in, void* out, size_t count)
+	{
+		each<T, 9, 1>(in, out, count, [](const T* a, T* o) { o[0] = wellconditioned3(a).determinant(); });
+	}
+
+	template<typename T>
+	void mat4mul(const void* in, void* out, size_t count)
+	{
+		each<T, 32, 16>(in, out, count, [](const T* a, T* o) { put(o, m4(a) * m4(a + 16)); });
+	}
+
+	template<typename T>
+	void mat4transform(const void* in, void* out, size_t count)
+	{
+		each<T, 20, 4>(in, out, count, [](const T* a, T* o) { put(o, m4(a) * v4(a + 16)); });
+	}
+
+	template<typename T>
+	void mat4scale(const void* in, void* out, size_t count)
+	{
+		each<T, 17, 16>(in, out, count, [](const T* a, T* o)
+		{
+			mat4<T> m = m4(a);
+			m *= a[16];
+
+			put(o, m);
+		});
+	}
+
+	template<typename T>
+	void mat4transpose(const void* in, void* out, size_t count)
+	{
+		each<T, 16, 16>(in, out, count, [](const T* a, T* o) { put(o, m4(a).transposed()); });
+	}
+
+	template<typename T>
+	void mat4inverse(const void* in, void* out, size_t count)
+	{
+		each<T, 16, 16>(in, out, count, [](const T* a, T* o) { put(o, wellconditioned4(a).inverted()); });
+	}
+
+	template<typename T>
+	void mat4determinant(const void* in, void* out, size_t count)
+	{
+		each<T, 16, 1>(in, out, count, [](const T* a, T* o) { o[0] = wellconditioned4(a).determinant(); });
+	}
+
+	template<typename T>
+	void mat4equal(const void* in, void* out, size_t count)
+	{
+		each<T, 16, 2>(in, out, count, [](const T* a, T* o)
+		{
+			mat4<T> m = m4(a);
+			mat4<T> other = m;
+			other.m23 += static_cast<T>(1);
+
+			o[0] = static_cast<T>((m == m) + 2 * (m == other));
+			o[1] = static_cast<T>((m != m) + 2 * (m != other));
+		});
+	}
+
+	template<typename T>
+	void mat4compose(const void* in, void* out, size_t count)
+	{
+		each<T, 10, 16>(in, out, count, [](const T* a, T* o) { put(o, mat4<T>::compose(v3(a), unitquat(a + 3), positive3(a + 7))); });
+	}
+
+	template<typename T>
+	void mat4decompose(const void* in, void* out, size_t count)
+	{
+		each<T, 10, 10>(in, out, count, [](const T* a, T* o)
+		{
+			mat4<T> m = mat4<T>::compose(v3(a), unitquat(a + 3), positive3(a + 7));
+
+			vec3<T> t, s;
+			quat<T> r;
+			m.decompose(t, r, s);
+
+			put(o, t);
+			put(o + 3, r);
+			put(o + 7, s);
+		});
+	}
+
+	// Quaternions
+
+	template<typename T>
+	void quatmul(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 4>(in, out, count, [](const T* a, T* o)
+		{
+			quat<T> q = quat<T>(a[0], a[1], a[2], a[3]) * quat<T>(a[4], a[5], a[6], a[7]);
+
+			o[0] = q.x;
+			o[1] = q.y;
+			o[2] = q.z;
+			o[3] = q.w;
+		});
+	}
+
+	template<typename T>
+	void quatrotate(const void* in, void* out, size_t count)
+	{
+		each<T, 7, 3>(in, out, count, [](const T* a, T* o) { put(o, unitquat(a) * v3(a + 4)); });
+	}
+
+	template<typename T>
+	void quatnormalize(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 4>(in, out, count, [](const T* a, T* o) { put(o, quat<T>(a[0], a[1], a[2], a[3]).normalized()); });
+	}
+
+	template<typename T>
+	void quatslerp(const void* in, void* out, size_t count)
+	{
+		each<T, 9, 4>(in, out, count, [](const T* a, T* o)
+		{
+			T t = std::fabs(a[8]) * static_cast<T>(0.5);
+			put(o, quat<T>::slerp(unitquat(a), unitquat(a + 4), t));
+		});
+	}
+
+	template<typename T>
+	void quatfrommatrix3(const void* in, void* out, size_t count)
+	{
+		each<T, 4, 4>(in, out, count, [](const T* a, T* o) { put(o, quat<T>::frommatrix3(rotation3(unitquat(a)))); });
+	}
+
+	template<typename T>
+	void quatfrommatrix3array(const void* in, void* out, size_t count)
+	{
+		each<T, 4 * block, 4 * block>(in, out, count, [](const T* a, T* o)
+		{
+			mat3<T> m[block];
+			quat<T> q[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				m[i] = rotation3(unitquat(a + 4 * i));
+			}
+
+			quat<T>::frommatrix3(m, q, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 4 * i, q[i]);
+			}
+		});
+	}
+
+	template<typename T>
+	void dualquatmul(const void* in, void* out, size_t count)
+	{
+		each<T, 14, 7>(in, out, count, [](const T* a, T* o)
+		{
+			dualquat<T> d = dualquat<T>(unitquat(a), v3(a + 4)) * dualquat<T>(unitquat(a + 7), v3(a + 11));
+
+			put(o, d.rotation());
+			put(o + 4, d.translation());
+		});
+	}
+
+	template<typename T>
+	void dualquattransform(const void* in, void* out, size_t count)
+	{
+		each<T, 10, 3>(in, out, count, [](const T* a, T* o) { put(o, dualquat<T>(unitquat(a), v3(a + 4)).transformPoint(v3(a + 7))); });
+	}
+
+	// Array kernels, every item is one array of 'block' elements
+
+	template<typename T>
+	void arrayadd(const void* in, void* out, size_t count)
+	{
+		each<T, 8 * block, 4 * block>(in, out, count, [](const T* a, T* o)
+		{
+			vec4<T> x[block], y[block], r[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v4(a + 8 * i);
+				y[i] = v4(a + 8 * i + 4);
+			}
+
+			sml::add(x, y, r, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 4 * i, r[i]);
+			}
+		});
+	}
+
+	template<typename T>
+	void arrayminmax(const void* in, void* out, size_t count)
+	{
+		each<T, 8 * block, 8 * block>(in, out, count, [](const T* a, T* o)
+		{
+			vec4<T> x[block], y[block], lo[block], hi[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v4(a + 8 * i);
+				y[i] = v4(a + 8 * i + 4);
+			}
+
+			sml::min(x, y, lo, block);
+			sml::max(x, y, hi, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 8 * i, lo[i]);
+				put(o + 8 * i + 4, hi[i]);
+			}
+		});
+	}
+
+	template<typename T>
+	void arrayscale(const void* in, void* out, size_t count)
+	{
+		each<T, 4 * block + 1, 4 * block>(in, out, count, [](const T* a, T* o)
+		{
+			vec4<T> x[block], r[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v4(a + 4 * i);
+			}
+
+			sml::scale(x, a[4 * block], r, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 4 * i, r[i]);
+			}
+		});
+	}
+
+	template<typename T, bool Fast>
+	void arraynormalize(const void* in, void* out, size_t count)
+	{
+		each<T, 3 * block, 3 * block>(in, out, count, [](const T* a, T* o)
+		{
+			vec3<T> x[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v3(a + 3 * i);
+			}
+
+			if constexpr (Fast)
+				sml::normalizeFast(x, block);
+			else
+				sml::normalize(x, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 3 * i, x[i]);
+			}
+		});
+	}
+
+	template<typename T>
+	void reducesum(const void* in, void* out, size_t count)
+	{
+		each<T, 4 * block, 12>(in, out, count, [](const T* a, T* o)
+		{
+			vec4<T> x[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v4(a + 4 * i);
+			}
+
+			put(o, sml::sum(x, block));
+			put(o + 4, sml::minimum(x, block));
+			put(o + 8, sml::maximum(x, block));
+		});
+	}
+
+	template<typename T>
+	void maskcompare(const void* in, void* out, size_t count)
+	{
+		each<T, 8, 7>(in, out, count, [](const T* a, T* o)
+		{
+			vec4<T> x = v4(a), y = v4(a + 4);
+			// Rounded so some lanes compare equal
+			vec4<T> rx(std::round(x.x), std::round(x.y), std::round(x.z), std::round(x.w));
+			vec4<T> ry(std::round(y.x), std::round(y.y), std::round(y.z), std::round(y.w));
+
+			o[0] = static_cast<T>(sml::lessThan(rx, ry).bits());
+			o[1] = static_cast<T>(sml::lessEqual(rx, ry).bits());
+			o[2] = static_cast<T>(sml::equal(rx, ry).bits());
+			o[3] = static_cast<T>(sml::notEqual(rx, ry).bits());
+
+			vec4<T> s = sml::select(sml::greaterThan(x, y), x, y);
+			o[4] = s.x;
+			o[5] = s.y;
+			o[6] = s.z + s.w;
+		});
+	}
+
+	// Transforms and skinning
+
+	template<typename T>
+	void trscompose(const void* in, void* out, size_t count)
+	{
+		each<T, 10 * block, 16 * block>(in, out, count, [](const T* a, T* o)
+		{
+			T c[10][block];
+			mat4<T> m[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				const T* p = a + 10 * i;
+				quat<T> q = unitquat(p + 3);
+				vec3<T> s = positive3(p + 7);
+
+				c[0][i] = p[0]; c[1][i] = p[1]; c[2][i] = p[2];
+				c[3][i] = q.x; c[4][i] = q.y; c[5][i] = q.z; c[6][i] = q.w;
+				c[7][i] = s.x; c[8][i] = s.y; c[9][i] = s.z;
+			}
+
+			trsarray<T> trs = { c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9] };
+			sml::compose(trs, m, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 16 * i, m[i]);
+			}
+		});
+	}
+
+	template<typename T>
+	void trsdecompose(const void* in, void* out, size_t count)
+	{
+		each<T, 10 * block, 10 * block>(in, out, count, [](const T* a, T* o)
+		{
+			T c[10][block];
+			mat4<T> m[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				const T* p = a + 10 * i;
+				m[i] = mat4<T>::compose(v3(p), unitquat(p + 3), positive3(p + 7));
+			}
+
+			trsarray<T> trs = { c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9] };
+			sml::decompose(m, trs, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				T* r = o + 10 * i;
+
+				r[0] = c[0][i]; r[1] = c[1][i]; r[2] = c[2][i];
+				put(r + 3, quat<T>(c[3][i], c[4][i], c[5][i], c[6][i]));
+				r[7] = c[7][i]; r[8] = c[8][i]; r[9] = c[9][i];
+			}
+		});
+	}
+
+	// Two joint palette (translation, rotation, scale each) followed by 'block' vertices of
+	// position, normal and the weight of the first joint
+	template<typename T, bool Dualquat>
+	void skin(const void* in, void* out, size_t count)
+	{
+		each<T, 20 + 7 * block, 6 * block>(in, out, count, [](const T* a, T* o)
+		{
+			const T one = static_cast<T>(1);
+
+			mat4<T> matrices[2];
+			dualquat<T> dualquats[2];
+
+			for (size_t j = 0; j < 2; j++)
+			{
+				const T* p = a + 10 * j;
+
+				matrices[j] = mat4<T>::compose(v3(p), unitquat(p + 3), positive3(p + 7));
+				dualquats[j] = dualquat<T>(unitquat(p + 3), v3(p));
+			}
+
+			T position[3][block], normal[3][block], weight[2][block];
+			T outposition[3][block], outnormal[3][block];
+			u16 joint[2][block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				const T* p = a + 20 + 7 * i;
+
+				for (size_t c = 0; c < 3; c++)
+				{
+					position[c][i] = p[c];
+					normal[c][i] = p[3 + c];
+				}
+
+				// Away from zero length
+				normal[0][i] += static_cast<T>(3);
+
+				weight[0][i] = std::fabs(p[6]) * static_cast<T>(0.5);
+				weight[1][i] = one - weight[0][i];
+				joint[0][i] = static_cast<u16>(i & 1);
+				joint[1][i] = static_cast<u16>(1 - (i & 1));
+			}
+
+			skinstreams<T> streams = {};
+			for (size_t c = 0; c < 3; c++)
+			{
+				streams.position[c] = position[c];
+				streams.normal[c] = normal[c];
+				streams.outposition[c] = outposition[c];
+				streams.outnormal[c] = outnormal[c];
+			}
+
+			streams.joint[0] = joint[0];
+			streams.joint[1] = joint[1];
+			streams.weight[0] = weight[0];
+			streams.weight[1] = weight[1];
+			streams.influences = 2;
+
+			if constexpr (Dualquat)
+				sml::skindualquat(dualquats, streams, block);
+			else
+				sml::skinlinear(matrices, streams, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				for (size_t c = 0; c < 3; c++)
+				{
+					o[6 * i + c] = outposition[c][i];
+					o[6 * i + 3 + c] = outnormal[c][i];
+				}
+			}
+		});
+	}
+
+	// Integers, the inputs are uniform in [-30000, 30000] so products don't overflow
+
+	void ivec4add(const void* in, void* out, size_t count)
+	{
+		each<s32, 8, 4>(in, out, count, [](const s32* a, s32* o) { put(o, v4(a) + v4(a + 4)); });
+	}
+
+	void ivec4sub(const void* in, void* out, size_t count)
+	{
+		each<s32, 8, 4>(in, out, count, [](const s32* a, s32* o) { put(o, v4(a) - v4(a + 4)); });
+	}
+
+	void ivec4mul(const void* in, void* out, size_t count)
+	{
+		each<s32, 8, 4>(in, out, count, [](const s32* a, s32* o) { put(o, v4(a) * v4(a + 4)); });
+	}
+
+	void ivec4minmax(const void* in, void* out, size_t count)
+	{
+		each<s32, 8, 8>(in, out, count, [](const s32* a, s32* o)
+		{
+			put(o, ivec4::min(v4(a), v4(a + 4)));
+			put(o + 4, ivec4::max(v4(a), v4(a + 4)));
+		});
+	}
+
+	void ivec4compare(const void* in, void* out, size_t count)
+	{
+		each<s32, 8, 3>(in, out, count, [](const s32* a, s32* o)
+		{
+			ivec4 x = v4(a);
+			ivec4 y(a[4] / 1000, a[5] / 1000, a[6] / 1000, a[7] / 1000);
+			ivec4 rx(a[0] / 1000, a[1] / 1000, a[2] / 1000, a[3] / 1000);
+
+			o[0] = sml::lessThan(x, v4(a + 4)).bits();
+			o[1] = sml::equal(rx, y).bits();
+			o[2] = sml::greaterEqual(rx, y).bits();
+		});
+	}
+
+	void ivec4divide(const void* in, void* out, size_t count)
+	{
+		each<s32, 5, 4>(in, out, count, [](const s32* a, s32* o)
+		{
+			s32 d = a[4] / 300;
+			idivider divider(d != 0 ? d : 7);
+
+			put(o, v4(a) / divider);
+		});
+	}
+
+	void ivec4dividearray(const void* in, void* out, size_t count)
+	{
+		each<s32, 4 * block + 1, 4 * block>(in, out, count, [](const s32* a, s32* o)
+		{
+			ivec4 x[block], r[block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				x[i] = v4(a + 4 * i);
+			}
+
+			s32 d = a[4 * block] / 300;
+			sml::divide(x, idivider(d != 0 ? d : -3), r, block);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				put(o + 4 * i, r[i]);
+			}
+		});
+	}
+
+	// Noise, 'block' points scaled to span a few lattice cells, two octave fractal sum with its
+	// derivative
+	template<typename T, noisetype Type>
+	void noise(const void* in, void* out, size_t count)
+	{
+		each<T, 3 * block, 4 * block>(in, out, count, [](const T* a, T* o)
+		{
+			T p[3][block], r[4][block];
+
+			for (size_t i = 0; i < block; i++)
+			{
+				for (size_t k = 0; k < 3; k++)
+				{
+					p[k][i] = a[3 * i + k] * static_cast<T>(3);
+				}
+			}
+
+			fbmparams<T> params;
+			params.octaves = 2;
+
+			noisestreams<T> streams = { { p[0], p[1], p[2], nullptr }, 3, r[0], { r[1], r[2], r[3], nullptr }, nullptr };
+			sml::fbm(Type, streams, block, params);
+
+			for (size_t i = 0; i < block; i++)
+			{
+				for (size_t k = 0; k < 4; k++)
+				{
+					o[4 * i + k] = r[k][i];
+				}
+			}
+		});
+	}
+
+	template<typename T, size_t In, size_t Out>
+	constexpr operation entry(const char* name, void (*run)(const void*, void*, size_t), double ulps = 4.0, double absolute = defaultabsolute<T>()) noexcept
+	{
+		return operation { name, typeof<T>(), In, Out, ulps, absolute, run };
+	}
+
+	// Every backend fills in the same table, in the same order
+	const operation operations[] =
+	{
+		entry<f32, 4, 2>("fvec2 add", &vec2add<f32>),
+		entry<f32, 4, 2>("fvec2 mul", &vec2mul<f32>),
+		entry<f32, 2, 2>("fvec2 normalize", &vec2normalize<f32>),
+		entry<f32, 6, 3>("fvec3 add", &vec3add<f32>),
+		entry<f32, 6, 3>("fvec3 sub", &vec3sub<f32>),
+		entry<f32, 6, 3>("fvec3 mul", &vec3mul<f32>),
+		entry<f32, 6, 3>("fvec3 div", &vec3div<f32>),
+		entry<f32, 4, 3>("fvec3 scale", &vec3scale<f32>),
+		entry<f32, 6, 1>("fvec3 dot", &vec3dot<f32>),
+		entry<f32, 6, 3>("fvec3 cross", &vec3cross<f32>),
+		entry<f32, 3, 1>("fvec3 length", &vec3length<f32>),
+		entry<f32, 3, 3>("fvec3 normalize", &vec3normalize<f32>),
+		entry<f32, 3, 3>("fvec3 normalizeFast", &vec3normalizefast<f32>, 64.0),
+		entry<f32, 7, 3>("fvec3 lerp", &vec3lerp<f32>),
+		entry<f32, 6, 6>("fvec3 min/max", &vec3minmax<f32>, 0.0, 0.0),
+		entry<f32, 8, 4>("fvec4 add", &vec4add<f32>),
+		entry<f32, 8, 4>("fvec4 mul", &vec4mul<f32>),
+		entry<f32, 8, 1>("fvec4 dot", &vec4dot<f32>),
+		entry<f32, 4, 4>("fvec4 normalize", &vec4normalize<f32>),
+		entry<f32, 4, 4>("fvec4 normalizeFast", &vec4normalizefast<f32>, 64.0),
+		entry<f32, 8, 8>("fvec4 min/max", &vec4minmax<f32>, 0.0, 0.0),
+		entry<f32, 8, 4>("fmat2 mul", &mat2mul<f32>),
+		entry<f32, 4, 4>("fmat2 inverse", &mat2inverse<f32>),
+		entry<f32, 4, 2>("fmat2 ==/!=", &mat2equal<f32>, 0.0, 0.0),
+		entry<f32, 18, 9>("fmat3 mul", &mat3mul<f32>),
+		entry<f32, 12, 3>("fmat3 * fvec3", &mat3transform<f32>),
+		entry<f32, 9, 9>("fmat3 inverse", &mat3inverse<f32>, 16.0),
+		entry<f32, 9, 1>("fmat3 determinant", &mat3determinant<f32>, 16.0),
+		entry<f32, 32, 16>("fmat4 mul", &mat4mul<f32>),
+		entry<f32, 20, 4>("fmat4 * fvec4", &mat4transform<f32>),
+		entry<f32, 17, 16>("fmat4 scale", &mat4scale<f32>),
+		entry<f32, 16, 16>("fmat4 transpose", &mat4transpose<f32>, 0.0, 0.0),
+		entry<f32, 16, 16>("fmat4 inverse", &mat4inverse<f32>, 16.0),
+		entry<f32, 16, 1>("fmat4 determinant", &mat4determinant<f32>, 16.0),
+		entry<f32, 16, 2>("fmat4 ==/!=", &mat4equal<f32>, 0.0, 0.0),
+		entry<f32, 10, 16>("fmat4 compose", &mat4compose<f32>),
+		entry<f32, 10, 10>("fmat4 decompose", &mat4decompose<f32>, 64.0),
+		entry<f32, 8, 4>("fquat mul", &quatmul<f32>),
+		entry<f32, 7, 3>("fquat * fvec3", &quatrotate<f32>),
+		entry<f32, 4, 4>("fquat normalize", &quatnormalize<f32>),
+		entry<f32, 9, 4>("fquat slerp", &quatslerp<f32>, 64.0),
+		entry<f32, 4, 4>("fquat frommatrix3", &quatfrommatrix3<f32>, 64.0),
+		entry<f32, 4 * block, 4 * block>("fquat frommatrix3 array", &quatfrommatrix3array<f32>, 64.0),
+		entry<f32, 14, 7>("fdualquat mul", &dualquatmul<f32>),
+		entry<f32, 10, 3>("fdualquat transformPoint", &dualquattransform<f32>),
+		entry<f32, 8 * block, 4 * block>("fvec4 array add", &arrayadd<f32>),
+		entry<f32, 8 * block, 8 * block>("fvec4 array min/max", &arrayminmax<f32>, 0.0, 0.0),
+		entry<f32, 4 * block + 1, 4 * block>("fvec4 array scale", &arrayscale<f32>),
+		entry<f32, 3 * block, 3 * block>("fvec3 array normalize", &arraynormalize<f32, false>),
+		entry<f32, 3 * block, 3 * block>("fvec3 array normalizeFast", &arraynormalize<f32, true>, 64.0),
+		entry<f32, 4 * block, 12>("fvec4 sum/minimum/maximum", &reducesum<f32>),
+		entry<f32, 8, 7>("fvec4 compare/select", &maskcompare<f32>, 0.0, 0.0),
+		entry<f32, 10 * block, 16 * block>("ftrs compose", &trscompose<f32>),
+		entry<f32, 10 * block, 10 * block>("ftrs decompose", &trsdecompose<f32>, 64.0),
+		entry<f32, 20 + 7 * block, 6 * block>("fskin linear", &skin<f32, false>, 16.0),
+		entry<f32, 20 + 7 * block, 6 * block>("fskin dualquat", &skin<f32, true>, 16.0),
+		entry<f32, 3 * block, 4 * block>("fperlin fbm", &noise<f32, noisetype::perlin>, 64.0, 2e-4),
+		entry<f32, 3 * block, 4 * block>("fsimplex fbm", &noise<f32, noisetype::simplex>, 64.0, 2e-4),
+
+		entry<f64, 4, 2>("dvec2 add", &vec2add<f64>),
+		entry<f64, 2, 2>("dvec2 normalize", &vec2normalize<f64>),
+		entry<f64, 6, 3>("dvec3 add", &vec3add<f64>),
+		entry<f64, 6, 3>("dvec3 div", &vec3div<f64>),
+		entry<f64, 6, 1>("dvec3 dot", &vec3dot<f64>),
+		entry<f64, 6, 3>("dvec3 cross", &vec3cross<f64>),
+		entry<f64, 3, 3>("dvec3 normalize", &vec3normalize<f64>),
+		entry<f64, 6, 6>("dvec3 min/max", &vec3minmax<f64>, 0.0, 0.0),
+		entry<f64, 8, 4>("dvec4 mul", &vec4mul<f64>),
+		entry<f64, 8, 1>("dvec4 dot", &vec4dot<f64>),
+		entry<f64, 4, 4>("dvec4 normalize", &vec4normalize<f64>),
+		entry<f64, 8, 4>("dmat2 mul", &mat2mul<f64>),
+		entry<f64, 4, 4>("dmat2 inverse", &mat2inverse<f64>),
+		entry<f64, 4, 2>("dmat2 ==/!=", &mat2equal<f64>, 0.0, 0.0),
+		entry<f64, 18, 9>("dmat3 mul", &mat3mul<f64>),
+		entry<f64, 9, 9>("dmat3 inverse", &mat3inverse<f64>, 16.0),
+		entry<f64, 32, 16>("dmat4 mul", &mat4mul<f64>),
+		entry<f64, 20, 4>("dmat4 * dvec4", &mat4transform<f64>),
+		entry<f64, 16, 16>("dmat4 inverse", &mat4inverse<f64>, 16.0),
+		entry<f64, 16, 2>("dmat4 ==/!=", &mat4equal<f64>, 0.0, 0.0),
+		entry<f64, 10, 10>("dmat4 decompose", &mat4decompose<f64>, 64.0),
+		entry<f64, 7, 3>("dquat * dvec3", &quatrotate<f64>),
+		entry<f64, 4 * block, 4 * block>("dquat frommatrix3 array", &quatfrommatrix3array<f64>, 64.0),
+		entry<f64, 8 * block, 4 * block>("dvec4 array add", &arrayadd<f64>),
+		entry<f64, 3 * block, 3 * block>("dvec3 array normalize", &arraynormalize<f64, false>),
+		entry<f64, 4 * block, 12>("dvec4 sum/minimum/maximum", &reducesum<f64>),
+		entry<f64, 10 * block, 16 * block>("dtrs compose", &trscompose<f64>),
+		entry<f64, 20 + 7 * block, 6 * block>("dskin linear", &skin<f64, false>, 16.0),
+		entry<f64, 3 * block, 4 * block>("dsimplex fbm", &noise<f64, noisetype::simplex>, 64.0, 1e-11),
+
+		entry<s32, 8, 4>("ivec4 add", &ivec4add, 0.0),
+		entry<s32, 8, 4>("ivec4 sub", &ivec4sub, 0.0),
+		entry<s32, 8, 4>("ivec4 mul", &ivec4mul, 0.0),
+		entry<s32, 8, 8>("ivec4 min/max", &ivec4minmax, 0.0),
+		entry<s32, 8, 3>("ivec4 compare", &ivec4compare, 0.0),
+		entry<s32, 5, 4>("ivec4 / idivider", &ivec4divide, 0.0),
+		entry<s32, 4 * block + 1, 4 * block>("ivec4 array divide", &ivec4dividearray, 0.0)
+	};
+} // namespace
+} // namespace differential
@@ -0,0 +1,139 @@
+#include <arclength.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// Length by summing many short arclength() pieces
+static f64 reference(const dcurve3& curve, f64 t0, f64 t1)
+{
+	const s32 pieces = 256;
+	f64 length = 0;
+
+	for (s32 i = 0; i < pieces; i++)
+	{
+		length += arclength(curve, t0 + (t1 - t0) * i / pieces, t0 + (t1 - t0) * (i + 1) / pieces);
+	}
+
+	return length;
+}
+
+// QUADRATURE TESTS
+
+TEST(arclength, Quadrature)
+{
+	// A straight line at constant speed and a quarter circle approximation
+	dcurve3 line = dcurve3::bezier(dvec3(0, 0, 0), dvec3(1, 0, 0), dvec3(2, 0, 0), dvec3(3, 0, 0));
+	EXPECT_NEAR(arclength(line), 3.0, 1e-12);
+	EXPECT_NEAR(arclength(line, 0.25, 0.5), 0.75, 1e-12);
+
+	const f64 k = 0.5522847498;
+	dcurve3 arc = dcurve3::bezier(dvec3(1, 0, 0), dvec3(1, k, 0), dvec3(k, 1, 0), dvec3(0, 1, 0));
+	EXPECT_NEAR(reference(arc, 0, 1), 1.5707963, 1e-3);
+	EXPECT_NEAR(arclength(arc), reference(arc, 0, 1), 1e-4);
+}
+
+// TABLE TESTS
+
+TEST(arclength, Table)
+{
+	dvec3 points[6] = { dvec3(0, 0, 0), dvec3(0, 0, 0), dvec3(4, 1, 0), dvec3(5, 6, 2), dvec3(-2, 3, 1), dvec3(-2, 3, 1) };
+	std::vector<dcurve3> curves;
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		curves.push_back(dcurve3::catmullrom(points[i], points[i + 1], points[i + 2], points[i + 3]));
+	}
+
+	darclength3 table(curves.data(), curves.size());
+	f64 length = reference(curves[0], 0, 1) + reference(curves[1], 0, 1) + reference(curves[2], 0, 1);
+
+	EXPECT_EQ(table.segments(), 3u);
+	EXPECT_NEAR(table.length(), length, 1e-9 * length);
+	EXPECT_DOUBLE_EQ(table.tToDistance(0), 0.0);
+	EXPECT_DOUBLE_EQ(table.tToDistance(3), table.length());
+	EXPECT_DOUBLE_EQ(table.tToDistance(-1), 0.0);
+	EXPECT_DOUBLE_EQ(table.distanceToT(table.length() * 2), 3.0);
+
+	for (f64 t = 0; t <= 3.0; t += 0.0625)
+	{
+		size_t segment = std::min(static_cast<size_t>(t), static_cast<size_t>(2));
+		f64 distance = 0;
+
+		for (size_t i = 0; i < segment; i++)
+		{
+			distance += reference(curves[i], 0, 1);
+		}
+
+		distance += reference(curves[segment], 0, t - segment);
+
+		EXPECT_NEAR(table.tToDistance(t), distance, 1e-5 * length);
+		EXPECT_NEAR(table.distanceToT(table.tToDistance(t)), t, 1e-5);
+	}
+}
+
+TEST(arclength, ConstantSpeed)
+{
+	// The ends have zero speed, so uniform t bunches up there
+	fcurve3 curve = fcurve3::bezier(fvec3(0, 0, 0), fvec3(0, 0, 0), fvec3(10, 5, 0), fvec3(10, 5, 0));
+	farclength3 table(&curve, 1, 32);
+
+	const size_t steps = 50;
+	f32 spacing = table.length() / steps;
+
+	for (size_t i = 0; i < steps; i++)
+	{
+		fvec3 a = curve.evaluate(table.distanceToT(spacing * i));
+		fvec3 b = curve.evaluate(table.distanceToT(spacing * (i + 1)));
+		// One Newton step leaves some error in the second point from either stop
+		f32 tolerance = i < 2 || i + 2 >= steps ? 2e-2f : 1e-3f;
+		EXPECT_NEAR((b - a).length(), spacing, tolerance * spacing);
+	}
+}
+
+template<typename T>
+static void testarrays()
+{
+	std::vector<cubiccurve<vec2, T>> curves;
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		T s = static_cast<T>(i);
+		curves.push_back(cubiccurve<vec2, T>::bezier(vec2<T>(s, 0), vec2<T>(s + 1, 2), vec2<T>(s, 3), vec2<T>(s + 2, 1)));
+	}
+
+	arclengthtable<vec2, T> table(curves.data(), curves.size(), 8);
+	std::vector<T> t(45), distances(45), fromt(45), fromdistance(45);
+
+	for (size_t i = 0; i < t.size(); i++)
+	{
+		t[i] = static_cast<T>(i) / static_cast<T>(10) - static_cast<T>(0.2);
+		distances[i] = table.length() * (static_cast<T>(i) / static_cast<T>(40) - static_cast<T>(0.05));
+	}
+
+	table.tToDistance(t.data(), t.size(), fromt.data());
+	table.distanceToT(distances.data(), distances.size(), fromdistance.data());
+
+	for (size_t i = 0; i < t.size(); i++)
+	{
+		EXPECT_NEAR(fromt[i], table.tToDistance(t[i]), table.length() * static_cast<T>(1e-6));
+		EXPECT_NEAR(fromdistance[i], table.distanceToT(distances[i]), static_cast<T>(1e-5));
+	}
+}
+
+TEST(arclength, Arrays)
+{
+	testarrays<f32>();
+	testarrays<f64>();
+
+	// An empty table maps everything to zero
+	darclength3 empty;
+	f64 in[5] = { 0, 1, 2, 3, 4 }, out[5];
+	empty.distanceToT(in, 5, out);
+
+	EXPECT_DOUBLE_EQ(out[4], 0.0);
+	EXPECT_DOUBLE_EQ(empty.tToDistance(1), 0.0);
+	EXPECT_DOUBLE_EQ(empty.length(), 0.0);
+}
@@ -0,0 +1,423 @@
+#include <divider.h>
+#include <vecarray.h>
+#include <reduce.h>
+#include <trs.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// INTDIVIDER TESTS
+
+TEST(idivider, Scalar)
+{
+	const s32 divisors[] = { 1, -1, 2, -2, 3, 7, -7, 10, 16, 641, -1000, 0x7FFFFFFF, static_cast<s32>(0x80000000) };
+	const s32 values[] = { 0, 1, -1, 5, -5, 99, -99, 12345678, -12345678, 0x7FFFFFFF, static_cast<s32>(0x80000001), static_cast<s32>(0x80000000) };
+
+	for (s32 d : divisors)
+	{
+		idivider divider(d);
+
+		for (s32 n : values)
+		{
+			// INT_MIN / -1 overflows
+			if (d == -1 && n == static_cast<s32>(0x80000000))
+				continue;
+
+			EXPECT_EQ(divider.divide(n), n / d) << n << " / " << d;
+			EXPECT_EQ((ivec4(n, n, n, n) / divider).x, n / d) << n << " / " << d;
+		}
+	}
+}
+
+TEST(udivider, Scalar)
+{
+	const u32 divisors[] = { 1, 2, 3, 7, 10, 16, 641, 1000, 0x7FFFFFFFu, 0x80000000u, 0x80000001u, 0xFFFFFFFFu };
+	const u32 values[] = { 0, 1, 5, 99, 12345678, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFEu, 0xFFFFFFFFu };
+
+	for (u32 d : divisors)
+	{
+		udivider divider(d);
+
+		for (u32 n : values)
+		{
+			EXPECT_EQ(divider.divide(n), n / d) << n << " / " << d;
+		}
+	}
+}
+
+TEST(idivider, Vector)
+{
+	idivider divider(-7);
+	ivec3 v(100, -100, 7);
+
+	ivec3 r = v / divider;
+
+	EXPECT_EQ(r.x, -14);
+	EXPECT_EQ(r.y, 14);
+	EXPECT_EQ(r.z, -1);
+}
+
+TEST(udivider, Vector)
+{
+	udivider divider(16);
+	uvec4 v(100, 0xFFFFFFFFu, 15, 16);
+
+	uvec4 r = v / divider;
+
+	EXPECT_EQ(r.x, 6u);
+	EXPECT_EQ(r.y, 0x0FFFFFFFu);
+	EXPECT_EQ(r.z, 0u);
+	EXPECT_EQ(r.w, 1u);
+}
+
+// ARRAY KERNEL TESTS
+
+TEST(vecarray, IntegerAdd)
+{
+	std::vector<ivec3> a, b, out(7);
+	for (s32 i = 0; i < 7; i++)
+	{
+		a.emplace_back(i, -i, 2 * i);
+		b.emplace_back(10, 20, -30);
+	}
+
+	sml::add(a.data(), b.data(), out.data(), out.size());
+
+	for (s32 i = 0; i < 7; i++)
+	{
+		EXPECT_EQ(out[i], ivec3(i + 10, 20 - i, 2 * i - 30));
+	}
+}
+
+TEST(vecarray, IntegerMinMax)
+{
+	std::vector<uvec3> a, b, lo(5), hi(5);
+	for (u32 i = 0; i < 5; i++)
+	{
+		a.emplace_back(i, 0xFFFFFFFFu - i, 3);
+		b.emplace_back(2, 2, 2);
+	}
+
+	sml::min(a.data(), b.data(), lo.data(), lo.size());
+	sml::max(a.data(), b.data(), hi.data(), hi.size());
+
+	for (u32 i = 0; i < 5; i++)
+	{
+		EXPECT_EQ(lo[i], uvec3(i < 2 ? i : 2, 2, 2));
+		EXPECT_EQ(hi[i], uvec3(i > 2 ? i : 2, 0xFFFFFFFFu - i, 3));
+	}
+}
+
+TEST(vecarray, IntegerScaleAndDivide)
+{
+	std::vector<ivec4> a, out(9);
+	for (s32 i = 0; i < 9; i++)
+	{
+		a.emplace_back(i, -i, 100 * i, -1000 * i);
+	}
+
+	sml::scale(a.data(), 3, out.data(), out.size());
+	sml::divide(out.data(), idivider(3), out.data(), out.size());
+
+	for (s32 i = 0; i < 9; i++)
+	{
+		EXPECT_EQ(out[i], a[i]);
+	}
+}
+
+TEST(vecarray, FloatMul)
+{
+	std::vector<fvec3> a, b, out(3);
+	for (s32 i = 0; i < 3; i++)
+	{
+		a.emplace_back(static_cast<f32>(i), 2.0f, 0.5f);
+		b.emplace_back(2.0f, static_cast<f32>(i), 4.0f);
+	}
+
+	sml::mul(a.data(), b.data(), out.data(), out.size());
+
+	for (s32 i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(out[i], fvec3(2.0f * i, 2.0f * i, 2.0f));
+	}
+}
+
+TEST(vecarray, DoubleSub)
+{
+	std::vector<dvec2> a, b, out(3);
+	for (s32 i = 0; i < 3; i++)
+	{
+		a.emplace_back(static_cast<f64>(i), 2.0);
+		b.emplace_back(1.0, static_cast<f64>(i));
+	}
+
+	sml::sub(a.data(), b.data(), out.data(), out.size());
+
+	for (s32 i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(out[i], dvec2(i - 1.0, 2.0 - i));
+	}
+}
+
+// REDUCTION TESTS
+
+TEST(reduce, Sum)
+{
+	std::vector<fvec3> f;
+	std::vector<dvec3> d;
+	std::vector<ivec2> i;
+	for (s32 n = 0; n < 1001; n++)
+	{
+		f.emplace_back(1.0f, static_cast<f32>(n), -2.0f);
+		d.emplace_back(1.0, static_cast<f64>(n), -2.0);
+		i.emplace_back(1, n);
+	}
+
+	EXPECT_EQ(sum(f.data(), f.size()), fvec3(1001, 500500, -2002));
+	EXPECT_EQ(sum(d.data(), d.size()), dvec3(1001, 500500, -2002));
+	EXPECT_EQ(sum(i.data(), i.size()), ivec2(1001, 500500));
+}
+
+TEST(reduce, PairwiseSumAccuracy)
+{
+	std::vector<fvec4> values(1 << 22, fvec4(0.1f));
+
+	fvec4 s = sum(values.data(), values.size());
+
+	EXPECT_NEAR(s.x, 0.1 * (1 << 22), 1.0);
+	EXPECT_NEAR(s.w, 0.1 * (1 << 22), 1.0);
+}
+
+TEST(reduce, MinimumMaximum)
+{
+	std::vector<fvec3> f;
+	std::vector<ivec3> i;
+	for (s32 n = 0; n < 11; n++)
+	{
+		f.emplace_back(static_cast<f32>(n), static_cast<f32>(-n), static_cast<f32>(n % 3));
+		i.emplace_back(n, -n, n % 3);
+	}
+
+	EXPECT_EQ(minimum(f.data(), f.size()), fvec3(0, -10, 0));
+	EXPECT_EQ(maximum(f.data(), f.size()), fvec3(10, 0, 2));
+	EXPECT_EQ(minimum(i.data(), i.size()), ivec3(0, -10, 0));
+	EXPECT_EQ(maximum(i.data(), i.size()), ivec3(10, 0, 2));
+}
+
+TEST(reduce, Bounds)
+{
+	dvec3 values[] = { dvec3(1, 2, 3), dvec3(-1, 5, 0), dvec3(4, -2, 1), dvec3(0, 0, 7) };
+
+	dvec3 lo, hi;
+	bounds(values, 4, lo, hi);
+
+	EXPECT_EQ(lo, dvec3(-1, -2, 0));
+	EXPECT_EQ(hi, dvec3(4, 5, 7));
+}
+
+TEST(reduce, CentroidVariance)
+{
+	fvec2 values[] = { fvec2(1, 10), fvec2(3, 10), fvec2(5, 10), fvec2(7, 10) };
+
+	EXPECT_EQ(centroid(values, 4), fvec2(4, 10));
+	EXPECT_EQ(variance(values, 4), fvec2(5, 0));
+}
+
+TEST(reduce, Covariance)
+{
+	// Points on the line y = 2x, z = -x
+	std::vector<dvec3> values;
+	for (s32 n = -3; n <= 3; n++)
+	{
+		values.emplace_back(static_cast<f64>(n), 2.0 * n, -1.0 * n);
+	}
+
+	dmat3 c = covariance(values.data(), values.size());
+
+	EXPECT_DOUBLE_EQ(c.m00, 4);
+	EXPECT_DOUBLE_EQ(c.m11, 16);
+	EXPECT_DOUBLE_EQ(c.m22, 4);
+	EXPECT_DOUBLE_EQ(c.m01, 8);
+	EXPECT_DOUBLE_EQ(c.m10, 8);
+	EXPECT_DOUBLE_EQ(c.m12, -8);
+	EXPECT_DOUBLE_EQ(c.m02, -4);
+	EXPECT_DOUBLE_EQ(c.m20, -4);
+}
+
+TEST(reduce, MaxLength)
+{
+	fvec3 values[] = { fvec3(1, 0, 0), fvec3(0, 3, 4), fvec3(-2, 0, 0), fvec3(0, 0, -5) };
+
+	EXPECT_EQ(argmaxlength(values, 4), 1u);
+	EXPECT_EQ(maxlength(values, 4), 5);
+}
+
+// NORMALIZE TESTS
+
+TEST(vecarray, NormalizeFloat)
+{
+	std::vector<fvec3> values, fast;
+	for (s32 i = 0; i < 11; i++)
+	{
+		values.emplace_back(static_cast<f32>(i), 2.0f - i, 0.5f * i);
+	}
+	values[3].zero();
+	fast = values;
+
+	sml::normalize(values.data(), values.size());
+	sml::normalizeFast(fast.data(), fast.size());
+
+	for (s32 i = 0; i < 11; i++)
+	{
+		fvec3 expected = i == 3 ? fvec3(0, 0, 0) : fvec3(static_cast<f32>(i), 2.0f - i, 0.5f * i).normalized();
+
+		EXPECT_NEAR(values[i].x, expected.x, 1e-6f);
+		EXPECT_NEAR(values[i].y, expected.y, 1e-6f);
+		EXPECT_NEAR(values[i].z, expected.z, 1e-6f);
+		EXPECT_EQ(values[i].v[3], 0);
+
+		EXPECT_NEAR(fast[i].x, expected.x, 1e-6f);
+		EXPECT_NEAR(fast[i].y, expected.y, 1e-6f);
+		EXPECT_NEAR(fast[i].z, expected.z, 1e-6f);
+		EXPECT_EQ(fast[i].v[3], 0);
+	}
+}
+
+TEST(vecarray, NormalizeDouble)
+{
+	std::vector<dvec4> values;
+	for (s32 i = 0; i < 5; i++)
+	{
+		values.emplace_back(static_cast<f64>(i), 2.0 - i, 0.5 * i, 1.0);
+	}
+
+	sml::normalizeFast(values.data(), values.size());
+
+	for (s32 i = 0; i < 5; i++)
+	{
+		EXPECT_NEAR(values[i].length(), 1.0, 1e-12);
+	}
+}
+
+// TRS TESTS
+
+TEST(trs, ComposeDecomposeFloat)
+{
+	const size_t count = 19;
+	std::vector<f32> data(10 * count);
+	std::vector<f32> back(10 * count);
+
+	trsarray<f32> trs = { &data[0], &data[count], &data[2 * count], &data[3 * count], &data[4 * count], &data[5 * count], &data[6 * count], &data[7 * count], &data[8 * count], &data[9 * count] };
+	trsarray<f32> res = { &back[0], &back[count], &back[2 * count], &back[3 * count], &back[4 * count], &back[5 * count], &back[6 * count], &back[7 * count], &back[8 * count], &back[9 * count] };
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fquat q = fquat::euler(i * 17.0f, i * 31.0f - 90, i * 7.0f);
+
+		trs.tx[i] = static_cast<f32>(i);
+		trs.ty[i] = -static_cast<f32>(i);
+		trs.tz[i] = 0.5f * i;
+		trs.qx[i] = q.x;
+		trs.qy[i] = q.y;
+		trs.qz[i] = q.z;
+		trs.qw[i] = q.w;
+		trs.sx[i] = 1.0f + i;
+		trs.sy[i] = 2.0f;
+		trs.sz[i] = i % 2 == 0 ? 0.5f : -0.5f;
+	}
+
+	std::vector<fmat4> matrices(count);
+	sml::compose(trs, matrices.data(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fmat4 expected = fmat4::compose(fvec3(trs.tx[i], trs.ty[i], trs.tz[i]), fquat(trs.qx[i], trs.qy[i], trs.qz[i], trs.qw[i]), fvec3(trs.sx[i], trs.sy[i], trs.sz[i]));
+
+		for (s32 j = 0; j < 16; j++)
+		{
+			EXPECT_FLOAT_EQ(matrices[i].v[j], expected.v[j]);
+		}
+	}
+
+	EXPECT_EQ(sml::decompose(matrices.data(), res, count), 0u);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fvec3 translation, scale;
+		fquat rotation;
+		matrices[i].decompose(translation, rotation, scale);
+
+		EXPECT_EQ(res.tx[i], trs.tx[i]);
+		EXPECT_EQ(res.ty[i], trs.ty[i]);
+		EXPECT_EQ(res.tz[i], trs.tz[i]);
+
+		EXPECT_NEAR(res.sx[i], trs.sx[i], 1e-4f);
+		EXPECT_NEAR(res.sy[i], trs.sy[i], 1e-4f);
+		EXPECT_NEAR(res.sz[i], trs.sz[i], 1e-4f);
+
+		EXPECT_NEAR(res.qx[i], rotation.x, 1e-5f);
+		EXPECT_NEAR(res.qy[i], rotation.y, 1e-5f);
+		EXPECT_NEAR(res.qz[i], rotation.z, 1e-5f);
+		EXPECT_NEAR(res.qw[i], rotation.w, 1e-5f);
+
+		f32 dot = res.qx[i] * trs.qx[i] + res.qy[i] * trs.qy[i] + res.qz[i] * trs.qz[i] + res.qw[i] * trs.qw[i];
+		EXPECT_NEAR(sml::abs(dot), 1, 1e-5f);
+	}
+}
+
+TEST(trs, DecomposeDegenerate)
+{
+	// Degenerate matrices both in the SIMD blocks and in the scalar tail
+	const size_t count = 11;
+	const dvec3 t(1, 2, 3);
+	const dquat q = dquat::euler(10, 20, 30);
+
+	std::vector<dmat4> matrices(count, dmat4::compose(t, q, dvec3(1, 1, 1)));
+	matrices[1] = dmat4::compose(t, q, dvec3(0, 1, 1));
+	matrices[2] = dmat4::compose(t, q, dvec3(1, 0, 1));
+	matrices[5] = dmat4::compose(t, q, dvec3(0, 0, 1));
+	matrices[6] = dmat4::compose(t, q, dvec3(0, 0, 0));
+	matrices[9] = dmat4::scale(dvec3(1, 0, 1));
+	matrices[10] = dmat4::scale(dvec3(0, 0, 0));
+
+	std::vector<f64> data(10 * count);
+	trsarray<f64> trs = { &data[0], &data[count], &data[2 * count], &data[3 * count], &data[4 * count], &data[5 * count], &data[6 * count], &data[7 * count], &data[8 * count], &data[9 * count] };
+
+	EXPECT_EQ(sml::decompose(matrices.data(), trs, count), 6u);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		f64 length = trs.qx[i] * trs.qx[i] + trs.qy[i] * trs.qy[i] + trs.qz[i] * trs.qz[i] + trs.qw[i] * trs.qw[i];
+		EXPECT_NEAR(length, 1, 1e-12);
+
+		// The missing axes are rebuilt from the other columns, so composing gives back the matrix
+		dvec3 translation, scale;
+		dquat rotation;
+		matrices[i].decompose(translation, rotation, scale);
+
+		dmat4 single = dmat4::compose(translation, rotation, scale);
+		dmat4 array = dmat4::compose(dvec3(trs.tx[i], trs.ty[i], trs.tz[i]), dquat(trs.qx[i], trs.qy[i], trs.qz[i], trs.qw[i]), dvec3(trs.sx[i], trs.sy[i], trs.sz[i]));
+
+		for (s32 j = 0; j < 16; j++)
+		{
+			EXPECT_NEAR(single.v[j], matrices[i].v[j], 1e-12) << i << ", " << j;
+			EXPECT_NEAR(array.v[j], matrices[i].v[j], 1e-12) << i << ", " << j;
+		}
+	}
+
+	// Unit x still gives unit y and z when there is nothing left to build them from
+	dvec3 translation, scale;
+	dquat rotation;
+	EXPECT_FALSE(dmat4(0.0).decompose(translation, rotation, scale));
+	EXPECT_NEAR(rotation.w, 1, 1e-12);
+	EXPECT_NEAR(scale.length(), 0, 1e-12);
+
+	EXPECT_FALSE(dmat4::scale(dvec3(1, 0, 1)).decompose(translation, rotation, scale));
+	EXPECT_NEAR(rotation.w, 1, 1e-12);
+	EXPECT_NEAR(scale.x, 1, 1e-12);
+	EXPECT_NEAR(scale.y, 0, 1e-12);
+	EXPECT_NEAR(scale.z, 1, 1e-12);
+}
@@ -0,0 +1,236 @@
+#include <closest.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// Closest point on a triangle by dense sampling of its barycentric coordinates
+static f64 sampledtriangle(const dvec3& p, const dvec3& a, const dvec3& b, const dvec3& c)
+{
+	const s32 steps = 200;
+	f64 best = 1e300;
+
+	for (s32 i = 0; i <= steps; i++)
+	{
+		for (s32 j = 0; i + j <= steps; j++)
+		{
+			f64 v = static_cast<f64>(i) / steps, w = static_cast<f64>(j) / steps;
+			dvec3 d = p - (a + (b - a) * v + (c - a) * w);
+			best = std::min(best, d.dot(d));
+		}
+	}
+
+	return best;
+}
+
+// POINT QUERY TESTS
+
+TEST(closest, Segment)
+{
+	dvec3 a(0, 0, 0), b(2, 0, 0);
+
+	EXPECT_EQ(closestpointsegment(dvec3(1, 1, 0), a, b), dvec3(1, 0, 0));
+	EXPECT_EQ(closestpointsegment(dvec3(-1, 1, 0), a, b), a);
+	EXPECT_EQ(closestpointsegment(dvec3(3, 0, 4), a, b), b);
+	EXPECT_DOUBLE_EQ(distancesquaredsegment(dvec3(3, 0, 4), a, b), 17.0);
+	EXPECT_DOUBLE_EQ(distancesegment(dvec3(1, 3, 4), a, b), 5.0);
+
+	// Degenerate segment
+	EXPECT_EQ(closestpointsegment(dvec3(1, 1, 1), a, a), a);
+}
+
+TEST(closest, Triangle)
+{
+	rng r(31);
+
+	for (s32 i = 0; i < 200; i++)
+	{
+		dvec3 a = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1));
+		dvec3 b = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1));
+		dvec3 c = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1));
+		dvec3 p = r.inbox(dvec3(-2, -2, -2), dvec3(2, 2, 2));
+
+		dvec3 q = closestpointtriangle(p, a, b, c);
+
+		// On the triangle: the barycentric weights are in [0, 1] and the point is in its plane
+		dvec3 n = dvec3::cross(b - a, c - a);
+		EXPECT_NEAR(n.dot(q - a), 0.0, 1e-9);
+
+		f64 dsq = distancesquaredtriangle(p, a, b, c);
+		f64 sampled = sampledtriangle(p, a, b, c);
+
+		EXPECT_LE(dsq, sampled + 1e-12);
+		EXPECT_NEAR(dsq, sampled, 2e-3);
+	}
+
+	// Every Voronoi region
+	dvec3 a(0, 0, 0), b(1, 0, 0), c(0, 1, 0);
+
+	EXPECT_EQ(closestpointtriangle(dvec3(-1, -1, 1), a, b, c), a);
+	EXPECT_EQ(closestpointtriangle(dvec3(2, -1, 1), a, b, c), b);
+	EXPECT_EQ(closestpointtriangle(dvec3(-1, 2, 1), a, b, c), c);
+	EXPECT_EQ(closestpointtriangle(dvec3(0.5, -1, 1), a, b, c), dvec3(0.5, 0, 0));
+	EXPECT_EQ(closestpointtriangle(dvec3(-1, 0.5, 1), a, b, c), dvec3(0, 0.5, 0));
+	EXPECT_EQ(closestpointtriangle(dvec3(1, 1, 1), a, b, c), dvec3(0.5, 0.5, 0));
+	EXPECT_EQ(closestpointtriangle(dvec3(0.25, 0.25, 3), a, b, c), dvec3(0.25, 0.25, 0));
+	EXPECT_DOUBLE_EQ(distancetriangle(dvec3(0.25, 0.25, 3), a, b, c), 3.0);
+}
+
+TEST(closest, Aabb)
+{
+	fvec3 min(-1, -1, -1), max(1, 2, 3);
+
+	EXPECT_EQ(closestpointaabb(fvec3(0, 0, 0), min, max), fvec3(0, 0, 0));
+	EXPECT_EQ(closestpointaabb(fvec3(-3, 5, 1), min, max), fvec3(-1, 2, 1));
+	EXPECT_FLOAT_EQ(distancesquaredaabb(fvec3(0, 0, 0), min, max), 0.0f);
+	EXPECT_FLOAT_EQ(distancesquaredaabb(fvec3(-3, 5, 1), min, max), 13.0f);
+	EXPECT_FLOAT_EQ(distanceaabb(fvec3(4, 2, 7), min, max), 5.0f);
+}
+
+TEST(closest, Segments)
+{
+	dvec3 onp, onq;
+
+	// Crossing
+	EXPECT_DOUBLE_EQ(closestpointssegments(dvec3(-1, 0, 0), dvec3(1, 0, 0), dvec3(0, -1, 1), dvec3(0, 1, 1), onp, onq), 1.0);
+	EXPECT_EQ(onp, dvec3(0, 0, 0));
+	EXPECT_EQ(onq, dvec3(0, 0, 1));
+
+	// Parallel, overlapping
+	EXPECT_DOUBLE_EQ(distancesquaredsegments(dvec3(0, 0, 0), dvec3(2, 0, 0), dvec3(1, 2, 0), dvec3(3, 2, 0)), 4.0);
+
+	// Endpoint to endpoint
+	EXPECT_DOUBLE_EQ(distancesegments(dvec3(0, 0, 0), dvec3(1, 0, 0), dvec3(4, 4, 0), dvec3(4, 8, 0)), 5.0);
+
+	// Degenerate
+	EXPECT_DOUBLE_EQ(distancesquaredsegments(dvec3(0, 0, 0), dvec3(0, 0, 0), dvec3(-1, 1, 0), dvec3(1, 1, 0)), 1.0);
+	EXPECT_DOUBLE_EQ(distancesquaredsegments(dvec3(0, 0, 0), dvec3(0, 0, 0), dvec3(3, 4, 0), dvec3(3, 4, 0)), 25.0);
+
+	// Random pairs against sampling the first segment
+	rng r(2);
+	for (s32 i = 0; i < 100; i++)
+	{
+		dvec3 p0 = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1)), p1 = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1));
+		dvec3 q0 = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1)), q1 = r.inbox(dvec3(-1, -1, -1), dvec3(1, 1, 1));
+
+		f64 dsq = closestpointssegments(p0, p1, q0, q1, onp, onq);
+		f64 sampled = 1e300;
+
+		for (s32 s = 0; s <= 2000; s++)
+		{
+			sampled = std::min(sampled, distancesquaredsegment(p0 + (p1 - p0) * (s / 2000.0), q0, q1));
+		}
+
+		EXPECT_LE(dsq, sampled + 1e-12);
+		EXPECT_NEAR(dsq, sampled, 1e-5);
+	}
+}
+
+// ARRAY TESTS
+
+TEST(closest, TriangleArray)
+{
+	rng r(9);
+
+	const size_t count = 203;
+	std::vector<fvec3> vertices(count * 3);
+	std::vector<u32> indices(count * 3);
+	inbox(r, fvec3(-10, -10, -10), fvec3(10, 10, 10), vertices.data(), vertices.size());
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		indices[i] = static_cast<u32>((i * 5) % vertices.size());
+	}
+
+	for (s32 q = 0; q < 50; q++)
+	{
+		fvec3 p = r.inbox(fvec3(-12, -12, -12), fvec3(12, 12, 12));
+
+		size_t expected = count;
+		f32 expecteddsq = 1e30f;
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 d = distancesquaredtriangle(p, vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+			if (d < expecteddsq)
+			{
+				expecteddsq = d;
+				expected = i;
+			}
+		}
+
+		fvec3 closest;
+		f32 dsq;
+		ASSERT_EQ(closesttriangle(p, vertices.data(), static_cast<const u32*>(nullptr), count, &closest, &dsq), expected);
+		ASSERT_NEAR(dsq, expecteddsq, 1e-4f * (1.0f + expecteddsq));
+		ASSERT_NEAR((closest - p).dot(closest - p), expecteddsq, 1e-4f * (1.0f + expecteddsq));
+
+		size_t indexed = count;
+		f32 indexeddsq = 1e30f;
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 d = distancesquaredtriangle(p, vertices[indices[i * 3]], vertices[indices[i * 3 + 1]], vertices[indices[i * 3 + 2]]);
+			if (d < indexeddsq)
+			{
+				indexeddsq = d;
+				indexed = i;
+			}
+		}
+
+		ASSERT_EQ(closesttriangle(p, vertices.data(), indices.data(), count, &closest, &dsq), indexed);
+		ASSERT_NEAR(dsq, indexeddsq, 1e-4f * (1.0f + indexeddsq));
+	}
+
+	EXPECT_EQ(closesttriangle(fvec3(0, 0, 0), vertices.data(), static_cast<const u32*>(nullptr), 0), 0u);
+}
+
+TEST(closest, SegmentArray)
+{
+	rng r(10);
+
+	const size_t count = 37;
+	std::vector<dvec3> endpoints(count * 2);
+	inbox(r, dvec3(-5, -5, -5), dvec3(5, 5, 5), endpoints.data(), endpoints.size());
+
+	for (s32 q = 0; q < 50; q++)
+	{
+		dvec3 p = r.inbox(dvec3(-6, -6, -6), dvec3(6, 6, 6));
+
+		size_t expected = count;
+		f64 expecteddsq = 1e300;
+		for (size_t i = 0; i < count; i++)
+		{
+			f64 d = distancesquaredsegment(p, endpoints[i * 2], endpoints[i * 2 + 1]);
+			if (d < expecteddsq)
+			{
+				expecteddsq = d;
+				expected = i;
+			}
+		}
+
+		dvec3 closest;
+		f64 dsq;
+		ASSERT_EQ(closestsegment(p, endpoints.data(), count, &closest, &dsq), expected);
+		ASSERT_NEAR(dsq, expecteddsq, 1e-9);
+		ASSERT_NEAR((closest - p).dot(closest - p), expecteddsq, 1e-9);
+	}
+}
+
+TEST(closest, AabbArray)
+{
+	rng r(12);
+
+	std::vector<fvec3> points(29);
+	std::vector<f32> distances(points.size());
+	inbox(r, fvec3(-4, -4, -4), fvec3(4, 4, 4), points.data(), points.size());
+
+	fvec3 min(-1, -2, 0), max(1, 1, 3);
+	distancesquaredaabb(points.data(), points.size(), min, max, distances.data());
+
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		EXPECT_FLOAT_EQ(distances[i], distancesquaredaabb(points[i], min, max));
+	}
+}
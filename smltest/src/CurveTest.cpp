@@ -0,0 +1,190 @@
+#include <curve.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// Point on a Bezier curve by repeated lerps
+template<template<typename> class V, typename T>
+static V<T> decasteljau(const V<T>& p0, const V<T>& p1, const V<T>& p2, const V<T>& p3, T t)
+{
+	V<T> a = p0 + (p1 - p0) * t, b = p1 + (p2 - p1) * t, c = p2 + (p3 - p2) * t;
+	V<T> d = a + (b - a) * t, e = b + (c - b) * t;
+
+	return d + (e - d) * t;
+}
+
+// Distance from p to the polyline
+static f64 polylinedistance(const dvec3& p, const std::vector<dvec3>& points)
+{
+	f64 best = 1e300;
+
+	for (size_t i = 0; i + 1 < points.size(); i++)
+	{
+		dvec3 a = points[i], ab = points[i + 1] - a;
+		f64 t = clamp((p - a).dot(ab) / ab.dot(ab), 0.0, 1.0);
+		best = std::min(best, (p - (a + ab * t)).length());
+	}
+
+	return best;
+}
+
+// CONSTRUCTION TESTS
+
+TEST(curve, Bases)
+{
+	dvec3 p0(0, 0, 0), p1(1, 2, 0), p2(3, 2, 1), p3(4, 0, -1);
+	dcurve3 bezier = dcurve3::bezier(p0, p1, p2, p3);
+
+	for (f64 t = 0; t <= 1.0; t += 0.125)
+	{
+		dvec3 expected = decasteljau(p0, p1, p2, p3, t);
+		EXPECT_NEAR((bezier.evaluate(t) - expected).length(), 0.0, 1e-12);
+	}
+
+	dvec3 b0, b1, b2, b3;
+	bezier.bezierpoints(b0, b1, b2, b3);
+	EXPECT_NEAR((b1 - p1).length() + (b2 - p2).length() + (b3 - p3).length(), 0.0, 1e-12);
+
+	// Hermite ends at the given points with the given tangents
+	dcurve3 hermite = dcurve3::hermite(p0, dvec3(1, 0, 0), p3, dvec3(0, 1, 0));
+	EXPECT_EQ(hermite.evaluate(0), p0);
+	EXPECT_NEAR((hermite.evaluate(1) - p3).length(), 0.0, 1e-12);
+	EXPECT_NEAR((hermite.derivative(0) - dvec3(1, 0, 0)).length(), 0.0, 1e-12);
+	EXPECT_NEAR((hermite.derivative(1) - dvec3(0, 1, 0)).length(), 0.0, 1e-12);
+
+	// Catmull-Rom runs from p1 to p2 with tangents from the neighbours
+	dcurve3 catmullrom = dcurve3::catmullrom(p0, p1, p2, p3);
+	EXPECT_NEAR((catmullrom.evaluate(0) - p1).length(), 0.0, 1e-12);
+	EXPECT_NEAR((catmullrom.evaluate(1) - p2).length(), 0.0, 1e-12);
+	EXPECT_NEAR((catmullrom.derivative(0) - (p2 - p0) * 0.5).length(), 0.0, 1e-12);
+
+	// Derivatives against central differences
+	const f64 h = 1e-5;
+	dvec3 numeric = (bezier.evaluate(0.3 + h) - bezier.evaluate(0.3 - h)) / (2 * h);
+	EXPECT_NEAR((bezier.derivative(0.3) - numeric).length(), 0.0, 1e-8);
+	numeric = (bezier.derivative(0.3 + h) - bezier.derivative(0.3 - h)) / (2 * h);
+	EXPECT_NEAR((bezier.secondderivative(0.3) - numeric).length(), 0.0, 1e-8);
+}
+
+// BATCH TESTS
+
+template<template<typename> class V, typename T>
+static void testarrays(T epsilon)
+{
+	rng random(11);
+	std::vector<T> parameters(37);
+
+	for (T& t : parameters)
+	{
+		t = random.uniform<T>();
+	}
+
+	V<T> p[4];
+
+	for (V<T>& point : p)
+	{
+		for (size_t k = 0; k < veclanes<V>::value; k++)
+		{
+			point.v[k] = random.uniform<T>() * 10 - 5;
+		}
+	}
+
+	cubiccurve<V, T> curve = cubiccurve<V, T>::bezier(p[0], p[1], p[2], p[3]);
+	std::vector<V<T>> points(parameters.size()), derivatives(parameters.size());
+	curve.evaluate(parameters.data(), parameters.size(), points.data());
+	curve.derivative(parameters.data(), parameters.size(), derivatives.data());
+
+	for (size_t i = 0; i < parameters.size(); i++)
+	{
+		for (size_t k = 0; k < veclanes<V>::value; k++)
+		{
+			EXPECT_NEAR(points[i].v[k], curve.evaluate(parameters[i]).v[k], epsilon);
+			EXPECT_NEAR(derivatives[i].v[k], curve.derivative(parameters[i]).v[k], epsilon * 10);
+		}
+	}
+
+	// One parameter per curve
+	std::vector<cubiccurve<V, T>> curves(parameters.size());
+
+	for (size_t i = 0; i < curves.size(); i++)
+	{
+		curves[i] = cubiccurve<V, T>::catmullrom(p[i % 4], p[(i + 1) % 4], p[(i + 2) % 4], p[(i + 3) % 4]);
+	}
+
+	evaluate(curves.data(), parameters.data(), curves.size(), points.data());
+
+	for (size_t i = 0; i < curves.size(); i++)
+	{
+		for (size_t k = 0; k < veclanes<V>::value; k++)
+		{
+			EXPECT_NEAR(points[i].v[k], curves[i].evaluate(parameters[i]).v[k], epsilon);
+		}
+	}
+}
+
+TEST(curve, Arrays)
+{
+	testarrays<vec2, f32>(1e-4f);
+	testarrays<vec3, f32>(1e-4f);
+	testarrays<vec4, f32>(1e-4f);
+	testarrays<vec2, f64>(1e-12);
+	testarrays<vec3, f64>(1e-12);
+	testarrays<vec4, f64>(1e-12);
+}
+
+TEST(curve, Tessellate)
+{
+	fcurve3 curve = fcurve3::bezier(fvec3(0, 0, 0), fvec3(10, 20, 0), fvec3(30, -20, 5), fvec3(40, 0, 0));
+
+	for (size_t count : { 0, 1, 2, 3, 64, 65, 1000 })
+	{
+		std::vector<fvec3> points(count);
+		curve.tessellate(count, points.data());
+
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 t = count > 1 ? static_cast<f32>(i) / static_cast<f32>(count - 1) : 0.0f;
+			EXPECT_NEAR((points[i] - curve.evaluate(t)).length(), 0.0f, 1e-3f);
+		}
+
+		if (count > 1)
+		{
+			EXPECT_EQ(points[count - 1], curve.evaluate(1.0f));
+		}
+	}
+}
+
+TEST(curve, Flatten)
+{
+	dcurve3 curve = dcurve3::bezier(dvec3(0, 0, 0), dvec3(0, 10, 0), dvec3(10, 10, 3), dvec3(10, 0, 0));
+
+	for (f64 tolerance : { 1.0, 0.1, 0.001 })
+	{
+		std::vector<dvec3> points;
+		std::vector<f64> parameters;
+		curve.flatten(tolerance, points, &parameters);
+
+		ASSERT_EQ(points.size(), parameters.size());
+		EXPECT_EQ(points.front(), curve.evaluate(0));
+		EXPECT_DOUBLE_EQ(parameters.back(), 1.0);
+
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			EXPECT_NEAR((points[i] - curve.evaluate(parameters[i])).length(), 0.0, 1e-12);
+		}
+
+		for (f64 t = 0; t <= 1.0; t += 1.0 / 512)
+		{
+			EXPECT_LE(polylinedistance(curve.evaluate(t), points), tolerance);
+		}
+	}
+
+	// A straight curve needs no subdivision
+	std::vector<dvec3> line;
+	dcurve3::bezier(dvec3(0, 0, 0), dvec3(1, 0, 0), dvec3(2, 0, 0), dvec3(3, 0, 0)).flatten(0.01, line);
+	EXPECT_EQ(line.size(), 2u);
+}
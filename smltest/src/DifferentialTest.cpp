@@ -0,0 +1,185 @@
+#include "differential.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace differential
+{
+	size_t items = 128;
+	bool report = false;
+}
+
+using namespace differential;
+
+// Distance in units in the last place, floats are mapped to integers that are ordered the same way
+template<typename T, typename I>
+static double ulpdistance(T a, T b)
+{
+	if (a == b)
+	{
+		return 0.0;
+	}
+
+	if (std::isnan(a) || std::isnan(b))
+	{
+		return std::isnan(a) && std::isnan(b) ? 0.0 : INFINITY;
+	}
+
+	I ia, ib;
+	std::memcpy(&ia, &a, sizeof(T));
+	std::memcpy(&ib, &b, sizeof(T));
+
+	const I sign = static_cast<I>(static_cast<I>(1) << (sizeof(I) * 8 - 1));
+	ia = ia < 0 ? static_cast<I>(sign - ia) : ia;
+	ib = ib < 0 ? static_cast<I>(sign - ib) : ib;
+
+	return std::fabs(static_cast<double>(ia) - static_cast<double>(ib));
+}
+
+static size_t elementsize(element type)
+{
+	return type == element::f64 ? sizeof(double) : sizeof(float);
+}
+
+// Largest difference of a result to the reference that isn't within the absolute tolerance,
+// in ulps (the integer results compare exactly)
+static double maxulps(const operation& op, const void* reference, const void* result, size_t count)
+{
+	double worst = 0.0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		double d = 0.0;
+
+		if (op.type == element::f32)
+		{
+			float a = static_cast<const float*>(reference)[i];
+			float b = static_cast<const float*>(result)[i];
+			d = std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= op.absolute ? 0.0 : ulpdistance<float, int32_t>(a, b);
+		}
+		else if (op.type == element::f64)
+		{
+			double a = static_cast<const double*>(reference)[i];
+			double b = static_cast<const double*>(result)[i];
+			d = std::fabs(a - b) <= op.absolute ? 0.0 : ulpdistance<double, int64_t>(a, b);
+		}
+		else
+		{
+			int32_t a = static_cast<const int32_t*>(reference)[i];
+			int32_t b = static_cast<const int32_t*>(result)[i];
+			d = std::fabs(static_cast<double>(a) - static_cast<double>(b));
+		}
+
+		worst = std::max(worst, d);
+	}
+
+	return worst;
+}
+
+static void randomize(const operation& op, std::vector<unsigned char>& buffer, std::mt19937& random)
+{
+	size_t count = items * op.inputs;
+
+	if (op.type == element::f32)
+	{
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		float* p = reinterpret_cast<float*>(buffer.data());
+		for (size_t i = 0; i < count; i++) p[i] = dist(random);
+	}
+	else if (op.type == element::f64)
+	{
+		std::uniform_real_distribution<double> dist(-2.0, 2.0);
+		double* p = reinterpret_cast<double*>(buffer.data());
+		for (size_t i = 0; i < count; i++) p[i] = dist(random);
+	}
+	else
+	{
+		std::uniform_int_distribution<int32_t> dist(-30000, 30000);
+		int32_t* p = reinterpret_cast<int32_t*>(buffer.data());
+		for (size_t i = 0; i < count; i++) p[i] = dist(random);
+	}
+}
+
+// Best of a few runs, in nanoseconds per item
+static double timeoperation(const operation& op, const void* in, void* out)
+{
+	double best = INFINITY;
+
+	for (int rep = 0; rep < 5; rep++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		op.run(in, out, items);
+		auto end = std::chrono::steady_clock::now();
+
+		best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(items));
+	}
+
+	return best;
+}
+
+TEST(differential, Backends)
+{
+	const backend* reference = scalarbackend();
+	ASSERT_NE(reference, nullptr);
+
+	std::vector<const backend*> backends;
+	for (const backend* b : { ssebackend(), avxbackend(), avx512backend() })
+	{
+		if (b != nullptr && b->supported())
+		{
+			ASSERT_EQ(b->count, reference->count);
+			backends.push_back(b);
+		}
+	}
+
+	if (report)
+	{
+		std::printf("%-28s %-8s %12s %10s\n", "operation", "backend", "max ulps", "ns/item");
+	}
+
+	std::mt19937 random(20200517u);
+
+	for (size_t o = 0; o < reference->count; o++)
+	{
+		const operation& op = reference->operations[o];
+		size_t size = elementsize(op.type);
+
+		// Sized as doubles so the buffers are aligned for every element type
+		std::vector<unsigned char> in(items * op.inputs * size + sizeof(double));
+		std::vector<unsigned char> expected(items * op.outputs * size + sizeof(double));
+		std::vector<unsigned char> actual(expected.size());
+
+		randomize(op, in, random);
+		reference->operations[o].run(in.data(), expected.data(), items);
+
+		if (report)
+		{
+			std::printf("%-28s %-8s %12s %10.2f\n", op.name, reference->name, "-", timeoperation(op, in.data(), actual.data()));
+		}
+
+		for (const backend* b : backends)
+		{
+			const operation& other = b->operations[o];
+			ASSERT_STREQ(other.name, op.name);
+
+			std::fill(actual.begin(), actual.end(), static_cast<unsigned char>(0));
+			other.run(in.data(), actual.data(), items);
+
+			double ulps = maxulps(op, expected.data(), actual.data(), items * op.outputs);
+			EXPECT_LE(ulps, op.ulps) << op.name << " on the " << b->name << " backend";
+
+			if (report)
+			{
+				std::printf("%-28s %-8s %12.0f %10.2f\n", op.name, b->name, ulps, timeoperation(other, in.data(), actual.data()));
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include <dualquat.h>
+
+#include <gtest/gtest.h>
+
+using namespace sml;
+
+// FDUALQUAT Tests
+
+TEST(fdualquat, DefaultConstructor)
+{
+	fdualquat dq;
+
+	EXPECT_EQ(dq.real.x, 0);
+	EXPECT_EQ(dq.real.y, 0);
+	EXPECT_EQ(dq.real.z, 0);
+	EXPECT_EQ(dq.real.w, 1);
+	EXPECT_EQ(dq.dual.x, 0);
+	EXPECT_EQ(dq.dual.y, 0);
+	EXPECT_EQ(dq.dual.z, 0);
+	EXPECT_EQ(dq.dual.w, 0);
+}
+
+TEST(fdualquat, RotationTranslation)
+{
+	fquat r = fquat::euler(20, 40, 60);
+	fvec3 t(1, -2, 3);
+
+	fdualquat dq(r, t);
+	fvec3 translation = dq.translation();
+
+	EXPECT_NEAR(translation.x, t.x, 1e-6f);
+	EXPECT_NEAR(translation.y, t.y, 1e-6f);
+	EXPECT_NEAR(translation.z, t.z, 1e-6f);
+
+	fvec3 p(4, 5, 6);
+	fvec3 expected = r * p + t;
+	fvec3 result = dq * p;
+
+	EXPECT_NEAR(result.x, expected.x, 1e-5f);
+	EXPECT_NEAR(result.y, expected.y, 1e-5f);
+	EXPECT_NEAR(result.z, expected.z, 1e-5f);
+}
+
+TEST(fdualquat, Multiply)
+{
+	fdualquat a(fquat::euler(10, 0, 90), fvec3(1, 2, 3));
+	fdualquat b(fquat::euler(0, 45, 0), fvec3(-3, 0, 1));
+	fvec3 p(1, 1, 1);
+
+	fvec3 expected = a * (b * p);
+	fvec3 result = (a * b) * p;
+
+	EXPECT_NEAR(result.x, expected.x, 1e-5f);
+	EXPECT_NEAR(result.y, expected.y, 1e-5f);
+	EXPECT_NEAR(result.z, expected.z, 1e-5f);
+
+	fvec3 back = (a.conjugate() * a) * p;
+
+	EXPECT_NEAR(back.x, p.x, 1e-5f);
+	EXPECT_NEAR(back.y, p.y, 1e-5f);
+	EXPECT_NEAR(back.z, p.z, 1e-5f);
+}
+
+TEST(fdualquat, Normalize)
+{
+	fdualquat dq(fquat::euler(10, 20, 30), fvec3(1, 2, 3));
+	fdualquat scaled = dq * 3.0f;
+	scaled.dual += scaled.real;
+
+	scaled.normalize();
+
+	EXPECT_NEAR(scaled.real.length(), 1, 1e-6f);
+	EXPECT_NEAR(scaled.real.v.dot(scaled.dual.v), 0, 1e-6f);
+	EXPECT_NEAR(scaled.translation().x, 1, 1e-5f);
+	EXPECT_NEAR(scaled.translation().y, 2, 1e-5f);
+	EXPECT_NEAR(scaled.translation().z, 3, 1e-5f);
+}
+
+TEST(fdualquat, Matrix)
+{
+	fdualquat dq(fquat::euler(-30, 15, 75), fvec3(4, -5, 6));
+	fmat4 m = dq.tomatrix4();
+	fvec3 p(1, 2, 3);
+
+	fvec4 expected = m * fvec4(p.x, p.y, p.z, 1);
+	fvec3 result = dq * p;
+
+	EXPECT_NEAR(result.x, expected.x, 1e-5f);
+	EXPECT_NEAR(result.y, expected.y, 1e-5f);
+	EXPECT_NEAR(result.z, expected.z, 1e-5f);
+
+	fdualquat back = fdualquat::frommatrix4(m);
+	fvec3 roundtrip = back * p;
+
+	EXPECT_NEAR(roundtrip.x, expected.x, 1e-5f);
+	EXPECT_NEAR(roundtrip.y, expected.y, 1e-5f);
+	EXPECT_NEAR(roundtrip.z, expected.z, 1e-5f);
+}
+
+TEST(fdualquat, Sclerp)
+{
+	// A screw about z: 90 degrees of rotation and 4 units along the axis
+	fdualquat a;
+	fdualquat b(fquat::axisangle(fvec3(0, 0, 1), constants::half_pi), fvec3(0, 0, 4));
+
+	fdualquat start = fdualquat::sclerp(a, b, 0);
+	fdualquat end = fdualquat::sclerp(a, b, 1);
+	fdualquat half = fdualquat::sclerp(a, b, 0.5f);
+
+	EXPECT_NEAR(start.real.w, 1, 1e-6f);
+	EXPECT_NEAR(end.translation().z, 4, 1e-5f);
+
+	fvec3 p = half * fvec3(1, 0, 0);
+
+	EXPECT_NEAR(p.x, sml::cos(constants::pi / 4), 1e-5f);
+	EXPECT_NEAR(p.y, sml::sin(constants::pi / 4), 1e-5f);
+	EXPECT_NEAR(p.z, 2, 1e-5f);
+
+	fdualquat translation = fdualquat::sclerp(a, fdualquat(fquat::identity(), fvec3(2, 4, 6)), 0.25f);
+
+	EXPECT_NEAR(translation.translation().x, 0.5f, 1e-6f);
+	EXPECT_NEAR(translation.translation().y, 1, 1e-6f);
+	EXPECT_NEAR(translation.translation().z, 1.5f, 1e-6f);
+}
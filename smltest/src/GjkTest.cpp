@@ -0,0 +1,205 @@
+#include <gjk.h>
+#include <closest.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// SUPPORT TESTS
+
+TEST(gjk, MaxDot)
+{
+	rng r(6);
+
+	for (size_t count : { 1, 7, 8, 9, 31, 100 })
+	{
+		std::vector<fvec3> vertices(count);
+		onsphere(r, vertices.data(), count);
+
+		for (s32 i = 0; i < 20; i++)
+		{
+			fvec3 d = r.onsphere<f32>();
+
+			size_t expected = 0;
+			for (size_t v = 1; v < count; v++)
+			{
+				if (vertices[v].dot(d) > vertices[expected].dot(d))
+					expected = v;
+			}
+
+			ASSERT_FLOAT_EQ(vertices[maxdot(vertices.data(), count, d)].dot(d), vertices[expected].dot(d));
+		}
+	}
+
+	// The first of equal vertices
+	std::vector<dvec3> same(13, dvec3(1, 2, 3));
+	EXPECT_EQ(maxdot(same.data(), same.size(), dvec3(0, 1, 0)), 0u);
+}
+
+TEST(gjk, Supports)
+{
+	EXPECT_EQ((spheresupport<f64>{ dvec3(1, 0, 0), 2.0 }(dvec3(0, 0, -5))), dvec3(1, 0, -2));
+	EXPECT_EQ((boxsupport<f64>{ dvec3(0, 0, 0), dvec3(1, 2, 3) }(dvec3(-1, 1, -0.1))), dvec3(-1, 2, -3));
+	EXPECT_EQ((capsulesupport<f64>{ dvec3(0, 0, 0), dvec3(0, 4, 0), 1.0 }(dvec3(0, 1, 0))), dvec3(0, 5, 0));
+
+	// A box rotated a quarter turn around z and moved
+	transformedsupport<boxsupport<f64>, f64> box{ { dvec3(0, 0, 0), dvec3(1, 2, 3) }, dquat::axisangle(dvec3(0, 0, 1), 1.57079632679489661923), dvec3(10, 0, 0) };
+	dvec3 p = box(dvec3(1, 0, 0));
+	EXPECT_NEAR(p.x, 12.0, 1e-12);
+}
+
+// DISTANCE TESTS
+
+TEST(gjk, Distance)
+{
+	gjksimplex<f64> simplex;
+
+	// Spheres
+	gjkresult<f64> result = gjk(spheresupport<f64>{ dvec3(0, 0, 0), 1.0 }, spheresupport<f64>{ dvec3(3, 4, 0), 2.0 }, simplex);
+	EXPECT_FALSE(result.intersecting);
+	EXPECT_NEAR(result.distance, 2.0, 1e-6);
+	EXPECT_NEAR(result.pointa.x, 0.6, 1e-3);
+	EXPECT_NEAR(result.pointa.y, 0.8, 1e-3);
+
+	// Boxes apart along y
+	simplex.reset();
+	result = gjk(boxsupport<f64>{ dvec3(0, 0, 0), dvec3(1, 1, 1) }, boxsupport<f64>{ dvec3(0.5, 3.5, 0), dvec3(1, 1, 1) }, simplex);
+	EXPECT_FALSE(result.intersecting);
+	EXPECT_NEAR(result.distance, 1.5, 1e-12);
+	EXPECT_NEAR(result.pointa.y, 1.0, 1e-12);
+	EXPECT_NEAR(result.pointb.y, 2.5, 1e-12);
+
+	// Capsules against the segment distance
+	rng r(4);
+	for (s32 i = 0; i < 100; i++)
+	{
+		capsulesupport<f64> a{ r.inbox(dvec3(-3, -3, -3), dvec3(3, 3, 3)), r.inbox(dvec3(-3, -3, -3), dvec3(3, 3, 3)), 0.25 };
+		capsulesupport<f64> b{ r.inbox(dvec3(-3, -3, -3), dvec3(3, 3, 3)), r.inbox(dvec3(-3, -3, -3), dvec3(3, 3, 3)), 0.5 };
+
+		f64 expected = distancesegments(a.a, a.b, b.a, b.b) - 0.75;
+
+		simplex.reset();
+		result = gjk(a, b, simplex);
+
+		if (expected > 1e-6)
+		{
+			ASSERT_FALSE(result.intersecting);
+			ASSERT_NEAR(result.distance, expected, 1e-6);
+			ASSERT_NEAR((result.pointa - result.pointb).length(), result.distance, 1e-9);
+		}
+		else if (expected < -1e-6)
+		{
+			ASSERT_TRUE(result.intersecting);
+		}
+
+		simplex.reset();
+		ASSERT_EQ(gjkintersect(a, b, simplex), expected <= 0);
+	}
+}
+
+TEST(gjk, Hull)
+{
+	// Cube corners plus points inside it as a hull, against a sphere
+	std::vector<fvec3> cube;
+	for (s32 i = 0; i < 8; i++)
+	{
+		cube.emplace_back(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+	}
+
+	rng r(1);
+	for (s32 i = 0; i < 21; i++)
+	{
+		cube.push_back(r.inbox(fvec3(-1, -1, -1), fvec3(1, 1, 1)));
+	}
+
+	hullsupport<f32> hull{ cube.data(), cube.size() };
+	gjksimplex<f32> simplex;
+
+	gjkresult<f32> result = gjk(hull, spheresupport<f32>{ fvec3(3, 0, 0), 1.0f }, simplex);
+	EXPECT_FALSE(result.intersecting);
+	EXPECT_NEAR(result.distance, 1.0f, 1e-4f);
+
+	// Towards a corner
+	simplex.reset();
+	result = gjk(hull, spheresupport<f32>{ fvec3(3, 3, 3), 1.0f }, simplex);
+	EXPECT_NEAR(result.distance, 2.0f * sqrt(3.0f) - 1.0f, 1e-4f);
+	EXPECT_NEAR(result.pointa.x, 1.0f, 1e-4f);
+
+	simplex.reset();
+	EXPECT_TRUE(gjk(hull, spheresupport<f32>{ fvec3(0.5f, 0.5f, 1.5f), 1.0f }, simplex).intersecting);
+}
+
+TEST(gjk, WarmStart)
+{
+	transformedsupport<boxsupport<f64>, f64> a{ { dvec3(0, 0, 0), dvec3(1, 0.5, 2) }, dquat::axisangle(dvec3(0, 1, 0), 0.3), dvec3(0, 0, 0) };
+	transformedsupport<boxsupport<f64>, f64> b{ { dvec3(0, 0, 0), dvec3(0.5, 1, 1) }, dquat::axisangle(dvec3(1, 1, 0).normalized(), 0.7), dvec3(4, 1, 0.5) };
+
+	gjksimplex<f64> warm;
+	u32 coldtotal = 0, warmtotal = 0;
+
+	for (s32 frame = 0; frame < 50; frame++)
+	{
+		b.position.x -= 0.02;
+		b.rotation = b.rotation * dquat::axisangle(dvec3(0, 0, 1), 0.01);
+
+		gjksimplex<f64> cold;
+		gjkresult<f64> c = gjk(a, b, cold);
+		gjkresult<f64> w = gjk(a, b, warm);
+
+		ASSERT_EQ(c.intersecting, w.intersecting);
+		ASSERT_NEAR(c.distance, w.distance, 1e-9);
+
+		coldtotal += c.iterations;
+		warmtotal += w.iterations;
+	}
+
+	EXPECT_LT(warmtotal, coldtotal);
+}
+
+// PENETRATION TESTS
+
+TEST(gjk, Epa)
+{
+	// Boxes overlapping by 0.25 along x
+	boxsupport<f64> a{ dvec3(0, 0, 0), dvec3(1, 1, 1) }, b{ dvec3(1.75, 0.2, -0.3), dvec3(1, 1, 1) };
+	gjksimplex<f64> simplex;
+
+	ASSERT_TRUE(gjk(a, b, simplex).intersecting);
+
+	penetration<f64> p;
+	ASSERT_TRUE(epa(a, b, simplex, p));
+	EXPECT_NEAR(p.depth, 0.25, 1e-9);
+	EXPECT_NEAR(p.normal.x, 1.0, 1e-9);
+	EXPECT_NEAR((p.pointa - p.pointb - p.normal * p.depth).length(), 0.0, 1e-9);
+
+	// Spheres, the polytope only approximates them
+	spheresupport<f64> s{ dvec3(0, 0, 0), 1.0 }, t{ dvec3(0.6, 0.8, 0), 1.5 };
+	simplex.reset();
+	ASSERT_TRUE(gjkintersect(s, t, simplex));
+	ASSERT_TRUE(epa(s, t, simplex, p, 128));
+	EXPECT_NEAR(p.depth, 1.5, 2e-2);
+	EXPECT_NEAR(p.normal.dot(dvec3(0.6, 0.8, 0)), 1.0, 1e-2);
+
+	// Moving b along the normal by the depth leaves them just touching
+	rng r(5);
+	for (s32 i = 0; i < 50; i++)
+	{
+		transformedsupport<boxsupport<f64>, f64> c{ { dvec3(0, 0, 0), dvec3(1, 0.5, 0.75) }, r.rotation<f64>(), dvec3(0, 0, 0) };
+		transformedsupport<boxsupport<f64>, f64> d{ { dvec3(0, 0, 0), dvec3(0.5, 0.5, 1) }, r.rotation<f64>(), r.insphere<f64>() * 1.2 };
+
+		simplex.reset();
+		if (!gjk(c, d, simplex).intersecting)
+			continue;
+
+		ASSERT_TRUE(epa(c, d, simplex, p));
+
+		d.position += p.normal * (p.depth + 1e-6);
+		simplex.reset();
+		gjkresult<f64> apart = gjk(c, d, simplex);
+		ASSERT_FALSE(apart.intersecting);
+		ASSERT_LT(apart.distance, 1e-5);
+	}
+}
@@ -0,0 +1,166 @@
+#include <kdtree.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sml;
+
+template<template<typename> class V, typename T>
+static std::vector<std::pair<T, u32>> sorted(const std::vector<V<T>>& points, const V<T>& p)
+{
+	std::vector<std::pair<T, u32>> result;
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		V<T> d = points[i] - p;
+		result.emplace_back(d.dot(d), static_cast<u32>(i));
+	}
+
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+// QUERY TESTS
+
+TEST(kdtree, Nearest)
+{
+	rng r(17);
+
+	std::vector<fvec3> points(3001), queries(300);
+	inbox(r, fvec3(-5, -5, -5), fvec3(5, 5, 5), points.data(), points.size());
+	inbox(r, fvec3(-6, -6, -6), fvec3(6, 6, 6), queries.data(), queries.size());
+
+	kdtree<vec3, f32> tree(points.data(), points.size());
+	EXPECT_EQ(tree.size(), points.size());
+
+	for (const fvec3& q : queries)
+	{
+		auto expected = sorted(points, q);
+
+		f32 dsq = 0.0f;
+		u32 index = tree.nearest(q, &dsq);
+
+		ASSERT_FLOAT_EQ(dsq, expected[0].first);
+		ASSERT_FLOAT_EQ((points[index] - q).dot(points[index] - q), expected[0].first);
+
+		u32 indices[7];
+		f32 distances[7];
+		ASSERT_EQ(tree.nearest(q, 7, indices, distances), 7u);
+
+		for (size_t i = 0; i < 7; i++)
+		{
+			ASSERT_FLOAT_EQ(distances[i], expected[i].first);
+		}
+
+		std::vector<u32> found;
+		tree.query(q, 0.8f, found);
+		std::sort(found.begin(), found.end());
+
+		std::vector<u32> inside;
+		for (auto& e : expected)
+		{
+			if (e.first <= 0.8f * 0.8f)
+				inside.push_back(e.second);
+		}
+
+		std::sort(inside.begin(), inside.end());
+		ASSERT_EQ(found, inside);
+	}
+}
+
+TEST(kdtree, Vec2)
+{
+	rng r(4);
+
+	std::vector<dvec2> points(517);
+	for (dvec2& p : points)
+	{
+		p = dvec2(r.uniform(-1.0, 1.0), r.uniform(-1.0, 1.0));
+	}
+
+	kdtree<vec2, f64> tree(points.data(), points.size());
+
+	for (s32 i = 0; i < 100; i++)
+	{
+		dvec2 q(r.uniform(-1.0, 1.0), r.uniform(-1.0, 1.0));
+		auto expected = sorted(points, q);
+
+		f64 dsq = 0.0;
+		(void)tree.nearest(q, &dsq);
+		ASSERT_DOUBLE_EQ(dsq, expected[0].first);
+	}
+
+	// Small and empty trees
+	kdtree<vec2, f64> small(points.data(), 5), empty;
+
+	u32 indices[8];
+	EXPECT_EQ(small.nearest(dvec2(0, 0), 8, indices), 5u);
+	EXPECT_EQ(empty.nearest(dvec2(0, 0)), 0xFFFFFFFFu);
+	EXPECT_EQ(empty.nearest(dvec2(0, 0), 3, indices), 0u);
+}
+
+TEST(kdtree, Duplicates)
+{
+	// Many points on one coordinate still split and answer correctly
+	std::vector<fvec3> points;
+	for (s32 i = 0; i < 200; i++)
+	{
+		points.emplace_back(1.0f, static_cast<f32>(i % 3), 0.0f);
+	}
+
+	kdtree<vec3, f32> tree(points.data(), points.size());
+
+	std::vector<u32> found;
+	EXPECT_EQ(tree.query(fvec3(1, 1, 0), 0.5f, found), 67u);
+
+	f32 dsq = -1.0f;
+	u32 index = tree.nearest(fvec3(1, 2.2f, 0), &dsq);
+	EXPECT_EQ(index % 3, 2u);
+	EXPECT_NEAR(dsq, 0.04f, 1e-6f);
+}
+
+// ARRAY TESTS
+
+TEST(kdtree, Batch)
+{
+	rng r(8);
+
+	std::vector<fvec3> points(2000), queries(513);
+	inbox(r, fvec3(0, 0, 0), fvec3(10, 10, 10), points.data(), points.size());
+	inbox(r, fvec3(0, 0, 0), fvec3(10, 10, 10), queries.data(), queries.size());
+
+	kdtree<vec3, f32> tree(points.data(), points.size());
+
+	std::vector<u32> nearest(queries.size()), knn(queries.size() * 4);
+	std::vector<f32> distance(queries.size()), knndistance(queries.size() * 4);
+
+	tree.nearest(queries.data(), queries.size(), nearest.data(), distance.data());
+	tree.nearest(queries.data(), queries.size(), 4, knn.data(), knndistance.data());
+
+	std::vector<size_t> counts(queries.size(), 0);
+	tree.query(queries.data(), queries.size(), 1.0f, [&](size_t q, u32, f32) { counts[q]++; });
+
+	for (size_t q = 0; q < queries.size(); q++)
+	{
+		f32 dsq = 0.0f;
+		u32 single = tree.nearest(queries[q], &dsq);
+
+		ASSERT_EQ(nearest[q], single);
+		ASSERT_EQ(distance[q], dsq);
+		ASSERT_EQ(knn[q * 4], single);
+
+		u32 indices[4];
+		f32 distances[4];
+		(void)tree.nearest(queries[q], 4, indices, distances);
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			ASSERT_EQ(knndistance[q * 4 + i], distances[i]);
+		}
+
+		std::vector<u32> found;
+		ASSERT_EQ(tree.query(queries[q], 1.0f, found), counts[q]);
+	}
+}
@@ -1,8 +1,28 @@
+#include "differential.h"
+
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <cstring>
+
 int main(int argc, char** argv)
 {
 	::testing::InitGoogleTest(&argc, argv);
 
+	// --differential[=items] prints the ulps and timings of every backend
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strncmp(argv[i], "--differential", 14) == 0)
+		{
+			differential::report = true;
+
+			size_t items = argv[i][14] == '=' ? static_cast<size_t>(std::strtoul(argv[i] + 15, nullptr, 10)) : 0;
+			if (items > 0)
+			{
+				differential::items = items;
+			}
+		}
+	}
+
 	return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
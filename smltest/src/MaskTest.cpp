@@ -0,0 +1,117 @@
+#include <mask.h>
+
+#include <gtest/gtest.h>
+
+using namespace sml;
+
+// VECMASK TESTS
+
+TEST(vecmask, FloatCompare)
+{
+	fvec3 a(1, 5, 3);
+	fvec3 b(2, 5, 1);
+
+	EXPECT_EQ(lessThan(a, b).bits(), 0b001);
+	EXPECT_EQ(lessEqual(a, b).bits(), 0b011);
+	EXPECT_EQ(greaterThan(a, b).bits(), 0b100);
+	EXPECT_EQ(greaterEqual(a, b).bits(), 0b110);
+	EXPECT_EQ(equal(a, b).bits(), 0b010);
+	EXPECT_EQ(notEqual(a, b).bits(), 0b101);
+}
+
+TEST(vecmask, DoubleCompare)
+{
+	dvec4 a(1, 5, 3, -1);
+	dvec4 b(2, 5, 1, -2);
+
+	EXPECT_EQ(lessThan(a, b).bits(), 0b0001);
+	EXPECT_EQ(greaterEqual(a, b).bits(), 0b1110);
+}
+
+TEST(vecmask, IntegerCompare)
+{
+	ivec3 a(-1, 5, 3);
+	ivec3 b(2, 5, 1);
+
+	EXPECT_EQ(lessThan(a, b).bits(), 0b001);
+	EXPECT_EQ(greaterEqual(a, b).bits(), 0b110);
+
+	uvec3 ua(0xFFFFFFFFu, 5, 3);
+	uvec3 ub(2, 5, 1);
+
+	EXPECT_EQ(lessThan(ua, ub).bits(), 0b000);
+	EXPECT_EQ(greaterThan(ua, ub).bits(), 0b101);
+}
+
+TEST(vecmask, AnyAllNone)
+{
+	fvec2 a(1, 2);
+
+	EXPECT_TRUE(lessThan(a, fvec2(3)).all());
+	EXPECT_TRUE(lessThan(a, fvec2(2)).any());
+	EXPECT_FALSE(lessThan(a, fvec2(2)).all());
+	EXPECT_TRUE(lessThan(a, fvec2(0.0f)).none());
+}
+
+TEST(vecmask, Logic)
+{
+	fvec4 a(1, 2, 3, 4);
+	vec4mask<f32> lo = greaterThan(a, fvec4(1));
+	vec4mask<f32> hi = lessThan(a, fvec4(4));
+
+	EXPECT_EQ((lo & hi).bits(), 0b0110);
+	EXPECT_EQ((lo | hi).bits(), 0b1111);
+	EXPECT_EQ((lo ^ hi).bits(), 0b1001);
+	EXPECT_EQ((~lo).bits(), 0b0001);
+}
+
+TEST(vecmask, Select)
+{
+	fvec3 a(1, 5, 3);
+	fvec3 b(2, 5, 1);
+
+	EXPECT_EQ(select(lessThan(a, b), a, b), fvec3::min(a, b));
+	EXPECT_EQ(select(lessThan(a, b), b, a), fvec3::max(a, b));
+
+	dvec3 da(1, 5, 3);
+	dvec3 db(2, 4, 1);
+
+	EXPECT_EQ(select(greaterThan(da, db), da, db), dvec3(2, 5, 3));
+
+	ivec2 ia(-1, 7);
+	ivec2 ib(3, 3);
+
+	EXPECT_EQ(select(lessThan(ia, ib), ia, ib), ivec2(-1, 3));
+}
+
+TEST(vecmask, FindAll)
+{
+	fvec3 values[] = { fvec3(0, 0, 0), fvec3(5, 0, 0), fvec3(1, 1, 1), fvec3(-1, -1, 3), fvec3(2, 2, 2) };
+	u32 indices[5];
+
+	size_t n = findall<compare::less>(values, fvec3(2), indices, 5);
+
+	ASSERT_EQ(n, 2u);
+	EXPECT_EQ(indices[0], 0u);
+	EXPECT_EQ(indices[1], 2u);
+
+	n = findany<compare::greaterequal>(values, fvec3(2), indices, 5);
+
+	ASSERT_EQ(n, 3u);
+	EXPECT_EQ(indices[0], 1u);
+	EXPECT_EQ(indices[1], 3u);
+	EXPECT_EQ(indices[2], 4u);
+}
+
+TEST(vecmask, FindInside)
+{
+	ivec3 values[] = { ivec3(0, 0, 0), ivec3(5, 0, 0), ivec3(1, 1, 1), ivec3(-1, -1, 3), ivec3(2, 2, 2) };
+	u32 indices[5];
+
+	size_t n = findinside(values, ivec3(0, 0, 0), ivec3(2), indices, 5);
+
+	ASSERT_EQ(n, 3u);
+	EXPECT_EQ(indices[0], 0u);
+	EXPECT_EQ(indices[1], 2u);
+	EXPECT_EQ(indices[2], 4u);
+}
@@ -1065,6 +1065,7 @@ TEST(dmat3, Determinant)
 }
 
 #include "mat4.h"
+#include "quat.h"
 
 // FMAT4 Tests
 
@@ -1491,6 +1492,59 @@ TEST(fmat4, Determinant)
 	EXPECT_EQ(d, -36);
 }
 
+TEST(fmat4, Compose)
+{
+	fvec3 t(1, -2, 3);
+	fquat q = fquat::euler(30, -45, 60);
+	fvec3 s(2, 0.5f, 3);
+
+	fmat4 m = fmat4::compose(t, q, s);
+	fmat4 expected = fmat4::translate(t) * fmat4::scale(s);
+
+	fvec3 axes[] = { q * fvec3(s.x, 0, 0), q * fvec3(0, s.y, 0), q * fvec3(0, 0, s.z) };
+
+	for (s32 c = 0; c < 3; c++)
+	{
+		EXPECT_NEAR(m.col[c].x, axes[c].x, 1e-5f);
+		EXPECT_NEAR(m.col[c].y, axes[c].y, 1e-5f);
+		EXPECT_NEAR(m.col[c].z, axes[c].z, 1e-5f);
+		EXPECT_EQ(m.col[c].w, 0);
+	}
+
+	EXPECT_EQ(m.m30, expected.m30);
+	EXPECT_EQ(m.m31, expected.m31);
+	EXPECT_EQ(m.m32, expected.m32);
+	EXPECT_EQ(m.m33, 1);
+}
+
+TEST(fmat4, Decompose)
+{
+	fvec3 t(1, -2, 3);
+	fquat q = fquat::euler(30, -45, 60);
+	fvec3 s(2, 0.5f, -3);
+
+	fvec3 translation, scale;
+	fquat rotation;
+
+	EXPECT_TRUE(fmat4::compose(t, q, s).decompose(translation, rotation, scale));
+
+	EXPECT_EQ(translation.x, t.x);
+	EXPECT_EQ(translation.y, t.y);
+	EXPECT_EQ(translation.z, t.z);
+
+	EXPECT_NEAR(scale.x, s.x, 1e-5f);
+	EXPECT_NEAR(scale.y, s.y, 1e-5f);
+	EXPECT_NEAR(scale.z, s.z, 1e-5f);
+
+	EXPECT_NEAR(sml::abs(rotation.v.dot(q.v)), 1, 1e-5f);
+
+	fmat4 flat = fmat4::compose(t, q, fvec3(1, 0, 1));
+
+	EXPECT_FALSE(flat.decompose(translation, rotation, scale));
+	EXPECT_NEAR(rotation.length(), 1, 1e-5f);
+	EXPECT_NEAR(scale.y, 0, 1e-5f);
+}
+
 // DMAT4 Tests
 
 TEST(dmat4, DefaultConstructor)
@@ -1914,4 +1968,26 @@ TEST(dmat4, Determinant)
 	f64 d = m.determinant();
 
 	EXPECT_EQ(d, -36);
-}
\ No newline at end of file
+}
+
+TEST(dmat4, ComposeDecompose)
+{
+	dvec3 t(-4, 0.25, 9);
+	dquat q = dquat::euler(-120, 10, 85);
+	dvec3 s(1.5, 3, 0.75);
+
+	dvec3 translation, scale;
+	dquat rotation;
+
+	EXPECT_TRUE(dmat4::compose(t, q, s).decompose(translation, rotation, scale));
+
+	EXPECT_EQ(translation.x, t.x);
+	EXPECT_EQ(translation.y, t.y);
+	EXPECT_EQ(translation.z, t.z);
+
+	EXPECT_NEAR(scale.x, s.x, 1e-12);
+	EXPECT_NEAR(scale.y, s.y, 1e-12);
+	EXPECT_NEAR(scale.z, s.z, 1e-12);
+
+	EXPECT_NEAR(sml::abs(rotation.v.dot(q.v)), 1, 1e-12);
+}
@@ -0,0 +1,263 @@
+#include <noise.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// Central difference of f along every axis of p
+template<template<typename> class V, typename F>
+static V<f64> difference(const V<f64>& p, const F& f)
+{
+	const f64 h = 1e-6;
+	V<f64> d;
+
+	for (size_t k = 0; k < veclanes<V>::value; k++)
+	{
+		V<f64> a = p, b = p;
+		a.v[k] += h;
+		b.v[k] -= h;
+
+		d.v[k] = (f(a) - f(b)) / (2.0 * h);
+	}
+
+	return d;
+}
+
+template<template<typename> class V, typename F, typename G>
+static void expectderivative(const F& f, const G& g)
+{
+	for (s32 i = 0; i < 64; i++)
+	{
+		V<f64> p;
+		for (size_t k = 0; k < veclanes<V>::value; k++)
+		{
+			p.v[k] = -20.0 + 0.731 * i + 1.37 * static_cast<f64>(k * i % 7) + 0.1 * static_cast<f64>(k);
+		}
+
+		V<f64> d;
+		f64 value = g(p, d);
+		V<f64> expected = difference<V>(p, f);
+
+		EXPECT_NEAR(value, f(p), 1e-12);
+
+		for (size_t k = 0; k < veclanes<V>::value; k++)
+		{
+			EXPECT_NEAR(d.v[k], expected.v[k], 1e-5) << "axis " << k << " point " << i;
+		}
+	}
+}
+
+// POINT TESTS
+
+TEST(noise, PerlinLattice)
+{
+	for (s32 i = -5; i < 5; i++)
+	{
+		EXPECT_EQ(perlin(dvec2(i, 3 * i)), 0.0);
+		EXPECT_EQ(perlin(dvec3(i, 2, -i)), 0.0);
+		EXPECT_EQ(perlin(fvec4(static_cast<f32>(i), 1, 7, 0)), 0.0f);
+	}
+}
+
+TEST(noise, Range)
+{
+	for (s32 i = 0; i < 4000; i++)
+	{
+		f64 x = 0.0731 * i - 100.0, y = 0.0417 * i, z = 13.3 - 0.0029 * i;
+
+		EXPECT_LE(abs(perlin(dvec2(x, y))), 1.0);
+		EXPECT_LE(abs(perlin(dvec3(x, y, z))), 1.0);
+		EXPECT_LE(abs(perlin(dvec4(x, y, z, x - z))), 1.0);
+		EXPECT_LE(abs(valuenoise(dvec3(x, y, z))), 1.0);
+		EXPECT_LE(abs(simplex(dvec2(x, y))), 1.05);
+		EXPECT_LE(abs(simplex(dvec3(x, y, z))), 1.05);
+
+		dvec2 f = worley(dvec3(x, y, z));
+		EXPECT_GE(f.x, 0.0);
+		EXPECT_LE(f.x, f.y);
+	}
+}
+
+TEST(noise, Period)
+{
+	// Lattice points hash modulo 289, the noise repeats (simplex noise along offsets that add up
+	// to zero) and stays continuous across the wrap
+	for (s32 i = 0; i < 16; i++)
+	{
+		dvec3 p(0.37 * i, 1.1 - 0.2 * i, 0.05 * i);
+		dvec3 q = p + dvec3(578.0, -289.0, -289.0);
+
+		EXPECT_NEAR(perlin(p), perlin(q), 1e-9);
+		EXPECT_NEAR(simplex(p), simplex(q), 1e-9);
+		EXPECT_NEAR(valuenoise(p), valuenoise(q), 1e-9);
+		EXPECT_NEAR(worley(p).x, worley(q).x, 1e-9);
+	}
+
+	EXPECT_NEAR(perlin(dvec2(289.0 - 1e-9, 0.5)), perlin(dvec2(289.0 + 1e-9, 0.5)), 1e-6);
+	EXPECT_NEAR(simplex(dvec2(-1e-9, 288.9999999)), simplex(dvec2(1e-9, 289.0000001)), 1e-6);
+}
+
+TEST(noise, Derivatives)
+{
+	expectderivative<vec2>([](const dvec2& p) { return perlin(p); }, [](const dvec2& p, dvec2& d) { return perlin(p, d); });
+	expectderivative<vec3>([](const dvec3& p) { return perlin(p); }, [](const dvec3& p, dvec3& d) { return perlin(p, d); });
+	expectderivative<vec4>([](const dvec4& p) { return perlin(p); }, [](const dvec4& p, dvec4& d) { return perlin(p, d); });
+
+	expectderivative<vec2>([](const dvec2& p) { return simplex(p); }, [](const dvec2& p, dvec2& d) { return simplex(p, d); });
+	expectderivative<vec3>([](const dvec3& p) { return simplex(p); }, [](const dvec3& p, dvec3& d) { return simplex(p, d); });
+
+	expectderivative<vec2>([](const dvec2& p) { return valuenoise(p); }, [](const dvec2& p, dvec2& d) { return valuenoise(p, d); });
+	expectderivative<vec4>([](const dvec4& p) { return valuenoise(p); }, [](const dvec4& p, dvec4& d) { return valuenoise(p, d); });
+
+	expectderivative<vec3>([](const dvec3& p) { return worley(p).x; }, [](const dvec3& p, dvec3& d) { return worley(p, d).x; });
+
+	fbmparams<f64> params;
+	params.octaves = 4;
+	params.frequency = 0.5;
+
+	expectderivative<vec3>([&](const dvec3& p) { return fbm(noisetype::perlin, p, params); }, [&](const dvec3& p, dvec3& d) { return fbm(noisetype::perlin, p, d, params); });
+	expectderivative<vec2>([&](const dvec2& p) { return fbm(noisetype::simplex, p, params); }, [&](const dvec2& p, dvec2& d) { return fbm(noisetype::simplex, p, d, params); });
+}
+
+TEST(noise, Fbm)
+{
+	fbmparams<f32> params;
+	params.octaves = 1;
+	params.frequency = 2.0f;
+
+	fvec3 p(0.3f, -1.7f, 4.2f);
+
+	EXPECT_EQ(fbm(noisetype::perlin, p, params), perlin(p * 2.0f));
+	EXPECT_EQ(fbm(noisetype::worley, p, params), worley(p * 2.0f).x);
+
+	params.octaves = 3;
+	params.gain = 0.25f;
+
+	EXPECT_NEAR(fbm(noisetype::value, p, params), valuenoise(p * 2.0f) + 0.25f * valuenoise(p * 4.0f) + 0.0625f * valuenoise(p * 8.0f), 1e-6f);
+	EXPECT_EQ(fbm(noisetype::simplex, fvec4(p.x, p.y, p.z, 1.0f), params), 0.0f);
+}
+
+// ARRAY TESTS
+
+// Every array noise against the single point noise, with a count that leaves a remainder
+template<typename T, u32 D>
+static void expectarrays(const T tolerance)
+{
+	const size_t count = 37;
+
+	std::vector<T> position[4], derivative[4], value(count), second(count);
+
+	for (size_t k = 0; k < 4; k++)
+	{
+		position[k].resize(count);
+		derivative[k].resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			position[k][i] = static_cast<T>(-7.0 + 0.413 * static_cast<f64>(i) + 2.9 * static_cast<f64>(k) - 0.021 * static_cast<f64>(i * i % 11));
+		}
+	}
+
+	noisestreams<T> streams = { { position[0].data(), position[1].data(), position[2].data(), position[3].data() }, D,
+	                            value.data(), { derivative[0].data(), derivative[1].data(), derivative[2].data(), derivative[3].data() }, second.data() };
+
+	// Runs the single point form on the first D components of every point
+	auto check = [&](const char* name, auto point)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			vec4<T> p(position[0][i], position[1][i], position[2][i], position[3][i]), d;
+			vec2<T> v;
+
+			if constexpr (D == 2)
+			{
+				vec2<T> g;
+				v = point(vec2<T>(p.x, p.y), g);
+				d = vec4<T>(g.x, g.y, 0, 0);
+			}
+			else if constexpr (D == 3)
+			{
+				vec3<T> g;
+				v = point(vec3<T>(p.x, p.y, p.z), g);
+				d = vec4<T>(g.x, g.y, g.z, 0);
+			}
+			else
+			{
+				v = point(p, d);
+			}
+
+			EXPECT_NEAR(value[i], v.x, tolerance) << name << " " << D << "d " << i;
+			EXPECT_NEAR(second[i], v.y, tolerance) << name << " " << D << "d " << i;
+
+			for (u32 k = 0; k < D; k++)
+			{
+				EXPECT_NEAR(derivative[k][i], d.v[k], tolerance * 10) << name << " " << D << "d " << i;
+			}
+		}
+	};
+
+	perlin(streams, count);
+	check("perlin", [](const auto& p, auto& d) { return vec2<T>(perlin(p, d), 0); });
+
+	valuenoise(streams, count);
+	check("value", [](const auto& p, auto& d) { return vec2<T>(valuenoise(p, d), 0); });
+
+	fbmparams<T> params;
+	fbm(noisetype::perlin, streams, count, params);
+	check("fbm", [&](const auto& p, auto& d) { return vec2<T>(fbm(noisetype::perlin, p, d, params), 0); });
+
+	if constexpr (D < 4)
+	{
+		simplex(streams, count);
+		check("simplex", [](const auto& p, auto& d) { return vec2<T>(simplex(p, d), 0); });
+
+		worley(streams, count);
+		check("worley", [](const auto& p, auto& d) { return worley(p, d); });
+	}
+}
+
+TEST(noise, ArrayF32)
+{
+	// Fused multiply adds only on some paths, the simplex scale magnifies their rounding
+	expectarrays<f32, 2>(1e-4f);
+	expectarrays<f32, 3>(1e-4f);
+	expectarrays<f32, 4>(1e-4f);
+}
+
+TEST(noise, ArrayF64)
+{
+	expectarrays<f64, 2>(1e-12);
+	expectarrays<f64, 3>(1e-12);
+	expectarrays<f64, 4>(1e-12);
+}
+
+TEST(noise, ArrayOptionalStreams)
+{
+	const size_t count = 11;
+
+	f32 x[count], y[count], value[count];
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = 0.3f * i;
+		y[i] = 1.0f - 0.7f * i;
+		value[i] = -2.0f;
+	}
+
+	noisestreams<f32> streams = { { x, y, nullptr, nullptr }, 2, value, { nullptr, nullptr, nullptr, nullptr }, nullptr };
+
+	simplex(streams, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		EXPECT_NEAR(value[i], simplex(fvec2(x[i], y[i])), 1e-6f);
+	}
+
+	// Simplex noise has no 4D form, the streams stay untouched
+	value[0] = -2.0f;
+	streams.dimensions = 4;
+	simplex(streams, 1);
+
+	EXPECT_EQ(value[0], -2.0f);
+}
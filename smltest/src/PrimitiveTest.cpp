@@ -0,0 +1,177 @@
+#include <plane.h>
+#include <ray.h>
+#include <segment.h>
+#include <triangle.h>
+#include <capsule.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// PLANE TESTS
+
+TEST(primitive, Plane)
+{
+	dplane p = dplane::frompoints(dvec3(0, 2, 0), dvec3(0, 2, 1), dvec3(1, 2, 0));
+
+	EXPECT_EQ(p.normal(), dvec3(0, 1, 0));
+	EXPECT_DOUBLE_EQ(p.distance(), -2.0);
+	EXPECT_DOUBLE_EQ(p.signeddistance(dvec3(5, 5, 5)), 3.0);
+	EXPECT_DOUBLE_EQ(p.signeddistance(dvec3(5, -1, 5)), -3.0);
+	EXPECT_EQ(p.project(dvec3(3, 7, -4)), dvec3(3, 2, -4));
+
+	dplane scaled(0, 0, 4, -8);
+	scaled.normalize();
+	EXPECT_EQ(scaled, dplane(dvec3(0, 0, 1), -2));
+	EXPECT_EQ(dplane::frompointnormal(dvec3(1, 1, 2), dvec3(0, 0, 1)), scaled);
+}
+
+TEST(primitive, PlaneTransform)
+{
+	dplane p = dplane::frompointnormal(dvec3(0, 0, 1), dvec3(0, 0, 1));
+	dmat4 m = dmat4::translate(dvec3(1, 2, 3)) * dmat4::rotate(dvec3(1, 0, 0), 0.5) * dmat4::scale(dvec3(2, 3, 4));
+
+	dplane t = p.transformed(m).normalized();
+	dvec3 points[3] = { dvec3(0, 0, 1), dvec3(1, 0, 1), dvec3(0, 1, 1) };
+
+	for (const dvec3& point : points)
+	{
+		EXPECT_NEAR(t.signeddistance(m.transformPoint(point)), 0.0, 1e-12);
+	}
+
+	// The side of a point is kept
+	EXPECT_GT(t.signeddistance(m.transformPoint(dvec3(0, 0, 2))), 0.0);
+	EXPECT_EQ(p.transformed(m.inverted().transposed(), true), p.transformed(m));
+}
+
+TEST(primitive, Classify)
+{
+	rng random(7);
+	fplane p = fplane::frompointnormal(fvec3(0, 0.25f, 0), fvec3(0.6f, 0.8f, 0));
+
+	for (size_t count : { 0, 3, 8, 61 })
+	{
+		std::vector<fvec3> points(count);
+		std::vector<f32> distances(count);
+		std::vector<s8> sides(count);
+
+		for (fvec3& point : points)
+		{
+			point = random.insphere<f32>() * 2.0f;
+		}
+
+		if (count > 2)
+		{
+			points[1] = fvec3(0, 0.25f, 5);
+		}
+
+		signeddistance(p, points.data(), count, distances.data());
+		u32 found = classify(p, points.data(), count, sides.data(), 1e-5f);
+		u32 expected = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 distance = p.signeddistance(points[i]);
+			s8 side = static_cast<s8>(distance > 1e-5f ? 1 : distance < -1e-5f ? -1 : 0);
+
+			EXPECT_NEAR(distances[i], distance, 1e-5f);
+			EXPECT_EQ(sides[i], side);
+			expected |= 1u << (side + 1);
+		}
+
+		EXPECT_EQ(found, expected);
+	}
+
+	fvec3 front[9];
+
+	for (fvec3& point : front)
+	{
+		point = fvec3(0, 1, 0);
+	}
+
+	s8 sides[9];
+	EXPECT_EQ(classify(p, front, 9, sides), 4u);
+}
+
+// LINEAR TESTS
+
+TEST(primitive, Ray)
+{
+	dray r(dvec3(1, 0, 0), dvec3(0, 2, 0));
+
+	EXPECT_EQ(r.at(1.5), dvec3(1, 3, 0));
+	EXPECT_DOUBLE_EQ(r.closestparameter(dvec3(4, 4, 0)), 2.0);
+	EXPECT_DOUBLE_EQ(r.closestparameter(dvec3(4, -4, 0)), 0.0);
+	EXPECT_DOUBLE_EQ(r.distance(dvec3(4, -4, 0)), 5.0);
+	EXPECT_EQ(r.normalized().direction, dvec3(0, 1, 0));
+
+	dline l(r.origin, r.direction);
+	EXPECT_DOUBLE_EQ(l.closestparameter(dvec3(4, -4, 0)), -2.0);
+	EXPECT_DOUBLE_EQ(l.distance(dvec3(4, -4, 0)), 3.0);
+
+	dmat4 m = dmat4::translate(dvec3(0, 0, 5));
+	EXPECT_EQ(r.transformed(m), dray(dvec3(1, 0, 5), dvec3(0, 2, 0)));
+	EXPECT_EQ(l.transformed(m).at(1), dvec3(1, 2, 5));
+}
+
+TEST(primitive, Segment)
+{
+	dsegment s(dvec3(0, 0, 0), dvec3(4, 0, 0));
+
+	EXPECT_DOUBLE_EQ(s.length(), 4.0);
+	EXPECT_DOUBLE_EQ(s.lengthsquared(), 16.0);
+	EXPECT_EQ(s.midpoint(), dvec3(2, 0, 0));
+	EXPECT_EQ(s.closestpoint(dvec3(6, 1, 0)), dvec3(4, 0, 0));
+	EXPECT_DOUBLE_EQ(s.distance(dvec3(2, 3, 4)), 5.0);
+
+	dvec3 onp, onq;
+	f64 distsq = dsegment::closestpoints(s, dsegment(dvec3(1, -1, 2), dvec3(1, 1, 2)), onp, onq);
+	EXPECT_DOUBLE_EQ(distsq, 4.0);
+	EXPECT_EQ(onp, dvec3(1, 0, 0));
+	EXPECT_EQ(onq, dvec3(1, 0, 2));
+}
+
+// SURFACE TESTS
+
+TEST(primitive, Triangle)
+{
+	dtriangle t(dvec3(0, 0, 0), dvec3(2, 0, 0), dvec3(0, 2, 0));
+
+	EXPECT_EQ(t.unitnormal(), dvec3(0, 0, 1));
+	EXPECT_DOUBLE_EQ(t.area(), 2.0);
+	EXPECT_EQ(t.toplane(), dplane(dvec3(0, 0, 1), 0));
+	EXPECT_DOUBLE_EQ(t.distance(dvec3(0.5, 0.5, 3)), 3.0);
+	EXPECT_EQ(t.closestpoint(dvec3(3, 3, 0)), dvec3(1, 1, 0));
+
+	dvec3 weights = t.barycentric(dvec3(0.5, 1, 7));
+	EXPECT_DOUBLE_EQ(weights.x, 0.25);
+	EXPECT_DOUBLE_EQ(weights.y, 0.25);
+	EXPECT_DOUBLE_EQ(weights.z, 0.5);
+
+	dvec3 centroid = t.barycentric(t.centroid());
+	EXPECT_NEAR(centroid.x, 1.0 / 3.0, 1e-15);
+	EXPECT_NEAR(centroid.y, 1.0 / 3.0, 1e-15);
+
+	dtriangle moved = t.transformed(dmat4::translate(dvec3(0, 0, 1)));
+	EXPECT_EQ(moved.toplane(), dplane(dvec3(0, 0, 1), -1));
+}
+
+TEST(primitive, Capsule)
+{
+	dcapsule c(dvec3(0, 0, 0), dvec3(0, 4, 0), 1);
+
+	EXPECT_TRUE(c.contains(dvec3(0.5, 4.5, 0)));
+	EXPECT_FALSE(c.contains(dvec3(0, 5.5, 0)));
+	EXPECT_DOUBLE_EQ(c.signeddistance(dvec3(3, 2, 0)), 2.0);
+	EXPECT_DOUBLE_EQ(c.signeddistance(dvec3(0, 2, 0)), -1.0);
+	EXPECT_EQ(c.closestpoint(dvec3(0, 9, 0)), dvec3(0, 5, 0));
+	EXPECT_EQ(c.closestpoint(dvec3(-3, 1, 0)), dvec3(-1, 1, 0));
+
+	dcapsule t = c.transformed(dmat4::translate(dvec3(1, 0, 0)) * dmat4::scale(dvec3(1, 3, 2)));
+	EXPECT_EQ(t.a, dvec3(1, 0, 0));
+	EXPECT_EQ(t.b, dvec3(1, 12, 0));
+	EXPECT_DOUBLE_EQ(t.radius, 3.0);
+}
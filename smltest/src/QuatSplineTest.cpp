@@ -0,0 +1,136 @@
+#include <quatspline.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// Angular velocity of the spline at t by a one sided difference
+static dvec3 angularvelocity(const dquatspline& spline, f64 t, f64 h)
+{
+	dquat a = spline.evaluate(t), b = spline.evaluate(t + h);
+	dquat delta = (b * a.conjugate()).log();
+
+	return delta.xyz * (2.0 / h);
+}
+
+static std::vector<dquat> makekeys(size_t count)
+{
+	std::vector<dquat> keys;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		f64 s = static_cast<f64>(i);
+		keys.push_back(dquat::axisangle(dvec3(sml::sin(s), 1, sml::cos(2 * s)), 0.7 * s));
+	}
+
+	return keys;
+}
+
+// SPLINE TESTS
+
+TEST(quatspline, Keys)
+{
+	std::vector<dquat> keys = makekeys(6);
+
+	// A flipped key is the same rotation, the spline flips it back
+	keys[3] = dquat(-keys[3].xyz, -keys[3].w);
+	dquatspline spline(keys.data(), keys.size());
+
+	EXPECT_EQ(spline.size(), 6u);
+	EXPECT_GT(spline.keys()[3].dot(spline.keys()[2]), 0);
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		dquat q = spline.evaluate(static_cast<f64>(i));
+		EXPECT_NEAR(sml::abs(q.v.dot(keys[i].v)), 1, 1e-12);
+	}
+
+	// Clamped outside the keys
+	EXPECT_NEAR(sml::abs(spline.evaluate(-2).v.dot(keys[0].v)), 1, 1e-12);
+	EXPECT_NEAR(sml::abs(spline.evaluate(9).v.dot(keys[5].v)), 1, 1e-12);
+
+	// Matches quat::squad with the spline's control points
+	const std::vector<dquat>& k = spline.keys();
+	const std::vector<dquat>& c = spline.controls();
+	dquat expected = dquat::squad(k[2], c[2], c[3], k[3], 0.35);
+	EXPECT_NEAR(spline.evaluate(2.35).v.dot(expected.v), 1, 1e-9);
+}
+
+TEST(quatspline, Smooth)
+{
+	std::vector<dquat> keys = makekeys(5);
+	dquatspline spline(keys.data(), keys.size());
+
+	const f64 h = 1e-6;
+
+	for (f64 t : { 1.0, 2.0, 3.0 })
+	{
+		dvec3 before = angularvelocity(spline, t - h, h);
+		dvec3 after = angularvelocity(spline, t, h);
+		EXPECT_NEAR((after - before).length(), 0, 1e-4 * after.length());
+	}
+}
+
+TEST(quatspline, Degenerate)
+{
+	dquatspline empty;
+	EXPECT_EQ(empty.evaluate(1).w, 1);
+
+	dquat key = dquat::axisangle(dvec3(0, 0, 1), 1);
+	dquatspline single(&key, 1);
+	EXPECT_NEAR(single.evaluate(0.5).v.dot(key.v), 1, 1e-12);
+}
+
+template<typename T>
+static void testarrays()
+{
+	std::vector<quat<T>> keys;
+
+	for (size_t i = 0; i < 7; i++)
+	{
+		T s = static_cast<T>(i);
+		keys.push_back(quat<T>::axisangle(vec3<T>(1, s, 2 - s), static_cast<T>(0.5) * s));
+	}
+
+	quatspline<T> spline(keys.data(), keys.size());
+	std::vector<T> t(29);
+	std::vector<quat<T>> out(t.size());
+
+	for (size_t i = 0; i < t.size(); i++)
+	{
+		t[i] = static_cast<T>(i) * static_cast<T>(0.25) - static_cast<T>(0.3);
+	}
+
+	spline.evaluate(t.data(), t.size(), out.data());
+
+	for (size_t i = 0; i < t.size(); i++)
+	{
+		quat<T> expected = spline.evaluate(t[i]);
+		EXPECT_NEAR(out[i].v.dot(expected.v), 1, 1e-6);
+	}
+
+	// One sample per track
+	std::vector<quatspline<T>> tracks(t.size());
+
+	for (size_t i = 0; i < tracks.size(); i++)
+	{
+		tracks[i].build(keys.data() + i % 4, 3);
+	}
+
+	tracks[9] = quatspline<T>();
+	evaluate(tracks.data(), t.data(), tracks.size(), out.data());
+
+	for (size_t i = 0; i < tracks.size(); i++)
+	{
+		quat<T> expected = tracks[i].evaluate(t[i]);
+		EXPECT_NEAR(out[i].v.dot(expected.v), 1, 1e-6);
+	}
+}
+
+TEST(quatspline, Arrays)
+{
+	testarrays<f32>();
+	testarrays<f64>();
+}
@@ -266,6 +266,31 @@ TEST(fquat, TimesEqualsOperator)
 	EXPECT_EQ(lhs.w, -0.5);
 }
 
+TEST(fquat, MultiplyComposesRotations)
+{
+	fquat a = fquat::euler(30, 0, 0);
+	fquat b = fquat::euler(0, 60, 20);
+	fvec3 p(1, 2, 3);
+
+	fvec3 expected = a * (b * p);
+	fvec3 result = (a * b) * p;
+
+	EXPECT_NEAR(result.x, expected.x, 1e-5f);
+	EXPECT_NEAR(result.y, expected.y, 1e-5f);
+	EXPECT_NEAR(result.z, expected.z, 1e-5f);
+
+	dquat c = dquat::euler(30, 0, 0);
+	dquat d = dquat::euler(0, 60, 20);
+	dvec3 q(1, 2, 3);
+
+	dvec3 dexpected = c * (d * q);
+	dvec3 dresult = (c * d) * q;
+
+	EXPECT_NEAR(dresult.x, dexpected.x, 1e-12);
+	EXPECT_NEAR(dresult.y, dexpected.y, 1e-12);
+	EXPECT_NEAR(dresult.z, dexpected.z, 1e-12);
+}
+
 TEST(fquat, TimesEqualsScalarOperator)
 {
 	fquat lhs(1, 2, 3, 4);
@@ -292,6 +317,23 @@ TEST(fquat, Normalize)
 	EXPECT_FLOAT_EQ(q.length(), 1);
 }
 
+TEST(fquat, NormalizeFast)
+{
+	fquat q(1, 2, 3, 4);
+	fquat n = q.normalized();
+	q.normalizeFast();
+
+	EXPECT_NEAR(q.x, n.x, 1e-6f);
+	EXPECT_NEAR(q.y, n.y, 1e-6f);
+	EXPECT_NEAR(q.z, n.z, 1e-6f);
+	EXPECT_NEAR(q.w, n.w, 1e-6f);
+
+	fquat zero(0, 0, 0, 0);
+	zero.normalizeFast();
+
+	EXPECT_EQ(zero.w, 1);
+}
+
 TEST(fquat, Length)
 {
 	fquat q(1, 2, 3, 4);
@@ -329,6 +371,66 @@ TEST(fquat, EulerAngles)
 	EXPECT_EQ(euler.z, 0);
 }
 
+TEST(fquat, FromMatrix3)
+{
+	// One rotation per branch of the conversion: w, x, y and z largest
+	fquat rotations[] = { fquat::euler(10, 20, 30), fquat::axisangle(fvec3(1, 0, 0), 3), fquat::axisangle(fvec3(0, 1, 0), 3), fquat::axisangle(fvec3(0, 0, 1), 3) };
+
+	for (const fquat& q : rotations)
+	{
+		fvec3 c0 = q * fvec3(1, 0, 0);
+		fvec3 c1 = q * fvec3(0, 1, 0);
+		fvec3 c2 = q * fvec3(0, 0, 1);
+
+		fquat r = fquat::frommatrix3(fmat3(c0.x, c0.y, c0.z, c1.x, c1.y, c1.z, c2.x, c2.y, c2.z));
+
+		EXPECT_NEAR(r.length(), 1, 1e-6f);
+		EXPECT_NEAR(sml::abs(r.v.dot(q.v)), 1, 1e-6f);
+	}
+}
+
+TEST(fquat, FromMatrix4)
+{
+	fquat q = fquat::euler(-40, 75, 5);
+
+	fvec3 c0 = q * fvec3(1, 0, 0);
+	fvec3 c1 = q * fvec3(0, 1, 0);
+	fvec3 c2 = q * fvec3(0, 0, 1);
+
+	fquat r = fquat::frommatrix4(fmat4(c0.x, c0.y, c0.z, 0, c1.x, c1.y, c1.z, 0, c2.x, c2.y, c2.z, 0, 4, 5, 6, 1));
+
+	EXPECT_NEAR(sml::abs(r.v.dot(q.v)), 1, 1e-6f);
+}
+
+TEST(fquat, FromMatrix3Array)
+{
+	fmat3 matrices[19];
+	fquat expected[19];
+	fquat result[19];
+
+	for (s32 i = 0; i < 19; i++)
+	{
+		fquat q = fquat::euler(i * 37.0f, i * 71.0f - 180, i * 13.0f);
+
+		fvec3 c0 = q * fvec3(1, 0, 0);
+		fvec3 c1 = q * fvec3(0, 1, 0);
+		fvec3 c2 = q * fvec3(0, 0, 1);
+
+		matrices[i] = fmat3(c0.x, c0.y, c0.z, c1.x, c1.y, c1.z, c2.x, c2.y, c2.z);
+		expected[i] = fquat::frommatrix3(matrices[i]);
+	}
+
+	fquat::frommatrix3(matrices, result, 19);
+
+	for (s32 i = 0; i < 19; i++)
+	{
+		EXPECT_FLOAT_EQ(result[i].x, expected[i].x);
+		EXPECT_FLOAT_EQ(result[i].y, expected[i].y);
+		EXPECT_FLOAT_EQ(result[i].z, expected[i].z);
+		EXPECT_FLOAT_EQ(result[i].w, expected[i].w);
+	}
+}
+
 TEST(fquat, Identity)
 {
 	fquat q(1, 2, 3, 4);
@@ -340,6 +442,33 @@ TEST(fquat, Identity)
 	EXPECT_EQ(q.w, 1);
 }
 
+TEST(fquat, SlerpArray)
+{
+	const s32 count = 19;
+	fquat a[count], b[count], result[count];
+	f32 t[count];
+
+	for (s32 i = 0; i < count; i++)
+	{
+		a[i] = fquat::axisangle(fvec3(1, static_cast<f32>(i), 2), 0.1f * i);
+		b[i] = fquat::axisangle(fvec3(static_cast<f32>(i % 3), 1, -1), 3.0f - 0.3f * i);
+		t[i] = static_cast<f32>(i) / (count - 1);
+	}
+
+	// Opposite signs are the same rotation, the short way is taken
+	b[3] = fquat(-b[3].xyz, -b[3].w);
+	b[4] = a[4];
+
+	fquat::slerp(a, b, t, count, result);
+
+	for (s32 i = 0; i < count; i++)
+	{
+		fquat expected = fquat::slerp(a[i], b[i], t[i]);
+		EXPECT_NEAR(sml::abs(result[i].v.dot(expected.v)), 1.0f, 1e-5f);
+		EXPECT_NEAR(result[i].length(), 1.0f, 1e-5f);
+	}
+}
+
 // DQUAT Tests
 
 TEST(dquat, DefaultConstructor)
@@ -665,6 +794,33 @@ TEST(dquat, EulerAngles)
 	EXPECT_FLOAT_EQ(euler.z, 360);
 }
 
+TEST(dquat, FromMatrix4Array)
+{
+	dmat4 matrices[7];
+	dquat result[7];
+
+	for (s32 i = 0; i < 7; i++)
+	{
+		dquat q = dquat::euler(i * 53.0, i * 29.0 - 90, i * 101.0);
+
+		dvec3 c0 = q * dvec3(1, 0, 0);
+		dvec3 c1 = q * dvec3(0, 1, 0);
+		dvec3 c2 = q * dvec3(0, 0, 1);
+
+		matrices[i] = dmat4(c0.x, c0.y, c0.z, 0, c1.x, c1.y, c1.z, 0, c2.x, c2.y, c2.z, 0, i, i, i, 1);
+		result[i] = q;
+	}
+
+	dquat::frommatrix4(matrices, result, 7);
+
+	for (s32 i = 0; i < 7; i++)
+	{
+		dquat q = dquat::euler(i * 53.0, i * 29.0 - 90, i * 101.0);
+
+		EXPECT_NEAR(sml::abs(result[i].v.dot(q.v)), 1, 1e-12);
+	}
+}
+
 TEST(dquat, Identity)
 {
 	dquat q(1, 2, 3, 4);
@@ -676,3 +832,65 @@ TEST(dquat, Identity)
 	EXPECT_EQ(q.w, 1);
 }
 
+TEST(dquat, LogExp)
+{
+	dquat q = dquat::axisangle(dvec3(1, 2, 3), 1.2);
+	dquat l = q.log();
+
+	EXPECT_NEAR(l.w, 0, 1e-15);
+	EXPECT_NEAR(l.xyz.length(), 0.6, 1e-15);
+	EXPECT_NEAR(l.xyz.dot(dvec3(1, 2, 3).normalized()), 0.6, 1e-15);
+
+	dquat e = l.exp();
+	EXPECT_NEAR(e.x, q.x, 1e-15);
+	EXPECT_NEAR(e.y, q.y, 1e-15);
+	EXPECT_NEAR(e.z, q.z, 1e-15);
+	EXPECT_NEAR(e.w, q.w, 1e-15);
+
+	// Not unit length, log |q| goes to w
+	dquat scaled(q.xyz * 3.0, q.w * 3.0);
+	dquat back = scaled.log().exp();
+	EXPECT_NEAR(back.x, scaled.x, 1e-14);
+	EXPECT_NEAR(back.w, scaled.w, 1e-14);
+
+	// The identity has no axis
+	dquat zero = dquat::identity().log();
+	EXPECT_EQ(zero.xyz, dvec3(0, 0, 0));
+	EXPECT_EQ(zero.w, 0);
+	EXPECT_EQ(zero.exp().w, 1);
+}
+
+TEST(dquat, Pow)
+{
+	dquat q = dquat::axisangle(dvec3(0, 1, 1), 1.5);
+	dquat half = q.pow(0.5), third = dquat::axisangle(dvec3(0, 1, 1), 0.5);
+
+	dquat twice = half * half;
+	EXPECT_NEAR(twice.v.dot(q.v), 1, 1e-14);
+	EXPECT_NEAR(q.pow(1.0 / 3.0).v.dot(third.v), 1, 1e-14);
+	EXPECT_NEAR(q.pow(0).v.dot(dquat::identity().v), 1, 1e-15);
+
+	// pow follows slerp from the identity
+	EXPECT_NEAR(q.pow(0.3).v.dot(dquat::slerp(dquat::identity(), q, 0.3).v), 1, 1e-12);
+}
+
+TEST(dquat, Squad)
+{
+	dquat q0 = dquat::axisangle(dvec3(1, 0, 0), 0.2);
+	dquat q1 = dquat::axisangle(dvec3(0, 1, 0), 0.9);
+	dquat q2 = dquat::axisangle(dvec3(1, 1, 0), 1.4);
+	dquat q3 = dquat::axisangle(dvec3(0, 0, 1), 0.4);
+
+	dquat a1 = dquat::squadcontrol(q0, q1, q2), a2 = dquat::squadcontrol(q1, q2, q3);
+
+	// Ends at the keys
+	EXPECT_NEAR(dquat::squad(q1, a1, a2, q2, 0).v.dot(q1.v), 1, 1e-12);
+	EXPECT_NEAR(dquat::squad(q1, a1, a2, q2, 1).v.dot(q2.v), 1, 1e-12);
+
+	// Control points of keys on a single great circle lie on it, squad is slerp then
+	dvec3 axis(0, 0, 1);
+	dquat r0 = dquat::axisangle(axis, 0.0), r1 = dquat::axisangle(axis, 0.5), r2 = dquat::axisangle(axis, 1.0);
+	dquat control = dquat::squadcontrol(r0, r1, r2);
+	EXPECT_NEAR(control.v.dot(r1.v), 1, 1e-12);
+	EXPECT_NEAR(dquat::squad(r0, dquat::squadcontrol(r0, r0, r1), control, r1, 0.5).v.dot(dquat::slerp(r0, r1, 0.5).v), 1, 1e-3);
+}
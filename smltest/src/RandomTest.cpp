@@ -0,0 +1,174 @@
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// GENERATOR TESTS
+
+TEST(rng, Xoshiro)
+{
+	// Outputs of the reference xoshiro128** for the state { 1, 2, 3, 4 }
+	const u32 expected[] = { 11520, 0, 5927040, 70819200 };
+
+	alignas(32) u32 state[4][8];
+	for (size_t l = 0; l < 8; l++)
+	{
+		state[0][l] = 1;
+		state[1][l] = 2;
+		state[2][l] = 3;
+		state[3][l] = 4;
+	}
+
+	for (u32 e : expected)
+	{
+		for (size_t l = 0; l < 8; l++)
+		{
+			EXPECT_EQ(detail::xoshirostep<detail::xoshiroscalar>(state, l), e);
+		}
+	}
+}
+
+TEST(rng, Seeding)
+{
+	rng a(1234, 0), b(1234, 0), c(1234, 1), d(1235, 0);
+
+	u32 same = 0, stream = 0, seed = 0;
+	for (s32 i = 0; i < 64; i++)
+	{
+		u32 x = a.next();
+
+		same += x == b.next();
+		stream += x == c.next();
+		seed += x == d.next();
+	}
+
+	EXPECT_EQ(same, 64u);
+	EXPECT_LT(stream, 2u);
+	EXPECT_LT(seed, 2u);
+
+	a.seed(1234, 1);
+	c.seed(1234, 1);
+	EXPECT_EQ(a.next(), c.next());
+}
+
+TEST(rng, Uniform)
+{
+	rng r(7);
+
+	std::vector<f32> f(100003);
+	std::vector<f64> d(100003);
+	uniform(r, f.data(), f.size());
+	uniform(r, d.data(), d.size(), -2.0, 6.0);
+
+	f64 fsum = 0.0, dsum = 0.0;
+	for (size_t i = 0; i < f.size(); i++)
+	{
+		ASSERT_GE(f[i], 0.0f);
+		ASSERT_LT(f[i], 1.0f);
+		ASSERT_GE(d[i], -2.0);
+		ASSERT_LT(d[i], 6.0);
+
+		fsum += f[i];
+		dsum += d[i];
+	}
+
+	EXPECT_NEAR(fsum / f.size(), 0.5, 0.01);
+	EXPECT_NEAR(dsum / d.size(), 2.0, 0.04);
+
+	for (s32 i = 0; i < 1000; i++)
+	{
+		f64 u = r.uniform<f64>();
+		ASSERT_GE(u, 0.0);
+		ASSERT_LT(u, 1.0);
+	}
+}
+
+// SAMPLER TESTS
+
+TEST(rng, Samplers)
+{
+	const size_t count = 20003;
+	rng r(99, 5);
+
+	std::vector<fvec3> box(count), ball(count), sphere(count), hemisphere(count);
+	std::vector<fvec2> disc(count);
+	std::vector<dquat> rotations(count);
+
+	inbox(r, fvec3(-1, 2, 0), fvec3(1, 3, 5), box.data(), count);
+	insphere(r, ball.data(), count);
+	onsphere(r, sphere.data(), count);
+	sml::hemisphere(r, hemisphere.data(), count);
+	indisc(r, disc.data(), count);
+	rotation(r, rotations.data(), count);
+
+	fvec3 boxmean(0, 0, 0), spheremean(0, 0, 0);
+	f64 ballradius = 0.0, hemispherez = 0.0, discradius = 0.0, rotationw = 0.0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_GE(box[i].x, -1.0f);
+		ASSERT_LT(box[i].x, 1.0f);
+		ASSERT_GE(box[i].y, 2.0f);
+		ASSERT_LT(box[i].y, 3.0f);
+		ASSERT_GE(box[i].z, 0.0f);
+		ASSERT_LT(box[i].z, 5.0f);
+
+		ASSERT_LE(ball[i].length(), 1.0f + 1e-6f);
+		ASSERT_NEAR(sphere[i].length(), 1.0f, 1e-6f);
+		ASSERT_NEAR(hemisphere[i].length(), 1.0f, 1e-6f);
+		ASSERT_GE(hemisphere[i].z, 0.0f);
+		ASSERT_LE(disc[i].length(), 1.0f + 1e-6f);
+		ASSERT_NEAR(rotations[i].length(), 1.0, 1e-12);
+
+		boxmean += box[i];
+		spheremean += sphere[i];
+		ballradius += ball[i].length();
+		hemispherez += hemisphere[i].z;
+		discradius += disc[i].length();
+		rotationw += abs(rotations[i].w);
+	}
+
+	const f32 n = static_cast<f32>(count);
+
+	// Expected means: radius 3/4 in the ball, 2/3 in the disc, cos theta 2/3 for the cosine
+	// weighted hemisphere, |w| 4 / (3 pi) of a uniform rotation
+	EXPECT_NEAR(boxmean.x / n, 0.0f, 0.02f);
+	EXPECT_NEAR(boxmean.y / n, 2.5f, 0.01f);
+	EXPECT_NEAR(boxmean.z / n, 2.5f, 0.05f);
+	EXPECT_NEAR(spheremean.length() / n, 0.0f, 0.02f);
+	EXPECT_NEAR(ballradius / n, 0.75, 0.01);
+	EXPECT_NEAR(discradius / n, 2.0 / 3.0, 0.01);
+	EXPECT_NEAR(hemispherez / n, 2.0 / 3.0, 0.01);
+	EXPECT_NEAR(rotationw / n, 4.0 / (3.0 * 3.14159265358979323846), 0.01);
+}
+
+TEST(rng, StructureOfArrays)
+{
+	// The array forms match between SoA and AoS output for the same seed, with a remainder
+	const size_t count = 19;
+
+	rng a(3), b(3);
+
+	f64 x[count], y[count], z[count], w[count];
+	dquat q[count];
+
+	rotation(a, x, y, z, w, count);
+	rotation(b, q, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		EXPECT_EQ(q[i].x, x[i]);
+		EXPECT_EQ(q[i].y, y[i]);
+		EXPECT_EQ(q[i].z, z[i]);
+		EXPECT_EQ(q[i].w, w[i]);
+	}
+
+	fvec3 p = a.onsphere<f32>();
+	fvec2 d = a.indisc<f32>();
+
+	EXPECT_NEAR(p.length(), 1.0f, 1e-6f);
+	EXPECT_LE(d.length(), 1.0f);
+}
@@ -0,0 +1,213 @@
+#include <rotation.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+namespace
+{
+	const eulerorder orders[] = { eulerorder::xyz, eulerorder::xzy, eulerorder::yxz, eulerorder::yzx, eulerorder::zxy, eulerorder::zyx };
+
+	template<typename T>
+	mat4<T> axisrotation(size_t axis, T angle)
+	{
+		const vec3<T> axes[3] = { vec3<T>(1, 0, 0), vec3<T>(0, 1, 0), vec3<T>(0, 0, 1) };
+		return mat4<T>::rotate(axes[axis], angle);
+	}
+
+	// The rotation of the order by multiplying single axis matrices, the first axis rightmost
+	template<typename T>
+	mat4<T> eulermatrix(const vec3<T>& angles, eulerorder order)
+	{
+		static const size_t axes[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+		const size_t* a = axes[static_cast<size_t>(order)];
+
+		return axisrotation(a[2], angles.v[a[2]]) * axisrotation(a[1], angles.v[a[1]]) * axisrotation(a[0], angles.v[a[0]]);
+	}
+
+	template<typename T>
+	void expectrotation(const mat4<T>& a, const mat4<T>& b, T epsilon)
+	{
+		for (size_t c = 0; c < 3; c++)
+		{
+			for (size_t r = 0; r < 3; r++)
+			{
+				EXPECT_NEAR(a.v[4 * c + r], b.v[4 * c + r], epsilon) << "column " << c << " row " << r;
+			}
+		}
+	}
+
+	// Angles in the range matrixtoeuler returns, the middle axis of the order within 90 degrees
+	template<typename T>
+	std::vector<vec3<T>> randomangles(size_t count, eulerorder order)
+	{
+		const size_t middle[6] = { 1, 2, 0, 2, 0, 1 };
+
+		rng random(11);
+		std::vector<vec3<T>> angles(count);
+
+		for (vec3<T>& a : angles)
+		{
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				a.v[axis] = axis == middle[static_cast<size_t>(order)] ? random.uniform<T>(-1.5, 1.5) : random.uniform<T>(-3, 3);
+			}
+		}
+
+		return angles;
+	}
+}
+
+// ROTATION TESTS
+
+TEST(rotation, EulerOrders)
+{
+	for (eulerorder order : orders)
+	{
+		std::vector<dvec3> angles = randomangles<f64>(37, order);
+		std::vector<dmat4> matrices(angles.size());
+
+		eulertomatrix(angles.data(), matrices.data(), angles.size(), order);
+
+		for (size_t i = 0; i < angles.size(); i++)
+		{
+			expectrotation(matrices[i], eulermatrix(angles[i], order), 1e-12);
+		}
+	}
+}
+
+TEST(rotation, EulerRoundTrip)
+{
+	for (eulerorder order : orders)
+	{
+		std::vector<dvec3> angles = randomangles<f64>(37, order);
+		std::vector<dquat> rotations(angles.size());
+		std::vector<dvec3> back(angles.size());
+
+		eulertoquat(angles.data(), rotations.data(), angles.size(), order);
+		quattoeuler(rotations.data(), back.data(), angles.size(), order);
+
+		for (size_t i = 0; i < angles.size(); i++)
+		{
+			EXPECT_NEAR(back[i].x, angles[i].x, 1e-9);
+			EXPECT_NEAR(back[i].y, angles[i].y, 1e-9);
+			EXPECT_NEAR(back[i].z, angles[i].z, 1e-9);
+		}
+	}
+}
+
+TEST(rotation, GimbalLock)
+{
+	std::vector<fvec3> angles = { fvec3(0.3f, 90.0f, -0.4f), fvec3(0.3f, -90.0f, -0.4f), fvec3(10.0f, 89.99f, 20.0f), fvec3(-50.0f, -90.0f, 0.0f) };
+	std::vector<fvec3> back(angles.size());
+	std::vector<fmat4> matrices(angles.size());
+	std::vector<fmat4> rebuilt(angles.size());
+
+	for (eulerorder order : orders)
+	{
+		for (fvec3& a : angles)
+		{
+			std::swap(a.x, a.y);
+		}
+
+		eulertomatrix(angles.data(), matrices.data(), angles.size(), order, angleunit::degrees);
+		matrixtoeuler(matrices.data(), back.data(), angles.size(), order, angleunit::degrees);
+		eulertomatrix(back.data(), rebuilt.data(), angles.size(), order, angleunit::degrees);
+
+		for (size_t i = 0; i < angles.size(); i++)
+		{
+			expectrotation(rebuilt[i], matrices[i], 1e-3f);
+		}
+	}
+}
+
+TEST(rotation, YawPitchRoll)
+{
+	fvec3 angles[9];
+	fmat4 matrices[9];
+
+	for (size_t i = 0; i < 9; i++)
+	{
+		angles[i] = fvec3(0.1f * i - 0.3f, 0.5f - 0.2f * i, 0.3f * i);
+	}
+
+	eulertomatrix(angles, matrices, 9, eulerorder::zxy);
+
+	for (size_t i = 0; i < 9; i++)
+	{
+		expectrotation(matrices[i], fmat4::rotate(-angles[i].y, angles[i].x, angles[i].z), 1e-5f);
+	}
+}
+
+TEST(rotation, AxisAngle)
+{
+	rng random(5);
+	std::vector<fvec4> axisangles(29);
+
+	for (fvec4& a : axisangles)
+	{
+		fvec3 axis = random.insphere<f32>().normalized();
+		a = fvec4(axis.x, axis.y, axis.z, random.uniform<f32>() * 3.1f);
+	}
+
+	std::vector<fquat> rotations(axisangles.size());
+	std::vector<fmat4> matrices(axisangles.size());
+	std::vector<fvec4> back(axisangles.size());
+	std::vector<fvec4> frommatrix(axisangles.size());
+
+	axisangletoquat(axisangles.data(), rotations.data(), axisangles.size());
+	axisangletomatrix(axisangles.data(), matrices.data(), axisangles.size());
+	quattoaxisangle(rotations.data(), back.data(), axisangles.size());
+	matrixtoaxisangle(matrices.data(), frommatrix.data(), axisangles.size());
+
+	for (size_t i = 0; i < axisangles.size(); i++)
+	{
+		const fvec4& a = axisangles[i];
+		fquat expected = fquat::axisangle(fvec3(a.x, a.y, a.z), a.w);
+
+		EXPECT_NEAR(rotations[i].x, expected.x, 1e-5f);
+		EXPECT_NEAR(rotations[i].y, expected.y, 1e-5f);
+		EXPECT_NEAR(rotations[i].z, expected.z, 1e-5f);
+		EXPECT_NEAR(rotations[i].w, expected.w, 1e-5f);
+		expectrotation(matrices[i], fmat4::rotate(fvec3(a.x, a.y, a.z), a.w), 1e-5f);
+
+		for (size_t c = 0; c < 4; c++)
+		{
+			EXPECT_NEAR(back[i].v[c], a.v[c], 1e-4f);
+			EXPECT_NEAR(frommatrix[i].v[c], a.v[c], 1e-4f);
+		}
+	}
+
+	fquat identity[1] = { fquat() };
+	fvec4 none[1];
+	quattoaxisangle(identity, none, 1);
+	EXPECT_EQ(none[0], fvec4(1, 0, 0, 0));
+}
+
+TEST(rotation, Conversions)
+{
+	std::vector<dvec3> angles = randomangles<f64>(13, eulerorder::yxz);
+	std::vector<dquat> rotations(angles.size()), frommatrix(angles.size());
+	std::vector<dmat4> matrices(angles.size()), fromquat(angles.size());
+	std::vector<dvec4> axisangles(angles.size());
+	std::vector<dvec3> back(angles.size());
+
+	eulertoquat(angles.data(), rotations.data(), angles.size(), eulerorder::yxz);
+	eulertomatrix(angles.data(), matrices.data(), angles.size(), eulerorder::yxz);
+	quattomatrix(rotations.data(), fromquat.data(), angles.size());
+	matrixtoquat(matrices.data(), frommatrix.data(), angles.size());
+	eulertoaxisangle(angles.data(), axisangles.data(), angles.size(), eulerorder::yxz);
+	axisangletoeuler(axisangles.data(), back.data(), angles.size(), eulerorder::yxz);
+
+	for (size_t i = 0; i < angles.size(); i++)
+	{
+		expectrotation(fromquat[i], matrices[i], 1e-12);
+		EXPECT_NEAR(std::abs(frommatrix[i].dot(rotations[i])), 1.0, 1e-12);
+		EXPECT_NEAR(back[i].x, angles[i].x, 1e-9);
+		EXPECT_NEAR(back[i].y, angles[i].y, 1e-9);
+		EXPECT_NEAR(back[i].z, angles[i].z, 1e-9);
+	}
+}
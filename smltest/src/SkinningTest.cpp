@@ -0,0 +1,304 @@
+#include <skinning.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sml;
+
+// LINEAR BLEND TESTS
+
+// Reference: the weighted sum of every influence transformed on its own
+static fvec3 blendpoint(const fmat4* palette, const u16* joint, const f32* weight, s32 influences, const fvec3& p, f32 w)
+{
+	fvec4 res(0.0f, 0.0f, 0.0f, 0.0f);
+
+	for (s32 k = 0; k < influences; k++)
+	{
+		res += (palette[joint[k]] * fvec4(p.x, p.y, p.z, w)) * weight[k];
+	}
+
+	return fvec3(res.x, res.y, res.z);
+}
+
+TEST(skinning, LinearBlend)
+{
+	const size_t count = 21;
+	const u16 joints = 6;
+
+	std::vector<fmat4> palette;
+	std::vector<f32> affine;
+	for (u16 j = 0; j < joints; j++)
+	{
+		fmat4 m = fmat4::compose(fvec3(static_cast<f32>(j), -1, 2), fquat::euler(j * 30.0f, j * 10.0f, 5), fvec3(1, 1 + j * 0.1f, 1));
+		palette.push_back(m);
+
+		for (s32 r = 0; r < 3; r++)
+		{
+			for (s32 c = 0; c < 4; c++)
+			{
+				affine.push_back(m.col[c].v[r]);
+			}
+		}
+	}
+
+	std::vector<f32> position[3], normal[3], weight[4], outposition[3], outnormal[3], affineposition[3], affinenormal[3];
+	std::vector<u16> joint[4];
+
+	for (s32 c = 0; c < 4; c++)
+	{
+		weight[c].resize(count);
+		joint[c].resize(count);
+	}
+
+	for (s32 c = 0; c < 3; c++)
+	{
+		position[c].resize(count);
+		normal[c].resize(count);
+		outposition[c].resize(count);
+		outnormal[c].resize(count);
+		affineposition[c].resize(count);
+		affinenormal[c].resize(count);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		position[0][i] = static_cast<f32>(i);
+		position[1][i] = 2.0f;
+		position[2][i] = -0.25f * i;
+		normal[0][i] = 0.6f;
+		normal[1][i] = 0.0f;
+		normal[2][i] = 0.8f;
+
+		for (s32 k = 0; k < 4; k++)
+		{
+			joint[k][i] = static_cast<u16>((i + 2 * k) % joints);
+		}
+	}
+
+	skinstreams<f32> streams = {};
+	for (s32 c = 0; c < 3; c++)
+	{
+		streams.position[c] = position[c].data();
+		streams.normal[c] = normal[c].data();
+	}
+
+	for (s32 c = 0; c < 4; c++)
+	{
+		streams.joint[c] = joint[c].data();
+		streams.weight[c] = weight[c].data();
+	}
+
+	for (u32 influences = 1; influences <= 4; influences++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			f32 first = influences == 1 ? 1.0f : 0.3f + 0.02f * i;
+
+			weight[0][i] = first;
+			for (u32 k = 1; k < 4; k++)
+			{
+				weight[k][i] = k < influences ? (1.0f - first) / (influences - 1) : 0.0f;
+			}
+		}
+
+		streams.influences = influences;
+
+		for (s32 c = 0; c < 3; c++)
+		{
+			streams.outposition[c] = outposition[c].data();
+			streams.outnormal[c] = outnormal[c].data();
+		}
+
+		skinlinear(palette.data(), streams, count);
+
+		for (s32 c = 0; c < 3; c++)
+		{
+			streams.outposition[c] = affineposition[c].data();
+			streams.outnormal[c] = affinenormal[c].data();
+		}
+
+		skinlinearaffine(affine.data(), streams, count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			u16 j[4] = { joint[0][i], joint[1][i], joint[2][i], joint[3][i] };
+			f32 w[4] = { weight[0][i], weight[1][i], weight[2][i], weight[3][i] };
+
+			fvec3 p = blendpoint(palette.data(), j, w, influences, fvec3(position[0][i], position[1][i], position[2][i]), 1);
+			fvec3 n = blendpoint(palette.data(), j, w, influences, fvec3(normal[0][i], normal[1][i], normal[2][i]), 0).normalized();
+
+			EXPECT_NEAR(outposition[0][i], p.x, 1e-4f);
+			EXPECT_NEAR(outposition[1][i], p.y, 1e-4f);
+			EXPECT_NEAR(outposition[2][i], p.z, 1e-4f);
+			EXPECT_NEAR(outnormal[0][i], n.x, 1e-5f);
+			EXPECT_NEAR(outnormal[1][i], n.y, 1e-5f);
+			EXPECT_NEAR(outnormal[2][i], n.z, 1e-5f);
+
+			EXPECT_NEAR(affineposition[0][i], p.x, 1e-4f);
+			EXPECT_NEAR(affineposition[1][i], p.y, 1e-4f);
+			EXPECT_NEAR(affineposition[2][i], p.z, 1e-4f);
+			EXPECT_NEAR(affinenormal[0][i], n.x, 1e-5f);
+			EXPECT_NEAR(affinenormal[1][i], n.y, 1e-5f);
+			EXPECT_NEAR(affinenormal[2][i], n.z, 1e-5f);
+		}
+	}
+}
+
+TEST(skinning, LinearBlendDouble)
+{
+	const size_t count = 7;
+	dmat4 palette[2] = { dmat4::compose(dvec3(1, 2, 3), dquat::euler(10, 20, 30), dvec3(2, 2, 2)), dmat4::compose(dvec3(0, -1, 0), dquat::euler(-50, 0, 5), dvec3(1, 1, 1)) };
+
+	f64 px[count] = { 0, 1, 2, 3, 4, 5, 6 }, py[count] = { 1, 1, 1, 1, 1, 1, 1 }, pz[count] = { 6, 5, 4, 3, 2, 1, 0 };
+	f64 ox[count], oy[count], oz[count];
+	f64 w[count] = { 1, 0.5, 0.25, 0, 0.75, 0.1, 0.9 };
+	u16 j0[count] = { 0, 0, 0, 0, 0, 0, 0 }, j1[count] = { 1, 1, 1, 1, 1, 1, 1 };
+
+	skinstreams<f64> streams = {};
+	streams.position[0] = px;
+	streams.position[1] = py;
+	streams.position[2] = pz;
+	streams.joint[0] = j0;
+	streams.joint[1] = j1;
+	streams.weight[0] = w;
+	streams.influences = 2;
+	streams.outposition[0] = ox;
+	streams.outposition[1] = oy;
+	streams.outposition[2] = oz;
+
+	skinlinear(palette, streams, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		dvec4 p(px[i], py[i], pz[i], 1.0);
+		dvec4 expected = (palette[0] * p) * w[i] + (palette[1] * p) * (1 - w[i]);
+
+		EXPECT_NEAR(ox[i], expected.x, 1e-12);
+		EXPECT_NEAR(oy[i], expected.y, 1e-12);
+		EXPECT_NEAR(oz[i], expected.z, 1e-12);
+	}
+}
+
+// DUAL QUATERNION TESTS
+
+TEST(skinning, DualQuaternion)
+{
+	const size_t count = 19;
+	const u16 joints = 5;
+
+	std::vector<fdualquat> palette;
+	for (u16 j = 0; j < joints; j++)
+	{
+		palette.emplace_back(fquat::euler(j * 40.0f, j * 15.0f, 0), fvec3(static_cast<f32>(j), 0, 1));
+	}
+
+	// Same rotation on the other hemisphere, must not cancel out
+	palette[4].real *= -1.0f;
+	palette[4].dual *= -1.0f;
+
+	std::vector<f32> position[3], normal[3], weight[3], outposition[3], outnormal[3];
+	std::vector<u16> joint[3];
+
+	for (s32 c = 0; c < 3; c++)
+	{
+		position[c].resize(count);
+		normal[c].resize(count);
+		weight[c].resize(count);
+		outposition[c].resize(count);
+		outnormal[c].resize(count);
+		joint[c].resize(count);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		position[0][i] = static_cast<f32>(i);
+		position[1][i] = 1.0f;
+		position[2][i] = -0.5f * i;
+		normal[0][i] = 0;
+		normal[1][i] = 1;
+		normal[2][i] = 0;
+
+		joint[0][i] = static_cast<u16>(i % joints);
+		joint[1][i] = static_cast<u16>((i + 1) % joints);
+		joint[2][i] = static_cast<u16>((i + 3) % joints);
+		weight[0][i] = 0.5f;
+		weight[1][i] = i % 2 == 0 ? 0.5f : 0.25f;
+		weight[2][i] = i % 2 == 0 ? 0.0f : 0.25f;
+	}
+
+	skinstreams<f32> streams = {};
+	for (s32 c = 0; c < 3; c++)
+	{
+		streams.position[c] = position[c].data();
+		streams.normal[c] = normal[c].data();
+		streams.joint[c] = joint[c].data();
+		streams.weight[c] = weight[c].data();
+		streams.outposition[c] = outposition[c].data();
+		streams.outnormal[c] = outnormal[c].data();
+	}
+	streams.influences = 3;
+
+	skindualquat(palette.data(), streams, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		fdualquat first = palette[joint[0][i]];
+		fdualquat blend = first * weight[0][i];
+
+		for (s32 k = 1; k < 3; k++)
+		{
+			fdualquat dq = palette[joint[k][i]];
+			f32 w = first.real.v.dot(dq.real.v) < 0 ? -weight[k][i] : weight[k][i];
+
+			blend += dq * w;
+		}
+
+		f32 inv = 1.0f / blend.real.length();
+		blend *= inv;
+
+		fvec3 p = blend * fvec3(position[0][i], position[1][i], position[2][i]);
+		fvec3 n = blend.transformVector(fvec3(normal[0][i], normal[1][i], normal[2][i]));
+
+		EXPECT_NEAR(outposition[0][i], p.x, 1e-4f);
+		EXPECT_NEAR(outposition[1][i], p.y, 1e-4f);
+		EXPECT_NEAR(outposition[2][i], p.z, 1e-4f);
+		EXPECT_NEAR(outnormal[0][i], n.x, 1e-5f);
+		EXPECT_NEAR(outnormal[1][i], n.y, 1e-5f);
+		EXPECT_NEAR(outnormal[2][i], n.z, 1e-5f);
+	}
+}
+
+TEST(skinning, DualQuaternionRigid)
+{
+	// A single influence reproduces the joint transform exactly
+	const size_t count = 6;
+	ddualquat palette[2] = { ddualquat(dquat::euler(10, 20, 30), dvec3(1, 2, 3)), ddualquat(dquat::euler(-50, 0, 5), dvec3(0, -1, 0)) };
+
+	f64 px[count] = { 0, 1, 2, 3, 4, 5 }, py[count] = { 1, 1, 1, 1, 1, 1 }, pz[count] = { 5, 4, 3, 2, 1, 0 };
+	f64 ox[count], oy[count], oz[count];
+	f64 w[count] = { 1, 1, 1, 1, 1, 1 };
+	u16 j[count] = { 0, 1, 0, 1, 1, 0 };
+
+	skinstreams<f64> streams = {};
+	streams.position[0] = px;
+	streams.position[1] = py;
+	streams.position[2] = pz;
+	streams.joint[0] = j;
+	streams.weight[0] = w;
+	streams.influences = 1;
+	streams.outposition[0] = ox;
+	streams.outposition[1] = oy;
+	streams.outposition[2] = oz;
+
+	skindualquat(palette, streams, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		dvec3 expected = palette[j[i]] * dvec3(px[i], py[i], pz[i]);
+
+		EXPECT_NEAR(ox[i], expected.x, 1e-12);
+		EXPECT_NEAR(oy[i], expected.y, 1e-12);
+		EXPECT_NEAR(oz[i], expected.z, 1e-12);
+	}
+}
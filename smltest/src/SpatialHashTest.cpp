@@ -0,0 +1,142 @@
+#include <spatialhash.h>
+#include <random.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sml;
+
+template<typename T>
+static std::vector<u32> bruteforce(const std::vector<vec3<T>>& points, const vec3<T>& center, T radius)
+{
+	std::vector<u32> result;
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		vec3<T> d = points[i] - center;
+		if (d.x * d.x + d.y * d.y + d.z * d.z <= radius * radius)
+			result.push_back(static_cast<u32>(i));
+	}
+
+	return result;
+}
+
+template<typename T>
+static void compare(const spatialhash<T>& grid, const std::vector<vec3<T>>& points, const std::vector<vec3<T>>& centers, T radius)
+{
+	std::vector<u32> found;
+	for (const vec3<T>& c : centers)
+	{
+		found.clear();
+		grid.query(c, radius, found);
+		std::sort(found.begin(), found.end());
+
+		ASSERT_EQ(found, bruteforce(points, c, radius));
+	}
+}
+
+// QUERY TESTS
+
+TEST(spatialhash, Query)
+{
+	rng r(11);
+
+	std::vector<fvec3> points(5003), centers(200);
+	inbox(r, fvec3(-10, -10, -10), fvec3(10, 10, 10), points.data(), points.size());
+	inbox(r, fvec3(-12, -12, -12), fvec3(12, 12, 12), centers.data(), centers.size());
+
+	spatialhash<f32> grid(1.0f);
+	grid.build(points.data(), points.size());
+
+	EXPECT_EQ(grid.size(), points.size());
+
+	compare(grid, points, centers, 1.0f);
+	compare(grid, points, centers, 0.3f);
+	compare(grid, points, centers, 2.5f);
+
+	// A radius covering more cells than there are buckets scans everything once
+	compare(grid, points, centers, 30.0f);
+
+	f32 maximum = 0.0f;
+	grid.query(fvec3(0, 0, 0), 1.5f, [&](u32 index, f32 dsq)
+	{
+		EXPECT_FLOAT_EQ(dsq, points[index].dot(points[index]));
+		maximum = std::max(maximum, dsq);
+	});
+
+	EXPECT_LE(maximum, 1.5f * 1.5f);
+}
+
+TEST(spatialhash, Ordering)
+{
+	rng r(5);
+
+	std::vector<dvec3> points(777);
+	inbox(r, dvec3(0, 0, 0), dvec3(4, 4, 4), points.data(), points.size());
+
+	spatialhash<f64> grid(0.5);
+	grid.build(points.data(), points.size());
+
+	// A permutation of the points
+	std::vector<u32> order = grid.ordering();
+	std::sort(order.begin(), order.end());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		ASSERT_EQ(order[i], i);
+	}
+
+	std::vector<dvec3> reordered;
+	for (u32 i : grid.ordering())
+	{
+		reordered.push_back(points[i]);
+	}
+
+	grid.build(reordered.data(), reordered.size());
+	compare(grid, reordered, std::vector<dvec3>{ dvec3(1, 1, 1), dvec3(3, 0.5, 2) }, 0.7);
+}
+
+// UPDATE TESTS
+
+TEST(spatialhash, Update)
+{
+	rng r(23);
+
+	std::vector<fvec3> points(4000), centers(64);
+	inbox(r, fvec3(0, 0, 0), fvec3(16, 16, 16), points.data(), points.size());
+	inbox(r, fvec3(0, 0, 0), fvec3(16, 16, 16), centers.data(), centers.size());
+
+	spatialhash<f32> grid(1.0f);
+	grid.build(points.data(), points.size());
+
+	// Small steps, few points change cells and the grid keeps them aside
+	bool rebuilt = false;
+	for (s32 step = 0; step < 3; step++)
+	{
+		for (fvec3& p : points)
+		{
+			p += (r.inbox(fvec3(0, 0, 0), fvec3(1, 1, 1)) - fvec3(0.5f, 0.5f, 0.5f)) * 0.01f;
+		}
+
+		rebuilt |= grid.update(points.data(), points.size());
+		compare(grid, points, centers, 1.2f);
+	}
+
+	EXPECT_FALSE(rebuilt);
+	EXPECT_GT(grid.movedcount(), 0u);
+
+	// Large steps move most points and force a rebuild
+	for (fvec3& p : points)
+	{
+		p += fvec3(0.7f, -1.3f, 2.1f);
+	}
+
+	EXPECT_TRUE(grid.update(points.data(), points.size()));
+	EXPECT_EQ(grid.movedcount(), 0u);
+	compare(grid, points, centers, 1.2f);
+
+	// A different count rebuilds as well
+	points.resize(100);
+	EXPECT_TRUE(grid.update(points.data(), points.size()));
+	compare(grid, points, centers, 3.0f);
+}
@@ -966,6 +966,17 @@ TEST(fvec3, Length)
 	EXPECT_EQ(l, sml::sqrt(1250.0f));
 }
 
+TEST(fvec3, Sqrt)
+{
+	fvec3 v(4, 9, 16);
+
+	fvec3 r = v.sqrt();
+
+	EXPECT_EQ(r.x, 2);
+	EXPECT_EQ(r.y, 3);
+	EXPECT_EQ(r.z, 4);
+}
+
 TEST(fvec3, LengthSquared)
 {
 	fvec3 v(15, 20, 25);
@@ -988,6 +999,24 @@ TEST(fvec3, Normalize)
 	EXPECT_EQ(v.length(), 1);
 }
 
+TEST(fvec3, NormalizeFast)
+{
+	fvec3 v(10, 15, 10);
+	fvec3 n = v.normalized();
+	v.normalizeFast();
+
+	EXPECT_NEAR(v.x, n.x, 1e-6f);
+	EXPECT_NEAR(v.y, n.y, 1e-6f);
+	EXPECT_NEAR(v.z, n.z, 1e-6f);
+
+	EXPECT_NEAR(v.length(), 1, 1e-6f);
+
+	fvec3 zero(0, 0, 0);
+	zero.normalizeFast();
+
+	EXPECT_EQ(zero, fvec3(0, 0, 0));
+}
+
 TEST(fvec3, Distance)
 {
 	fvec3 lhs(0, 0, 0);
@@ -1363,6 +1392,17 @@ TEST(dvec3, Length)
 	EXPECT_EQ(l, sml::sqrt(1250.0));
 }
 
+TEST(dvec3, Sqrt)
+{
+	dvec3 v(4, 9, 16);
+
+	dvec3 r = v.sqrt();
+
+	EXPECT_EQ(r.x, 2);
+	EXPECT_EQ(r.y, 3);
+	EXPECT_EQ(r.z, 4);
+}
+
 TEST(dvec3, LengthSquared)
 {
 	dvec3 v(15, 20, 25);
@@ -2229,6 +2269,18 @@ TEST(dvec4, Normalize)
 	EXPECT_FLOAT_EQ(v.length(), 1);
 }
 
+TEST(dvec4, NormalizeFast)
+{
+	dvec4 v(10, 15, 10, 5);
+	dvec4 n = v.normalized();
+	v.normalizeFast();
+
+	EXPECT_DOUBLE_EQ(v.x, n.x);
+	EXPECT_DOUBLE_EQ(v.y, n.y);
+	EXPECT_DOUBLE_EQ(v.z, n.z);
+	EXPECT_DOUBLE_EQ(v.w, n.w);
+}
+
 TEST(dvec4, Distance)
 {
 	dvec4 lhs(0, 0, 0, 0);
@@ -2388,4 +2440,134 @@ TEST(dvec4, NegateOperator)
 	EXPECT_EQ(v.y, -5);
 	EXPECT_EQ(v.z, -2);
 	EXPECT_EQ(v.w, -1);
-}
\ No newline at end of file
+}
+// IVEC / UVEC TESTS
+
+TEST(ivec3, VectorPlusEquals)
+{
+	ivec3 lhs(10, -10, 10);
+	ivec3 rhs(5, 2, -5);
+
+	lhs += rhs;
+
+	EXPECT_EQ(lhs.x, 15);
+	EXPECT_EQ(lhs.y, -8);
+	EXPECT_EQ(lhs.z, 5);
+}
+
+TEST(ivec3, VectorMinusEquals)
+{
+	ivec3 lhs(10, -10, 10);
+	ivec3 rhs(5, 2, -5);
+
+	lhs -= rhs;
+
+	EXPECT_EQ(lhs.x, 5);
+	EXPECT_EQ(lhs.y, -12);
+	EXPECT_EQ(lhs.z, 15);
+}
+
+TEST(ivec3, VectorTimesEquals)
+{
+	ivec3 lhs(10, -10, 10);
+	ivec3 rhs(5, 2, -5);
+
+	lhs *= rhs;
+
+	EXPECT_EQ(lhs.x, 50);
+	EXPECT_EQ(lhs.y, -20);
+	EXPECT_EQ(lhs.z, -50);
+}
+
+TEST(ivec3, ScalarTimesEquals)
+{
+	ivec3 lhs(10, -10, 10);
+
+	lhs *= -2;
+
+	EXPECT_EQ(lhs.x, -20);
+	EXPECT_EQ(lhs.y, 20);
+	EXPECT_EQ(lhs.z, -20);
+}
+
+TEST(ivec3, Min)
+{
+	ivec3 lhs(10, -15, 20);
+	ivec3 rhs(4, 25, -40);
+
+	ivec3 m = ivec3::min(lhs, rhs);
+
+	EXPECT_EQ(m.x, 4);
+	EXPECT_EQ(m.y, -15);
+	EXPECT_EQ(m.z, -40);
+}
+
+TEST(ivec3, Max)
+{
+	ivec3 lhs(10, -15, 20);
+	ivec3 rhs(4, 25, -40);
+
+	ivec3 m = ivec3::max(lhs, rhs);
+
+	EXPECT_EQ(m.x, 10);
+	EXPECT_EQ(m.y, 25);
+	EXPECT_EQ(m.z, 20);
+}
+
+TEST(ivec3, NegateOperator)
+{
+	ivec3 v(10, -5, 2);
+	v = -v;
+
+	EXPECT_EQ(v.x, -10);
+	EXPECT_EQ(v.y, 5);
+	EXPECT_EQ(v.z, -2);
+}
+
+TEST(uvec3, Min)
+{
+	uvec3 lhs(10, 0xFFFFFFF0u, 20);
+	uvec3 rhs(4, 25, 40);
+
+	uvec3 m = uvec3::min(lhs, rhs);
+
+	EXPECT_EQ(m.x, 4u);
+	EXPECT_EQ(m.y, 25u);
+	EXPECT_EQ(m.z, 20u);
+}
+
+TEST(uvec3, Max)
+{
+	uvec3 lhs(10, 0xFFFFFFF0u, 20);
+	uvec3 rhs(4, 25, 40);
+
+	uvec3 m = uvec3::max(lhs, rhs);
+
+	EXPECT_EQ(m.x, 10u);
+	EXPECT_EQ(m.y, 0xFFFFFFF0u);
+	EXPECT_EQ(m.z, 40u);
+}
+
+TEST(ivec2, VectorPlusOperator)
+{
+	ivec2 lhs(10, -10);
+	ivec2 rhs(5, 2);
+
+	ivec2 r = lhs + rhs;
+
+	EXPECT_EQ(r.x, 15);
+	EXPECT_EQ(r.y, -8);
+}
+
+TEST(uvec4, VectorMultiplyOperator)
+{
+	uvec4 lhs(10, 10, 0x10000u, 1);
+	uvec4 rhs(5, 2, 0x10000u, 0);
+
+	uvec4 r = lhs * rhs;
+
+	EXPECT_EQ(r.x, 50u);
+	EXPECT_EQ(r.y, 20u);
+	EXPECT_EQ(r.z, 0u);
+	EXPECT_EQ(r.w, 0u);
+}
@@ -0,0 +1,44 @@
+// The library instantiations are built for the platform's backend only
+#undef SML_EXTERN_TEMPLATES
+#undef SML_FORCE_SCALAR
+#undef SML_BACKEND
+
+#include "differential.h"
+
+#if defined(__AVX512F__)
+
+#define SML_BACKEND SML_BACKEND_AVX512
+
+#include "differentialbackend.hpp"
+
+namespace differential
+{
+	static bool avx512supported()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_cpu_supports("avx512f");
+#else
+		return true;
+#endif
+	}
+
+	const backend* avx512backend()
+	{
+		static const backend instance = { sml::backendname, &avx512supported, operations, sizeof(operations) / sizeof(operations[0]) };
+
+		return &instance;
+	}
+}
+
+#else
+
+namespace differential
+{
+	// The compiler doesn't target AVX-512F for this file
+	const backend* avx512backend()
+	{
+		return nullptr;
+	}
+}
+
+#endif
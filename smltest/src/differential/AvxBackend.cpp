@@ -0,0 +1,44 @@
+// The library instantiations are built for the platform's backend only
+#undef SML_EXTERN_TEMPLATES
+#undef SML_FORCE_SCALAR
+#undef SML_BACKEND
+
+#include "differential.h"
+
+#if defined(__AVX__)
+
+#define SML_BACKEND SML_BACKEND_AVX
+
+#include "differentialbackend.hpp"
+
+namespace differential
+{
+	static bool avxsupported()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_cpu_supports("avx");
+#else
+		return true;
+#endif
+	}
+
+	const backend* avxbackend()
+	{
+		static const backend instance = { sml::backendname, &avxsupported, operations, sizeof(operations) / sizeof(operations[0]) };
+
+		return &instance;
+	}
+}
+
+#else
+
+namespace differential
+{
+	// The compiler doesn't target AVX for this file
+	const backend* avxbackend()
+	{
+		return nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,23 @@
+// The library instantiations are built for the platform's backend only
+#undef SML_EXTERN_TEMPLATES
+#undef SML_BACKEND
+#ifndef SML_FORCE_SCALAR
+#define SML_FORCE_SCALAR
+#endif
+
+#include "differentialbackend.hpp"
+
+namespace differential
+{
+	static bool scalarsupported()
+	{
+		return true;
+	}
+
+	const backend* scalarbackend()
+	{
+		static const backend instance = { sml::backendname, &scalarsupported, operations, sizeof(operations) / sizeof(operations[0]) };
+
+		return &instance;
+	}
+}
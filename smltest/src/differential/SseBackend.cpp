@@ -0,0 +1,44 @@
+// The library instantiations are built for the platform's backend only
+#undef SML_EXTERN_TEMPLATES
+#undef SML_FORCE_SCALAR
+#undef SML_BACKEND
+
+#include "differential.h"
+
+#if defined(__SSE4_1__)
+
+#define SML_BACKEND SML_BACKEND_SSE
+
+#include "differentialbackend.hpp"
+
+namespace differential
+{
+	static bool ssesupported()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_cpu_supports("sse4.1");
+#else
+		return true;
+#endif
+	}
+
+	const backend* ssebackend()
+	{
+		static const backend instance = { sml::backendname, &ssesupported, operations, sizeof(operations) / sizeof(operations[0]) };
+
+		return &instance;
+	}
+}
+
+#else
+
+namespace differential
+{
+	// The compiler doesn't target SSE4.1 for this file
+	const backend* ssebackend()
+	{
+		return nullptr;
+	}
+}
+
+#endif